@@ -0,0 +1,70 @@
+#include "capture.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace tradecore {
+namespace loadgen {
+
+CaptureWriter::CaptureWriter(const std::filesystem::path& path) : out_(path, std::ios::binary | std::ios::trunc) {
+  if (!out_) {
+    throw std::runtime_error("cannot create capture file " + path.string());
+  }
+  out_.write(reinterpret_cast<const char*>(&kCaptureMagic), sizeof(kCaptureMagic));
+  out_.write(reinterpret_cast<const char*>(&kCaptureVersion), sizeof(kCaptureVersion));
+}
+
+void CaptureWriter::append(common::TimestampNs offset_ns, std::span<const std::byte> datagram) {
+  offset_ns = std::max(offset_ns, last_offset_ns_);
+  last_offset_ns_ = offset_ns;
+  const auto length = static_cast<std::uint32_t>(datagram.size());
+  out_.write(reinterpret_cast<const char*>(&offset_ns), sizeof(offset_ns));
+  out_.write(reinterpret_cast<const char*>(&length), sizeof(length));
+  out_.write(reinterpret_cast<const char*>(datagram.data()), static_cast<std::streamsize>(datagram.size()));
+  ++count_;
+}
+
+void CaptureWriter::close() {
+  out_.flush();
+  if (!out_) {
+    throw std::runtime_error("capture file write failed");
+  }
+  out_.close();
+}
+
+std::vector<CapturedDatagram> read_capture(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("cannot open capture file " + path.string());
+  }
+  std::uint32_t magic = 0;
+  std::uint32_t version = 0;
+  in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  in.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if (!in || magic != kCaptureMagic) {
+    throw std::runtime_error(path.string() + " is not a capture file");
+  }
+  if (version != kCaptureVersion) {
+    throw std::runtime_error("unsupported capture version " + std::to_string(version));
+  }
+
+  std::vector<CapturedDatagram> datagrams;
+  common::TimestampNs offset_ns = 0;
+  while (in.read(reinterpret_cast<char*>(&offset_ns), sizeof(offset_ns))) {
+    std::uint32_t length = 0;
+    CapturedDatagram datagram{.offset_ns = offset_ns};
+    if (!in.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+      throw std::runtime_error("truncated capture record in " + path.string());
+    }
+    datagram.bytes.resize(length);
+    if (!in.read(reinterpret_cast<char*>(datagram.bytes.data()), length)) {
+      throw std::runtime_error("truncated capture record in " + path.string());
+    }
+    datagrams.push_back(std::move(datagram));
+  }
+  return datagrams;
+}
+
+}  // namespace loadgen
+}  // namespace tradecore
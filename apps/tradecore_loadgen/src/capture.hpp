@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+
+#include "tradecore/common/types.hpp"
+
+namespace tradecore {
+namespace loadgen {
+
+// Capture file: wire datagrams with the time each was sent (or received,
+// for traffic captured off the network), for replay at the original pace.
+//
+//   [magic 'TCAP':4][version:4]
+//   then per datagram: [offset_ns:8][length:4][datagram:length]
+//
+// Offsets count from the start of the capture and never decrease. Native
+// little-endian, like the WAL and key store files.
+inline constexpr std::uint32_t kCaptureMagic = 0x50414354;  // "TCAP"
+inline constexpr std::uint32_t kCaptureVersion = 1;
+
+struct CapturedDatagram {
+  common::TimestampNs offset_ns{0};
+  std::vector<std::byte> bytes;
+};
+
+// Appends datagrams to a new capture file; throws std::runtime_error when
+// the file cannot be written.
+class CaptureWriter {
+ public:
+  explicit CaptureWriter(const std::filesystem::path& path);
+
+  // `offset_ns` is clamped to the previous offset so replay never runs
+  // backwards when several threads record into one file.
+  void append(common::TimestampNs offset_ns, std::span<const std::byte> datagram);
+  // Flushes and closes; throws if any write failed.
+  void close();
+
+  [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+
+ private:
+  std::ofstream out_;
+  common::TimestampNs last_offset_ns_{0};
+  std::uint64_t count_{0};
+};
+
+// Reads a whole capture file, so replay pacing is not disturbed by disk
+// reads; throws std::runtime_error on a bad header or a truncated record.
+[[nodiscard]] std::vector<CapturedDatagram> read_capture(const std::filesystem::path& path);
+
+}  // namespace loadgen
+}  // namespace tradecore
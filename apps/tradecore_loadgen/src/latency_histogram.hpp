@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace tradecore {
+namespace loadgen {
+
+// Latency histogram for run reports. telemetry::StreamingHistogram keeps one
+// bucket per power of two, too coarse to tell p99 from p99.9; this one splits
+// each power of two into 16 linear buckets (values are within about 6%) and
+// merges, so each sending thread keeps its own.
+class LatencyHistogram {
+ public:
+  void record(std::int64_t value_ns) noexcept {
+    const auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(value_ns, 0));
+    ++buckets_[index(value)];
+    ++count_;
+    max_ = std::max(max_, value);
+  }
+
+  void merge(const LatencyHistogram& other) noexcept {
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+      buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+  }
+
+  [[nodiscard]] std::uint64_t count() const noexcept { return count_; }
+  [[nodiscard]] std::uint64_t max() const noexcept { return max_; }
+
+  // Value at percentile `p` (0..100), as the midpoint of its bucket.
+  [[nodiscard]] std::uint64_t percentile(double p) const noexcept {
+    if (count_ == 0) {
+      return 0;
+    }
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(static_cast<double>(count_) * p / 100.0));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+      seen += buckets_[i];
+      if (seen >= rank) {
+        return std::min(midpoint(i), max_);
+      }
+    }
+    return max_;
+  }
+
+ private:
+  static constexpr std::size_t kSubBits = 4;
+  static constexpr std::size_t kSub = 1 << kSubBits;
+  // Values below kSub get a bucket each; above, 16 per power of two up to 2^63.
+  static constexpr std::size_t kBuckets = kSub + (64 - kSubBits) * kSub;
+
+  static std::size_t index(std::uint64_t value) noexcept {
+    if (value < kSub) {
+      return static_cast<std::size_t>(value);
+    }
+    const auto shift = static_cast<std::size_t>(std::bit_width(value)) - 1 - kSubBits;
+    return kSub + shift * kSub + static_cast<std::size_t>((value >> shift) & (kSub - 1));
+  }
+
+  static std::uint64_t midpoint(std::size_t index) noexcept {
+    if (index < kSub) {
+      return index;
+    }
+    const auto shift = (index - kSub) / kSub;
+    const auto lower = (kSub + (index - kSub) % kSub) << shift;
+    return lower + ((std::uint64_t{1} << shift) >> 1);
+  }
+
+  std::array<std::uint64_t, kBuckets> buckets_{};
+  std::uint64_t count_{0};
+  std::uint64_t max_{0};
+};
+
+}  // namespace loadgen
+}  // namespace tradecore
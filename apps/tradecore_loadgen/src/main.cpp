@@ -0,0 +1,559 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "capture.hpp"
+#include "latency_histogram.hpp"
+#include "order_flow.hpp"
+#include "target.hpp"
+#include "tradecore/auth/key_store.hpp"
+#include "tradecore/common/time_utils.hpp"
+#include "tradecore/ingest/transport.hpp"
+
+namespace {
+
+using namespace tradecore;
+
+std::atomic<bool> g_interrupted{false};
+
+void handle_interrupt(int /*signal*/) {
+  g_interrupted.store(true);
+}
+
+void print_usage(const char* program) {
+  std::cerr << "Usage: " << program << " [options]                    generate order flow\n"
+            << "       " << program << " --replay <file> [options]    resend a capture at its recorded pace\n"
+            << "       " << program << " --capture <udp://host:port> --record <file> [--duration s]\n"
+            << "       " << program << " --write-keys <path> [--accounts n] [--first-account a] [--seed s]\n"
+            << "Options:\n"
+            << "  --target <uri>        udp://host:port, tcp://host:port, shm://<name>, inproc\n"
+            << "                        (an ingress pipeline in this process, the default) or none\n"
+            << "  --serve               host the transport and pipeline for --target here, to measure\n"
+            << "                        end-to-end latency (implied by inproc)\n"
+            << "  --mix <name>          quote (default), sweep or retail\n"
+            << "  --rate <n>            frames per second over all threads; 0 sends flat out (default 10000)\n"
+            << "  --duration <s>        seconds to run (default 5)\n"
+            << "  --accounts <n>        accounts to spread the flow over (default 100)\n"
+            << "  --first-account <a>   first account id (default 1)\n"
+            << "  --market <id>         market the orders name (default 1)\n"
+            << "  --batch <n>           messages per frame; above 1 sends batch frames (default 1)\n"
+            << "  --threads <n>         sending threads, each with its own accounts (default 1)\n"
+            << "  --nonce-base <n>      first nonce per account (default: microseconds since the epoch)\n"
+            << "  --seed <n>            account key and order-flow seed (default 1)\n"
+            << "  --record <file>       also write every frame sent to a capture file\n"
+            << "  --speed <x>           replay speed multiplier (default 1)\n"
+            << "  --verify-workers <n>  signature threads of the hosted pipeline (default 0)\n";
+}
+
+struct Options {
+  std::string target{"inproc"};
+  bool serve{false};
+  loadgen::Mix mix{loadgen::Mix::kQuote};
+  double rate{10'000};
+  double duration_s{5};
+  std::size_t accounts{100};
+  common::AccountId first_account{1};
+  common::MarketId market{1};
+  std::size_t batch{1};
+  std::size_t threads{1};
+  std::optional<std::uint64_t> nonce_base;
+  std::uint64_t seed{1};
+  std::string record;
+  std::string replay;
+  std::string capture;
+  std::string write_keys;
+  double speed{1.0};
+  std::size_t verify_workers{0};
+};
+
+// Parses the command line; nullopt (after printing why) when it is invalid.
+std::optional<Options> parse_options(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view flag = argv[i];
+    if (flag == "--serve") {
+      options.serve = true;
+      continue;
+    }
+    if (flag == "--help" || i + 1 >= argc) {
+      return std::nullopt;
+    }
+    const std::string value = argv[++i];
+    if (flag == "--target") {
+      options.target = value;
+    } else if (flag == "--mix") {
+      const auto mix = loadgen::parse_mix(value);
+      if (!mix) {
+        std::cerr << "Unknown mix: " << value << "\n";
+        return std::nullopt;
+      }
+      options.mix = *mix;
+    } else if (flag == "--rate") {
+      options.rate = std::stod(value);
+    } else if (flag == "--duration") {
+      options.duration_s = std::stod(value);
+    } else if (flag == "--accounts") {
+      options.accounts = std::stoull(value);
+    } else if (flag == "--first-account") {
+      options.first_account = std::stoull(value);
+    } else if (flag == "--market") {
+      options.market = static_cast<common::MarketId>(std::stoul(value));
+    } else if (flag == "--batch") {
+      options.batch = std::stoull(value);
+    } else if (flag == "--threads") {
+      options.threads = std::stoull(value);
+    } else if (flag == "--nonce-base") {
+      options.nonce_base = std::stoull(value);
+    } else if (flag == "--seed") {
+      options.seed = std::stoull(value);
+    } else if (flag == "--record") {
+      options.record = value;
+    } else if (flag == "--replay") {
+      options.replay = value;
+    } else if (flag == "--capture") {
+      options.capture = value;
+    } else if (flag == "--write-keys") {
+      options.write_keys = value;
+    } else if (flag == "--speed") {
+      options.speed = std::stod(value);
+    } else if (flag == "--verify-workers") {
+      options.verify_workers = std::stoull(value);
+    } else {
+      std::cerr << "Unknown option: " << flag << "\n";
+      return std::nullopt;
+    }
+  }
+
+  if (options.accounts == 0 || options.threads == 0 || options.threads > options.accounts) {
+    std::cerr << "--threads must be between 1 and --accounts\n";
+    return std::nullopt;
+  }
+  if (options.batch == 0 || options.batch > ingest::kMaxBatchMessages) {
+    std::cerr << "--batch must be between 1 and " << ingest::kMaxBatchMessages << "\n";
+    return std::nullopt;
+  }
+  if (options.rate < 0 || options.duration_s <= 0 || options.speed <= 0) {
+    std::cerr << "--rate, --duration and --speed must be positive\n";
+    return std::nullopt;
+  }
+  if (options.target == "none" && options.replay.empty() && (options.rate == 0 || options.record.empty())) {
+    std::cerr << "--target none builds a capture offline and needs --rate and --record\n";
+    return std::nullopt;
+  }
+  return options;
+}
+
+common::TimestampNs now_ns() noexcept {
+  return static_cast<common::TimestampNs>(common::now_steady().count());
+}
+
+// Sleeps most of the way to `deadline` and yields the rest, so a sender on
+// a busy host neither oversleeps nor starves the threads it is measuring.
+void wait_until(common::TimestampNs deadline) {
+  while (true) {
+    const auto remaining = deadline - now_ns();
+    if (remaining <= 0) {
+      return;
+    }
+    if (remaining > 200'000) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - 100'000));
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+std::string microseconds(std::uint64_t ns) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(1) << static_cast<double>(ns) / 1'000.0;
+  return out.str();
+}
+
+void print_latency(std::string_view label, const loadgen::LatencyHistogram& histogram) {
+  if (histogram.count() == 0) {
+    return;
+  }
+  std::cout << "  " << label << " (us): p50=" << microseconds(histogram.percentile(50))
+            << " p90=" << microseconds(histogram.percentile(90)) << " p99=" << microseconds(histogram.percentile(99))
+            << " p99.9=" << microseconds(histogram.percentile(99.9)) << " max=" << microseconds(histogram.max())
+            << "\n";
+}
+
+// What a sending thread did.
+struct SendResults {
+  std::uint64_t frames{0};
+  std::uint64_t messages{0};
+  std::uint64_t dropped{0};
+  // When the last frame went out.
+  common::TimestampNs finished_ns{0};
+  // How late each frame left against its schedule; empty when sending flat out.
+  loadgen::LatencyHistogram lag;
+  loadgen::RejectCounts rejects{};
+
+  void merge(const SendResults& other) {
+    frames += other.frames;
+    messages += other.messages;
+    dropped += other.dropped;
+    finished_ns = std::max(finished_ns, other.finished_ns);
+    lag.merge(other.lag);
+    for (std::size_t i = 0; i < rejects.size(); ++i) {
+      rejects[i] += other.rejects[i];
+    }
+  }
+};
+
+// Frames sent are appended to the capture, if one is being recorded.
+class Recorder {
+ public:
+  explicit Recorder(const std::string& path) {
+    if (!path.empty()) {
+      writer_.emplace(path);
+    }
+  }
+
+  void append(common::TimestampNs offset_ns, std::span<const std::byte> datagram) {
+    if (writer_) {
+      std::scoped_lock lock(mutex_);
+      writer_->append(offset_ns, datagram);
+    }
+  }
+
+  void close(const std::string& path) {
+    if (writer_) {
+      writer_->close();
+      std::cout << "Recorded " << writer_->count() << " frames to " << path << "\n";
+    }
+  }
+
+ private:
+  std::mutex mutex_;
+  std::optional<loadgen::CaptureWriter> writer_;
+};
+
+// Acks for the tail of the run arrive after the last send.
+void drain_acks(loadgen::Sender& sender, SendResults& results) {
+  const auto deadline = now_ns() + 100'000'000;
+  while (now_ns() < deadline) {
+    sender.poll_acks(results.rejects);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+}
+
+SendResults run_flow(const Options& options, std::size_t thread, common::TimestampNs start_ns,
+                     common::TimestampNs end_ns, loadgen::LocalIngress* local, Recorder& recorder) {
+  const bool offline = options.target == "none";
+  const auto accounts = (options.accounts - thread + options.threads - 1) / options.threads;
+  loadgen::OrderFlow flow({
+      .mix = options.mix,
+      .first_account = options.first_account + thread,
+      .accounts = accounts,
+      .stride = options.threads,
+      .market = options.market,
+      .nonce_base = *options.nonce_base,
+      .batch = options.batch,
+      .seed = options.seed,
+  });
+  const auto sender = loadgen::make_sender(options.target, local, thread);
+  const double interval_ns = options.rate > 0 ? 1e9 * static_cast<double>(options.threads) / options.rate : 0;
+
+  SendResults results;
+  for (std::uint64_t i = 0; !g_interrupted.load(std::memory_order_relaxed); ++i) {
+    auto intended_ns = start_ns + static_cast<common::TimestampNs>(static_cast<double>(i) * interval_ns);
+    if (interval_ns == 0) {
+      intended_ns = std::max(intended_ns, now_ns());
+    }
+    if (intended_ns >= end_ns) {
+      break;
+    }
+    if (!offline) {
+      wait_until(intended_ns);
+    }
+    // Frames carry the time they were due, so a late send counts against
+    // the latency measured at the far end.
+    const auto datagram = flow.next(intended_ns);
+    if (!sender->send(datagram)) {
+      ++results.dropped;
+    }
+    results.finished_ns = offline ? intended_ns : now_ns();
+    if (!offline && interval_ns > 0) {
+      results.lag.record(results.finished_ns - intended_ns);
+    }
+    recorder.append(intended_ns - start_ns, datagram);
+    ++results.frames;
+    results.messages += flow.last_messages();
+    if (i % 64 == 0) {
+      sender->poll_acks(results.rejects);
+    }
+  }
+  drain_acks(*sender, results);
+  return results;
+}
+
+// Client timestamp of a captured frame, if it has a wire header.
+std::optional<common::TimestampNs> header_timestamp(std::span<const std::byte> datagram) {
+  if (datagram.size() < sizeof(ingest::WireHeader)) {
+    return std::nullopt;
+  }
+  ingest::WireHeader header;
+  std::memcpy(&header, datagram.data(), sizeof(header));
+  return static_cast<common::TimestampNs>(header.timestamp_ns);
+}
+
+// Messages a captured frame carries: a batch frame's count, otherwise one.
+std::size_t message_count(std::span<const std::byte> datagram) {
+  if (datagram.size() < sizeof(ingest::WireHeader)) {
+    return 0;
+  }
+  ingest::WireHeader header;
+  std::memcpy(&header, datagram.data(), sizeof(header));
+  if (header.kind != static_cast<std::uint8_t>(ingest::MessageKind::kBatch)) {
+    return 1;
+  }
+  const auto count_offset = sizeof(header) + ((header.flags & ingest::kFrameFlagSessionMac) != 0
+                                                   ? ingest::kFrameSessionMacSize
+                                                   : ingest::kFrameSignatureSize);
+  return count_offset < datagram.size() ? std::to_integer<std::size_t>(datagram[count_offset]) : 0;
+}
+
+SendResults run_replay(const Options& options, const std::vector<loadgen::CapturedDatagram>& capture,
+                       common::TimestampNs start_ns, loadgen::LocalIngress* local, Recorder& recorder) {
+  const auto sender = loadgen::make_sender(options.target, local, 0);
+  SendResults results;
+  std::uint64_t i = 0;
+  for (const auto& datagram : capture) {
+    if (g_interrupted.load(std::memory_order_relaxed)) {
+      break;
+    }
+    const auto intended_ns =
+        start_ns + static_cast<common::TimestampNs>(static_cast<double>(datagram.offset_ns) / options.speed);
+    wait_until(intended_ns);
+    if (!sender->send(datagram.bytes)) {
+      ++results.dropped;
+    }
+    results.finished_ns = now_ns();
+    results.lag.record(results.finished_ns - intended_ns);
+    recorder.append(intended_ns - start_ns, datagram.bytes);
+    ++results.frames;
+    results.messages += message_count(datagram.bytes);
+    if (i++ % 64 == 0) {
+      sender->poll_acks(results.rejects);
+    }
+  }
+  drain_acks(*sender, results);
+  return results;
+}
+
+
+// Records datagrams sent to a UDP endpoint, with their arrival times, until
+// the duration ends or the run is interrupted.
+int capture_traffic(const Options& options) {
+  const auto target = options.capture;
+  const auto scheme = target.find("://");
+  const auto colon = target.rfind(':');
+  if (!target.starts_with("udp://") || colon == std::string::npos || colon <= scheme) {
+    std::cerr << "--capture needs a udp://host:port endpoint\n";
+    return 1;
+  }
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<std::uint16_t>(std::stoul(target.substr(colon + 1))));
+  const auto host = target.substr(scheme + 3, colon - scheme - 3);
+  if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+    std::cerr << "Bad IPv4 address: " << host << "\n";
+    return 1;
+  }
+  const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0 || bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    std::cerr << "Cannot listen on " << target << ": " << std::strerror(errno) << "\n";
+    if (fd >= 0) {
+      close(fd);
+    }
+    return 1;
+  }
+  timeval timeout{.tv_sec = 0, .tv_usec = 100'000};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  loadgen::CaptureWriter writer(options.record);
+  std::vector<std::byte> buffer(ingest::kMaxWireFrameSize);
+  const auto start_ns = now_ns();
+  const auto end_ns = start_ns + static_cast<common::TimestampNs>(options.duration_s * 1e9);
+  std::cout << "Capturing " << target << " for " << options.duration_s << "s\n";
+  while (!g_interrupted.load() && now_ns() < end_ns) {
+    const auto length = recv(fd, buffer.data(), buffer.size(), 0);
+    if (length > 0) {
+      writer.append(now_ns() - start_ns, std::span<const std::byte>(buffer.data(), static_cast<std::size_t>(length)));
+    }
+  }
+  close(fd);
+  writer.close();
+  std::cout << "Captured " << writer.count() << " datagrams to " << options.record << "\n";
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::optional<Options> parsed;
+  try {
+    parsed = parse_options(argc, argv);
+  } catch (const std::exception& ex) {
+    std::cerr << "Invalid option value: " << ex.what() << "\n";
+  }
+  if (!parsed) {
+    print_usage(argv[0]);
+    return 1;
+  }
+  auto& options = *parsed;
+  if (!options.nonce_base) {
+    options.nonce_base = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+  }
+  std::signal(SIGINT, handle_interrupt);
+  std::signal(SIGTERM, handle_interrupt);
+
+  try {
+    if (!options.write_keys.empty()) {
+      const auto keys = loadgen::OrderFlow::public_keys(options.seed, options.first_account, options.accounts);
+      auth::KeyStore::write(options.write_keys, keys);
+      std::cout << "Wrote " << keys.size() << " account keys (seed " << options.seed << ") to " << options.write_keys
+                << "\n";
+      return 0;
+    }
+    if (!options.capture.empty()) {
+      if (options.record.empty()) {
+        print_usage(argv[0]);
+        return 1;
+      }
+      return capture_traffic(options);
+    }
+
+    std::vector<loadgen::CapturedDatagram> capture;
+    if (!options.replay.empty()) {
+      capture = loadgen::read_capture(options.replay);
+      options.threads = 1;
+    }
+
+    std::unique_ptr<loadgen::LocalIngress> local;
+    if (options.target == "inproc" || options.serve) {
+      local = std::make_unique<loadgen::LocalIngress>(loadgen::LocalIngress::Options{
+          .endpoint = options.target == "inproc" ? std::string{} : options.target,
+          .lanes = options.threads,
+          .verify_workers = options.verify_workers,
+          .seed = options.seed,
+          .first_account = options.first_account,
+          .accounts = options.accounts,
+      });
+      if (!local->start()) {
+        std::cerr << "Cannot serve " << options.target << "\n";
+        return 1;
+      }
+    }
+
+    Recorder recorder(options.record);
+    // Leave the threads time to start before the first frame is due.
+    const auto start_ns = now_ns() + 20'000'000;
+    SendResults totals;
+    if (!options.replay.empty()) {
+      std::cout << "Replaying " << capture.size() << " frames from " << options.replay << " to " << options.target
+                << " at " << options.speed << "x\n";
+      if (local && !capture.empty()) {
+        // Frames recorded by this tool carry their send time at record time;
+        // map the first one onto the replay's schedule.
+        const auto first = header_timestamp(capture.front().bytes).value_or(0) - capture.front().offset_ns;
+        local->set_clock(first, start_ns, options.speed);
+      }
+      totals = run_replay(options, capture, start_ns, local.get(), recorder);
+    } else {
+      const auto end_ns = start_ns + static_cast<common::TimestampNs>(options.duration_s * 1e9);
+      std::cout << "Sending " << loadgen::mix_name(options.mix) << " flow for " << options.accounts
+                << " accounts to " << options.target << " at "
+                << (options.rate > 0 ? std::to_string(static_cast<std::uint64_t>(options.rate)) + " frames/s"
+                                     : std::string("full speed"))
+                << " (" << options.threads << " threads, batch " << options.batch << ")\n";
+      std::vector<SendResults> results(options.threads);
+      std::vector<std::thread> threads;
+      std::exception_ptr failure;
+      std::mutex failure_mutex;
+      for (std::size_t t = 0; t < options.threads; ++t) {
+        threads.emplace_back([&, t] {
+          try {
+            results[t] = run_flow(options, t, start_ns, end_ns, local.get(), recorder);
+          } catch (...) {
+            std::scoped_lock lock(failure_mutex);
+            failure = std::current_exception();
+            g_interrupted.store(true);
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      if (failure) {
+        std::rethrow_exception(failure);
+      }
+      for (const auto& result : results) {
+        totals.merge(result);
+      }
+    }
+    const auto elapsed_ns = totals.finished_ns - start_ns;
+    recorder.close(options.record);
+
+    const auto seconds = static_cast<double>(std::max<common::TimestampNs>(elapsed_ns, 1)) / 1e9;
+    std::cout << std::fixed << std::setprecision(2) << "Sent " << totals.frames << " frames (" << totals.messages
+              << " messages) in " << seconds << "s: " << std::setprecision(0)
+              << static_cast<double>(totals.frames) / seconds << " frames/s, "
+              << static_cast<double>(totals.messages) / seconds << " messages/s\n";
+    if (totals.dropped > 0) {
+      std::cout << "  dropped: " << totals.dropped << "\n";
+    }
+    print_latency("send lag", totals.lag);
+    std::uint64_t acked = 0;
+    for (const auto count : totals.rejects) {
+      acked += count;
+    }
+    if (acked > 0) {
+      std::cout << "  rejects acked:";
+      for (std::size_t reason = 1; reason < totals.rejects.size(); ++reason) {
+        std::cout << " " << loadgen::reject_reason_name(static_cast<ingest::RejectReason>(reason)) << "="
+                  << totals.rejects[reason];
+      }
+      std::cout << "\n";
+    }
+
+    if (local) {
+      local->stop();
+      const auto served = local->results();
+      std::cout << "Ingress (" << local->lanes() << " lanes): " << served.dequeued << " messages dequeued, "
+                << static_cast<double>(served.dequeued) / seconds << " messages/s\n";
+      print_latency("send to dequeue", served.latency);
+      std::cout << "  accepted=" << served.stats.accepted << " rejected: auth=" << served.stats.rejected_auth
+                << " replay=" << served.stats.rejected_replay << " rate_limit=" << served.stats.rejected_rate_limit
+                << " queue_full=" << served.stats.rejected_queue_full << " shed=" << served.stats.rejected_shed
+                << "\n";
+    }
+  } catch (const std::exception& ex) {
+    std::cerr << "Load generation failed: " << ex.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
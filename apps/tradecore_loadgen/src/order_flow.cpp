@@ -0,0 +1,242 @@
+#include "order_flow.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "tradecore/ingest/sbe_messages.hpp"
+
+namespace tradecore {
+namespace loadgen {
+
+namespace {
+
+// Resting orders an account remembers; older ones are assumed filled.
+constexpr std::size_t kMaxResting = 64;
+
+std::uint64_t order_id(common::MarketId market, common::AccountId account, std::uint64_t nonce) noexcept {
+  // Matches replay::new_order_request, which names a new order after the
+  // frame that placed it.
+  return common::OrderId{
+      .market = market,
+      .session = static_cast<common::SessionId>(account & 0xffff),
+      .local = static_cast<common::SequenceId>(nonce & 0xffffffff),
+  }
+      .value();
+}
+
+}  // namespace
+
+std::optional<Mix> parse_mix(std::string_view name) noexcept {
+  if (name == "quote") {
+    return Mix::kQuote;
+  }
+  if (name == "sweep") {
+    return Mix::kSweep;
+  }
+  if (name == "retail") {
+    return Mix::kRetail;
+  }
+  return std::nullopt;
+}
+
+std::string_view mix_name(Mix mix) noexcept {
+  switch (mix) {
+    case Mix::kQuote:
+      return "quote";
+    case Mix::kSweep:
+      return "sweep";
+    case Mix::kRetail:
+      return "retail";
+  }
+  return "unknown";
+}
+
+OrderFlow::OrderFlow(const FlowOptions& options) : options_(options), rng_(options.seed + options.first_account) {
+  if (options_.accounts == 0) {
+    throw std::invalid_argument("OrderFlow: no accounts");
+  }
+  options_.batch = std::clamp<std::size_t>(options_.batch, 1, ingest::kMaxBatchMessages);
+  accounts_.resize(options_.accounts);
+  for (std::size_t i = 0; i < accounts_.size(); ++i) {
+    auto& account = accounts_[i];
+    account.id = options_.first_account + i * options_.stride;
+    account.nonce = options_.nonce_base;
+    auth::PublicKey public_key;
+    account_keys(options_.seed, account.id, public_key, account.secret);
+  }
+  datagram_.reserve(ingest::kMaxWireFrameSize);
+  message_.reserve(sizeof(ingest::FrameHeader) + ingest::kMaxWireFrameSize);
+}
+
+void OrderFlow::account_keys(std::uint64_t seed, common::AccountId account, auth::PublicKey& out_public,
+                             auth::SecretKey& out_secret) {
+  auth::KeySeed key_seed{};
+  std::memcpy(key_seed.data(), &seed, sizeof(seed));
+  std::memcpy(key_seed.data() + sizeof(seed), &account, sizeof(account));
+  auth::Authenticator::derive_keypair(key_seed, out_public, out_secret);
+}
+
+std::vector<auth::KeyTable::Entry> OrderFlow::public_keys(std::uint64_t seed, common::AccountId first_account,
+                                                          std::size_t accounts) {
+  std::vector<auth::KeyTable::Entry> entries;
+  entries.reserve(accounts);
+  for (std::size_t i = 0; i < accounts; ++i) {
+    auth::PublicKey public_key;
+    auth::SecretKey secret;
+    account_keys(seed, first_account + i, public_key, secret);
+    entries.emplace_back(first_account + i, public_key);
+  }
+  return entries;
+}
+
+std::uint8_t OrderFlow::priority() const noexcept {
+  // Quotes go to the priority tier (priority_threshold defaults to 1).
+  return options_.mix == Mix::kQuote ? 1 : 0;
+}
+
+OrderFlow::Message OrderFlow::next_message(Account& account, std::uint64_t nonce) {
+  Message message;
+  const auto roll = rng_() % 100;
+  mid_ = std::max<std::int64_t>(mid_ + static_cast<std::int64_t>(rng_() % 3) - 1, 1'000);
+  const auto side = (rng_() & 1) != 0 ? common::Side::kBuy : common::Side::kSell;
+  const std::int64_t sign = side == common::Side::kBuy ? -1 : 1;
+
+  auto cancel = [&](std::size_t index) {
+    message.kind = ingest::MessageKind::kCancel;
+    message.length = ingest::sbe::encode(ingest::sbe::Cancel{.order_id = account.resting[index]}, message.body);
+    account.resting.erase(account.resting.begin() + static_cast<std::ptrdiff_t>(index));
+  };
+  auto replace = [&](std::size_t index, std::int64_t quantity, std::int64_t price) {
+    message.kind = ingest::MessageKind::kReplace;
+    message.length = ingest::sbe::encode(ingest::sbe::Replace{.order_id = account.resting[index],
+                                                              .new_quantity = quantity,
+                                                              .new_price = price},
+                                         message.body);
+  };
+  auto place = [&](std::int64_t quantity, std::int64_t price, std::uint16_t flags, common::TimeInForce tif) {
+    message.kind = ingest::MessageKind::kNewOrder;
+    message.length = ingest::sbe::encode(ingest::sbe::NewOrder{.side = side,
+                                                               .quantity = quantity,
+                                                               .price = std::max<std::int64_t>(price, 1),
+                                                               .flags = flags,
+                                                               .market = options_.market,
+                                                               .time_in_force = tif,
+                                                               .client_order_id = nonce},
+                                         message.body);
+    if (tif == common::TimeInForce::kGtc) {
+      account.resting.push_back(order_id(options_.market, account.id, nonce));
+      if (account.resting.size() > kMaxResting) {
+        account.resting.pop_front();
+      }
+    }
+  };
+  const auto quantity = [&](std::int64_t low, std::int64_t high) {
+    return low + static_cast<std::int64_t>(rng_() % static_cast<std::uint64_t>(high - low + 1));
+  };
+  const bool resting = !account.resting.empty();
+
+  switch (options_.mix) {
+    case Mix::kQuote:
+      if (roll < 45 && resting) {
+        cancel(0);
+      } else if (roll < 55 && resting) {
+        // Reprice the oldest quote; it keeps its id and queues last.
+        replace(0, quantity(1, 10), mid_ + sign * quantity(1, 5));
+        std::rotate(account.resting.begin(), account.resting.begin() + 1, account.resting.end());
+      } else {
+        place(quantity(1, 10), mid_ + sign * quantity(1, 5), common::OrderFlags::kPostOnly,
+              common::TimeInForce::kGtc);
+      }
+      break;
+    case Mix::kSweep:
+      if (roll < 80) {
+        place(quantity(10, 100), mid_ - sign * 50, 0, common::TimeInForce::kIoc);
+      } else if (roll < 90 && resting) {
+        cancel(0);
+      } else {
+        place(quantity(1, 10), mid_ + sign * quantity(1, 10), 0, common::TimeInForce::kGtc);
+      }
+      break;
+    case Mix::kRetail:
+      if (roll < 20 && resting) {
+        cancel(rng_() % account.resting.size());
+      } else if (roll < 30 && resting) {
+        replace(rng_() % account.resting.size(), quantity(1, 5), mid_ + sign * quantity(0, 20));
+      } else {
+        place(quantity(1, 5), mid_ + sign * quantity(0, 20), 0, common::TimeInForce::kGtc);
+      }
+      break;
+  }
+  return message;
+}
+
+std::span<const std::byte> OrderFlow::next(common::TimestampNs timestamp_ns) {
+  auto& account = accounts_[next_account_];
+  next_account_ = (next_account_ + 1) % accounts_.size();
+
+  constexpr std::size_t kBodyOffset = sizeof(ingest::WireHeader) + ingest::kFrameSignatureSize;
+  datagram_.assign(kBodyOffset, std::byte{0});
+  auto append = [this](const Message& message) {
+    datagram_.insert(datagram_.end(), message.body.begin(),
+                     message.body.begin() + static_cast<std::ptrdiff_t>(message.length));
+  };
+
+  ingest::MessageKind kind;
+  std::size_t count = 0;
+  if (options_.batch == 1) {
+    const auto message = next_message(account, account.nonce);
+    append(message);
+    kind = message.kind;
+    count = 1;
+  } else {
+    // [count:1] then count x [kind:1][length:1][SBE message:length]
+    datagram_.push_back(std::byte{0});
+    while (count < options_.batch &&
+           datagram_.size() + 2 + ingest::sbe::kMaxEncodedSize <= ingest::kMaxBatchFrameSize) {
+      const auto message = next_message(account, account.nonce + count);
+      datagram_.push_back(static_cast<std::byte>(message.kind));
+      datagram_.push_back(static_cast<std::byte>(message.length));
+      append(message);
+      ++count;
+    }
+    datagram_[kBodyOffset] = static_cast<std::byte>(count);
+    kind = ingest::MessageKind::kBatch;
+  }
+
+  const ingest::WireHeader wire{
+      .magic = ingest::WireHeader::kMagic,
+      .version = ingest::WireHeader::kVersion,
+      .flags = 0,
+      .account = account.id,
+      .nonce = account.nonce,
+      .timestamp_ns = static_cast<std::uint64_t>(timestamp_ns),
+      .priority = priority(),
+      .kind = static_cast<std::uint8_t>(kind),
+      .payload_len = static_cast<std::uint16_t>(datagram_.size() - sizeof(ingest::WireHeader)),
+  };
+  std::memcpy(datagram_.data(), &wire, sizeof(wire));
+
+  // The signature covers the FrameHeader the transport will rebuild from the
+  // wire header, then the payload after the signature.
+  const ingest::FrameHeader header{
+      .account = wire.account,
+      .nonce = wire.nonce,
+      .received_time_ns = timestamp_ns,
+      .priority = wire.priority,
+      .kind = kind,
+  };
+  const auto* header_bytes = reinterpret_cast<const std::byte*>(&header);
+  message_.assign(header_bytes, header_bytes + sizeof(header));
+  message_.insert(message_.end(), datagram_.begin() + kBodyOffset, datagram_.end());
+  auth::Signature signature;
+  auth::Authenticator::sign(account.secret, message_, signature);
+  std::memcpy(datagram_.data() + sizeof(ingest::WireHeader), signature.data(), signature.size());
+
+  account.nonce += count;
+  last_messages_ = count;
+  return datagram_;
+}
+
+}  // namespace loadgen
+}  // namespace tradecore
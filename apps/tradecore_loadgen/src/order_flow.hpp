@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "tradecore/auth/authenticator.hpp"
+#include "tradecore/auth/key_table.hpp"
+#include "tradecore/common/types.hpp"
+#include "tradecore/ingest/frame.hpp"
+#include "tradecore/ingest/transport.hpp"
+
+namespace tradecore {
+namespace loadgen {
+
+// Order-flow shapes the generator can produce.
+enum class Mix : std::uint8_t {
+  // Market makers: post-only quotes on the priority tier, most of them
+  // cancelled or repriced soon after.
+  kQuote,
+  // Aggressive takers: IOC orders priced through the book, a few passive
+  // orders and cancels between sweeps.
+  kSweep,
+  // Many small GTC limit orders near the mid with occasional cancels and
+  // replaces, on the standard tier.
+  kRetail,
+};
+
+[[nodiscard]] std::optional<Mix> parse_mix(std::string_view name) noexcept;
+[[nodiscard]] std::string_view mix_name(Mix mix) noexcept;
+
+struct FlowOptions {
+  Mix mix{Mix::kQuote};
+  // Accounts first_account, first_account + stride, ... (count of them), so
+  // several flows can split one account range between them.
+  common::AccountId first_account{1};
+  std::size_t accounts{1};
+  std::size_t stride{1};
+  common::MarketId market{1};
+  // First nonce every account uses; must exceed the nonces of earlier runs
+  // against the same daemon or its replay windows reject the frames.
+  std::uint64_t nonce_base{1};
+  // Messages per frame; above 1, frames are batch frames holding up to this
+  // many messages (fewer when they would not fit kMaxBatchFrameSize).
+  std::size_t batch{1};
+  // Seeds the account keys (see account_keys) and, with first_account, the
+  // order-flow choices.
+  std::uint64_t seed{1};
+};
+
+// Builds signed wire datagrams (WireHeader, ed25519 signature, SBE payload
+// or batch body) exactly as a client would send them, cycling through the
+// flow's accounts. Each account tracks its resting orders so cancels and
+// replaces name live order ids (OrderId from the market, the account and
+// the nonce of the new order). Not thread-safe: one flow per sending thread.
+class OrderFlow {
+ public:
+  explicit OrderFlow(const FlowOptions& options);
+
+  // The next datagram, stamped with `timestamp_ns` (the header's client
+  // time, which tradecored keeps as FrameHeader::received_time_ns). The span
+  // is valid until the next call.
+  [[nodiscard]] std::span<const std::byte> next(common::TimestampNs timestamp_ns);
+
+  // Messages in the last datagram next() returned.
+  [[nodiscard]] std::size_t last_messages() const noexcept { return last_messages_; }
+
+  // Deterministic keys for an account under a seed, so a key store written
+  // by one run (write_keys) verifies the frames of another.
+  static void account_keys(std::uint64_t seed, common::AccountId account, auth::PublicKey& out_public,
+                           auth::SecretKey& out_secret);
+  [[nodiscard]] static std::vector<auth::KeyTable::Entry> public_keys(std::uint64_t seed,
+                                                                      common::AccountId first_account,
+                                                                      std::size_t accounts);
+
+ private:
+  struct Account {
+    common::AccountId id{0};
+    auth::SecretKey secret{};
+    std::uint64_t nonce{0};
+    // Order ids of this account's orders that may still rest, oldest first.
+    std::deque<std::uint64_t> resting;
+  };
+
+  struct Message {
+    ingest::MessageKind kind{ingest::MessageKind::kNewOrder};
+    std::array<std::byte, ingest::sbe::kMaxEncodedSize> body{};
+    std::size_t length{0};
+  };
+
+  // Picks and encodes the next message for `account`, which will carry
+  // `nonce`.
+  Message next_message(Account& account, std::uint64_t nonce);
+  std::uint8_t priority() const noexcept;
+
+  FlowOptions options_;
+  std::vector<Account> accounts_;
+  std::size_t next_account_{0};
+  std::mt19937_64 rng_;
+  // Mid price the flow quotes around; drifts a tick at a time.
+  std::int64_t mid_{100'000};
+  std::vector<std::byte> datagram_;
+  std::vector<std::byte> message_;
+  std::size_t last_messages_{0};
+};
+
+}  // namespace loadgen
+}  // namespace tradecore
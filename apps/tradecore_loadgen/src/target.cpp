@@ -0,0 +1,359 @@
+#include "target.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "order_flow.hpp"
+#include "tradecore/common/time_utils.hpp"
+#include "tradecore/ingest/feedback.hpp"
+#include "tradecore/ingest/shm_transport.hpp"
+#include "tradecore/ingest/tcp_transport.hpp"
+#include "tradecore/ingest/transport.hpp"
+
+namespace tradecore {
+namespace loadgen {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+common::TimestampNs now_ns() noexcept {
+  return static_cast<common::TimestampNs>(common::now_steady().count());
+}
+
+// "udp://host:port" style endpoint to a socket address.
+sockaddr_in parse_address(std::string_view target) {
+  const auto scheme = target.find("://");
+  const auto rest = target.substr(scheme + 3);
+  const auto colon = rest.rfind(':');
+  if (colon == std::string_view::npos) {
+    throw std::invalid_argument("missing port in " + std::string(target));
+  }
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  const std::string host(rest.substr(0, colon));
+  if (inet_pton(AF_INET, host == "localhost" ? "127.0.0.1" : host.c_str(), &address.sin_addr) != 1) {
+    throw std::invalid_argument("bad IPv4 address in " + std::string(target));
+  }
+  address.sin_port = htons(static_cast<std::uint16_t>(std::stoul(std::string(rest.substr(colon + 1)))));
+  return address;
+}
+
+int connect_socket(std::string_view target, int type) {
+  const auto address = parse_address(target);
+  const int fd = socket(AF_INET, type, 0);
+  if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    const auto error = errno;
+    if (fd >= 0) {
+      close(fd);
+    }
+    throw std::runtime_error("cannot connect to " + std::string(target) + ": " + std::strerror(error));
+  }
+  return fd;
+}
+
+void count_ack(std::span<const std::byte> bytes, RejectCounts& counts) {
+  const auto ack = ingest::decode_reject_ack(bytes);
+  const auto reason = ack ? static_cast<std::size_t>(ack->reason) : 0;
+  if (ack && reason < counts.size()) {
+    counts[reason] += ack->count;
+  }
+}
+
+class UdpSender final : public Sender {
+ public:
+  explicit UdpSender(std::string_view target) : fd_(connect_socket(target, SOCK_DGRAM)) {}
+  ~UdpSender() override { close(fd_); }
+
+  bool send(std::span<const std::byte> datagram) override {
+    return ::send(fd_, datagram.data(), datagram.size(), 0) == static_cast<ssize_t>(datagram.size());
+  }
+
+  void poll_acks(RejectCounts& counts) override {
+    std::array<std::byte, 64> buffer{};
+    ssize_t length;
+    while ((length = recv(fd_, buffer.data(), buffer.size(), MSG_DONTWAIT)) > 0) {
+      count_ack(std::span<const std::byte>(buffer.data(), static_cast<std::size_t>(length)), counts);
+    }
+  }
+
+ private:
+  int fd_;
+};
+
+// Frames back to back on one connection; a full socket buffer blocks the
+// sender, which is the backpressure the TCP transport applies.
+class TcpSender final : public Sender {
+ public:
+  explicit TcpSender(std::string_view target) : fd_(connect_socket(target, SOCK_STREAM)) {
+    const int on = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  }
+  ~TcpSender() override { close(fd_); }
+
+  bool send(std::span<const std::byte> datagram) override {
+    while (!datagram.empty()) {
+      const auto sent = ::send(fd_, datagram.data(), datagram.size(), MSG_NOSIGNAL);
+      if (sent < 0 && errno == EINTR) {
+        continue;
+      }
+      if (sent <= 0) {
+        return false;
+      }
+      datagram = datagram.subspan(static_cast<std::size_t>(sent));
+    }
+    return true;
+  }
+
+  void poll_acks(RejectCounts& counts) override {
+    std::array<std::byte, 4096> buffer{};
+    ssize_t length;
+    while ((length = recv(fd_, buffer.data(), buffer.size(), MSG_DONTWAIT)) > 0) {
+      pending_.insert(pending_.end(), buffer.begin(), buffer.begin() + length);
+    }
+    std::size_t offset = 0;
+    for (; pending_.size() - offset >= ingest::kRejectAckSize; offset += ingest::kRejectAckSize) {
+      count_ack(std::span<const std::byte>(pending_).subspan(offset, ingest::kRejectAckSize), counts);
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(offset));
+  }
+
+ private:
+  int fd_;
+  // Ack bytes short of a whole ack.
+  std::vector<std::byte> pending_;
+};
+
+class ShmSender final : public Sender {
+ public:
+  explicit ShmSender(std::string_view name) {
+    if (!client_.connect(name)) {
+      throw std::runtime_error("no free shm ring for " + std::string(name));
+    }
+  }
+
+  bool send(std::span<const std::byte> datagram) override {
+    // A full ring means the transport is behind: wait for room, like a
+    // client would, but give up on one that stays full.
+    const auto deadline = now_ns() + 1'000'000'000;
+    std::uint32_t spins = 0;
+    while (!client_.send(datagram)) {
+      if (++spins % 256 == 0) {
+        if (now_ns() > deadline) {
+          return false;
+        }
+        std::this_thread::yield();
+      }
+    }
+    return true;
+  }
+
+ private:
+  ingest::ShmClient client_;
+};
+
+class InprocSender final : public Sender {
+ public:
+  InprocSender(LocalIngress& local, std::size_t lane) : local_(local), lane_(lane) {}
+
+  bool send(std::span<const std::byte> datagram) override {
+    local_.submit(lane_, datagram);
+    return true;
+  }
+
+ private:
+  LocalIngress& local_;
+  std::size_t lane_;
+};
+
+class NullSender final : public Sender {
+ public:
+  bool send(std::span<const std::byte> /*datagram*/) override { return true; }
+};
+
+}  // namespace
+
+std::string_view reject_reason_name(ingest::RejectReason reason) noexcept {
+  switch (reason) {
+    case ingest::RejectReason::kAuth:
+      return "auth";
+    case ingest::RejectReason::kReplay:
+      return "replay";
+    case ingest::RejectReason::kRateLimit:
+      return "rate_limit";
+    case ingest::RejectReason::kQueueFull:
+      return "queue_full";
+    case ingest::RejectReason::kShed:
+      return "shed";
+  }
+  return "unknown";
+}
+
+LocalIngress::LocalIngress(const Options& options) : options_(options), frame_auth_(authenticator_) {
+  const auto keys = OrderFlow::public_keys(options_.seed, options_.first_account, options_.accounts);
+  authenticator_.register_accounts(keys);
+  if (!options_.endpoint.empty()) {
+    transport_.emplace(options_.endpoint, ingest::TransportOptions{});
+  }
+  lanes_ = transport_ ? transport_->lane_count() : std::max<std::size_t>(options_.lanes, 1);
+
+  ingest::IngressPipeline::Config config;
+  config.lanes = lanes_;
+  config.max_new_orders_per_second = std::numeric_limits<std::uint32_t>::max();
+  config.max_cancels_per_second = std::numeric_limits<std::uint32_t>::max();
+  config.max_replaces_per_second = std::numeric_limits<std::uint32_t>::max();
+  config.verify_workers = options_.verify_workers;
+  pipeline_.configure(
+      config,
+      [this](const ingest::FrameHeader& header, std::span<const std::byte> payload) {
+        return frame_auth_.verify_frame(&header, sizeof(header), payload, header.account);
+      },
+      [this](std::span<const ingest::Frame> frames, std::span<bool> valid) {
+        thread_local std::vector<auth::FrameAuthenticator::FrameInput> inputs;
+        inputs.clear();
+        for (const auto& frame : frames) {
+          inputs.push_back({
+              .header_data = &frame.header,
+              .header_size = sizeof(frame.header),
+              .payload = frame.payload,
+              .account = frame.header.account,
+          });
+        }
+        (void)frame_auth_.verify_frames(inputs, valid);
+      });
+}
+
+LocalIngress::~LocalIngress() {
+  if (running_.load()) {
+    stop(0ms);
+  }
+}
+
+bool LocalIngress::start() {
+  running_.store(true);
+  consumer_ = std::thread([this] { consume(); });
+  if (!transport_) {
+    return true;
+  }
+  for (std::size_t lane = 0; lane < transport_->lane_count(); ++lane) {
+    transport_->attach_slab(lane, &pipeline_.frame_slab(lane));
+  }
+  transport_->set_batch_callback([this](std::size_t lane) { pipeline_.flush(lane); });
+  transport_->set_pressure_callback([this](std::size_t lane) { return pipeline_.congested(lane); });
+  // Acked as tradecored acks them, so the counts match a run against it.
+  pipeline_.set_reject_observer([this, stream = transport_->stream()](const ingest::Frame& frame,
+                                                                      ingest::RejectReason reason, std::size_t messages,
+                                                                      bool authenticated) {
+    if (!ingest::should_ack_reject(reason, authenticated, stream)) {
+      return;
+    }
+    std::array<std::byte, ingest::kRejectAckSize> ack{};
+    ingest::encode_reject_ack(frame.header, messages, reason, pipeline_.queue_fill_pct(frame.lane), ack);
+    (void)transport_->reply(frame, ack);
+  });
+  if (!transport_->start(options_.endpoint,
+                         [this](std::span<const ingest::Frame> frames) { pipeline_.submit(frames); })) {
+    running_.store(false);
+    consumer_.join();
+    return false;
+  }
+  return true;
+}
+
+void LocalIngress::stop(std::chrono::milliseconds settle) {
+  const auto begin = now_ns();
+  while (true) {
+    const auto quiet_since = std::max(begin, last_dequeue_ns_.load(std::memory_order_relaxed));
+    if (now_ns() - quiet_since >= std::chrono::nanoseconds(settle).count()) {
+      break;
+    }
+    std::this_thread::sleep_for(10ms);
+  }
+  if (transport_) {
+    transport_->stop();
+  }
+  running_.store(false);
+  if (consumer_.joinable()) {
+    consumer_.join();
+  }
+}
+
+void LocalIngress::set_clock(common::TimestampNs origin_ns, common::TimestampNs start_ns, double speed) noexcept {
+  origin_ns_.store(origin_ns, std::memory_order_relaxed);
+  start_ns_.store(start_ns, std::memory_order_relaxed);
+  speed_.store(speed, std::memory_order_relaxed);
+}
+
+void LocalIngress::submit(std::size_t lane, std::span<const std::byte> datagram) {
+  std::array<ingest::Frame, ingest::kMaxBatchMessages> frames{};
+  const auto count = ingest::UdpTransport::parse_frame(datagram.data(), datagram.size(), frames);
+  if (count == 0) {
+    return;
+  }
+  const auto received_ns = now_ns();
+  for (std::size_t i = 0; i < count; ++i) {
+    frames[i].lane = static_cast<std::uint16_t>(lane);
+    frames[i].times.received_ns = received_ns;
+  }
+  pipeline_.submit(std::span<const ingest::Frame>(frames.data(), count));
+  pipeline_.flush(lane);
+}
+
+void LocalIngress::consume() {
+  ingest::OwnedFrame frame;
+  std::uint32_t idle = 0;
+  while (running_.load(std::memory_order_relaxed)) {
+    if (!pipeline_.next(frame)) {
+      if (++idle % 256 == 0) {
+        std::this_thread::yield();
+      }
+      continue;
+    }
+    idle = 0;
+    const auto dequeued_ns = now_ns();
+    const auto origin = origin_ns_.load(std::memory_order_relaxed);
+    const auto start = start_ns_.load(std::memory_order_relaxed);
+    const auto speed = speed_.load(std::memory_order_relaxed);
+    const auto intended_ns =
+        start + static_cast<common::TimestampNs>(static_cast<double>(frame.header.received_time_ns - origin) / speed);
+    latency_.record(dequeued_ns - intended_ns);
+    ++dequeued_;
+    last_dequeue_ns_.store(dequeued_ns, std::memory_order_relaxed);
+  }
+}
+
+LocalIngress::Results LocalIngress::results() const {
+  return {.dequeued = dequeued_, .latency = latency_, .stats = pipeline_.stats()};
+}
+
+std::unique_ptr<Sender> make_sender(std::string_view target, LocalIngress* local, std::size_t lane) {
+  if (target.starts_with("udp://") || target.starts_with("quic://")) {
+    return std::make_unique<UdpSender>(target);
+  }
+  if (ingest::TcpTransport::handles(target)) {
+    return std::make_unique<TcpSender>(target);
+  }
+  if (const auto name = ingest::ShmTransport::ring_name(target); !name.empty()) {
+    return std::make_unique<ShmSender>(name);
+  }
+  if (target == "inproc" && local != nullptr) {
+    return std::make_unique<InprocSender>(*local, lane % local->lanes());
+  }
+  if (target == "none") {
+    return std::make_unique<NullSender>();
+  }
+  throw std::invalid_argument("unknown target " + std::string(target));
+}
+
+}  // namespace loadgen
+}  // namespace tradecore
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "latency_histogram.hpp"
+#include "tradecore/auth/authenticator.hpp"
+#include "tradecore/ingest/frame.hpp"
+#include "tradecore/ingest/ingress_pipeline.hpp"
+#include "tradecore/ingest/quic_transport.hpp"
+
+namespace tradecore {
+namespace loadgen {
+
+// Messages acknowledged as rejected (feedback::RejectAck), indexed by
+// RejectReason.
+using RejectCounts = std::array<std::uint64_t, static_cast<std::size_t>(ingest::RejectReason::kShed) + 1>;
+
+[[nodiscard]] std::string_view reject_reason_name(ingest::RejectReason reason) noexcept;
+
+// An ingress pipeline, and optionally the transport in front of it, hosted by
+// the load generator itself, so latency can be measured end to end: a
+// consumer thread drains the pipeline and records, per message, the time from
+// when its frame was meant to be sent (its header's client timestamp, see
+// set_clock) to when it was dequeued. Senders that fall behind the schedule
+// therefore show up in the latency instead of hiding it.
+//
+// Verification is real (the flow's account keys are registered) but rate
+// limits are lifted, since the point is to load the ingress path.
+class LocalIngress {
+ public:
+  struct Options {
+    // Transport endpoint to listen on; empty for in-process submission only.
+    std::string endpoint;
+    // Lanes for in-process submission; a transport brings its own.
+    std::size_t lanes{1};
+    std::size_t verify_workers{0};
+    std::uint64_t seed{1};
+    common::AccountId first_account{1};
+    std::size_t accounts{1};
+  };
+
+  struct Results {
+    std::uint64_t dequeued{0};
+    LatencyHistogram latency;
+    ingest::IngressPipeline::Stats stats{};
+  };
+
+  explicit LocalIngress(const Options& options);
+  ~LocalIngress();
+
+  LocalIngress(const LocalIngress&) = delete;
+  LocalIngress& operator=(const LocalIngress&) = delete;
+
+  // Starts the consumer and the transport; false when the transport cannot
+  // listen on the endpoint.
+  bool start();
+  // Waits until the pipeline has been quiet for `settle`, then stops the
+  // transport and the consumer.
+  void stop(std::chrono::milliseconds settle = std::chrono::milliseconds(200));
+
+  [[nodiscard]] std::size_t lanes() const noexcept { return lanes_; }
+
+  // Frames timestamped `origin_ns` were meant to go out at `start_ns`, and
+  // later ones `1 / speed` as far apart as their timestamps. Call before
+  // sending; the default maps every timestamp to itself.
+  void set_clock(common::TimestampNs origin_ns, common::TimestampNs start_ns, double speed) noexcept;
+
+  // Parses and submits one datagram as lane `lane`'s transport thread would;
+  // one thread per lane.
+  void submit(std::size_t lane, std::span<const std::byte> datagram);
+
+  [[nodiscard]] Results results() const;
+
+ private:
+  void consume();
+
+  Options options_;
+  std::size_t lanes_{1};
+  auth::Authenticator authenticator_;
+  auth::FrameAuthenticator frame_auth_;
+  ingest::IngressPipeline pipeline_;
+  std::optional<ingest::QuicTransport> transport_;
+  std::atomic<bool> running_{false};
+  std::atomic<common::TimestampNs> last_dequeue_ns_{0};
+  std::thread consumer_;
+
+  std::atomic<common::TimestampNs> origin_ns_{0};
+  std::atomic<common::TimestampNs> start_ns_{0};
+  std::atomic<double> speed_{1.0};
+
+  // Written by the consumer thread; read once it is joined.
+  std::uint64_t dequeued_{0};
+  LatencyHistogram latency_;
+};
+
+// Where generated or replayed datagrams go: "udp://host:port",
+// "tcp://host:port", "shm://<name>", "inproc" (a LocalIngress lane) or
+// "none" (nowhere, for building captures offline). One sender per thread.
+class Sender {
+ public:
+  virtual ~Sender() = default;
+
+  // False when the datagram was dropped: a socket error, or a shared-memory
+  // ring that stayed full.
+  virtual bool send(std::span<const std::byte> datagram) = 0;
+  // Collects any reject acks that have arrived; only UDP and TCP carry them.
+  virtual void poll_acks(RejectCounts& /*counts*/) {}
+};
+
+// Throws std::invalid_argument for an unknown target and std::runtime_error
+// when it cannot be reached; `local` must be set for "inproc".
+[[nodiscard]] std::unique_ptr<Sender> make_sender(std::string_view target, LocalIngress* local, std::size_t lane);
+
+}  // namespace loadgen
+}  // namespace tradecore
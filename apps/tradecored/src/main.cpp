@@ -9,6 +9,7 @@
 #include <filesystem>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -17,13 +18,20 @@
 
 #include "tradecore/api/api_router.hpp"
 #include "tradecore/auth/authenticator.hpp"
+#include "tradecore/auth/key_store.hpp"
+#include "tradecore/common/cpu.hpp"
+#include "tradecore/common/time_utils.hpp"
 #include "tradecore/config/config_loader.hpp"
 #include "tradecore/funding/funding_engine.hpp"
+#include "tradecore/ingest/feedback.hpp"
 #include "tradecore/ingest/ingress_pipeline.hpp"
+#include "tradecore/ingest/journal_record.hpp"
 #include "tradecore/ingest/quic_transport.hpp"
 #include "tradecore/ingest/sbe_messages.hpp"
 #include "tradecore/ledger/ledger_state.hpp"
 #include "tradecore/matcher/matching_engine.hpp"
+#include "tradecore/replay/book_checkpoint.hpp"
+#include "tradecore/replay/book_reconstructor.hpp"
 #include "tradecore/replay/replay_driver.hpp"
 #include "tradecore/risk/liquidation_engine.hpp"
 #include "tradecore/risk/risk_engine.hpp"
@@ -35,6 +43,19 @@ namespace {
 
 std::atomic<bool> g_shutdown_requested{false};
 
+// Telemetry sample ids.
+constexpr std::uint64_t kVerifyLatencyMetric = 2;
+constexpr std::uint64_t kVerifyQueueDepthMetric = 3;
+// Ingress latency by stage: kernel receive -> recv() return -> signature
+// checked -> dequeued -> WAL append -> matched, and the whole wire-to-match
+// span. The WAL append precedes matching, so it is a stage of its own.
+constexpr std::uint64_t kKernelToReceiveMetric = 4;
+constexpr std::uint64_t kReceiveToVerifyMetric = 5;
+constexpr std::uint64_t kVerifyToDequeueMetric = 6;
+constexpr std::uint64_t kDequeueToWalMetric = 7;
+constexpr std::uint64_t kWalToMatchMetric = 8;
+constexpr std::uint64_t kWireToMatchMetric = 9;
+
 struct RestingOrderContext {
   tradecore::common::AccountId account{0};
   tradecore::common::MarketId market{0};
@@ -51,42 +72,45 @@ void handle_shutdown_signal(int /*signal*/) {
   g_shutdown_requested.store(true);
 }
 
+// Stages missing a stamp at either end (no kernel timestamp, an in-process
+// producer, no verifier) are skipped; without a verifier the ring wait is
+// measured from receive.
+void record_stage_latency(tradecore::telemetry::TelemetrySink& telemetry, const tradecore::ingest::OwnedFrame& frame,
+                          tradecore::common::TimestampNs dequeued_ns, tradecore::common::TimestampNs logged_ns,
+                          tradecore::common::TimestampNs matched_ns) {
+  const auto record = [&telemetry](std::uint64_t id, tradecore::common::TimestampNs from,
+                                   tradecore::common::TimestampNs to) {
+    if (from != 0 && to >= from) {
+      telemetry.record_latency(id, std::chrono::nanoseconds(to - from));
+    }
+  };
+  const auto& times = frame.times;
+  record(kKernelToReceiveMetric, times.kernel_ns, times.received_ns);
+  record(kReceiveToVerifyMetric, times.received_ns, times.verified_ns);
+  record(kVerifyToDequeueMetric, times.verified_ns != 0 ? times.verified_ns : times.received_ns, dequeued_ns);
+  record(kDequeueToWalMetric, dequeued_ns, logged_ns);
+  record(kWalToMatchMetric, logged_ns, matched_ns);
+  record(kWireToMatchMetric, times.kernel_ns, matched_ns);
+}
+
 template <typename T>
 void append_primitive(std::vector<std::byte>& payload, T value) {
   auto raw = std::bit_cast<std::array<std::byte, sizeof(T)>>(value);
   payload.insert(payload.end(), raw.begin(), raw.end());
 }
 
-std::vector<std::byte> build_wal_payload(const tradecore::ingest::OwnedFrame& frame) {
+std::uint64_t append_ingress_wal_record(tradecore::wal::Writer& wal, const tradecore::ingest::OwnedFrame& frame,
+                                        tradecore::ingest::JournalRecordType type) {
   std::vector<std::byte> payload;
-  payload.reserve(
-      sizeof(std::uint8_t) + sizeof(frame.header.account) + sizeof(frame.header.nonce) +
-      sizeof(frame.header.received_time_ns) + frame.payload.size());
-  append_primitive<std::uint8_t>(payload, static_cast<std::uint8_t>(frame.header.kind));
-  append_primitive<tradecore::common::AccountId>(payload, frame.header.account);
-  append_primitive<std::uint64_t>(payload, frame.header.nonce);
-  append_primitive<tradecore::common::TimestampNs>(payload, frame.header.received_time_ns);
-  payload.insert(payload.end(), frame.payload.begin(), frame.payload.end());
-  return payload;
-}
-
-std::uint64_t append_ingress_wal_record(tradecore::wal::Writer& wal, const tradecore::ingest::OwnedFrame& frame) {
-  auto payload = build_wal_payload(frame);
+  tradecore::ingest::encode_journal_record(frame.header, frame.payload, payload);
   const auto wal_offset = wal.next_sequence();
   wal.append({
+      .header = {.type = static_cast<std::uint16_t>(type)},
       .payload = std::span<const std::byte>(payload.data(), payload.size()),
   });
   return wal_offset;
 }
 
-tradecore::common::OrderId decode_order_id(std::uint64_t encoded) {
-  return tradecore::common::OrderId{
-      .market = static_cast<tradecore::common::MarketId>(encoded >> 48),
-      .session = static_cast<tradecore::common::SessionId>((encoded >> 32) & 0xffff),
-      .local = static_cast<tradecore::common::SequenceId>(encoded & 0xffffffff),
-  };
-}
-
 tradecore::common::Side opposite_side(tradecore::common::Side side) {
   return side == tradecore::common::Side::kBuy ? tradecore::common::Side::kSell : tradecore::common::Side::kBuy;
 }
@@ -155,14 +179,23 @@ int main(int argc, char* argv[]) {
   // Initialize authenticator for ed25519 signature verification
   auth::Authenticator authenticator;
 
-  // TODO: Load account public keys from config or key store
-  // For now, generate a test keypair for development
-  auth::PublicKey test_pubkey;
-  auth::SecretKey test_seckey;
-  auth::Authenticator::generate_keypair(test_pubkey, test_seckey);
-  authenticator.register_account(1, test_pubkey);  // Register test account
-
-  std::cout << "  Auth: " << authenticator.account_count() << " registered accounts\n";
+  // Account keys come from the mapped key store; the table it yields serves
+  // the base file in place, so startup does not pay one insert per account
+  std::optional<auth::KeyStore> key_store;
+  try {
+    const auto load_start = std::chrono::steady_clock::now();
+    key_store.emplace(cfg.auth.key_store);
+    authenticator.load(*key_store);
+    const auto load_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - load_start);
+    const auto store_stats = key_store->stats();
+    std::cout << "  Auth: " << authenticator.account_count() << " registered accounts from "
+              << cfg.auth.key_store << " (" << store_stats.base_records << " mapped, "
+              << store_stats.log_records << " logged, " << load_us.count() << "us)\n";
+  } catch (const std::exception& e) {
+    std::cerr << "Failed to load key store: " << e.what() << "\n";
+    return 1;
+  }
 
   // Create frame authenticator for signature verification
   auth::FrameAuthenticator frame_auth(authenticator);
@@ -174,23 +207,104 @@ int main(int argc, char* argv[]) {
     // Note: In production, the header bytes would come from the wire format
     return frame_auth.verify_frame(&header, sizeof(header), payload, header.account);
   };
+  // Verify workers check runs of frames at once (see FrameAuthenticator::verify_frames).
+  auto batch_auth_verifier = [&frame_auth](std::span<const ingest::Frame> frames, std::span<bool> valid) {
+    thread_local std::vector<auth::FrameAuthenticator::FrameInput> inputs;
+    inputs.clear();
+    for (const auto& frame : frames) {
+      inputs.push_back({
+          .header_data = &frame.header,
+          .header_size = sizeof(frame.header),
+          .payload = frame.payload,
+          .account = frame.header.account,
+      });
+    }
+    (void)frame_auth.verify_frames(inputs, valid);
+  };
+
+  // Declared ahead of the pipeline: its verify workers report here until
+  // they are joined.
+  telemetry::TelemetrySink telemetry;
 
   ingest::IngressPipeline ingress;
   ingest::IngressPipeline::Config ingress_cfg;
   ingress_cfg.max_new_orders_per_second = cfg.ingress.max_new_orders_per_second;
   ingress_cfg.max_cancels_per_second = cfg.ingress.max_cancels_per_second;
+  ingress_cfg.max_replaces_per_second = cfg.ingress.max_replaces_per_second;
+  ingress_cfg.rate_burst_ms = cfg.ingress.rate_burst_ms;
+  ingress_cfg.rate_table_capacity = cfg.ingress.rate_table_capacity;
+  ingress_cfg.rate_idle_timeout_ns = static_cast<common::TimestampNs>(cfg.ingress.rate_idle_timeout_ms) * 1'000'000;
+  ingress_cfg.replay_protection = cfg.ingress.replay_protection;
+  ingress_cfg.replay_window_capacity = cfg.ingress.replay_window_capacity;
+  ingress_cfg.replay_cold_capacity = cfg.ingress.replay_cold_capacity;
+  for (std::size_t i = 0; i < cfg.ingress.rate_tiers.size(); ++i) {
+    const auto& tier = cfg.ingress.rate_tiers[i];
+    ingress_cfg.rate_tiers.push_back({
+        .new_orders_per_second = tier.new_orders_per_second,
+        .cancels_per_second = tier.cancels_per_second,
+        .replaces_per_second = tier.replaces_per_second,
+        .burst_ms = tier.burst_ms,
+    });
+    for (const auto account : tier.accounts) {
+      ingress_cfg.account_rate_tiers[account] = static_cast<std::uint8_t>(i + 1);
+    }
+  }
   ingress_cfg.new_order_queue_depth = cfg.ingress.new_order_queue_depth;
   ingress_cfg.cancel_queue_depth = cfg.ingress.cancel_queue_depth;
   ingress_cfg.replace_queue_depth = cfg.ingress.replace_queue_depth;
-  ingress.configure(ingress_cfg, auth_verifier);
+  ingress_cfg.lanes = cfg.transport.receive_threads;
+  ingress_cfg.priority_threshold = static_cast<std::uint8_t>(cfg.ingress.priority_threshold);
+  ingress_cfg.priority_queue_depth = cfg.ingress.priority_queue_depth;
+  ingress_cfg.scheduling = cfg.ingress.scheduling == "strict" ? ingest::IngressPipeline::Scheduling::kStrict
+                                                              : ingest::IngressPipeline::Scheduling::kWeighted;
+  ingress_cfg.class_weights = {cfg.ingress.cancel_weight, cfg.ingress.priority_weight, cfg.ingress.standard_weight};
+  ingress_cfg.verify_workers = cfg.ingress.verify_workers;
+  ingress_cfg.verify_batch = cfg.ingress.verify_batch;
+  ingress_cfg.signature_batch = cfg.ingress.signature_batch;
+  ingress_cfg.shed_watermark_pct = cfg.ingress.shed_watermark_pct;
+  ingress.configure(ingress_cfg, auth_verifier, batch_auth_verifier);
+  if (cfg.telemetry.enabled) {
+    ingress.set_verify_observer([&telemetry](std::chrono::nanoseconds latency, std::size_t /*queue_depth*/) {
+      telemetry.record_latency(kVerifyLatencyMetric, latency);
+    });
+  }
 
-  ingest::QuicTransport transport;
-  if (!transport.start(cfg.transport.endpoint, [&](const ingest::Frame& frame) {
-    ingress.submit(frame);
-  })) {
-    std::cerr << "Failed to start transport on " << cfg.transport.endpoint << "\n";
-    return 1;
+  ingest::QuicTransport transport(cfg.transport.endpoint, {
+      .receive_batch_size = cfg.transport.receive_batch_size,
+      .receive_threads = cfg.transport.receive_threads,
+      .io_uring = cfg.transport.io_uring,
+      .busy_poll = cfg.transport.busy_poll,
+      .busy_poll_us = cfg.transport.busy_poll_us,
+      .receive_cpus = cfg.transport.receive_cpus,
+      .kernel_timestamps = cfg.transport.kernel_timestamps,
+      .shm_clients = cfg.transport.shm_clients,
+      .shm_ring_bytes = cfg.transport.shm_ring_bytes,
+      .tcp_max_connections = cfg.transport.tcp_max_connections,
+      .tcp_read_buffer_bytes = cfg.transport.tcp_read_buffer_bytes,
+  });
+  for (std::size_t lane = 0; lane < transport.lane_count(); ++lane) {
+    transport.attach_slab(lane, &ingress.frame_slab(lane));
   }
+  // Frames queued for verification during a receive batch are committed to
+  // the ingress rings, in arrival order, before the lane receives again.
+  transport.set_batch_callback([&ingress](std::size_t lane) { ingress.flush(lane); });
+  // Refused frames are acknowledged to their sender so it can back off
+  // rather than time out and resend; the observer runs on the lane's thread.
+  // Over UDP only authenticated senders are acked (see should_ack_reject).
+  if (cfg.ingress.reject_feedback) {
+    ingress.set_reject_observer([&transport, &ingress, stream = transport.stream()](
+                                    const ingest::Frame& frame, ingest::RejectReason reason, std::size_t messages,
+                                    bool authenticated) {
+      if (!ingest::should_ack_reject(reason, authenticated, stream)) {
+        return;
+      }
+      std::array<std::byte, ingest::kRejectAckSize> ack{};
+      ingest::encode_reject_ack(frame.header, messages, reason, ingress.queue_fill_pct(frame.lane), ack);
+      (void)transport.reply(frame, ack);
+    });
+  }
+  // Stream transports stop reading while a lane's rings are full.
+  transport.set_pressure_callback([&ingress](std::size_t lane) { return ingress.congested(lane); });
 
   matcher::MatchingEngine matcher;
   risk::RiskEngine risk;
@@ -226,11 +340,18 @@ int main(int argc, char* argv[]) {
   wal::Writer wal{cfg.persistence.wal_path, cfg.persistence.wal_flush_threshold};
   snapshot::Store snapshot{cfg.persistence.snapshot_dir};
 
+  std::optional<replay::CheckpointStore> book_checkpoints;
+  if (cfg.persistence.checkpoint_interval > 0) {
+    book_checkpoints.emplace(cfg.persistence.checkpoint_dir);
+  }
+  std::uint64_t last_checkpoint_sequence = book_checkpoints
+                                               ? book_checkpoints->latest_sequence().value_or(0)
+                                               : 0;
+
   replay::Driver replay;
   replay.configure(snapshot.directory(), cfg.persistence.wal_path);
   (void)replay;
 
-  telemetry::TelemetrySink telemetry;
   if (cfg.telemetry.enabled) {
     telemetry.push({.id = 1, .value = 0});
   }
@@ -267,6 +388,44 @@ int main(int argc, char* argv[]) {
                                               : static_cast<common::MarketId>(cfg.markets.front().id);
   std::unordered_map<std::uint64_t, RestingOrderContext> resting_orders{};
 
+  // A resumed WAL continues its sequence, so the book has to continue too:
+  // rebuild it from the latest checkpoint and the WAL tail before any frame
+  // is sequenced, or later checkpoints would drop the orders resting from
+  // before the restart.
+  if (wal.next_sequence() > 1) {
+    try {
+      std::vector<common::MarketId> market_ids;
+      for (const auto& market_cfg : cfg.markets) {
+        market_ids.push_back(static_cast<common::MarketId>(market_cfg.id));
+      }
+      const replay::BookReconstructor reconstructor({
+          .wal_path = cfg.persistence.wal_path,
+          .checkpoint_directory = cfg.persistence.checkpoint_dir,
+          .default_market = default_market,
+          .markets = std::move(market_ids),
+      });
+      const auto restored = reconstructor.restore(matcher);
+      for (const auto market : matcher.market_ids()) {
+        const auto book = matcher.export_book(market);
+        for (const auto* side : {&book.bids, &book.asks}) {
+          for (const auto& order : *side) {
+            resting_orders[order.request.id.value()] = {
+                .account = order.request.account,
+                .market = market,
+                .side = order.request.side,
+            };
+          }
+        }
+      }
+      std::cout << "  Book: restored through WAL sequence " << restored.sequence << " (checkpoint "
+                << restored.checkpoint_sequence << ", " << restored.records_replayed << " records replayed, "
+                << resting_orders.size() << " resting)\n";
+    } catch (const std::exception& e) {
+      std::cerr << "Failed to restore book from " << cfg.persistence.wal_path << ": " << e.what() << "\n";
+      return 1;
+    }
+  }
+
   auto process_fills = [&](const std::vector<matcher::FillEvent>& fills,
                            const RestingOrderContext& taker,
                            std::uint64_t wal_offset,
@@ -304,149 +463,190 @@ int main(int argc, char* argv[]) {
     }
   };
 
-  auto process_new_orders = [&]() -> std::uint64_t {
-    std::uint64_t processed{0};
-    ingest::OwnedFrame frame;
-    while (ingress.next_new_order(frame)) {
-      ++processed;
-      const auto wal_offset = append_ingress_wal_record(wal, frame);
-      api.push_express_feed_frame({
-          .wal_offset = wal_offset,
-          .payload = frame.payload,
+  // Runs a new order past risk ahead of journaling it, so the WAL records
+  // the outcome replay must follow; nullopt when it is malformed or refused.
+  auto check_new_order = [&](const ingest::OwnedFrame& frame) -> std::optional<matcher::OrderRequest> {
+    try {
+      const auto decoded = ingest::sbe::decode_new_order(frame.payload);
+      if (!decoded) {
+        std::cerr << "Failed to process new order: truncated payload\n";
+        return std::nullopt;
+      }
+      const auto& order = *decoded;
+      const auto request = replay::new_order_request(frame.header, order, default_market);
+
+      const auto reduce_only = common::HasFlag(order.flags, common::OrderFlags::kReduceOnly);
+      const auto risk_result = risk.evaluate_order({
+          .account = frame.header.account,
+          .market = request.id.market,
+          .side = order.side,
+          .quantity = order.quantity,
+          .limit_price = order.price,
+          .reduce_only = reduce_only,
       });
+      if (risk_result.decision != risk::Decision::kAccepted) {
+        return std::nullopt;
+      }
+      return request;
+    } catch (const std::exception& ex) {
+      std::cerr << "Failed to process new order: " << ex.what() << "\n";
+      return std::nullopt;
+    }
+  };
 
-      try {
-        const auto order = ingest::sbe::decode_new_order(frame.payload);
-        const common::OrderId order_id{
-            .market = default_market,
-            .session = static_cast<common::SessionId>(frame.header.account & 0xffff),
-            .local = static_cast<common::SequenceId>(frame.header.nonce & 0xffffffff),
-        };
-
-        const auto reduce_only = common::HasFlag(order.flags, common::OrderFlags::kReduceOnly);
-        const auto risk_result = risk.evaluate_order({
-            .account = frame.header.account,
-            .market = default_market,
-            .side = order.side,
-            .quantity = order.quantity,
-            .limit_price = order.price,
-            .reduce_only = reduce_only,
-        });
-        if (risk_result.decision != risk::Decision::kAccepted) {
-          continue;
-        }
-
-        const auto result = matcher.submit({
-            .id = order_id,
-            .account = frame.header.account,
-            .side = order.side,
-            .quantity = order.quantity,
-            .price = order.price,
-            .tif = common::TimeInForce::kGtc,
-            .flags = order.flags,
-        });
-        if (!result.accepted) {
-          continue;
-        }
+  auto process_new_order = [&](const ingest::OwnedFrame& frame, const matcher::OrderRequest& request,
+                               std::uint64_t wal_offset) {
+    try {
+      const auto order_id = request.id;
+      const auto result = matcher.submit(request);
+      if (!result.accepted) {
+        return;
+      }
 
-        const RestingOrderContext taker{
-            .account = frame.header.account,
-            .market = default_market,
-            .side = order.side,
-        };
-        process_fills(result.fills, taker, wal_offset, frame.header.received_time_ns);
+      const RestingOrderContext taker{
+          .account = frame.header.account,
+          .market = order_id.market,
+          .side = request.side,
+      };
+      process_fills(result.fills, taker, wal_offset, frame.header.received_time_ns);
+
+      if (result.resting) {
+        resting_orders[order_id.value()] = taker;
+      } else {
+        resting_orders.erase(order_id.value());
+      }
+    } catch (const std::exception& ex) {
+      std::cerr << "Failed to process new order: " << ex.what() << "\n";
+    }
+  };
 
-        if (result.resting) {
-          resting_orders[order_id.value()] = taker;
-        } else {
-          resting_orders.erase(order_id.value());
-        }
-      } catch (const std::exception& ex) {
-        std::cerr << "Failed to process new order: " << ex.what() << "\n";
+  auto process_cancel = [&](const ingest::OwnedFrame& frame) {
+    try {
+      const auto cancel = ingest::sbe::CancelDecoder::wrap(frame.payload);
+      if (!cancel) {
+        std::cerr << "Failed to process cancel: truncated payload\n";
+        return;
+      }
+      const auto order_id = common::OrderId::from_value(cancel->order_id());
+      const auto result = matcher.cancel({.id = order_id});
+      if (result.cancelled) {
+        resting_orders.erase(order_id.value());
       }
+    } catch (const std::exception& ex) {
+      std::cerr << "Failed to process cancel: " << ex.what() << "\n";
     }
-    return processed;
   };
 
-  auto process_cancels = [&]() -> std::uint64_t {
-    std::uint64_t processed{0};
-    ingest::OwnedFrame frame;
-    while (ingress.next_cancel(frame)) {
-      ++processed;
-      const auto wal_offset = append_ingress_wal_record(wal, frame);
-      api.push_express_feed_frame({
-          .wal_offset = wal_offset,
-          .payload = frame.payload,
+  auto process_replace = [&](const ingest::OwnedFrame& frame, std::uint64_t wal_offset) {
+    try {
+      const auto replace = ingest::sbe::ReplaceDecoder::wrap(frame.payload);
+      if (!replace) {
+        std::cerr << "Failed to process replace: truncated payload\n";
+        return;
+      }
+      const auto order_id = common::OrderId::from_value(replace->order_id());
+
+      const auto taker_it = resting_orders.find(order_id.value());
+      RestingOrderContext taker = {
+          .account = frame.header.account,
+          .market = order_id.market,
+          .side = common::Side::kBuy,
+      };
+      if (taker_it != resting_orders.end()) {
+        taker = taker_it->second;
+      }
+
+      const auto result = matcher.replace({
+          .id = order_id,
+          .new_quantity = replace->new_quantity(),
+          .new_price = replace->new_price(),
+          .new_display_quantity = replace->new_display_quantity(),
+          .new_tif = replace->new_time_in_force(),
+          .new_flags = replace->new_flags(),
       });
 
-      try {
-        const auto cancel = ingest::sbe::decode_cancel(frame.payload);
-        const auto order_id = decode_order_id(cancel.order_id);
-        const auto result = matcher.cancel({.id = order_id});
-        if (result.cancelled) {
-          resting_orders.erase(order_id.value());
-        }
-      } catch (const std::exception& ex) {
-        std::cerr << "Failed to process cancel: " << ex.what() << "\n";
+      if (result.accepted) {
+        process_fills(result.fills, taker, wal_offset, frame.header.received_time_ns);
       }
+
+      if (result.accepted && result.resting) {
+        resting_orders[order_id.value()] = taker;
+      } else if (result.accepted && !result.resting) {
+        resting_orders.erase(order_id.value());
+      }
+    } catch (const std::exception& ex) {
+      std::cerr << "Failed to process replace: " << ex.what() << "\n";
     }
-    return processed;
   };
 
-  auto process_replaces = [&]() -> std::uint64_t {
+  // The pipeline's scheduler decides the order across cancels, priority-tier
+  // and standard orders; that order is what lands in the WAL.
+  auto process_ingress = [&]() -> std::uint64_t {
     std::uint64_t processed{0};
     ingest::OwnedFrame frame;
-    while (ingress.next_replace(frame)) {
+    while (ingress.next(frame)) {
       ++processed;
-      const auto wal_offset = append_ingress_wal_record(wal, frame);
+      const auto dequeued_ns = cfg.telemetry.enabled ? common::now_steady().count() : 0;
+      std::optional<matcher::OrderRequest> new_order;
+      auto record_type = ingest::JournalRecordType::kSequenced;
+      if (frame.header.kind == ingest::MessageKind::kNewOrder) {
+        new_order = check_new_order(frame);
+        if (!new_order) {
+          record_type = ingest::JournalRecordType::kRejected;
+        }
+      }
+      const auto wal_offset = append_ingress_wal_record(wal, frame, record_type);
+      const auto logged_ns = cfg.telemetry.enabled ? common::now_steady().count() : 0;
       api.push_express_feed_frame({
           .wal_offset = wal_offset,
-          .payload = frame.payload,
+          .payload = {frame.payload.begin(), frame.payload.end()},
       });
 
-      try {
-        const auto replace = ingest::sbe::decode_replace(frame.payload);
-        const auto order_id = decode_order_id(replace.order_id);
-
-        const auto taker_it = resting_orders.find(order_id.value());
-        RestingOrderContext taker = {
-            .account = frame.header.account,
-            .market = order_id.market,
-            .side = common::Side::kBuy,
-        };
-        if (taker_it != resting_orders.end()) {
-          taker = taker_it->second;
-        }
-
-        const auto result = matcher.replace({
-            .id = order_id,
-            .new_quantity = replace.new_quantity,
-            .new_price = replace.new_price,
-            .new_flags = replace.new_flags,
-        });
-
-        if (result.accepted) {
-          process_fills(result.fills, taker, wal_offset, frame.header.received_time_ns);
-        }
-
-        if (result.accepted && result.resting) {
-          resting_orders[order_id.value()] = taker;
-        } else if (result.accepted && !result.resting) {
-          resting_orders.erase(order_id.value());
-        }
-      } catch (const std::exception& ex) {
-        std::cerr << "Failed to process replace: " << ex.what() << "\n";
+      switch (frame.header.kind) {
+        case ingest::MessageKind::kNewOrder:
+          if (new_order) {
+            process_new_order(frame, *new_order, wal_offset);
+          }
+          break;
+        case ingest::MessageKind::kCancel:
+          process_cancel(frame);
+          break;
+        case ingest::MessageKind::kReplace:
+          process_replace(frame, wal_offset);
+          break;
+        case ingest::MessageKind::kHeartbeat:
+        case ingest::MessageKind::kBatch:
+          break;
+      }
+      if (cfg.telemetry.enabled) {
+        record_stage_latency(telemetry, frame, dequeued_ns, logged_ns, common::now_steady().count());
       }
     }
     return processed;
   };
 
+  // Traffic is accepted only once the book is rebuilt.
+  if (!transport.start(cfg.transport.endpoint, [&](std::span<const ingest::Frame> frames) {
+    ingress.submit(frames);
+  })) {
+    std::cerr << "Failed to start transport on " << cfg.transport.endpoint << "\n";
+    return 1;
+  }
+  std::cout << "  Transport backend: " << transport.backend() << " (" << transport.lane_count() << " lanes)\n";
+
   std::signal(SIGINT, handle_shutdown_signal);
   std::signal(SIGTERM, handle_shutdown_signal);
 
   std::cout << "tradecored bootstrapped successfully\n";
   std::cout << "Entering event loop. Press Ctrl+C to shut down.\n";
 
+  // Receive threads were started unpinned from this thread, so pinning it
+  // now does not drag them along.
+  if (!common::pin_current_thread(cfg.event_loop.cpu)) {
+    std::cerr << "Failed to pin event loop to cpu " << cfg.event_loop.cpu << "\n";
+    return 1;
+  }
+
   constexpr auto kIdleSleep = std::chrono::milliseconds(10);
   constexpr auto kStatusInterval = std::chrono::seconds(1);
   constexpr std::uint64_t kSnapshotInterval = 256;
@@ -454,7 +654,7 @@ int main(int argc, char* argv[]) {
   std::uint64_t last_snapshot_block = 0;
 
   while (!g_shutdown_requested.load()) {
-    const auto processed = process_new_orders() + process_cancels() + process_replaces();
+    const auto processed = process_ingress();
     if (processed > 0) {
       const auto new_block = block_number.fetch_add(processed) + processed;
       if (new_block - last_snapshot_block >= kSnapshotInterval) {
@@ -467,6 +667,23 @@ int main(int argc, char* argv[]) {
         snapshot.persist(seq, std::span<const std::byte>(snapshot_payload.data(), snapshot_payload.size()));
         last_snapshot_block = new_block;
       }
+
+      const auto applied_sequence = wal.next_sequence() - 1;
+      if (book_checkpoints &&
+          applied_sequence - last_checkpoint_sequence >= cfg.persistence.checkpoint_interval) {
+        wal.flush();
+        replay::BookCheckpoint checkpoint{
+            .sequence = applied_sequence,
+            .wal_offset = wal.next_offset(),
+        };
+        for (const auto market : matcher.market_ids()) {
+          checkpoint.books.push_back(matcher.export_book(market));
+        }
+        book_checkpoints->persist(checkpoint);
+        last_checkpoint_sequence = applied_sequence;
+      }
+    } else if (cfg.event_loop.spin) {
+      common::cpu_relax();
     } else {
       std::this_thread::sleep_for(kIdleSleep);
     }
@@ -474,10 +691,23 @@ int main(int argc, char* argv[]) {
     const auto now = std::chrono::steady_clock::now();
     if (now - last_status >= kStatusInterval) {
       const auto stats = transport.stats();
+      const auto ingress_stats = ingress.stats();
+      const auto verify = ingress.verify_stats();
+      const auto queues = ingress.queue_stats();
+      if (cfg.telemetry.enabled) {
+        telemetry.push({.id = kVerifyQueueDepthMetric, .value = static_cast<std::int64_t>(verify.queue_depth)});
+      }
       std::cout << "[status] block=" << block_number.load()
-                << " ingress_accepted=" << ingress.stats().accepted
+                << " ingress_accepted=" << ingress_stats.accepted
+                << " throttled_accounts=" << ingress_stats.throttled_accounts
+                << " shed=" << ingress_stats.rejected_shed
+                << " queue_hwm=" << queues.high_watermark[0] << "/" << queues.high_watermark[1] << "/"
+                << queues.high_watermark[2]
+                << " verify_queue=" << verify.queue_depth
                 << " frames=" << stats.frames_received
                 << " peers=" << stats.connections_active
+                << " batch_fill=" << stats.average_batch_fill()
+                << " backend=" << transport.backend()
                 << " wal_next=" << wal.next_sequence() << "\n";
       last_status = now;
     }
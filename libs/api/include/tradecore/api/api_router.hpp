@@ -5,11 +5,13 @@
 #include <deque>
 #include <functional>
 #include <shared_mutex>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
 
+#include "tradecore/api/sbe/market_data.hpp"
 #include "tradecore/common/types.hpp"
 
 namespace tradecore {
@@ -30,6 +32,11 @@ struct TradeMetadata {
   common::TimestampNs timestamp_ns{0};
 };
 
+// Encodes `metadata` as an SBE TradeReport (generated from
+// libs/api/schema/market_data.toml); returns the bytes written, or 0 when
+// `out` is shorter than sbe::kTradeReportEncodedSize.
+std::size_t encode_trade_report(const TradeMetadata& metadata, std::span<std::byte> out) noexcept;
+
 struct NodeStatus {
   std::uint64_t chain_id{1};
   std::uint64_t block_number{0};
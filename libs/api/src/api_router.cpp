@@ -31,6 +31,20 @@ void push_with_fifo_eviction(std::deque<T>& buffer, std::size_t max_size, T valu
 
 }  // namespace
 
+std::size_t encode_trade_report(const TradeMetadata& metadata, std::span<std::byte> out) noexcept {
+  return sbe::encode(
+      sbe::TradeReport{
+          .wal_offset = metadata.wal_offset,
+          .order_id = metadata.order_id.value(),
+          .account = metadata.account,
+          .market = metadata.market,
+          .price = metadata.price,
+          .quantity = metadata.quantity,
+          .timestamp_ns = metadata.timestamp_ns,
+      },
+      out);
+}
+
 ApiRouter::ApiRouter(
     std::size_t express_feed_capacity,
     std::size_t trade_metadata_capacity)
@@ -1,24 +1,29 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdint>
-#include <span>
-#include <unordered_map>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 
+#include "tradecore/auth/key_table.hpp"
 #include "tradecore/common/types.hpp"
 
 namespace tradecore {
 namespace auth {
 
-// ed25519 key sizes
-constexpr std::size_t kPublicKeySize = 32;
+class KeyStore;
+
+// ed25519 key sizes (kPublicKeySize and PublicKey live in key_table.hpp)
 constexpr std::size_t kSecretKeySize = 64;
 constexpr std::size_t kSignatureSize = 64;
+constexpr std::size_t kKeySeedSize = 32;
 
-using PublicKey = std::array<std::uint8_t, kPublicKeySize>;
 using SecretKey = std::array<std::uint8_t, kSecretKeySize>;
 using Signature = std::array<std::uint8_t, kSignatureSize>;
+using KeySeed = std::array<std::uint8_t, kKeySeedSize>;
 
 // Signed frame wire format:
 // [signature:64][header:36][payload:N]
@@ -28,22 +33,45 @@ struct SignedFrameHeader {
   // Followed by WireHeader and payload
 };
 
+// Account keys are held in an immutable KeyTable snapshot, RCU style:
+// writers (register/unregister, serialised by a mutex) build a new table and
+// publish it by bumping a version counter, and each reading thread keeps its
+// own reference to the snapshot it last saw, refreshing it only when the
+// version moves. Lookups on the verify path therefore take no lock, touch no
+// shared reference count and never allocate; a superseded table is freed
+// once the last thread holding it has refreshed.
 class Authenticator {
  public:
+  // One signature check in a batch; `message` and `signature` must outlive
+  // the verify_batch() call.
+  struct VerifyRequest {
+    common::AccountId account{0};
+    std::span<const std::byte> message{};
+    const Signature* signature{nullptr};
+  };
+
   Authenticator();
   ~Authenticator();
 
   // Register a public key for an account
   void register_account(common::AccountId account, const PublicKey& public_key);
 
+  // Register many keys with one table rebuild
+  void register_accounts(std::span<const KeyTable::Entry> entries);
+
+  // Replace every registered key with the store's current contents. The
+  // store's mapped base is served in place, so this costs the log replay,
+  // not one insert per account.
+  void load(const KeyStore& store);
+
   // Remove an account's key
   void unregister_account(common::AccountId account);
 
   // Check if account is registered
   bool has_account(common::AccountId account) const;
 
-  // Get account's public key (returns nullptr if not found)
-  const PublicKey* get_public_key(common::AccountId account) const;
+  // Get account's public key (by value: snapshots are replaced on update)
+  std::optional<PublicKey> get_public_key(common::AccountId account) const;
 
   // Verify a signature against a message using an account's registered key
   // Returns true if signature is valid
@@ -51,6 +79,11 @@ class Authenticator {
               std::span<const std::byte> message,
               const Signature& signature) const;
 
+  // Verify a batch of signatures, writing each outcome to results[i]
+  // (results.size() must be at least requests.size()). Returns true when
+  // every signature is valid.
+  bool verify_batch(std::span<const VerifyRequest> requests, std::span<bool> results) const;
+
   // Verify using explicit public key (for testing or one-off verification)
   static bool verify_with_key(const PublicKey& public_key,
                               std::span<const std::byte> message,
@@ -64,12 +97,23 @@ class Authenticator {
   // Generate a new keypair (for testing/setup)
   static void generate_keypair(PublicKey& out_public, SecretKey& out_secret);
 
+  // Derive the keypair for a seed; the same seed always gives the same keys
+  // (for load generators and fixtures that must agree with a key store)
+  static void derive_keypair(const KeySeed& seed, PublicKey& out_public, SecretKey& out_secret);
+
   // Number of registered accounts
   std::size_t account_count() const;
 
  private:
-  mutable std::mutex mutex_;
-  std::unordered_map<common::AccountId, PublicKey> keys_;
+  // The calling thread's snapshot, refreshed if a writer has published since.
+  const KeyTable& key_table() const;
+  void publish(std::shared_ptr<const KeyTable> table);
+
+  // Distinguishes authenticators in the per-thread snapshot cache.
+  const std::uint64_t instance_;
+  mutable std::mutex writer_mutex_;
+  std::shared_ptr<const KeyTable> table_;  // guarded by writer_mutex_
+  std::atomic<std::uint64_t> version_{0};
 };
 
 // Create an AuthVerifier callback for use with IngressPipeline
@@ -80,11 +124,28 @@ class FrameAuthenticator {
   explicit FrameAuthenticator(const Authenticator& auth);
 
   // Verify a frame - expects signature as first 64 bytes of payload
-  // Returns true if signature is valid
+  // Returns true if signature is valid. The signed message is assembled in a
+  // per-thread buffer, so steady-state calls do not allocate.
   bool verify_frame(const void* header_data, std::size_t header_size,
                     std::span<const std::byte> payload,
                     common::AccountId account) const;
 
+  // Verify a buffer already laid out as [signature:64][signed message], as in
+  // SignedFrameHeader; nothing is copied.
+  bool verify_signed(std::span<const std::byte> signed_frame, common::AccountId account) const;
+
+  struct FrameInput {
+    const void* header_data{nullptr};
+    std::size_t header_size{0};
+    std::span<const std::byte> payload{};
+    common::AccountId account{0};
+  };
+
+  // Verify a batch of frames via Authenticator::verify_batch; messages are
+  // assembled into one per-thread buffer instead of one allocation per frame.
+  // Returns true when every frame is valid.
+  bool verify_frames(std::span<const FrameInput> frames, std::span<bool> results) const;
+
  private:
   const Authenticator& auth_;
 };
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "tradecore/auth/key_table.hpp"
+#include "tradecore/common/types.hpp"
+
+namespace tradecore {
+namespace auth {
+
+// Persistent account keys: a base file mapped read-only plus an append log of
+// changes made since it was written.
+//
+// Base file (`path`, native little-endian):
+//   [magic 'TCKS':4][version:4][count:8][checksum:8][reserved:8]
+//   [KeyRecord:40] x count, strictly ascending by account
+// Log file (`path` + ".log"): 56-byte records of
+//   [magic 'TCKL':4][op:4][account:8][key:32][checksum:8]
+//
+// Opening maps the base, checks its checksum and order in one pass and
+// replays the log; the base is served in place by the KeyTable from table(),
+// so startup cost does not grow with a per-key insert. A torn record at the
+// log tail (a crash mid-append) ends the replay and is truncated away.
+// compact() folds the log into a new base file.
+class KeyStore {
+ public:
+  struct Stats {
+    std::size_t base_records{0};
+    std::size_t log_records{0};
+  };
+
+  // A missing base file opens as an empty store; a corrupt one throws.
+  explicit KeyStore(std::filesystem::path path);
+  ~KeyStore();
+
+  KeyStore(const KeyStore&) = delete;
+  KeyStore& operator=(const KeyStore&) = delete;
+
+  // Writes a base file holding `entries` (later duplicates win) through a
+  // temporary file and rename, so readers never see a partial store.
+  static void write(const std::filesystem::path& path, std::span<const KeyTable::Entry> entries);
+
+  // Append to the log and sync it before returning.
+  void put(std::span<const KeyTable::Entry> entries);
+  void remove(common::AccountId account);
+
+  // Rewrites the base with the current contents and truncates the log.
+  void compact();
+
+  // Current contents; the table keeps the mapping alive after the store is
+  // closed or compacted.
+  [[nodiscard]] std::shared_ptr<const KeyTable> table() const;
+
+  [[nodiscard]] Stats stats() const noexcept;
+  [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+ private:
+  struct Mapping;
+
+  void map_base();
+  void replay_log();
+  void append(std::span<const KeyTable::Update> updates);
+
+  std::filesystem::path path_;
+  std::filesystem::path log_path_;
+  std::shared_ptr<const Mapping> mapping_;
+  std::vector<KeyTable::Update> log_;
+  int log_fd_{-1};
+};
+
+}  // namespace auth
+}  // namespace tradecore
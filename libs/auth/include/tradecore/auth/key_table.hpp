@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "tradecore/common/types.hpp"
+
+namespace tradecore {
+namespace auth {
+
+constexpr std::size_t kPublicKeySize = 32;
+using PublicKey = std::array<std::uint8_t, kPublicKeySize>;
+
+// One account key as laid out in a key store file (see key_store.hpp).
+struct KeyRecord {
+  common::AccountId account{0};
+  PublicKey key{};
+};
+static_assert(sizeof(KeyRecord) == 40);
+
+// Immutable account -> public key map, built once and then only read, so any
+// number of threads can look keys up concurrently without synchronisation.
+// Authenticator publishes a new table for every change instead of mutating
+// one in place.
+//
+// A table is an optional base - a strictly ascending KeyRecord array, usually
+// a mapped key store file, searched by bisection and shared between tables -
+// overlaid by one flat open-addressing array at most half full. Overlay slots
+// replace or hide base records, so updating a table with millions of mapped
+// keys copies only the overlay.
+class KeyTable {
+ public:
+  using Entry = std::pair<common::AccountId, PublicKey>;
+
+  // A registration, or a removal when `remove` is set; applied in order.
+  struct Update {
+    common::AccountId account{0};
+    PublicKey key{};
+    bool remove{false};
+  };
+
+  KeyTable() = default;
+  // Later entries for the same account replace earlier ones.
+  explicit KeyTable(std::span<const Entry> entries);
+  // `base` must be strictly ascending by account and stay valid while `owner`
+  // is alive.
+  KeyTable(std::shared_ptr<const void> owner, std::span<const KeyRecord> base, std::span<const Update> updates);
+
+  [[nodiscard]] const PublicKey* find(common::AccountId account) const noexcept;
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  // This table with `updates` applied; the base is shared, not copied.
+  [[nodiscard]] std::shared_ptr<const KeyTable> apply(std::span<const Update> updates) const;
+
+  // Every entry: base records first, in account order, then the overlay in
+  // table order.
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    for (const auto& record : base_) {
+      if (overlay_slot(record.account) == nullptr) {
+        fn(record.account, record.key);
+      }
+    }
+    for (const auto& slot : slots_) {
+      if (slot.state == kPresent) {
+        fn(slot.account, slot.key);
+      }
+    }
+  }
+
+ private:
+  static constexpr std::uint8_t kEmpty = 0;
+  static constexpr std::uint8_t kPresent = 1;
+  static constexpr std::uint8_t kRemoved = 2;
+
+  struct Slot {
+    common::AccountId account{0};
+    PublicKey key{};
+    std::uint8_t state{kEmpty};
+  };
+
+  void build_overlay(std::span<const Update> updates);
+  [[nodiscard]] const Slot* overlay_slot(common::AccountId account) const noexcept;
+  [[nodiscard]] const KeyRecord* base_find(common::AccountId account) const noexcept;
+
+  std::shared_ptr<const void> owner_;
+  std::span<const KeyRecord> base_{};
+  std::vector<Slot> slots_;
+  std::size_t mask_{0};
+  unsigned shift_{64};
+  std::size_t size_{0};
+};
+
+}  // namespace auth
+}  // namespace tradecore
@@ -2,8 +2,12 @@
 
 #include <sodium.h>
 
+#include <atomic>
 #include <cstring>
 #include <stdexcept>
+#include <vector>
+
+#include "tradecore/auth/key_store.hpp"
 
 namespace tradecore {
 namespace auth {
@@ -24,48 +28,118 @@ void ensure_sodium_init() {
   static SodiumInitializer init;
 }
 
+std::uint64_t next_instance() {
+  static std::atomic<std::uint64_t> instances{0};
+  return instances.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 }  // namespace
 
-Authenticator::Authenticator() {
+Authenticator::Authenticator() : instance_(next_instance()) {
   ensure_sodium_init();
+  publish(std::make_shared<const KeyTable>());
 }
 
 Authenticator::~Authenticator() = default;
 
+void Authenticator::publish(std::shared_ptr<const KeyTable> table) {
+  // Caller holds writer_mutex_ (or is the constructor).
+  table_ = std::move(table);
+  version_.fetch_add(1, std::memory_order_release);
+}
+
+const KeyTable& Authenticator::key_table() const {
+  struct Snapshot {
+    std::uint64_t instance{0};
+    std::uint64_t version{0};
+    std::shared_ptr<const KeyTable> table;
+  };
+  thread_local Snapshot snapshot;
+
+  const auto version = version_.load(std::memory_order_acquire);
+  if (snapshot.instance != instance_ || snapshot.version != version) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    snapshot.instance = instance_;
+    snapshot.version = version_.load(std::memory_order_relaxed);
+    snapshot.table = table_;
+  }
+  return *snapshot.table;
+}
+
 void Authenticator::register_account(common::AccountId account, const PublicKey& public_key) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  keys_[account] = public_key;
+  const KeyTable::Entry entry{account, public_key};
+  register_accounts(std::span<const KeyTable::Entry>(&entry, 1));
+}
+
+void Authenticator::register_accounts(std::span<const KeyTable::Entry> entries) {
+  std::vector<KeyTable::Update> updates;
+  updates.reserve(entries.size());
+  for (const auto& [account, key] : entries) {
+    updates.push_back({.account = account, .key = key});
+  }
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  publish(table_->apply(updates));
+}
+
+void Authenticator::load(const KeyStore& store) {
+  auto table = store.table();
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  publish(std::move(table));
 }
 
 void Authenticator::unregister_account(common::AccountId account) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  keys_.erase(account);
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  if (table_->find(account) == nullptr) {
+    return;
+  }
+  const KeyTable::Update update{.account = account, .remove = true};
+  publish(table_->apply(std::span<const KeyTable::Update>(&update, 1)));
 }
 
 bool Authenticator::has_account(common::AccountId account) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return keys_.find(account) != keys_.end();
+  return key_table().find(account) != nullptr;
 }
 
-const PublicKey* Authenticator::get_public_key(common::AccountId account) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = keys_.find(account);
-  if (it == keys_.end()) {
-    return nullptr;
+std::optional<PublicKey> Authenticator::get_public_key(common::AccountId account) const {
+  if (const auto* key = key_table().find(account)) {
+    return *key;
   }
-  return &it->second;
+  return std::nullopt;
 }
 
 bool Authenticator::verify(common::AccountId account,
                            std::span<const std::byte> message,
                            const Signature& signature) const {
-  const PublicKey* key = get_public_key(account);
+  const PublicKey* key = key_table().find(account);
   if (!key) {
     return false;
   }
   return verify_with_key(*key, message, signature);
 }
 
+bool Authenticator::verify_batch(std::span<const VerifyRequest> requests, std::span<bool> results) const {
+  if (results.size() < requests.size()) {
+    throw std::invalid_argument("verify_batch: results shorter than requests");
+  }
+
+  // libsodium has no multi-scalar multiplication, so there is no aggregate
+  // check to try first: each signature is verified on its own against one
+  // snapshot of the key table.
+  ensure_sodium_init();
+  const auto& table = key_table();
+  bool all_valid = true;
+  for (std::size_t i = 0; i < requests.size(); ++i) {
+    const auto& request = requests[i];
+    const auto* key = table.find(request.account);
+    results[i] = key != nullptr && request.signature != nullptr &&
+                 crypto_sign_verify_detached(request.signature->data(),
+                                             reinterpret_cast<const unsigned char*>(request.message.data()),
+                                             request.message.size(), key->data()) == 0;
+    all_valid = all_valid && results[i];
+  }
+  return all_valid;
+}
+
 bool Authenticator::verify_with_key(const PublicKey& public_key,
                                     std::span<const std::byte> message,
                                     const Signature& signature) {
@@ -96,9 +170,13 @@ void Authenticator::generate_keypair(PublicKey& out_public, SecretKey& out_secre
   crypto_sign_keypair(out_public.data(), out_secret.data());
 }
 
+void Authenticator::derive_keypair(const KeySeed& seed, PublicKey& out_public, SecretKey& out_secret) {
+  ensure_sodium_init();
+  crypto_sign_seed_keypair(out_public.data(), out_secret.data(), seed.data());
+}
+
 std::size_t Authenticator::account_count() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return keys_.size();
+  return key_table().size();
 }
 
 FrameAuthenticator::FrameAuthenticator(const Authenticator& auth) : auth_(auth) {}
@@ -115,20 +193,62 @@ bool FrameAuthenticator::verify_frame(const void* header_data, std::size_t heade
   Signature signature;
   std::memcpy(signature.data(), payload.data(), kSignatureSize);
 
-  // Message is: header + remaining payload (after signature)
-  std::vector<std::byte> message;
-  message.reserve(header_size + payload.size() - kSignatureSize);
-
-  // Append header
+  // Message is: header + remaining payload (after signature), assembled in a
+  // buffer that only grows until it fits the largest frame
+  thread_local std::vector<std::byte> message;
   const auto* header_bytes = static_cast<const std::byte*>(header_data);
-  message.insert(message.end(), header_bytes, header_bytes + header_size);
+  message.assign(header_bytes, header_bytes + header_size);
+  message.insert(message.end(), payload.begin() + kSignatureSize, payload.end());
+
+  return auth_.verify(account, message, signature);
+}
 
-  // Append payload after signature
-  if (payload.size() > kSignatureSize) {
-    message.insert(message.end(), payload.begin() + kSignatureSize, payload.end());
+bool FrameAuthenticator::verify_signed(std::span<const std::byte> signed_frame, common::AccountId account) const {
+  if (signed_frame.size() < kSignatureSize) {
+    return false;
   }
+  Signature signature;
+  std::memcpy(signature.data(), signed_frame.data(), kSignatureSize);
+  return auth_.verify(account, signed_frame.subspan(kSignatureSize), signature);
+}
 
-  return auth_.verify(account, message, signature);
+bool FrameAuthenticator::verify_frames(std::span<const FrameInput> frames, std::span<bool> results) const {
+  if (results.size() < frames.size()) {
+    throw std::invalid_argument("verify_frames: results shorter than frames");
+  }
+
+  // Lay every message out in one buffer first; spans into it are only taken
+  // once it has stopped growing.
+  thread_local std::vector<std::byte> arena;
+  thread_local std::vector<std::size_t> offsets;
+  thread_local std::vector<Signature> signatures;
+  thread_local std::vector<Authenticator::VerifyRequest> requests;
+  arena.clear();
+  offsets.assign(frames.size() + 1, 0);
+  signatures.resize(frames.size());
+  for (std::size_t i = 0; i < frames.size(); ++i) {
+    const auto& frame = frames[i];
+    offsets[i] = arena.size();
+    if (frame.payload.size() < kSignatureSize) {
+      continue;
+    }
+    std::memcpy(signatures[i].data(), frame.payload.data(), kSignatureSize);
+    const auto* header_bytes = static_cast<const std::byte*>(frame.header_data);
+    arena.insert(arena.end(), header_bytes, header_bytes + frame.header_size);
+    arena.insert(arena.end(), frame.payload.begin() + kSignatureSize, frame.payload.end());
+  }
+  offsets[frames.size()] = arena.size();
+
+  requests.resize(frames.size());
+  for (std::size_t i = 0; i < frames.size(); ++i) {
+    const bool signed_frame = frames[i].payload.size() >= kSignatureSize;
+    requests[i] = {
+        .account = frames[i].account,
+        .message = std::span<const std::byte>(arena).subspan(offsets[i], offsets[i + 1] - offsets[i]),
+        .signature = signed_frame ? &signatures[i] : nullptr,
+    };
+  }
+  return auth_.verify_batch(requests, results);
 }
 
 }  // namespace auth
@@ -0,0 +1,365 @@
+#include "tradecore/auth/key_store.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace tradecore {
+namespace auth {
+
+static_assert(std::endian::native == std::endian::little, "key store files are little-endian");
+
+namespace {
+
+constexpr std::uint32_t kBaseMagic = 0x534b4354;  // 'TCKS'
+constexpr std::uint32_t kLogMagic = 0x4c4b4354;   // 'TCKL'
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kOpPut = 1;
+constexpr std::uint32_t kOpRemove = 2;
+
+struct BaseHeader {
+  std::uint32_t magic{kBaseMagic};
+  std::uint32_t version{kVersion};
+  std::uint64_t count{0};
+  std::uint64_t checksum{0};
+  std::uint64_t reserved{0};
+};
+static_assert(sizeof(BaseHeader) == 32);
+
+struct LogRecord {
+  std::uint32_t magic{kLogMagic};
+  std::uint32_t op{0};
+  common::AccountId account{0};
+  PublicKey key{};
+  std::uint64_t checksum{0};
+};
+static_assert(sizeof(LogRecord) == 56);
+
+// Four independent multiply chains over 8-byte words, folded at the end;
+// the chains overlap in the pipeline, so a multi-million-record base is
+// checked at close to memory bandwidth. Every update() but the last must be
+// a multiple of kBlock bytes for the result not to depend on how the input
+// was split.
+class Checksum {
+ public:
+  static constexpr std::size_t kBlock = 32;
+
+  void update(const void* data, std::size_t size) noexcept {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::size_t offset = 0;
+    for (; offset + kBlock <= size; offset += kBlock) {
+      for (std::size_t lane = 0; lane < 4; ++lane) {
+        lanes_[lane] = mix(lanes_[lane], load(bytes + offset + lane * 8, 8));
+      }
+    }
+    for (; offset < size; offset += 8) {
+      lanes_[0] = mix(lanes_[0], load(bytes + offset, std::min<std::size_t>(8, size - offset)));
+    }
+    length_ += size;
+  }
+
+  [[nodiscard]] std::uint64_t value() const noexcept {
+    auto hash = mix(lanes_[0], length_);
+    for (std::size_t lane = 1; lane < 4; ++lane) {
+      hash = mix(hash, lanes_[lane]);
+    }
+    return hash;
+  }
+
+ private:
+  static std::uint64_t mix(std::uint64_t hash, std::uint64_t word) noexcept {
+    return (std::rotl(hash, 23) ^ word) * 0x9e3779b97f4a7c15ULL;
+  }
+  static std::uint64_t load(const unsigned char* bytes, std::size_t size) noexcept {
+    std::uint64_t word = 0;
+    std::memcpy(&word, bytes, size);
+    return word;
+  }
+
+  std::uint64_t lanes_[4] = {0xcbf29ce484222325ULL, 1, 2, 3};
+  std::uint64_t length_{0};
+};
+
+// Records validated per step: small enough to stay in L2 between the order
+// check and the checksum, and a whole number of checksum blocks.
+constexpr std::size_t kValidateRecords = 1024;
+static_assert(kValidateRecords * sizeof(KeyRecord) % Checksum::kBlock == 0);
+
+std::uint64_t log_checksum(const LogRecord& record) noexcept {
+  Checksum checksum;
+  checksum.update(&record, offsetof(LogRecord, checksum));
+  return checksum.value();
+}
+
+void write_all(int fd, const void* data, std::size_t size, const char* what) {
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  while (size > 0) {
+    const auto written = ::write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::system_category(), what);
+    }
+    bytes += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+void create_parent(const std::filesystem::path& path) {
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path());
+  }
+}
+
+}  // namespace
+
+struct KeyStore::Mapping {
+  Mapping() = default;
+  Mapping(const Mapping&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+  ~Mapping() {
+    if (address != nullptr) {
+      ::munmap(address, length);
+    }
+  }
+
+  void* address{nullptr};
+  std::size_t length{0};
+  std::span<const KeyRecord> records{};
+};
+
+KeyStore::KeyStore(std::filesystem::path path)
+    : path_(std::move(path)), log_path_(path_.string() + ".log") {
+  map_base();
+  replay_log();
+}
+
+KeyStore::~KeyStore() {
+  if (log_fd_ >= 0) {
+    ::close(log_fd_);
+  }
+}
+
+void KeyStore::map_base() {
+  auto mapping = std::make_shared<Mapping>();
+  const int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    if (errno != ENOENT) {
+      throw std::system_error(errno, std::system_category(), "key store open failed");
+    }
+    mapping_ = std::move(mapping);
+    return;
+  }
+
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    const int error = errno;
+    ::close(fd);
+    throw std::system_error(error, std::system_category(), "key store stat failed");
+  }
+  const auto length = static_cast<std::size_t>(st.st_size);
+  if (length < sizeof(BaseHeader)) {
+    ::close(fd);
+    throw std::runtime_error("key store truncated: " + path_.string());
+  }
+  // MAP_POPULATE faults the whole file in with one call; the validation pass
+  // below reads every page anyway.
+  void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  const int error = errno;
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    throw std::system_error(error, std::system_category(), "key store mmap failed");
+  }
+  mapping->address = address;
+  mapping->length = length;
+
+  BaseHeader header;
+  std::memcpy(&header, address, sizeof(header));
+  if (header.magic != kBaseMagic || header.version != kVersion) {
+    throw std::runtime_error("not a key store file: " + path_.string());
+  }
+  if (header.count != (length - sizeof(BaseHeader)) / sizeof(KeyRecord) ||
+      length != sizeof(BaseHeader) + header.count * sizeof(KeyRecord)) {
+    throw std::runtime_error("key store size does not match its record count: " + path_.string());
+  }
+
+  const std::span<const KeyRecord> records(
+      reinterpret_cast<const KeyRecord*>(static_cast<const std::byte*>(address) + sizeof(BaseHeader)),
+      static_cast<std::size_t>(header.count));
+  // One pass over memory: each chunk is order-checked, then checksummed while
+  // still cached.
+  Checksum checksum;
+  for (std::size_t first = 0; first < records.size(); first += kValidateRecords) {
+    const auto chunk = records.subspan(first, std::min(kValidateRecords, records.size() - first));
+    for (std::size_t i = first == 0 ? 1 : 0; i < chunk.size(); ++i) {
+      if (chunk[i].account <= (&chunk[i])[-1].account) {
+        throw std::runtime_error("key store records out of order: " + path_.string());
+      }
+    }
+    checksum.update(chunk.data(), chunk.size_bytes());
+  }
+  if (checksum.value() != header.checksum) {
+    throw std::runtime_error("key store checksum mismatch: " + path_.string());
+  }
+  mapping->records = records;
+  mapping_ = std::move(mapping);
+}
+
+void KeyStore::replay_log() {
+  log_fd_ = ::open(log_path_.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+  if (log_fd_ < 0) {
+    if (errno != ENOENT) {
+      throw std::system_error(errno, std::system_category(), "key store log open failed");
+    }
+    return;
+  }
+
+  LogRecord record;
+  off_t valid = 0;
+  for (;;) {
+    const auto got = ::pread(log_fd_, &record, sizeof(record), valid);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got < 0) {
+      throw std::system_error(errno, std::system_category(), "key store log read failed");
+    }
+    if (static_cast<std::size_t>(got) < sizeof(record) || record.magic != kLogMagic ||
+        (record.op != kOpPut && record.op != kOpRemove) || record.checksum != log_checksum(record)) {
+      break;
+    }
+    log_.push_back({.account = record.account, .key = record.key, .remove = record.op == kOpRemove});
+    valid += static_cast<off_t>(sizeof(record));
+  }
+
+  struct stat st {};
+  if (::fstat(log_fd_, &st) != 0) {
+    throw std::system_error(errno, std::system_category(), "key store log stat failed");
+  }
+  if (st.st_size != valid && ::ftruncate(log_fd_, valid) != 0) {
+    throw std::system_error(errno, std::system_category(), "key store log truncate failed");
+  }
+}
+
+void KeyStore::append(std::span<const KeyTable::Update> updates) {
+  if (updates.empty()) {
+    return;
+  }
+  if (log_fd_ < 0) {
+    create_parent(log_path_);
+    log_fd_ = ::open(log_path_.c_str(), O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (log_fd_ < 0) {
+      throw std::system_error(errno, std::system_category(), "key store log open failed");
+    }
+  }
+
+  std::vector<LogRecord> records(updates.size());
+  for (std::size_t i = 0; i < updates.size(); ++i) {
+    auto& record = records[i];
+    record.op = updates[i].remove ? kOpRemove : kOpPut;
+    record.account = updates[i].account;
+    record.key = updates[i].key;
+    record.checksum = log_checksum(record);
+  }
+  write_all(log_fd_, records.data(), records.size() * sizeof(LogRecord), "key store log write failed");
+  if (::fdatasync(log_fd_) != 0) {
+    throw std::system_error(errno, std::system_category(), "key store log sync failed");
+  }
+  log_.insert(log_.end(), updates.begin(), updates.end());
+}
+
+void KeyStore::put(std::span<const KeyTable::Entry> entries) {
+  std::vector<KeyTable::Update> updates;
+  updates.reserve(entries.size());
+  for (const auto& [account, key] : entries) {
+    updates.push_back({.account = account, .key = key});
+  }
+  append(updates);
+}
+
+void KeyStore::remove(common::AccountId account) {
+  const KeyTable::Update update{.account = account, .remove = true};
+  append(std::span<const KeyTable::Update>(&update, 1));
+}
+
+void KeyStore::write(const std::filesystem::path& path, std::span<const KeyTable::Entry> entries) {
+  std::vector<KeyRecord> records;
+  records.reserve(entries.size());
+  for (const auto& [account, key] : entries) {
+    records.push_back({.account = account, .key = key});
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const KeyRecord& a, const KeyRecord& b) { return a.account < b.account; });
+  // Keep the last record of each run of equal accounts.
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    if (kept > 0 && records[kept - 1].account == records[i].account) {
+      records[kept - 1] = records[i];
+    } else {
+      records[kept++] = records[i];
+    }
+  }
+  records.resize(kept);
+
+  BaseHeader header;
+  header.count = records.size();
+  Checksum checksum;
+  checksum.update(records.data(), records.size() * sizeof(KeyRecord));
+  header.checksum = checksum.value();
+
+  create_parent(path);
+  const auto temporary = path.string() + ".tmp";
+  const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::system_error(errno, std::system_category(), "key store create failed");
+  }
+  try {
+    write_all(fd, &header, sizeof(header), "key store write failed");
+    write_all(fd, records.data(), records.size() * sizeof(KeyRecord), "key store write failed");
+    if (::fsync(fd) != 0) {
+      throw std::system_error(errno, std::system_category(), "key store sync failed");
+    }
+  } catch (...) {
+    ::close(fd);
+    ::unlink(temporary.c_str());
+    throw;
+  }
+  ::close(fd);
+  std::filesystem::rename(temporary, path);
+}
+
+void KeyStore::compact() {
+  std::vector<KeyTable::Entry> entries;
+  table()->for_each([&](common::AccountId account, const PublicKey& key) { entries.emplace_back(account, key); });
+  write(path_, entries);
+  // Replaying a log over a base that already holds its updates is harmless,
+  // so a crash between the rename and this truncate loses nothing.
+  if (log_fd_ >= 0 && (::ftruncate(log_fd_, 0) != 0 || ::fdatasync(log_fd_) != 0)) {
+    throw std::system_error(errno, std::system_category(), "key store log truncate failed");
+  }
+  log_.clear();
+  map_base();
+}
+
+std::shared_ptr<const KeyTable> KeyStore::table() const {
+  return std::make_shared<const KeyTable>(mapping_, mapping_->records, log_);
+}
+
+KeyStore::Stats KeyStore::stats() const noexcept {
+  return {.base_records = mapping_->records.size(), .log_records = log_.size()};
+}
+
+}  // namespace auth
+}  // namespace tradecore
@@ -0,0 +1,137 @@
+#include "tradecore/auth/key_table.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace tradecore {
+namespace auth {
+
+namespace {
+
+std::size_t home_slot(common::AccountId account, unsigned shift) noexcept {
+  return static_cast<std::size_t>((account * 0x9e3779b97f4a7c15ULL) >> shift);
+}
+
+}  // namespace
+
+KeyTable::KeyTable(std::span<const Entry> entries) {
+  std::vector<Update> updates;
+  updates.reserve(entries.size());
+  for (const auto& [account, key] : entries) {
+    updates.push_back({.account = account, .key = key});
+  }
+  build_overlay(updates);
+}
+
+KeyTable::KeyTable(std::shared_ptr<const void> owner, std::span<const KeyRecord> base, std::span<const Update> updates)
+    : owner_(std::move(owner)), base_(base) {
+  build_overlay(updates);
+}
+
+void KeyTable::build_overlay(std::span<const Update> updates) {
+  size_ = base_.size();
+  if (updates.empty()) {
+    return;
+  }
+  const auto capacity = std::bit_ceil(std::max<std::size_t>(updates.size() * 2, 8));
+  slots_.resize(capacity);
+  mask_ = capacity - 1;
+  shift_ = 64 - static_cast<unsigned>(std::countr_zero(capacity));
+  for (const auto& update : updates) {
+    for (auto index = home_slot(update.account, shift_);; index = (index + 1) & mask_) {
+      auto& slot = slots_[index];
+      if (slot.state == kEmpty || slot.account == update.account) {
+        slot = {.account = update.account, .key = update.key, .state = update.remove ? kRemoved : kPresent};
+        break;
+      }
+    }
+  }
+
+  // Overlay slots either replace a base record or add to it; removals only
+  // count when they hide one.
+  for (const auto& slot : slots_) {
+    if (slot.state == kEmpty) {
+      continue;
+    }
+    const bool in_base = base_find(slot.account) != nullptr;
+    if (slot.state == kPresent && !in_base) {
+      ++size_;
+    } else if (slot.state == kRemoved && in_base) {
+      --size_;
+    }
+  }
+}
+
+const KeyTable::Slot* KeyTable::overlay_slot(common::AccountId account) const noexcept {
+  if (slots_.empty()) {
+    return nullptr;
+  }
+  for (auto index = home_slot(account, shift_);; index = (index + 1) & mask_) {
+    const auto& slot = slots_[index];
+    if (slot.state == kEmpty) {
+      return nullptr;
+    }
+    if (slot.account == account) {
+      return &slot;
+    }
+  }
+}
+
+const KeyRecord* KeyTable::base_find(common::AccountId account) const noexcept {
+  if (base_.empty() || account < base_.front().account || account > base_.back().account) {
+    return nullptr;
+  }
+  // Account ids are mostly dense, so interpolating between the ends lands on
+  // or next to the record - one or two cache misses where bisecting a
+  // multi-million-record mapping takes twenty. Galloping out from the guess
+  // keeps skewed ids to O(log distance).
+  const auto span = base_.back().account - base_.front().account;
+  const auto last = base_.size() - 1;
+  auto guess = span == 0 ? 0
+                         : static_cast<std::size_t>(static_cast<double>(account - base_.front().account) /
+                                                    static_cast<double>(span) * static_cast<double>(last));
+  guess = std::min(guess, last);
+
+  auto lo = guess;
+  auto hi = guess + 1;
+  if (base_[guess].account < account) {
+    for (std::size_t step = 1; hi <= last && base_[hi].account < account; step *= 2) {
+      lo = hi;
+      hi = std::min(hi + step, last + 1);
+    }
+    hi = std::min(hi + 1, last + 1);
+  } else {
+    for (std::size_t step = 1; lo > 0 && base_[lo - 1].account >= account; step *= 2) {
+      hi = lo;
+      lo = lo > step ? lo - step : 0;
+    }
+  }
+  const auto it = std::lower_bound(base_.begin() + static_cast<std::ptrdiff_t>(lo),
+                                   base_.begin() + static_cast<std::ptrdiff_t>(hi), account,
+                                   [](const KeyRecord& record, common::AccountId value) { return record.account < value; });
+  return it != base_.end() && it->account == account ? &*it : nullptr;
+}
+
+const PublicKey* KeyTable::find(common::AccountId account) const noexcept {
+  if (const auto* slot = overlay_slot(account)) {
+    return slot->state == kPresent ? &slot->key : nullptr;
+  }
+  const auto* record = base_find(account);
+  return record != nullptr ? &record->key : nullptr;
+}
+
+std::shared_ptr<const KeyTable> KeyTable::apply(std::span<const Update> updates) const {
+  std::vector<Update> merged;
+  merged.reserve(slots_.size() / 2 + updates.size());
+  for (const auto& slot : slots_) {
+    // A removal only needs to survive while it hides a base record.
+    if (slot.state == kPresent || (slot.state == kRemoved && base_find(slot.account) != nullptr)) {
+      merged.push_back({.account = slot.account, .key = slot.key, .remove = slot.state == kRemoved});
+    }
+  }
+  merged.insert(merged.end(), updates.begin(), updates.end());
+  return std::make_shared<const KeyTable>(owner_, base_, merged);
+}
+
+}  // namespace auth
+}  // namespace tradecore
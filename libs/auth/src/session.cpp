@@ -0,0 +1,249 @@
+#include "tradecore/auth/session.hpp"
+
+#include <sodium.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include "tradecore/common/cpu.hpp"
+
+namespace tradecore {
+namespace auth {
+
+namespace {
+
+constexpr char kHelloTag[8] = {'T', 'C', 'S', 'H', 'E', 'L', 'L', 'O'};
+constexpr char kKeyContext[8] = {'T', 'C', 'S', 'E', 'S', 'S', 'N', '1'};
+
+std::size_t home_slot(common::AccountId account, unsigned shift) noexcept {
+  return static_cast<std::size_t>((account * 0x9e3779b97f4a7c15ULL) >> shift);
+}
+
+void put_u64(std::byte* out, std::uint64_t value) noexcept {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = static_cast<std::byte>(value >> (8 * i));
+  }
+}
+
+// Session key = BLAKE2b-256 keyed with the client-to-server kx key over the
+// context tag, account and hello nonce.
+SessionKey derive_session_key(const unsigned char* client_to_server, common::AccountId account,
+                              std::uint64_t nonce) {
+  std::array<std::byte, 24> context{};
+  std::memcpy(context.data(), kKeyContext, sizeof(kKeyContext));
+  put_u64(context.data() + 8, account);
+  put_u64(context.data() + 16, nonce);
+  SessionKey key{};
+  crypto_generichash(key.data(), key.size(), reinterpret_cast<const unsigned char*>(context.data()), context.size(),
+                     client_to_server, crypto_kx_SESSIONKEYBYTES);
+  return key;
+}
+
+}  // namespace
+
+std::array<std::byte, kSessionHelloMessageSize> session_hello_message(const SessionHello& hello) {
+  std::array<std::byte, kSessionHelloMessageSize> message{};
+  std::memcpy(message.data(), kHelloTag, sizeof(kHelloTag));
+  put_u64(message.data() + 8, hello.account);
+  put_u64(message.data() + 16, hello.nonce);
+  std::memcpy(message.data() + 24, hello.client_key.data(), hello.client_key.size());
+  return message;
+}
+
+SessionTable::SessionTable(const Authenticator& authenticator, Config config)
+    : authenticator_(authenticator), config_(config) {
+  if (config_.lifetime_ns <= 0) {
+    throw std::invalid_argument("SessionTable lifetime must be positive");
+  }
+  const auto capacity = std::bit_ceil(std::max(config_.capacity, kMaxProbe));
+  mask_ = capacity - 1;
+  shift_ = 64 - static_cast<unsigned>(std::countr_zero(capacity));
+  slots_ = std::make_unique<Slot[]>(capacity);
+}
+
+std::optional<SessionAccept> SessionTable::open(const SessionHello& hello, const Signature& signature,
+                                                common::TimestampNs now_ns) {
+  const auto message = session_hello_message(hello);
+  if (!authenticator_.verify(hello.account, message, signature)) {
+    rejected_hellos_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  auto& last_nonce = hello_nonces_[hello.account];
+  if (hello.nonce <= last_nonce) {
+    rejected_hellos_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  // The account's own slot, else the first free one, else one whose session
+  // has expired or been closed.
+  const auto home = home_slot(hello.account, shift_);
+  Slot* target = nullptr;
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    Slot& slot = slots_[(home + probe) & mask_];
+    if (!slot.used.load(std::memory_order_relaxed)) {
+      target = target ? target : &slot;
+      break;
+    }
+    if (slot.account.load(std::memory_order_relaxed) == hello.account) {
+      target = &slot;
+      break;
+    }
+    if (target == nullptr && slot.expires_ns.load(std::memory_order_relaxed) <= now_ns) {
+      target = &slot;
+    }
+  }
+  if (target == nullptr) {
+    rejected_hellos_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  KxPublicKey server_public{};
+  KxSecretKey server_secret{};
+  crypto_kx_keypair(server_public.data(), server_secret.data());
+  unsigned char server_rx[crypto_kx_SESSIONKEYBYTES];
+  unsigned char server_tx[crypto_kx_SESSIONKEYBYTES];
+  const bool exchanged = crypto_kx_server_session_keys(server_rx, server_tx, server_public.data(),
+                                                       server_secret.data(), hello.client_key.data()) == 0;
+  sodium_memzero(server_secret.data(), server_secret.size());
+  if (!exchanged) {
+    // The client key was not a valid curve point.
+    rejected_hellos_.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  const Session session{
+      .account = hello.account,
+      .nonce_floor = hello.nonce,
+      .expires_ns = now_ns + config_.lifetime_ns,
+      .key = derive_session_key(server_rx, hello.account, hello.nonce),
+  };
+  sodium_memzero(server_rx, sizeof(server_rx));
+  sodium_memzero(server_tx, sizeof(server_tx));
+  store(*target, session);
+  last_nonce = hello.nonce;
+  opened_.fetch_add(1, std::memory_order_relaxed);
+  return SessionAccept{.server_key = server_public, .expires_ns = session.expires_ns};
+}
+
+void SessionTable::close(common::AccountId account) {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  const auto home = home_slot(account, shift_);
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    Slot& slot = slots_[(home + probe) & mask_];
+    if (!slot.used.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (slot.account.load(std::memory_order_relaxed) == account) {
+      // Keep the account in place so probe chains stay intact.
+      store(slot, Session{.account = account});
+      return;
+    }
+  }
+}
+
+bool SessionTable::verify(common::AccountId account, std::uint64_t nonce, std::span<const std::byte> header,
+                          std::span<const std::byte> body, const SessionMac& mac,
+                          common::TimestampNs now_ns) const noexcept {
+  Session session;
+  if (!load(account, session) || now_ns >= session.expires_ns || nonce <= session.nonce_floor) {
+    return false;
+  }
+  const auto expected = SessionTable::mac(session.key, header, body);
+  sodium_memzero(session.key.data(), session.key.size());
+  return sodium_memcmp(expected.data(), mac.data(), mac.size()) == 0;
+}
+
+bool SessionTable::active(common::AccountId account, common::TimestampNs now_ns) const noexcept {
+  Session session;
+  return load(account, session) && now_ns < session.expires_ns;
+}
+
+SessionTable::Stats SessionTable::stats() const noexcept {
+  return {
+      .opened = opened_.load(std::memory_order_relaxed),
+      .rejected_hellos = rejected_hellos_.load(std::memory_order_relaxed),
+  };
+}
+
+SessionKey SessionTable::client_session_key(const SessionHello& hello, const KxSecretKey& client_secret,
+                                            const KxPublicKey& server_key) {
+  unsigned char client_rx[crypto_kx_SESSIONKEYBYTES];
+  unsigned char client_tx[crypto_kx_SESSIONKEYBYTES];
+  if (crypto_kx_client_session_keys(client_rx, client_tx, hello.client_key.data(), client_secret.data(),
+                                    server_key.data()) != 0) {
+    throw std::invalid_argument("SessionTable: invalid server key");
+  }
+  const auto key = derive_session_key(client_tx, hello.account, hello.nonce);
+  sodium_memzero(client_rx, sizeof(client_rx));
+  sodium_memzero(client_tx, sizeof(client_tx));
+  return key;
+}
+
+SessionMac SessionTable::mac(const SessionKey& key, std::span<const std::byte> header,
+                             std::span<const std::byte> body) noexcept {
+  crypto_generichash_state state;
+  crypto_generichash_init(&state, key.data(), key.size(), kSessionMacSize);
+  crypto_generichash_update(&state, reinterpret_cast<const unsigned char*>(header.data()), header.size());
+  crypto_generichash_update(&state, reinterpret_cast<const unsigned char*>(body.data()), body.size());
+  SessionMac out{};
+  crypto_generichash_final(&state, out.data(), out.size());
+  return out;
+}
+
+bool SessionTable::load(common::AccountId account, Session& out) const noexcept {
+  const auto home = home_slot(account, shift_);
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    const Slot& slot = slots_[(home + probe) & mask_];
+    if (!slot.used.load(std::memory_order_acquire)) {
+      return false;
+    }
+    if (slot.account.load(std::memory_order_relaxed) != account) {
+      continue;
+    }
+    // Sequence-lock read: retry while a writer is mid-update or raced us.
+    while (true) {
+      const auto before = slot.sequence.load(std::memory_order_acquire);
+      if (before & 1U) {
+        common::cpu_relax();
+        continue;
+      }
+      out.account = slot.account.load(std::memory_order_relaxed);
+      out.nonce_floor = slot.nonce_floor.load(std::memory_order_relaxed);
+      out.expires_ns = slot.expires_ns.load(std::memory_order_relaxed);
+      for (std::size_t w = 0; w < kKeyWords; ++w) {
+        const auto word = slot.key[w].load(std::memory_order_relaxed);
+        std::memcpy(out.key.data() + 8 * w, &word, sizeof(word));
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) == before) {
+        break;
+      }
+    }
+    // The slot may have been handed to another account meanwhile.
+    return out.account == account;
+  }
+  return false;
+}
+
+void SessionTable::store(Slot& slot, const Session& session) noexcept {
+  const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.account.store(session.account, std::memory_order_relaxed);
+  slot.nonce_floor.store(session.nonce_floor, std::memory_order_relaxed);
+  slot.expires_ns.store(session.expires_ns, std::memory_order_relaxed);
+  for (std::size_t w = 0; w < kKeyWords; ++w) {
+    std::uint64_t word = 0;
+    std::memcpy(&word, session.key.data() + 8 * w, sizeof(word));
+    slot.key[w].store(word, std::memory_order_relaxed);
+  }
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+  slot.used.store(true, std::memory_order_release);
+}
+
+}  // namespace auth
+}  // namespace tradecore
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+namespace tradecore {
+namespace common {
+
+// Destructive-interference granularity used to keep independently written
+// state on separate lines.
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// Spin-wait hint for busy-poll loops.
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Whether the process' affinity mask allows `cpu`.
+bool cpu_available(int cpu);
+
+// Pins the calling thread to `cpu`; a negative cpu leaves it unpinned.
+// Returns false if the kernel refuses the mask.
+bool pin_current_thread(int cpu);
+
+}  // namespace common
+}  // namespace tradecore
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "tradecore/common/cpu.hpp"
+
+namespace tradecore {
+namespace common {
+
+// Bounded multi-producer/single-consumer ring after Vyukov's bounded queue:
+// every slot carries a sequence number that tells producers when the slot is
+// free for position `pos` (sequence == pos) and the consumer when it holds
+// the element for `pos` (sequence == pos + 1). Producers claim positions
+// with a CAS on the shared tail and never touch each other's slots, so a
+// stalled producer delays only the consumer reaching its slot, not other
+// producers. The consumer index is private to the single consumer thread.
+template <typename T>
+class MpscRing {
+ public:
+  explicit MpscRing(std::size_t capacity_power_of_two)
+      : capacity_(capacity_power_of_two), mask_(capacity_power_of_two - 1) {
+    if (capacity_power_of_two < 2 || (capacity_power_of_two & mask_) != 0) {
+      throw std::invalid_argument("MpscRing capacity must be power of two (>= 2)");
+    }
+    cells_ = std::make_unique<Cell[]>(capacity_);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  ~MpscRing() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (std::size_t pos = consumer_.head;; ++pos) {
+        Cell& cell = cells_[pos & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+          break;
+        }
+        std::destroy_at(std::launder(reinterpret_cast<T*>(cell.bytes)));
+      }
+    }
+  }
+
+  // Producer side; safe from any number of threads.
+  template <typename... Args>
+  bool emplace(Args&&... args) {
+    std::size_t pos = producer_.tail.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (producer_.tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // full: the consumer has not released this slot yet
+      } else {
+        pos = producer_.tail.load(std::memory_order_relaxed);
+      }
+    }
+    ::new (static_cast<void*>(cell->bytes)) T(std::forward<Args>(args)...);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool push(const T& value) { return emplace(value); }
+  bool push(T&& value) { return emplace(std::move(value)); }
+
+  // Consumer side.
+  bool pop(T& out) {
+    Cell& cell = cells_[consumer_.head & mask_];
+    if (cell.sequence.load(std::memory_order_acquire) != consumer_.head + 1) {
+      return false;  // empty, or the claiming producer has not published yet
+    }
+    take(cell, out);
+    return true;
+  }
+
+  // Moves up to out.size() published elements into `out`, stopping at the
+  // first slot that is not yet published so ordering per producer is kept.
+  std::size_t pop_batch(std::span<T> out) {
+    std::size_t count = 0;
+    while (count < out.size()) {
+      Cell& cell = cells_[consumer_.head & mask_];
+      if (cell.sequence.load(std::memory_order_acquire) != consumer_.head + 1) {
+        break;
+      }
+      take(cell, out[count]);
+      ++count;
+    }
+    return count;
+  }
+
+  // Approximate; producers may be mid-publish.
+  bool empty() const {
+    return cells_[consumer_.head & mask_].sequence.load(std::memory_order_acquire) != consumer_.head + 1;
+  }
+
+  std::size_t capacity() const noexcept { return capacity_; }
+
+ private:
+  // One line per cell so producers publishing neighbouring positions do not
+  // contend on the same line.
+  struct alignas(kCacheLineSize) Cell {
+    std::atomic<std::size_t> sequence{0};
+    alignas(T) std::byte bytes[sizeof(T)];
+  };
+
+  struct alignas(kCacheLineSize) ProducerIndex {
+    std::atomic<std::size_t> tail{0};
+  };
+
+  struct alignas(kCacheLineSize) ConsumerIndex {
+    std::size_t head{0};
+  };
+
+  void take(Cell& cell, T& out) {
+    T* value = std::launder(reinterpret_cast<T*>(cell.bytes));
+    out = std::move(*value);
+    std::destroy_at(value);
+    // Hand the slot to the producer that will claim position head + capacity.
+    cell.sequence.store(consumer_.head + capacity_, std::memory_order_release);
+    ++consumer_.head;
+  }
+
+  alignas(kCacheLineSize) const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  ProducerIndex producer_;
+  ConsumerIndex consumer_;
+};
+
+}  // namespace common
+}  // namespace tradecore
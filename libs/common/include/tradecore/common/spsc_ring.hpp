@@ -1,58 +1,196 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
-#include <optional>
+#include <memory>
+#include <new>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
-#include <vector>
+
+#include "tradecore/common/cpu.hpp"
 
 namespace tradecore {
 namespace common {
 
+// Bounded single-producer/single-consumer ring holding up to `capacity`
+// elements. Head and tail are free-running counters on separate cache lines;
+// each side keeps a private copy of the other side's index and only reloads
+// the shared atomic when the copy says the ring is full (producer) or empty
+// (consumer), so steady-state traffic touches one shared line per batch
+// rather than two per element. Elements are constructed in place in raw
+// storage and destroyed when popped.
 template <typename T>
 class SpscRing {
  public:
   explicit SpscRing(std::size_t capacity_power_of_two)
-      : buffer_(capacity_power_of_two), mask_(capacity_power_of_two - 1) {
+      : capacity_(capacity_power_of_two), mask_(capacity_power_of_two - 1) {
     if (capacity_power_of_two == 0 || (capacity_power_of_two & mask_) != 0) {
       throw std::invalid_argument("SpscRing capacity must be power of two");
     }
+    slots_ = std::make_unique<Slot[]>(capacity_);
+  }
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  ~SpscRing() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      const std::size_t head = producer_.head.load(std::memory_order_relaxed);
+      for (std::size_t i = consumer_.tail.load(std::memory_order_relaxed); i != head; ++i) {
+        std::destroy_at(at(i));
+      }
+    }
   }
 
-  bool push(T value) {
-    const std::size_t head = head_.load(std::memory_order_relaxed);
-    const std::size_t next_head = (head + 1) & mask_;
-    const std::size_t tail = tail_.load(std::memory_order_acquire);
-    if (next_head == tail) {
-      return false;  // full
+  // Producer side.
+  template <typename... Args>
+  bool emplace(Args&&... args) {
+    const std::size_t head = producer_.head.load(std::memory_order_relaxed);
+    if (head - producer_.cached_tail == capacity_) {
+      producer_.cached_tail = consumer_.tail.load(std::memory_order_acquire);
+      if (head - producer_.cached_tail == capacity_) {
+        return false;  // full
+      }
     }
-    buffer_[head] = std::move(value);
-    head_.store(next_head, std::memory_order_release);
+    ::new (slot_storage(head)) T(std::forward<Args>(args)...);
+    producer_.head.store(head + 1, std::memory_order_release);
     return true;
   }
 
+  bool push(const T& value) { return emplace(value); }
+  bool push(T&& value) { return emplace(std::move(value)); }
+
+  // Copies the longest prefix of `values` that fits and publishes it with a
+  // single release store. Returns the number of elements pushed.
+  std::size_t push_batch(std::span<const T> values) {
+    const std::size_t head = producer_.head.load(std::memory_order_relaxed);
+    std::size_t free = capacity_ - (head - producer_.cached_tail);
+    if (free < values.size()) {
+      producer_.cached_tail = consumer_.tail.load(std::memory_order_acquire);
+      free = capacity_ - (head - producer_.cached_tail);
+    }
+    const std::size_t count = std::min(free, values.size());
+    for (std::size_t i = 0; i < count; ++i) {
+      ::new (slot_storage(head + i)) T(values[i]);
+    }
+    if (count != 0) {
+      producer_.head.store(head + count, std::memory_order_release);
+    }
+    return count;
+  }
+
+  // Consumer side.
   bool pop(T& out) {
-    const std::size_t tail = tail_.load(std::memory_order_relaxed);
-    const std::size_t head = head_.load(std::memory_order_acquire);
-    if (tail == head) {
+    const std::size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+    if (!readable(tail)) {
       return false;  // empty
     }
-    out = std::move(*buffer_[tail]);
-    buffer_[tail].reset();
-    tail_.store((tail + 1) & mask_, std::memory_order_release);
+    T* slot = at(tail);
+    out = std::move(*slot);
+    std::destroy_at(slot);
+    consumer_.tail.store(tail + 1, std::memory_order_release);
     return true;
   }
 
+  // Moves up to out.size() elements into `out` and releases them with a
+  // single release store. Returns the number of elements popped.
+  std::size_t pop_batch(std::span<T> out) {
+    const std::size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+    std::size_t available = consumer_.cached_head - tail;
+    if (available < out.size()) {
+      consumer_.cached_head = producer_.head.load(std::memory_order_acquire);
+      available = consumer_.cached_head - tail;
+    }
+    const std::size_t count = std::min(available, out.size());
+    for (std::size_t i = 0; i < count; ++i) {
+      T* slot = at(tail + i);
+      out[i] = std::move(*slot);
+      std::destroy_at(slot);
+    }
+    if (count != 0) {
+      consumer_.tail.store(tail + count, std::memory_order_release);
+    }
+    return count;
+  }
+
+  // The readable elements up to the end of the storage, without removing
+  // them; pair with consume(n) to drain in place. Empty when the ring is.
+  std::span<T> peek() {
+    const std::size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+    if (!readable(tail)) {
+      return {};
+    }
+    const std::size_t contiguous = std::min(consumer_.cached_head - tail, capacity_ - (tail & mask_));
+    return {at(tail), contiguous};
+  }
+
+  // Releases the first `count` elements of the last peek().
+  void consume(std::size_t count) {
+    const std::size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (std::size_t i = 0; i < count; ++i) {
+        std::destroy_at(at(tail + i));
+      }
+    }
+    consumer_.tail.store(tail + count, std::memory_order_release);
+  }
+
+  // The next element pop() would return, or nullptr when empty.
+  const T* front() const {
+    const std::size_t tail = consumer_.tail.load(std::memory_order_relaxed);
+    if (!readable(tail)) {
+      return nullptr;
+    }
+    return at(tail);
+  }
+
   bool empty() const {
-    return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    return consumer_.tail.load(std::memory_order_acquire) == producer_.head.load(std::memory_order_acquire);
+  }
+
+  // Approximate when called concurrently with the other side.
+  std::size_t size() const {
+    return producer_.head.load(std::memory_order_acquire) - consumer_.tail.load(std::memory_order_acquire);
   }
 
+  std::size_t capacity() const noexcept { return capacity_; }
+
  private:
-  std::vector<std::optional<T>> buffer_;
+  struct Slot {
+    alignas(T) std::byte bytes[sizeof(T)];
+  };
+
+  // Written by the producer; `cached_tail` is its private view of the tail.
+  struct alignas(kCacheLineSize) ProducerIndex {
+    std::atomic<std::size_t> head{0};
+    std::size_t cached_tail{0};
+  };
+
+  // Written by the consumer; `cached_head` is its private view of the head.
+  // Mutable so front() stays const while refreshing the cached head.
+  struct alignas(kCacheLineSize) ConsumerIndex {
+    std::atomic<std::size_t> tail{0};
+    mutable std::size_t cached_head{0};
+  };
+
+  void* slot_storage(std::size_t index) const noexcept { return slots_[index & mask_].bytes; }
+  T* at(std::size_t index) const noexcept { return std::launder(static_cast<T*>(slot_storage(index))); }
+
+  bool readable(std::size_t tail) const {
+    if (consumer_.cached_head == tail) {
+      consumer_.cached_head = producer_.head.load(std::memory_order_acquire);
+    }
+    return consumer_.cached_head != tail;
+  }
+
+  alignas(kCacheLineSize) const std::size_t capacity_;
   const std::size_t mask_;
-  std::atomic<std::size_t> head_{0};
-  std::atomic<std::size_t> tail_{0};
+  std::unique_ptr<Slot[]> slots_;
+  ProducerIndex producer_;
+  ConsumerIndex consumer_;
 };
 
 }  // namespace common
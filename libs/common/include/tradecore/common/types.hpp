@@ -48,6 +48,14 @@ struct OrderId {
            (static_cast<std::uint64_t>(session) << 32) |
            static_cast<std::uint64_t>(local);
   }
+
+  [[nodiscard]] static OrderId from_value(std::uint64_t encoded) noexcept {
+    return OrderId{
+        .market = static_cast<MarketId>(encoded >> 48),
+        .session = static_cast<SessionId>((encoded >> 32) & 0xffff),
+        .local = static_cast<SequenceId>(encoded & 0xffffffff),
+    };
+  }
 };
 
 struct EngineId {
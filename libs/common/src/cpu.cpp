@@ -0,0 +1,35 @@
+#include "tradecore/common/cpu.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace tradecore {
+namespace common {
+
+bool cpu_available(int cpu) {
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return false;
+  }
+  return CPU_ISSET(cpu, &allowed);
+}
+
+bool pin_current_thread(int cpu) {
+  if (cpu < 0) {
+    return true;
+  }
+  if (cpu >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  CPU_SET(cpu, &mask);
+  return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+}
+
+}  // namespace common
+}  // namespace tradecore
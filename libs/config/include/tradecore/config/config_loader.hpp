@@ -11,7 +11,28 @@ namespace tradecore {
 namespace config {
 
 struct TransportConfig {
-  std::string endpoint{"quic://127.0.0.1:9000"};
+  std::string endpoint{"quic://127.0.0.1:9000"};  // or shm://<name>, tcp://host:port
+  std::size_t receive_batch_size{32};  // datagrams per recvmmsg, 1 disables batching
+  std::size_t receive_threads{1};      // SO_REUSEPORT receive lanes
+  bool io_uring{true};                 // falls back to recvmmsg when unsupported
+  bool busy_poll{false};               // spin receive threads on non-blocking sockets
+  std::uint32_t busy_poll_us{50};      // SO_BUSY_POLL budget in spin mode
+  std::vector<int> receive_cpus;       // CPU per receive thread, -1 leaves it unpinned
+  bool kernel_timestamps{true};        // SO_TIMESTAMPNS receive stamps for stage latency
+  std::size_t shm_clients{16};          // client rings for a shm:// endpoint
+  std::size_t shm_ring_bytes{1 << 20};  // bytes per client ring
+  std::size_t tcp_max_connections{256};       // connections a tcp:// endpoint accepts
+  std::size_t tcp_read_buffer_bytes{1 << 16};  // read buffer per tcp connection
+};
+
+// Extra per-account rate tier; tier N is the Nth [[ingress.rate_tiers]] entry
+// (tier 0 is the [ingress] max_*_per_second limits).
+struct RateTierConfig {
+  std::uint32_t new_orders_per_second{10'000};
+  std::uint32_t cancels_per_second{20'000};
+  std::uint32_t replaces_per_second{20'000};
+  std::uint32_t burst_ms{1'000};
+  std::vector<std::uint64_t> accounts;
 };
 
 struct IngressConfig {
@@ -20,6 +41,33 @@ struct IngressConfig {
   std::size_t replace_queue_depth{1 << 12};
   std::uint32_t max_new_orders_per_second{10'000};
   std::uint32_t max_cancels_per_second{20'000};
+  std::uint32_t max_replaces_per_second{20'000};
+  std::uint32_t rate_burst_ms{1'000};              // token-bucket burst, ms of the rate
+  std::size_t rate_table_capacity{1 << 16};        // tracked accounts per receive lane
+  std::uint32_t rate_idle_timeout_ms{60'000};      // idle accounts are evicted after this
+  std::vector<RateTierConfig> rate_tiers;
+  bool replay_protection{true};                    // reject reused per-account nonces
+  std::size_t replay_window_capacity{1 << 15};     // hot replay windows per receive lane
+  std::size_t replay_cold_capacity{1 << 17};       // evicted accounts' top nonces per receive lane
+  std::size_t verify_workers{2};                   // signature threads; 0 verifies on receive threads
+  std::size_t verify_batch{64};                    // frames a lane queues between flushes
+  std::size_t signature_batch{16};                 // frames per batch verification call
+  // Orders with wire priority >= priority_threshold use the priority tier.
+  std::uint32_t priority_threshold{1};
+  std::size_t priority_queue_depth{1 << 10};
+  // "weighted" or "strict"; classes are cancels, priority tier, standard tier.
+  std::string scheduling{"weighted"};
+  std::uint32_t cancel_weight{8};
+  std::uint32_t priority_weight{4};
+  std::uint32_t standard_weight{1};
+  // Standard-tier orders are shed while a lane's fullest queue is at least
+  // this full (percent, 0 disables); refused frames get a RejectAck back.
+  std::uint32_t shed_watermark_pct{75};
+  bool reject_feedback{true};
+};
+
+struct AuthConfig {
+  std::filesystem::path key_store{"/var/lib/tradecore/accounts.keys"};  // mapped at startup; "<path>.log" holds updates
 };
 
 struct MarketRiskConfig {
@@ -49,6 +97,8 @@ struct PersistenceConfig {
   std::filesystem::path wal_path{"/var/lib/tradecore/events.wal"};
   std::filesystem::path snapshot_dir{"/var/lib/tradecore/snapshots"};
   std::size_t wal_flush_threshold{128};
+  std::filesystem::path checkpoint_dir{"/var/lib/tradecore/checkpoints"};
+  std::uint64_t checkpoint_interval{100'000};  // WAL records between book checkpoints, 0 disables
 };
 
 struct TelemetryConfig {
@@ -56,9 +106,16 @@ struct TelemetryConfig {
   std::size_t buffer_size{1024};
 };
 
+struct EventLoopConfig {
+  bool spin{false};  // busy-wait instead of sleeping when idle
+  int cpu{-1};       // CPU for the event loop thread, -1 leaves it unpinned
+};
+
 struct EngineConfig {
   TransportConfig transport;
+  EventLoopConfig event_loop;
   IngressConfig ingress;
+  AuthConfig auth;
   MatcherConfig matcher;
   PersistenceConfig persistence;
   TelemetryConfig telemetry;
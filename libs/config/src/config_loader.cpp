@@ -5,6 +5,7 @@
 
 #include <fstream>
 #include <sstream>
+#include <utility>
 
 namespace tradecore {
 namespace config {
@@ -37,6 +38,32 @@ TransportConfig parse_transport(const toml::table& root) {
   TransportConfig cfg;
   if (auto* transport = root["transport"].as_table()) {
     cfg.endpoint = get_str_or(*transport, "endpoint", cfg.endpoint);
+    cfg.receive_batch_size = static_cast<std::size_t>(get_int_or(*transport, "receive_batch_size", cfg.receive_batch_size));
+    cfg.receive_threads = static_cast<std::size_t>(get_int_or(*transport, "receive_threads", cfg.receive_threads));
+    cfg.io_uring = get_or(*transport, "io_uring", cfg.io_uring);
+    cfg.busy_poll = get_or(*transport, "busy_poll", cfg.busy_poll);
+    cfg.busy_poll_us = static_cast<std::uint32_t>(get_int_or(*transport, "busy_poll_us", cfg.busy_poll_us));
+    if (auto* cpus = (*transport)["receive_cpus"].as_array()) {
+      for (const auto& elem : *cpus) {
+        cfg.receive_cpus.push_back(static_cast<int>(elem.value_or<std::int64_t>(-1)));
+      }
+    }
+    cfg.kernel_timestamps = get_or(*transport, "kernel_timestamps", cfg.kernel_timestamps);
+    cfg.shm_clients = static_cast<std::size_t>(get_int_or(*transport, "shm_clients", cfg.shm_clients));
+    cfg.shm_ring_bytes = static_cast<std::size_t>(get_int_or(*transport, "shm_ring_bytes", cfg.shm_ring_bytes));
+    cfg.tcp_max_connections =
+        static_cast<std::size_t>(get_int_or(*transport, "tcp_max_connections", cfg.tcp_max_connections));
+    cfg.tcp_read_buffer_bytes =
+        static_cast<std::size_t>(get_int_or(*transport, "tcp_read_buffer_bytes", cfg.tcp_read_buffer_bytes));
+  }
+  return cfg;
+}
+
+EventLoopConfig parse_event_loop(const toml::table& root) {
+  EventLoopConfig cfg;
+  if (auto* event_loop = root["event_loop"].as_table()) {
+    cfg.spin = get_or(*event_loop, "spin", cfg.spin);
+    cfg.cpu = static_cast<int>(get_int_or(*event_loop, "cpu", cfg.cpu));
   }
   return cfg;
 }
@@ -49,6 +76,50 @@ IngressConfig parse_ingress(const toml::table& root) {
     cfg.replace_queue_depth = static_cast<std::size_t>(get_int_or(*ingress, "replace_queue_depth", cfg.replace_queue_depth));
     cfg.max_new_orders_per_second = static_cast<std::uint32_t>(get_int_or(*ingress, "max_new_orders_per_second", cfg.max_new_orders_per_second));
     cfg.max_cancels_per_second = static_cast<std::uint32_t>(get_int_or(*ingress, "max_cancels_per_second", cfg.max_cancels_per_second));
+    cfg.max_replaces_per_second = static_cast<std::uint32_t>(get_int_or(*ingress, "max_replaces_per_second", cfg.max_replaces_per_second));
+    cfg.rate_burst_ms = static_cast<std::uint32_t>(get_int_or(*ingress, "rate_burst_ms", cfg.rate_burst_ms));
+    cfg.rate_table_capacity = static_cast<std::size_t>(get_int_or(*ingress, "rate_table_capacity", cfg.rate_table_capacity));
+    cfg.rate_idle_timeout_ms = static_cast<std::uint32_t>(get_int_or(*ingress, "rate_idle_timeout_ms", cfg.rate_idle_timeout_ms));
+    if (auto* tiers = (*ingress)["rate_tiers"].as_array()) {
+      for (const auto& elem : *tiers) {
+        if (auto* tier_tbl = elem.as_table()) {
+          RateTierConfig tier;
+          tier.new_orders_per_second = static_cast<std::uint32_t>(get_int_or(*tier_tbl, "new_orders_per_second", tier.new_orders_per_second));
+          tier.cancels_per_second = static_cast<std::uint32_t>(get_int_or(*tier_tbl, "cancels_per_second", tier.cancels_per_second));
+          tier.replaces_per_second = static_cast<std::uint32_t>(get_int_or(*tier_tbl, "replaces_per_second", tier.replaces_per_second));
+          tier.burst_ms = static_cast<std::uint32_t>(get_int_or(*tier_tbl, "burst_ms", tier.burst_ms));
+          if (auto* accounts = (*tier_tbl)["accounts"].as_array()) {
+            for (const auto& account : *accounts) {
+              tier.accounts.push_back(static_cast<std::uint64_t>(account.value_or<std::int64_t>(0)));
+            }
+          }
+          cfg.rate_tiers.push_back(std::move(tier));
+        }
+      }
+    }
+    cfg.replay_protection = get_or(*ingress, "replay_protection", cfg.replay_protection);
+    cfg.replay_window_capacity = static_cast<std::size_t>(get_int_or(*ingress, "replay_window_capacity", cfg.replay_window_capacity));
+    cfg.replay_cold_capacity = static_cast<std::size_t>(get_int_or(*ingress, "replay_cold_capacity", cfg.replay_cold_capacity));
+    cfg.verify_workers = static_cast<std::size_t>(get_int_or(*ingress, "verify_workers", cfg.verify_workers));
+    cfg.verify_batch = static_cast<std::size_t>(get_int_or(*ingress, "verify_batch", cfg.verify_batch));
+    cfg.signature_batch = static_cast<std::size_t>(get_int_or(*ingress, "signature_batch", cfg.signature_batch));
+    cfg.priority_threshold = static_cast<std::uint32_t>(get_int_or(*ingress, "priority_threshold", cfg.priority_threshold));
+    cfg.priority_queue_depth = static_cast<std::size_t>(get_int_or(*ingress, "priority_queue_depth", cfg.priority_queue_depth));
+    cfg.scheduling = get_str_or(*ingress, "scheduling", cfg.scheduling);
+    cfg.cancel_weight = static_cast<std::uint32_t>(get_int_or(*ingress, "cancel_weight", cfg.cancel_weight));
+    cfg.priority_weight = static_cast<std::uint32_t>(get_int_or(*ingress, "priority_weight", cfg.priority_weight));
+    cfg.standard_weight = static_cast<std::uint32_t>(get_int_or(*ingress, "standard_weight", cfg.standard_weight));
+    cfg.shed_watermark_pct =
+        static_cast<std::uint32_t>(get_int_or(*ingress, "shed_watermark_pct", cfg.shed_watermark_pct));
+    cfg.reject_feedback = get_or(*ingress, "reject_feedback", cfg.reject_feedback);
+  }
+  return cfg;
+}
+
+AuthConfig parse_auth(const toml::table& root) {
+  AuthConfig cfg;
+  if (auto* auth = root["auth"].as_table()) {
+    cfg.key_store = get_str_or(*auth, "key_store", cfg.key_store.string());
   }
   return cfg;
 }
@@ -67,6 +138,8 @@ PersistenceConfig parse_persistence(const toml::table& root) {
     cfg.wal_path = get_str_or(*persistence, "wal_path", cfg.wal_path.string());
     cfg.snapshot_dir = get_str_or(*persistence, "snapshot_dir", cfg.snapshot_dir.string());
     cfg.wal_flush_threshold = static_cast<std::size_t>(get_int_or(*persistence, "wal_flush_threshold", cfg.wal_flush_threshold));
+    cfg.checkpoint_dir = get_str_or(*persistence, "checkpoint_dir", cfg.checkpoint_dir.string());
+    cfg.checkpoint_interval = static_cast<std::uint64_t>(get_int_or(*persistence, "checkpoint_interval", static_cast<std::int64_t>(cfg.checkpoint_interval)));
   }
   return cfg;
 }
@@ -118,7 +191,9 @@ std::vector<MarketConfig> parse_markets(const toml::table& root) {
 EngineConfig parse_config(const toml::table& root) {
   EngineConfig cfg;
   cfg.transport = parse_transport(root);
+  cfg.event_loop = parse_event_loop(root);
   cfg.ingress = parse_ingress(root);
+  cfg.auth = parse_auth(root);
   cfg.matcher = parse_matcher(root);
   cfg.persistence = parse_persistence(root);
   cfg.telemetry = parse_telemetry(root);
@@ -174,10 +249,117 @@ std::vector<ValidationError> ConfigLoader::validate(const EngineConfig& config)
     errors.push_back({"transport.endpoint", "endpoint cannot be empty"});
   }
 
+  if (config.transport.receive_batch_size == 0 || config.transport.receive_batch_size > 1024) {
+    errors.push_back({"transport.receive_batch_size", "must be between 1 and 1024"});
+  }
+
+  if (config.transport.receive_threads == 0 || config.transport.receive_threads > 64) {
+    errors.push_back({"transport.receive_threads", "must be between 1 and 64"});
+  }
+
+  if (config.transport.shm_clients == 0 || config.transport.shm_clients > 1024) {
+    errors.push_back({"transport.shm_clients", "must be between 1 and 1024"});
+  }
+
+  if (config.transport.tcp_max_connections == 0 || config.transport.tcp_max_connections > 65536) {
+    errors.push_back({"transport.tcp_max_connections", "must be between 1 and 65536"});
+  }
+
+  if (config.transport.receive_cpus.size() > config.transport.receive_threads) {
+    errors.push_back({"transport.receive_cpus", "more entries than receive_threads"});
+  }
+
+  for (const int cpu : config.transport.receive_cpus) {
+    if (cpu < -1) {
+      errors.push_back({"transport.receive_cpus", "cpu must be >= -1"});
+      break;
+    }
+  }
+
+  if (config.event_loop.cpu < -1) {
+    errors.push_back({"event_loop.cpu", "cpu must be >= -1"});
+  }
+
   if (config.ingress.max_new_orders_per_second == 0) {
     errors.push_back({"ingress.max_new_orders_per_second", "must be greater than 0"});
   }
 
+  if (config.ingress.max_cancels_per_second == 0) {
+    errors.push_back({"ingress.max_cancels_per_second", "must be greater than 0"});
+  }
+
+  if (config.ingress.max_replaces_per_second == 0) {
+    errors.push_back({"ingress.max_replaces_per_second", "must be greater than 0"});
+  }
+
+  if (config.ingress.rate_table_capacity == 0) {
+    errors.push_back({"ingress.rate_table_capacity", "must be greater than 0"});
+  }
+
+  if (config.ingress.replay_window_capacity == 0) {
+    errors.push_back({"ingress.replay_window_capacity", "must be greater than 0"});
+  }
+
+  if (config.ingress.replay_cold_capacity == 0) {
+    errors.push_back({"ingress.replay_cold_capacity", "must be greater than 0"});
+  }
+
+  if (config.ingress.verify_workers > 64) {
+    errors.push_back({"ingress.verify_workers", "must be at most 64"});
+  }
+
+  if (config.ingress.verify_batch == 0 || config.ingress.verify_batch > 4096 ||
+      (config.ingress.verify_batch & (config.ingress.verify_batch - 1)) != 0) {
+    errors.push_back({"ingress.verify_batch", "must be a power of two up to 4096"});
+  }
+
+  if (config.ingress.signature_batch == 0 || config.ingress.signature_batch > 256) {
+    errors.push_back({"ingress.signature_batch", "must be between 1 and 256"});
+  }
+
+  if (config.ingress.shed_watermark_pct > 100) {
+    errors.push_back({"ingress.shed_watermark_pct", "must be between 0 and 100"});
+  }
+
+  if (config.auth.key_store.empty()) {
+    errors.push_back({"auth.key_store", "key_store cannot be empty"});
+  }
+
+  if (config.ingress.rate_tiers.size() > 255) {
+    errors.push_back({"ingress.rate_tiers", "at most 255 tiers"});
+  }
+
+  for (std::size_t i = 0; i < config.ingress.rate_tiers.size(); ++i) {
+    const auto& tier = config.ingress.rate_tiers[i];
+    if (tier.new_orders_per_second == 0 || tier.cancels_per_second == 0 || tier.replaces_per_second == 0) {
+      errors.push_back({"ingress.rate_tiers[" + std::to_string(i) + "]", "rates must be greater than 0"});
+    }
+  }
+
+  if (config.ingress.priority_threshold == 0 || config.ingress.priority_threshold > 255) {
+    errors.push_back({"ingress.priority_threshold", "must be between 1 and 255"});
+  }
+
+  if (config.ingress.priority_queue_depth == 0 ||
+      (config.ingress.priority_queue_depth & (config.ingress.priority_queue_depth - 1)) != 0) {
+    errors.push_back({"ingress.priority_queue_depth", "must be a power of two"});
+  }
+
+  if (config.ingress.scheduling != "weighted" && config.ingress.scheduling != "strict") {
+    errors.push_back({"ingress.scheduling", "must be \"weighted\" or \"strict\""});
+  }
+
+  const std::pair<const char*, std::uint32_t> weights[] = {
+      {"ingress.cancel_weight", config.ingress.cancel_weight},
+      {"ingress.priority_weight", config.ingress.priority_weight},
+      {"ingress.standard_weight", config.ingress.standard_weight},
+  };
+  for (const auto& [field, weight] : weights) {
+    if (weight == 0) {
+      errors.push_back({field, "must be greater than 0"});
+    }
+  }
+
   if (config.matcher.arena_bytes < (1 << 16)) {
     errors.push_back({"matcher.arena_bytes", "must be at least 64KB"});
   }
@@ -190,6 +372,10 @@ std::vector<ValidationError> ConfigLoader::validate(const EngineConfig& config)
     errors.push_back({"persistence.snapshot_dir", "snapshot_dir cannot be empty"});
   }
 
+  if (config.persistence.checkpoint_interval > 0 && config.persistence.checkpoint_dir.empty()) {
+    errors.push_back({"persistence.checkpoint_dir", "checkpoint_dir cannot be empty when checkpoints are enabled"});
+  }
+
   for (std::size_t i = 0; i < config.markets.size(); ++i) {
     const auto& market = config.markets[i];
     std::string prefix = "markets[" + std::to_string(i) + "]";
@@ -228,6 +414,21 @@ std::string ConfigLoader::generate_default() {
 
 [transport]
 endpoint = "quic://127.0.0.1:9000"
+receive_batch_size = 32
+receive_threads = 1
+io_uring = true
+busy_poll = false
+busy_poll_us = 50
+receive_cpus = []
+kernel_timestamps = true
+shm_clients = 16
+shm_ring_bytes = 1048576
+tcp_max_connections = 256
+tcp_read_buffer_bytes = 65536
+
+[event_loop]
+spin = false
+cpu = -1
 
 [ingress]
 new_order_queue_depth = 4096
@@ -235,6 +436,27 @@ cancel_queue_depth = 4096
 replace_queue_depth = 4096
 max_new_orders_per_second = 100000
 max_cancels_per_second = 200000
+max_replaces_per_second = 200000
+rate_burst_ms = 1000
+rate_table_capacity = 65536
+rate_idle_timeout_ms = 60000
+replay_protection = true
+replay_window_capacity = 32768
+replay_cold_capacity = 131072
+verify_workers = 2
+verify_batch = 64
+signature_batch = 16
+priority_threshold = 1
+priority_queue_depth = 1024
+scheduling = "weighted"
+cancel_weight = 8
+priority_weight = 4
+standard_weight = 1
+shed_watermark_pct = 75
+reject_feedback = true
+
+[auth]
+key_store = "/var/lib/tradecore/accounts.keys"
 
 [matcher]
 arena_bytes = 1048576  # 1MB
@@ -243,6 +465,8 @@ arena_bytes = 1048576  # 1MB
 wal_path = "/var/lib/tradecore/events.wal"
 snapshot_dir = "/var/lib/tradecore/snapshots"
 wal_flush_threshold = 128
+checkpoint_dir = "/var/lib/tradecore/checkpoints"
+checkpoint_interval = 100000
 
 [telemetry]
 enabled = true
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "tradecore/ingest/frame.hpp"
+#include "tradecore/ingest/sbe/feedback.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Ack tradecored sends back, through Transport::reply, for a frame the
+// ingress pipeline turned away. The layout is feedback::RejectAck, generated
+// from libs/ingest/schema/feedback.toml.
+inline constexpr std::uint32_t kRejectAckMagic = 0x54524441;  // "TRDA"
+inline constexpr std::size_t kRejectAckSize = feedback::RejectAckDecoder::kBlockLength;
+
+// Writes the ack for the frame under `header` (for a batch, kind kBatch and
+// the first nonce) covering `count` messages into `out`; returns the bytes
+// written, or 0 when `out` is too short.
+inline std::size_t encode_reject_ack(const FrameHeader& header, std::size_t count, RejectReason reason,
+                                     std::uint8_t queue_fill_pct, std::span<std::byte> out) noexcept {
+  auto ack = feedback::RejectAckEncoder::wrap(out);
+  if (!ack) {
+    return 0;
+  }
+  ack->magic(kRejectAckMagic)
+      .account(header.account)
+      .nonce(header.nonce)
+      .count(static_cast<std::uint8_t>(count))
+      .kind(header.kind)
+      .reason(reason)
+      .queue_fill_pct(queue_fill_pct);
+  return kRejectAckSize;
+}
+
+// Whether a rejection gets an ack. Auth failures never do. A datagram's
+// source address can be forged, so over datagram transports only frames that
+// passed authentication before being refused are acked; otherwise anyone
+// could reflect acks at a spoofed address, and a shedding lane would spend a
+// send on every refused frame. Stream transports reply on the connection the
+// frame came in on, so every other refusal is acked there.
+[[nodiscard]] constexpr bool should_ack_reject(RejectReason reason, bool authenticated, bool stream) noexcept {
+  return reason != RejectReason::kAuth && (authenticated || stream);
+}
+
+// Decodes an ack; nullopt when `data` is short or is not an ack.
+[[nodiscard]] inline std::optional<feedback::RejectAck> decode_reject_ack(std::span<const std::byte> data) noexcept {
+  const auto ack = feedback::decode_reject_ack(data);
+  if (!ack || ack->magic != kRejectAckMagic) {
+    return std::nullopt;
+  }
+  return ack;
+}
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -2,7 +2,7 @@
 
 #include <cstdint>
 #include <span>
-#include <vector>
+#include <type_traits>
 
 #include "tradecore/common/types.hpp"
 
@@ -14,24 +14,102 @@ enum class MessageKind : std::uint8_t {
   kCancel,
   kReplace,
   kHeartbeat,
+  // Several of the kinds above under one header and one signature (see
+  // UdpTransport::unpack_batch). Only seen by transports and the admission
+  // path; the ingress rings carry the unpacked messages.
+  kBatch,
 };
 
+// Why the ingress pipeline turned a frame away, as reported to the sender in
+// a feedback::RejectAck.
+enum class RejectReason : std::uint8_t {
+  kAuth = 1,
+  kReplay,
+  kRateLimit,
+  kQueueFull,
+  // Standard-tier traffic refused early because the lane's queues passed
+  // the shed watermark; see IngressPipeline::Config::shed_watermark_pct.
+  kShed,
+};
+
+// FrameHeader::flags bits, carried from WireHeader::flags.
+// The payload starts with a 16-byte session MAC (auth::SessionTable) instead
+// of a 64-byte ed25519 signature.
+inline constexpr std::uint16_t kFrameFlagSessionMac = 0x0001;
+
 struct FrameHeader {
   common::AccountId account{0};
   std::uint64_t nonce{0};
   common::TimestampNs received_time_ns{0};
   std::uint8_t priority{0};
   MessageKind kind{MessageKind::kNewOrder};
+  std::uint16_t flags{0};
+  // Signatures cover the header's object bytes, so what would be tail
+  // padding is an explicit zero field: every copy then signs the same image.
+  std::uint32_t reserved{0};
+};
+
+static_assert(std::has_unique_object_representations_v<FrameHeader>, "FrameHeader must have no padding");
+
+inline constexpr std::uint32_t kNoSlabSlot = 0xffffffff;
+
+// When a frame passed each receive-side stage, as steady-clock nanoseconds
+// (the clock admission and the consumer use). Zero where the stage did not
+// run or gave no reading. Kept out of FrameHeader, which is signed; the
+// client's own clock stays in FrameHeader::received_time_ns.
+struct StageTimes {
+  // Kernel receive (SO_TIMESTAMPNS), rebased from CLOCK_REALTIME.
+  common::TimestampNs kernel_ns{0};
+  // Receive syscall returned to the transport thread, once per receive batch.
+  common::TimestampNs received_ns{0};
+  // Signature or session MAC check passed.
+  common::TimestampNs verified_ns{0};
 };
 
+class FrameSlab;
+
 struct Frame {
   FrameHeader header;
   std::span<const std::byte> payload;
+  // Slab slot backing `payload` when the transport received into a FrameSlab;
+  // whoever the frame is handed to takes ownership of the slot.
+  std::uint32_t slot{kNoSlabSlot};
+  // Receive lane (transport thread) the frame arrived on.
+  std::uint16_t lane{0};
+  // For a message unpacked from a batch frame: the batch payload from its
+  // auth prefix on, shared by the whole run. `slot` then backs every frame
+  // of the run. Empty for single-message frames.
+  std::span<const std::byte> batch{};
+  StageTimes times{};
+  // Transport handle for replies to the frame's sender (see
+  // Transport::reply); 0 when the transport has no way back.
+  std::uint64_t reply_to{0};
 };
 
+// Frame dequeued from the ingress pipeline. The payload aliases a FrameSlab
+// slot that is handed back to the slab when the frame is reset, reassigned
+// or destroyed.
 struct OwnedFrame {
-  FrameHeader header;
-  std::vector<std::byte> payload;
+  FrameHeader header{};
+  std::span<const std::byte> payload{};
+  // Monotonic admission time; the pipeline merges lanes in this order.
+  common::TimestampNs arrival_ns{0};
+  StageTimes times{};
+
+  OwnedFrame() = default;
+  OwnedFrame(const OwnedFrame&) = delete;
+  OwnedFrame& operator=(const OwnedFrame&) = delete;
+  OwnedFrame(OwnedFrame&& other) noexcept;
+  OwnedFrame& operator=(OwnedFrame&& other) noexcept;
+  ~OwnedFrame();
+
+  void reset() noexcept;
+  void assign(const FrameHeader& frame_header, FrameSlab& slab, std::uint32_t slot,
+              std::span<const std::byte> frame_payload) noexcept;
+
+ private:
+  FrameSlab* slab_{nullptr};
+  std::uint32_t slot_{kNoSlabSlot};
 };
 
 }  // namespace ingest
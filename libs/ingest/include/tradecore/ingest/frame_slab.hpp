@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
+
+#include "tradecore/common/spsc_ring.hpp"
+#include "tradecore/ingest/frame.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Preallocated pool of fixed-size frame buffers. Transports receive datagrams
+// straight into a slot and the ingress rings carry slot indices, so admitting
+// a frame performs no heap allocation.
+//
+// Slots are acquired by the receive thread and released by the consumer
+// thread through an SPSC free ring; slots the receive thread drops itself
+// (rejections) go through recycle() and never cross threads. A slot holding a
+// batch frame is shared by every message unpacked from it: share() sets how
+// many release() calls the slot waits for before it is free again.
+class FrameSlab {
+ public:
+  static constexpr std::size_t kSlotAlignment = 64;
+
+  FrameSlab(std::size_t slot_count, std::size_t slot_bytes);
+
+  FrameSlab(const FrameSlab&) = delete;
+  FrameSlab& operator=(const FrameSlab&) = delete;
+
+  // Producer side: returns kNoSlabSlot when every slot is in flight.
+  [[nodiscard]] std::uint32_t acquire() noexcept;
+  void recycle(std::uint32_t slot) noexcept;
+  // Before the slot's frames are published; `holders` must be at least one.
+  void share(std::uint32_t slot, std::uint32_t holders) noexcept { holders_[slot] = holders; }
+
+  // Consumer side.
+  void release(std::uint32_t slot) noexcept;
+
+  [[nodiscard]] std::span<std::byte> slot(std::uint32_t index) noexcept {
+    return {storage_.get() + static_cast<std::size_t>(index) * slot_bytes_, slot_bytes_};
+  }
+  [[nodiscard]] std::span<const std::byte> slot(std::uint32_t index) const noexcept {
+    return {storage_.get() + static_cast<std::size_t>(index) * slot_bytes_, slot_bytes_};
+  }
+  [[nodiscard]] std::size_t slot_bytes() const noexcept { return slot_bytes_; }
+  [[nodiscard]] std::size_t slot_count() const noexcept { return slot_count_; }
+
+ private:
+  struct AlignedDelete {
+    void operator()(std::byte* ptr) const noexcept { ::operator delete[](ptr, std::align_val_t{kSlotAlignment}); }
+  };
+
+  std::size_t slot_count_;
+  std::size_t slot_bytes_;
+  std::unique_ptr<std::byte[], AlignedDelete> storage_;
+  common::SpscRing<std::uint32_t> released_;
+  std::vector<std::uint32_t> recycled_;
+  // Outstanding release() calls per slot. Written by the producer before it
+  // publishes the slot and by the consumer after it pops it, so the ingress
+  // rings and the free ring order every access.
+  std::vector<std::uint32_t> holders_;
+};
+
+}  // namespace ingest
+}  // namespace tradecore
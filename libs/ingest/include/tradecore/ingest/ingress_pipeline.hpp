@@ -1,19 +1,79 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
-#include <memory_resource>
 #include <unordered_map>
+#include <vector>
 
 #include "tradecore/common/spsc_ring.hpp"
 #include "tradecore/ingest/frame.hpp"
+#include "tradecore/ingest/frame_slab.hpp"
+#include "tradecore/ingest/rate_limiter.hpp"
+#include "tradecore/ingest/replay_window.hpp"
+#include "tradecore/ingest/verify_stage.hpp"
 
 namespace tradecore {
 namespace ingest {
 
+// Admission and queueing between the transport and the sequencer.
+//
+// The pipeline is split into lanes, one per transport receive thread. Each
+// lane owns its frame slab, replay window, rate limiter and rings, so submit() for
+// different lanes can run concurrently with no shared state; submit() for one
+// lane must come from a single thread. The consumer-side next_*() calls merge
+// the lanes by admission time (ties go to the lower lane), which fixes the
+// global order the sequencer appends to the WAL.
+//
+// Frames are also split by priority class: cancels, priority-tier orders
+// (FrameHeader::priority at or above the threshold, e.g. market-maker quotes)
+// and standard-tier orders each queue separately, and next() serves the
+// classes in that order, strictly or by weight, so cancel latency stays flat
+// while standard new-order queues absorb a backlog.
+//
+// With verify_workers > 0, signature checks move off the receive threads:
+// submit() runs the cheap checks, parks the frame in its lane's VerifyStage
+// and returns, and flush() (called by the lane's thread at the end of each
+// receive batch) commits the verified frames to the rings in arrival order.
+//
+// Messages unpacked from one batch frame are admitted as a unit: one
+// signature check, then every message is queued or none is (replay window,
+// rate limits and ring room are all checked before the first push). They
+// share the batch's slab slot and admission time.
+//
+// Under overload the pipeline sheds the lowest class first: the lane's
+// queue occupancy is sampled every few submits and at every flush(), and
+// while its fullest queue is past the shed watermark, standard-tier new
+// orders and replaces are refused before their signature is checked, so
+// verification time and queue room go to cancels and the priority tier.
+// Every refusal is reported to the reject observer with its reason, so the
+// sender can be told instead of timing out and resending.
+//
+// Dequeued frames carry the stage times the transport stamped (kernel and
+// user-space receive) plus the end of their signature check, next to the
+// admission time in arrival_ns, so the consumer can break wire-to-match
+// latency down by stage.
 class IngressPipeline {
  public:
+  enum class PriorityClass : std::uint8_t {
+    kCancel,
+    kPriority,
+    kStandard,
+  };
+  static constexpr std::size_t kPriorityClassCount = 3;
+
+  enum class Scheduling : std::uint8_t {
+    // Always the highest non-empty class.
+    kStrict,
+    // Deficit round robin: each class may be served `class_weights[c]` times
+    // per round; a class with no credit left yields to lower classes, and
+    // credits refill once no credited class has work.
+    kWeighted,
+  };
+
   struct Config {
     std::size_t new_order_queue_depth{1 << 12};
     std::size_t cancel_queue_depth{1 << 12};
@@ -21,50 +81,215 @@ class IngressPipeline {
     std::uint32_t max_new_orders_per_second{10'000};
     std::uint32_t max_cancels_per_second{20'000};
     std::uint32_t max_replaces_per_second{20'000};
+    // Token-bucket burst for the limits above, in milliseconds of the rate.
+    std::uint32_t rate_burst_ms{1'000};
+    // Additional rate tiers numbered from 1 (tier 0 is the limits above) and
+    // the accounts assigned to them.
+    std::vector<RateTier> rate_tiers;
+    std::unordered_map<common::AccountId, std::uint8_t> account_rate_tiers;
+    // Per-lane account table; accounts idle this long are evicted.
+    std::size_t rate_table_capacity{1 << 16};
+    common::TimestampNs rate_idle_timeout_ns{60'000'000'000};
+    // Reject frames whose nonce an account has already used (see
+    // ReplayWindow); accounts with a hot window per lane.
+    bool replay_protection{true};
+    std::size_t replay_window_capacity{1 << 15};
+    // Evicted accounts whose top nonce each lane keeps; 0 derives four per
+    // window.
+    std::size_t replay_cold_capacity{0};
+    // Frame slab sizing; zero derives the slot count from the queue depths
+    // and the slot size from the largest wire frame (a full batch datagram)
+    // plus the receive headroom.
+    std::size_t frame_slab_slots{0};
+    std::size_t frame_slot_bytes{0};
+    // Receive lanes; queue depths and slab sizing apply per lane.
+    std::size_t lanes{1};
+    // New orders and replaces with header.priority >= priority_threshold go
+    // to the priority tier, whose queues hold priority_queue_depth frames
+    // each; everything below stays in the standard queues above.
+    std::uint8_t priority_threshold{1};
+    std::size_t priority_queue_depth{1 << 10};
+    Scheduling scheduling{Scheduling::kWeighted};
+    // Indexed by PriorityClass; weights of zero are treated as one.
+    std::array<std::uint32_t, kPriorityClassCount> class_weights{8, 4, 1};
+    // Signature verification threads shared by all lanes; zero verifies
+    // inline in submit(). verify_batch caps the frames a lane holds between
+    // flushes (rounded up to a power of two); signature_batch caps the frames
+    // a worker hands the batch verifier at once.
+    std::size_t verify_workers{0};
+    std::size_t verify_batch{64};
+    std::size_t signature_batch{16};
+    // Percent fill of a lane's fullest queue at which its standard-tier
+    // traffic is shed; 0 disables shedding.
+    std::uint32_t shed_watermark_pct{75};
   };
 
   struct Stats {
     std::uint64_t accepted{0};
     std::uint64_t rejected_auth{0};
+    std::uint64_t rejected_replay{0};
     std::uint64_t rejected_rate_limit{0};
     std::uint64_t rejected_queue_full{0};
+    std::uint64_t rejected_shed{0};
     std::uint64_t dropped_heartbeats{0};
+    // Batch frames whose body does not unpack; not an auth failure, so not
+    // acked or counted as one.
+    std::uint64_t dropped_malformed{0};
+    // Accounts currently tracked that have been throttled at least once.
+    std::uint64_t throttled_accounts{0};
+  };
+
+  // Indexed by PriorityClass, summed across lanes. Depths are approximate
+  // while the lanes run; high watermarks are the deepest sampled since
+  // reset_stats().
+  struct QueueStats {
+    std::array<std::size_t, kPriorityClassCount> depth{};
+    std::array<std::size_t, kPriorityClassCount> capacity{};
+    std::array<std::size_t, kPriorityClassCount> high_watermark{};
+  };
+
+  struct VerifyStats {
+    std::uint64_t verified{0};
+    std::uint64_t failed{0};
+    // Frames waiting for verification or for their lane's flush().
+    std::uint64_t queue_depth{0};
   };
 
   using AuthVerifier = std::function<bool(const FrameHeader&, std::span<const std::byte>)>;
+  // Writes the outcome for frames[i] to valid[i].
+  using BatchAuthVerifier = std::function<void(std::span<const Frame> frames, std::span<bool> valid)>;
+  // Called from flush() for every frame the stage verified, with the time
+  // from submit() to the end of its signature check and the lane backlog it
+  // joined.
+  using VerifyObserver = std::function<void(std::chrono::nanoseconds latency, std::size_t queue_depth)>;
+  // Called on the lane's thread for every frame turned away: a single frame,
+  // or a whole batch (header kind kBatch, first nonce) covering `messages`.
+  // `authenticated` is set when the frame's signature had been checked and
+  // passed before it was refused; see should_ack_reject().
+  using RejectObserver =
+      std::function<void(const Frame& frame, RejectReason reason, std::size_t messages, bool authenticated)>;
 
   IngressPipeline();
 
-  void configure(const Config& config, AuthVerifier verifier = AuthVerifier{});
+  // Reallocates the lanes; transports must be re-attached. Verifiers are
+  // shared by every lane and must be safe to call concurrently. Verify
+  // workers use `batch_verifier` when given and otherwise loop over
+  // `verifier`; either one alone is enough.
+  void configure(const Config& config, AuthVerifier verifier = AuthVerifier{},
+                 BatchAuthVerifier batch_verifier = BatchAuthVerifier{});
+  void set_verify_observer(VerifyObserver observer) { verify_observer_ = std::move(observer); }
+  void set_reject_observer(RejectObserver observer) { reject_observer_ = std::move(observer); }
+  // Admits on `frame.lane`. Takes ownership of `frame.slot` (a slot of that
+  // lane's slab) when set; otherwise copies the payload into a slab slot.
+  // With verify workers the frame is only queued for verification: true means
+  // it passed the pre-checks, and the outcome lands in stats() after flush().
   bool submit(const Frame& frame);
+  // Admits one datagram's frames (see Transport::FrameCallback): a single
+  // frame goes through submit(frame); a batch run is verified once and
+  // queued whole or rejected whole. Every frame of a run counts in stats().
+  bool submit(std::span<const Frame> frames);
+  // Commits every frame the lane has queued for verification, verifying
+  // unclaimed ones on the calling thread. Call from the lane's submit()
+  // thread; a no-op without verify workers.
+  void flush(std::size_t lane);
+
+  // Next frame of any kind per the configured scheduling; callers dispatch
+  // on header.kind.
+  bool next(OwnedFrame& out);
 
+  // Per-kind views that ignore the scheduler: both tiers merged by admission
+  // time.
   bool next_new_order(OwnedFrame& out);
   bool next_cancel(OwnedFrame& out);
   bool next_replace(OwnedFrame& out);
 
-  [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+  [[nodiscard]] PriorityClass classify(const FrameHeader& header) const noexcept;
+  // True while any of the lane's rings lacks room for a full batch (or half
+  // its depth, for shallow rings). Stream transports stop reading the lane
+  // until it clears; see Transport::set_pressure_callback. Call from the
+  // lane's submit() thread.
+  [[nodiscard]] bool congested(std::size_t lane) const noexcept;
+
+  // Summed across lanes.
+  [[nodiscard]] Stats stats() const noexcept;
+  [[nodiscard]] VerifyStats verify_stats() const noexcept;
+  [[nodiscard]] QueueStats queue_stats() const noexcept;
+  // Fill of the lane's fullest queue, in percent, when last sampled.
+  [[nodiscard]] std::uint8_t queue_fill_pct(std::size_t lane) const noexcept {
+    return lanes_[lane]->fill_pct.load(std::memory_order_relaxed);
+  }
   void reset_stats();
 
+  [[nodiscard]] std::size_t lane_count() const noexcept { return lanes_.size(); }
+  // Slab transports receive into for `lane`; see Transport::attach_slab.
+  [[nodiscard]] FrameSlab& frame_slab(std::size_t lane = 0) noexcept { return *lanes_[lane]->slab; }
+  [[nodiscard]] const RateLimiter& rate_limiter(std::size_t lane = 0) const noexcept { return lanes_[lane]->rate_limiter; }
+
  private:
-  struct AccountWindow {
-    common::TimestampNs window_start{0};
-    std::uint32_t new_orders{0};
-    std::uint32_t cancels{0};
-    std::uint32_t replaces{0};
+  // Ring element: the frame header plus the slab slot holding its payload.
+  struct SlotRef {
+    FrameHeader header{};
+    common::TimestampNs arrival_ns{0};
+    StageTimes times{};
+    std::uint32_t slot{kNoSlabSlot};
+    std::uint32_t payload_offset{0};
+    std::uint32_t payload_size{0};
   };
 
-  Config config_{};
-  AuthVerifier verifier_{};
-  Stats stats_{};
+  using Ring = common::SpscRing<SlotRef>;
 
-  std::pmr::monotonic_buffer_resource arena_;
-  std::pmr::unordered_map<common::AccountId, AccountWindow> rate_windows_;
+  // Everything one receive thread writes; aligned so lanes never share a line.
+  struct alignas(64) Lane {
+    explicit Lane(const Config& config);
 
-  std::unique_ptr<common::SpscRing<OwnedFrame>> new_orders_;
-  std::unique_ptr<common::SpscRing<OwnedFrame>> cancels_;
-  std::unique_ptr<common::SpscRing<OwnedFrame>> replaces_;
+    Stats stats{};
+    ReplayWindow replay_window;
+    RateLimiter rate_limiter;
+    std::unique_ptr<FrameSlab> slab;
+    Ring new_orders;
+    Ring cancels;
+    Ring replaces;
+    Ring priority_new_orders;
+    Ring priority_replaces;
+    // Batch runs unpacked again when they leave the verify stage.
+    std::vector<Frame> batch_frames;
+    // Occupancy as of the last sample; see sample_occupancy(). Written by the
+    // lane, read by queue_stats() and queue_fill_pct() from any thread.
+    std::array<std::atomic<std::size_t>, kPriorityClassCount> high_watermark{};
+    std::atomic<std::uint8_t> fill_pct{0};
+    bool shedding{false};
+    std::uint32_t submits_to_sample{0};
+  };
+
+  using RingMember = Ring Lane::*;
+
+  Config config_{};
+  AuthVerifier verifier_{};
+  VerifyObserver verify_observer_{};
+  RejectObserver reject_observer_{};
+  std::vector<std::unique_ptr<Lane>> lanes_;
+  // Declared after lanes_ so the workers stop before the slabs go away.
+  std::unique_ptr<VerifyStage> verify_stage_;
+  // Consumer-side weighted scheduling state.
+  std::array<std::uint32_t, kPriorityClassCount> credits_{};
 
-  bool rate_limit(AccountWindow& window, MessageKind kind, common::TimestampNs timestamp);
+  bool pop(std::span<const RingMember> rings, OwnedFrame& out);
+  bool pop_class(PriorityClass priority_class, OwnedFrame& out);
+  void refill_credits() noexcept;
+  Ring& ring_for(Lane& lane, const FrameHeader& header) noexcept;
+  bool admit(Lane& lane, const Frame& frame, common::TimestampNs now);
+  bool admit_batch(Lane& lane, std::span<const Frame> frames, common::TimestampNs now,
+                   common::TimestampNs verified_ns);
+  void commit_batch(Lane& lane, const Frame& batch, bool valid, const VerifyStage::Ticket& ticket);
+  bool stage_for_verify(Lane& lane, const Frame& frame, common::TimestampNs now);
+  void drop(Lane& lane, const Frame& frame);
+  // Counts the refusal under `reason` and reports it to the observer.
+  void reject(Lane& lane, const Frame& frame, RejectReason reason, std::size_t messages = 1,
+              bool authenticated = false);
+  // Samples the lane's occupancy every few calls; true when `frames` are all
+  // standard tier and the lane is shedding.
+  bool shed(Lane& lane, std::span<const Frame> frames);
+  void sample_occupancy(Lane& lane) noexcept;
 };
 
 }  // namespace ingest
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "tradecore/ingest/transport.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// UDP receive over io_uring. Each lane arms one multishot recvmsg against a
+// provided-buffer group whose buffers are the lane's frame slab slots, so
+// datagrams land in the slab with no per-packet syscall and the slot a
+// datagram arrived in is handed straight to the ingress pipeline. Sockets,
+// account steering and stats are shared with UdpTransport; a lane without a
+// usable slab or ring, or on a kernel without multishot recvmsg, falls back
+// to the UdpTransport receive loop, and backend() says so.
+class IoUringTransport final : public UdpTransport {
+ public:
+  explicit IoUringTransport(TransportOptions options = {});
+  ~IoUringTransport() override;
+
+  // "io_uring" while every lane runs on it; "io_uring+<socket loop>" once
+  // some lanes have fallen back, and the socket loop's name once all have.
+  std::string_view backend() const override;
+  bool start(const std::string& endpoint_uri, FrameCallback callback) override;
+
+  // Lanes running the UdpTransport receive loop instead of io_uring.
+  [[nodiscard]] std::size_t fallback_lanes() const noexcept {
+    return fallback_lanes_.load(std::memory_order_relaxed);
+  }
+
+  // Whether the running kernel provides io_uring with extended enter
+  // arguments and skippable completions (5.17+). Probed once; multishot
+  // recvmsg (6.0+) is detected per lane when first armed.
+  static bool supported();
+
+ protected:
+  void receive_loop(Lane& lane) override;
+
+ private:
+  // False when the lane cannot run on io_uring and should use the socket loop.
+  bool receive_uring(Lane& lane);
+
+  std::atomic<std::size_t> fallback_lanes_{0};
+};
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "tradecore/ingest/frame.hpp"
+#include "tradecore/ingest/sbe/journal.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Layout of an admitted ingress frame as journaled to the WAL by tradecored:
+// [kind:1][account:8][nonce:8][received_time_ns:8][payload:N]
+// The header is journal::JournalHeader, generated from
+// libs/ingest/schema/journal.toml.
+inline constexpr std::size_t kJournalHeaderSize = journal::JournalHeaderDecoder::kBlockLength;
+
+// WAL record type (wal::RecordHeader::type) a journaled frame is written
+// under. New orders are risk-checked before they are journaled, so the type
+// carries the outcome replay must follow; every other kind is kSequenced.
+enum class JournalRecordType : std::uint16_t {
+  // Written before outcomes were journaled: a new order may have been
+  // refused by risk after it reached the WAL.
+  kUnchecked = 0,
+  // Handed to the matcher in WAL order.
+  kSequenced = 1,
+  // A new order refused before matching (risk, or a malformed payload);
+  // journaled so the sequence stays complete, never applied.
+  kRejected = 2,
+};
+
+inline void encode_journal_record(const FrameHeader& header,
+                                  std::span<const std::byte> payload,
+                                  std::vector<std::byte>& out) {
+  out.resize(kJournalHeaderSize + payload.size());
+  journal::JournalHeaderEncoder::wrap(out)
+      ->kind(header.kind)
+      .account(header.account)
+      .nonce(header.nonce)
+      .received_time_ns(header.received_time_ns);
+  std::copy(payload.begin(), payload.end(), out.begin() + static_cast<std::ptrdiff_t>(kJournalHeaderSize));
+}
+
+// Decodes a journaled frame; the returned payload aliases `data`.
+inline bool decode_journal_record(std::span<const std::byte> data, Frame& out) {
+  const auto record = journal::JournalHeaderDecoder::wrap(data);
+  if (!record || static_cast<std::uint8_t>(record->kind()) > static_cast<std::uint8_t>(MessageKind::kHeartbeat)) {
+    return false;
+  }
+
+  out.header.kind = record->kind();
+  out.header.account = record->account();
+  out.header.nonce = record->nonce();
+  out.header.received_time_ns = record->received_time_ns();
+  out.header.priority = 0;
+  out.payload = data.subspan(kJournalHeaderSize);
+  return true;
+}
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "tradecore/common/types.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Last-seen times of the peers a transport has heard from, behind
+// TransportStats::connections_active. Every receive thread calls touch() per
+// datagram, so it takes no lock and costs the same however many peers are
+// connected: a bounded probe of a fixed open-addressing table, relaxed
+// atomic stores, and a few slots of incremental expiry sweep. Expired slots
+// become tombstones that later inserts reuse; a probe window with no room
+// leaves the peer untracked until a slot frees up.
+//
+// A sweep can retire a peer in the instant it is refreshed; the next
+// datagram re-inserts it, so liveness is off by at most one packet.
+class PeerTable {
+ public:
+  // `capacity` is rounded up to a power of two.
+  PeerTable(std::size_t capacity, common::TimestampNs liveness_ns);
+
+  PeerTable(const PeerTable&) = delete;
+  PeerTable& operator=(const PeerTable&) = delete;
+
+  // Records a datagram from `peer` (an address and port packed below 2^48)
+  // at `now_ns`, then sweeps the next few slots after the caller's
+  // `sweep_cursor`, which each receive thread keeps for itself.
+  void touch(std::uint64_t peer, common::TimestampNs now_ns, std::size_t& sweep_cursor) noexcept;
+  // Peers seen within the liveness window of `now_ns`. Scans the table; for
+  // stats readers, not the receive path.
+  [[nodiscard]] std::size_t live(common::TimestampNs now_ns) const noexcept;
+  // Forgets every peer; only while no thread is in touch().
+  void clear() noexcept;
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+ private:
+  static constexpr std::size_t kMaxProbe = 16;
+  static constexpr std::size_t kSweepStep = 2;
+  // A refresh within this long of the stored time is skipped, so a busy
+  // peer does not dirty its slot's cache line on every datagram.
+  static constexpr common::TimestampNs kRefreshNs = 1'000'000;
+
+  static constexpr std::uint64_t kEmpty = 0;
+  static constexpr std::uint64_t kTombstone = 1;
+
+  struct Slot {
+    // Peer key + 2, or kEmpty / kTombstone.
+    std::atomic<std::uint64_t> key{kEmpty};
+    std::atomic<common::TimestampNs> last_seen_ns{0};
+  };
+
+  [[nodiscard]] bool expired(const Slot& slot, common::TimestampNs now_ns) const noexcept;
+  void sweep(common::TimestampNs now_ns, std::size_t& cursor) noexcept;
+
+  std::size_t mask_;
+  unsigned shift_;
+  common::TimestampNs liveness_ns_;
+  std::unique_ptr<Slot[]> slots_;
+};
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -2,7 +2,9 @@
 
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 
 #include "tradecore/ingest/frame.hpp"
 #include "tradecore/ingest/transport.hpp"
@@ -15,9 +17,13 @@ namespace ingest {
 // Future: Will upgrade to full QUIC using MsQuic for 0-RTT, multiplexing, etc.
 class QuicTransport {
  public:
-  using FrameCallback = std::function<void(const Frame&)>;
+  using FrameCallback = Transport::FrameCallback;
 
-  QuicTransport();
+  explicit QuicTransport(TransportOptions options = {});
+  // Picks the backend for the endpoint start() will get: ShmTransport for
+  // "shm://<name>", TcpTransport for "tcp://host:port", the UDP transports
+  // otherwise.
+  QuicTransport(std::string_view endpoint_uri, TransportOptions options);
   ~QuicTransport();
 
   // Start listening on endpoint (e.g., "quic://127.0.0.1:9000")
@@ -32,6 +38,28 @@ class QuicTransport {
   // Get transport statistics
   TransportStats stats() const;
 
+  // Receive backend in use: shm or tcp for those endpoints, io_uring where
+  // supported, otherwise the socket loop
+  std::string_view backend() const;
+
+  // Connection-oriented backend (see Transport::stream)
+  bool stream() const;
+
+  // Receive lanes (see Transport::lane_count)
+  std::size_t lane_count() const;
+
+  // Receive into a lane's ingress frame slab (see Transport::attach_slab)
+  void attach_slab(std::size_t lane, FrameSlab* slab);
+
+  // Per-lane end-of-batch hook (see Transport::set_batch_callback)
+  void set_batch_callback(Transport::BatchCallback callback);
+
+  // Consumer congestion check (see Transport::set_pressure_callback)
+  void set_pressure_callback(Transport::PressureCallback callback);
+
+  // Best-effort message back to a frame's sender (see Transport::reply)
+  bool reply(const Frame& frame, std::span<const std::byte> message);
+
  private:
   std::unique_ptr<Transport> transport_;
   std::string endpoint_;
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "tradecore/common/cpu.hpp"
+#include "tradecore/common/types.hpp"
+#include "tradecore/ingest/frame.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Sustained rates per message kind and the burst an idle account may spend.
+struct RateTier {
+  std::uint32_t new_orders_per_second{10'000};
+  std::uint32_t cancels_per_second{20'000};
+  std::uint32_t replaces_per_second{20'000};
+  // Burst as milliseconds of the sustained rate (at least one message).
+  std::uint32_t burst_ms{1'000};
+};
+
+// Per-account token buckets in a fixed-capacity open-addressing table.
+//
+// Each bucket is kept as a GCRA theoretical arrival time, so admitting a
+// message is one table probe plus a compare and an add on integer
+// nanoseconds; there is no refill loop and no window boundary to burst
+// across. Entries that have been idle for `idle_timeout_ns` are reused for
+// new accounts in place, so the table never grows and never allocates after
+// construction. When an account finds neither its entry, a free slot nor an
+// idle one within the probe limit it is admitted untracked and counted as an
+// overflow. Single-threaded: the pipeline keeps one limiter per lane.
+class RateLimiter {
+ public:
+  struct Config {
+    // Tier 0 applies to every account not listed in account_tiers.
+    std::vector<RateTier> tiers{RateTier{}};
+    std::unordered_map<common::AccountId, std::uint8_t> account_tiers;
+    // Rounded up to a power of two.
+    std::size_t capacity{1 << 16};
+    common::TimestampNs idle_timeout_ns{60'000'000'000};
+  };
+
+  struct Stats {
+    std::uint64_t throttled{0};
+    // Accounts throttled at least once while tracked.
+    std::uint64_t throttled_accounts{0};
+    std::uint64_t evictions{0};
+    std::uint64_t overflows{0};
+    std::size_t tracked{0};
+  };
+
+  explicit RateLimiter(Config config);
+
+  RateLimiter(const RateLimiter&) = delete;
+  RateLimiter& operator=(const RateLimiter&) = delete;
+
+  // True when `kind` from `account` is within its tier's rate at `now_ns`
+  // (monotonic). Heartbeats are always admitted.
+  [[nodiscard]] bool admit(common::AccountId account, MessageKind kind, common::TimestampNs now_ns) noexcept;
+  // All of `frames` (one batch from `account`) or none: each kind's bucket
+  // must have room for every message of that kind. A refused batch counts
+  // each of its messages as throttled.
+  [[nodiscard]] bool admit_batch(common::AccountId account, std::span<const Frame> frames,
+                                 common::TimestampNs now_ns) noexcept;
+
+  [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+  // Tracked accounts with their throttled-message counts, most throttled
+  // first; scans the whole table, so keep it off the admission path.
+  [[nodiscard]] std::vector<std::pair<common::AccountId, std::uint32_t>> top_throttled(std::size_t limit) const;
+
+ private:
+  static constexpr std::size_t kMaxProbe = 16;
+  static constexpr std::size_t kKinds = 3;
+
+  // Emission interval and burst tolerance per kind, in nanoseconds.
+  struct TierLimits {
+    common::TimestampNs interval_ns[kKinds];
+    common::TimestampNs tolerance_ns[kKinds];
+  };
+
+  struct alignas(common::kCacheLineSize) Entry {
+    common::AccountId account{0};
+    common::TimestampNs tat_ns[kKinds]{};
+    common::TimestampNs last_seen_ns{0};
+    std::uint32_t throttled{0};
+    std::uint8_t tier{0};
+    bool used{false};
+  };
+
+  Entry* find_or_insert(common::AccountId account, common::TimestampNs now_ns) noexcept;
+  void throttle(Entry& entry, std::uint32_t messages) noexcept;
+
+  std::vector<TierLimits> tiers_;
+  std::unordered_map<common::AccountId, std::uint8_t> account_tiers_;
+  common::TimestampNs idle_timeout_ns_;
+  std::size_t mask_;
+  unsigned shift_;
+  std::unique_ptr<Entry[]> entries_;
+  Stats stats_{};
+};
+
+}  // namespace ingest
+}  // namespace tradecore
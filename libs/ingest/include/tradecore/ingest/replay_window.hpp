@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "tradecore/common/cpu.hpp"
+#include "tradecore/common/types.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Per-account anti-replay windows over FrameHeader::nonce, after the IPsec
+// sliding-window scheme (RFC 4303 3.4.3): each account keeps the highest
+// accepted nonce and a 512-bit bitmap of the nonces below it. A nonce above
+// the top is new, one more than kWindowBits below it is too old, and anything
+// in between is new only if its bit is clear.
+//
+// check() runs before signature verification and only reads; accept() runs
+// once the frame has been authenticated and admitted, so forged frames can
+// neither move the window nor burn a legitimate nonce. An entry is two cache
+// lines in a fixed open-addressing table. When a probe window is full the
+// least recently seen entry is evicted, and its top nonce is parked in a
+// second fixed table of {account, top} pairs so a later frame from that
+// account still cannot replay anything at or below it. Neither table
+// allocates after construction; when the cold table's probe window is full
+// too, the parked entry with the lowest top is dropped and counted in
+// cold_overflows. Single-threaded: the pipeline keeps one window per lane, which
+// holds because transports steer each account to one lane.
+class ReplayWindow {
+ public:
+  static constexpr std::uint64_t kWindowBits = 512;
+
+  struct Stats {
+    std::size_t tracked{0};
+    std::uint64_t evictions{0};
+    std::uint64_t restored{0};
+    // Evicted accounts whose top nonce is parked in the cold table.
+    std::size_t retired{0};
+    // Parked tops dropped to make room; those accounts lost their replay
+    // history.
+    std::uint64_t cold_overflows{0};
+  };
+
+  // Both capacities are rounded up to a power of two; a `cold_capacity` of 0
+  // parks up to four times `capacity` evicted accounts.
+  explicit ReplayWindow(std::size_t capacity, std::size_t cold_capacity = 0);
+
+  ReplayWindow(const ReplayWindow&) = delete;
+  ReplayWindow& operator=(const ReplayWindow&) = delete;
+
+  // False when `nonce` was already accepted for `account` or has fallen out
+  // of its window.
+  [[nodiscard]] bool check(common::AccountId account, std::uint64_t nonce) const noexcept;
+  // Records `nonce` as used; call only after check() passed and the frame
+  // was authenticated.
+  void accept(common::AccountId account, std::uint64_t nonce, common::TimestampNs now_ns);
+
+  [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+
+ private:
+  static constexpr std::size_t kMaxProbe = 8;
+  static constexpr std::size_t kWords = kWindowBits / 64;
+
+  // Bit i of `bits` marks nonce `top - i` as used.
+  struct alignas(common::kCacheLineSize) Entry {
+    common::AccountId account{0};
+    std::uint64_t top{0};
+    common::TimestampNs last_seen_ns{0};
+    bool used{false};
+    std::uint64_t bits[kWords]{};
+  };
+
+  struct Retired {
+    common::AccountId account{0};
+    std::uint64_t top{0};
+    bool used{false};
+  };
+
+  const Entry* find(common::AccountId account) const noexcept;
+  // The account's parked entry, or nullptr. Slots are emptied on restore, so
+  // the whole probe window is scanned rather than stopping at a gap.
+  const Retired* find_retired(common::AccountId account) const noexcept;
+  void retire(common::AccountId account, std::uint64_t top) noexcept;
+  Entry& insert(common::AccountId account, common::TimestampNs now_ns);
+  static bool seen(const Entry& entry, std::uint64_t nonce) noexcept;
+  static void mark(Entry& entry, std::uint64_t nonce) noexcept;
+
+  std::size_t mask_;
+  unsigned shift_;
+  std::unique_ptr<Entry[]> entries_;
+  // Top nonces of evicted accounts.
+  std::size_t cold_mask_;
+  unsigned cold_shift_;
+  std::unique_ptr<Retired[]> retired_;
+  Stats stats_{};
+};
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "tradecore/ingest/transport.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Ingress for clients on the same host. start("shm://<name>") creates
+// `shm_clients` rings, /dev/shm/<name>.0 and up, each a single-producer/
+// single-consumer byte ring of `shm_ring_bytes`; a client process claims one
+// with ShmClient::connect and writes wire datagrams into it exactly as it
+// would send them over UDP (WireHeader, batch frames, auth prefix), so they
+// are parsed and verified the same way. One receive thread polls every ring,
+// copies each datagram into a slab slot and hands the frames to the callback
+// as lane 0; neither side makes a syscall per frame. With busy_poll the
+// thread spins; otherwise, once every ring is empty, it yields for a while
+// and then naps between polls. While the pressure callback reports the lane
+// congested the thread stops advancing the rings' tails, so clients find
+// their rings full and hold back instead of the pipeline dropping frames.
+//
+// Rings are owned by the process that claimed them; a ring whose owner has
+// exited is reclaimed by the next connect. A ring holding a record that
+// fails validation is drained and counted as one malformed frame.
+class ShmTransport final : public Transport {
+ public:
+  explicit ShmTransport(TransportOptions options = {});
+  ~ShmTransport() override;
+
+  bool start(const std::string& endpoint_uri, FrameCallback callback) override;
+  void stop() override;
+  bool is_running() const override;
+  // connections_active counts claimed rings.
+  TransportStats stats() const override;
+  std::string_view backend() const override { return "shm"; }
+  bool stream() const override { return true; }
+  void attach_slab(std::size_t lane, FrameSlab* slab) override;
+  void set_batch_callback(BatchCallback callback) override;
+  void set_pressure_callback(PressureCallback callback) override;
+
+  // Times draining paused because the pressure callback reported congestion.
+  [[nodiscard]] std::uint64_t backpressure_pauses() const noexcept {
+    return backpressure_pauses_.load(std::memory_order_relaxed);
+  }
+
+  // Name part of a "shm://<name>" endpoint, or empty for any other scheme.
+  static std::string_view ring_name(std::string_view endpoint_uri) noexcept;
+
+ private:
+  struct Ring {
+    std::string path;
+    void* mapping{nullptr};
+    std::size_t length{0};
+    // Data bytes and read position; kept here because clients can write the
+    // mapped header.
+    std::uint64_t capacity{0};
+    std::uint64_t tail{0};
+  };
+
+  void receive_loop();
+  // Drains one ring, stopping early once the lane is congested; returns the
+  // datagrams taken.
+  std::size_t drain(Ring& ring);
+  void deliver(std::span<const std::byte> datagram, common::TimestampNs received_ns);
+  void unmap();
+
+  TransportOptions options_;
+  std::atomic<bool> running_{false};
+  FrameCallback callback_;
+  BatchCallback batch_callback_;
+  PressureCallback pressure_callback_;
+  FrameSlab* slab_{nullptr};
+  std::vector<Ring> rings_;
+  std::vector<std::byte> scratch_;
+  std::array<Frame, kMaxBatchMessages> frames_{};
+  std::thread thread_;
+
+  std::atomic<std::uint64_t> bytes_received_{0};
+  std::atomic<std::uint64_t> frames_received_{0};
+  std::atomic<std::uint64_t> batches_received_{0};
+  std::atomic<std::uint64_t> frames_malformed_{0};
+  std::atomic<std::uint64_t> receive_batches_{0};
+  std::atomic<std::uint64_t> datagrams_received_{0};
+  std::atomic<std::uint64_t> backpressure_pauses_{0};
+};
+
+// Producer side of a ShmTransport ring, for co-located clients (and
+// benchmarks). Not thread-safe: one sending thread per client.
+class ShmClient {
+ public:
+  ShmClient() = default;
+  ShmClient(const ShmClient&) = delete;
+  ShmClient& operator=(const ShmClient&) = delete;
+  ~ShmClient();
+
+  // Claims a free ring of the transport started as shm://<name>. False when
+  // no transport is running under that name or every ring is taken.
+  bool connect(std::string_view name);
+  // Releases the ring; frames already written are still delivered.
+  void close();
+  [[nodiscard]] bool connected() const noexcept { return mapping_ != nullptr; }
+
+  // Copies one wire datagram into the ring. False when it is larger than
+  // kMaxWireFrameSize, or the ring is full because the transport is behind.
+  bool send(std::span<const std::byte> datagram);
+
+ private:
+  void* mapping_{nullptr};
+  std::size_t length_{0};
+  // Producer-local copies of the ring positions; tail is reloaded only when
+  // the cached value says the ring is full.
+  std::uint64_t head_{0};
+  std::uint64_t cached_tail_{0};
+};
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "tradecore/ingest/transport.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Per-connection counters, as of TcpTransport::connection_stats().
+struct TcpConnectionStats {
+  std::string peer;  // "address:port"
+  common::TimestampNs connected_ns{0};
+  std::uint64_t bytes_received{0};
+  std::uint64_t frames_received{0};  // messages, counting each one a batch frame carries
+  std::uint64_t frames_malformed{0};
+  std::uint64_t reads{0};  // recv calls that returned data
+};
+
+// Reliable ingress for bulk clients: start("tcp://host:port") listens and
+// one epoll thread serves every connection as lane 0. The stream carries the
+// same frames clients send as datagrams, back to back; each frame's
+// WireHeader::payload_len is its length prefix. A recv fills the
+// connection's read buffer with as many frames as have arrived and they are
+// parsed in place, so frames alias the buffer for the callback and the
+// pipeline copies them into its slab (attach_slab is not used).
+//
+// With a pressure callback set, the thread checks it before every frame and
+// stops reading while the lane is congested, leaving unread bytes in the
+// kernel so TCP flow control throttles the client instead of the pipeline
+// dropping its orders. A frame with a valid header that fails to parse is
+// counted and skipped; a bad header or an oversized length loses the
+// framing, so the connection is closed.
+class TcpTransport final : public Transport {
+ public:
+  explicit TcpTransport(TransportOptions options = {});
+  ~TcpTransport() override;
+
+  bool start(const std::string& endpoint_uri, FrameCallback callback) override;
+  void stop() override;
+  bool is_running() const override;
+  // connections_active counts open connections; receive_batches and
+  // datagrams_received count recv calls and the wire frames they carried.
+  TransportStats stats() const override;
+  std::string_view backend() const override { return "tcp"; }
+  bool stream() const override { return true; }
+  void set_batch_callback(BatchCallback callback) override;
+  void set_pressure_callback(PressureCallback callback) override;
+  // Writes to the frame's connection if it is still open. A reply the
+  // socket only partly takes is finished before the next one, so replies
+  // are never interleaved; while one is pending, further replies are dropped.
+  bool reply(const Frame& frame, std::span<const std::byte> message) override;
+
+  // Open connections, in no particular order.
+  [[nodiscard]] std::vector<TcpConnectionStats> connection_stats() const;
+  // Times reading paused because the pressure callback reported congestion.
+  [[nodiscard]] std::uint64_t backpressure_pauses() const noexcept {
+    return backpressure_pauses_.load(std::memory_order_relaxed);
+  }
+
+  // True for "tcp://" endpoints.
+  static bool handles(std::string_view endpoint_uri) noexcept;
+
+ private:
+  struct Connection {
+    int fd{-1};
+    // Tells a reply handle from one for an earlier connection on the same fd.
+    std::uint32_t id{0};
+    std::string peer;
+    common::TimestampNs connected_ns{0};
+    std::vector<std::byte> buffer;
+    // Unparsed bytes are [begin, end) of buffer.
+    std::size_t begin{0};
+    std::size_t end{0};
+    // Steady time the last recv returned, stamped on the frames it carried.
+    common::TimestampNs received_ns{0};
+    // Listed in stalled_; not read again until its frames are passed on.
+    bool stalled{false};
+    // Unsent tail of a partly written reply.
+    std::vector<std::byte> outbox;
+    std::atomic<std::uint64_t> bytes_received{0};
+    std::atomic<std::uint64_t> frames_received{0};
+    std::atomic<std::uint64_t> frames_malformed{0};
+    std::atomic<std::uint64_t> reads{0};
+  };
+
+  enum class Parsed : std::uint8_t {
+    kDrained,   // only a partial frame, if anything, is left
+    kCongested, // stopped at a whole frame for backpressure
+    kBroken,    // framing lost; close the connection
+  };
+
+  void receive_loop();
+  void accept_connections();
+  // Reads once and parses what arrived; false when the connection closed.
+  bool read_connection(Connection& connection);
+  Parsed parse_frames(Connection& connection);
+  // Writes what it can of the outbox; true once it is empty.
+  bool flush_outbox(Connection& connection);
+  void close_connection(int fd);
+  void close_all();
+
+  TransportOptions options_;
+  std::atomic<bool> running_{false};
+  FrameCallback callback_;
+  BatchCallback batch_callback_;
+  PressureCallback pressure_callback_;
+  int listen_fd_{-1};
+  int epoll_fd_{-1};
+  std::thread thread_;
+
+  // Written by the receive thread only, under connections_mutex_; the thread
+  // reads it without the lock.
+  std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+  mutable std::mutex connections_mutex_;
+  // Connections holding whole frames that backpressure left unparsed.
+  std::vector<int> stalled_;
+  std::uint32_t next_connection_id_{0};
+  // Whether the current poll round passed frames on.
+  bool delivered_{false};
+  std::array<Frame, kMaxBatchMessages> frames_{};
+
+  std::atomic<std::uint64_t> bytes_received_{0};
+  std::atomic<std::uint64_t> frames_received_{0};
+  std::atomic<std::uint64_t> batches_received_{0};
+  std::atomic<std::uint64_t> frames_malformed_{0};
+  std::atomic<std::uint64_t> receive_batches_{0};
+  std::atomic<std::uint64_t> datagrams_received_{0};
+  std::atomic<std::uint64_t> backpressure_pauses_{0};
+};
+
+}  // namespace ingest
+}  // namespace tradecore
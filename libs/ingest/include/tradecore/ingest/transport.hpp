@@ -1,30 +1,80 @@
 #pragma once
 
-#include <chrono>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <ctime>
 #include <functional>
-#include <mutex>
+#include <span>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <thread>
-#include <unordered_map>
+#include <vector>
 
 #include "tradecore/ingest/frame.hpp"
+#include "tradecore/ingest/frame_slab.hpp"
+#include "tradecore/ingest/peer_table.hpp"
+#include "tradecore/ingest/sbe_messages.hpp"
 
 namespace tradecore {
 namespace ingest {
 
 struct TransportStats {
   std::uint64_t bytes_received{0};
-  std::uint64_t frames_received{0};
+  std::uint64_t frames_received{0};   // messages, counting each one a batch frame carries
+  std::uint64_t batches_received{0};  // batch frames among the datagrams
   std::uint64_t frames_malformed{0};
   std::uint64_t connections_active{0};
+  std::uint64_t receive_batches{0};     // receive syscalls that returned data
+  std::uint64_t datagrams_received{0};  // datagrams across those syscalls
+
+  [[nodiscard]] double average_batch_fill() const noexcept {
+    return receive_batches == 0 ? 0.0
+                                : static_cast<double>(datagrams_received) / static_cast<double>(receive_batches);
+  }
+};
+
+struct TransportOptions {
+  // Datagrams drained per recvmmsg call; 1 falls back to one recvfrom per datagram.
+  std::size_t receive_batch_size{32};
+  // Receive threads, each with its own SO_REUSEPORT socket; datagrams are
+  // steered to a thread by account (see UdpTransport::lane_for_account).
+  std::size_t receive_threads{1};
+  // Prefer the io_uring backend where the kernel supports it (see QuicTransport).
+  bool io_uring{true};
+  // Spin on a non-blocking socket instead of sleeping in the kernel; the
+  // socket also gets SO_BUSY_POLL for `busy_poll_us` where permitted.
+  bool busy_poll{false};
+  std::uint32_t busy_poll_us{50};
+  // CPU per receive lane, by lane index; missing or negative leaves it unpinned.
+  std::vector<int> receive_cpus{};
+  // Ask the kernel to stamp each datagram on arrival (SO_TIMESTAMPNS) and
+  // carry it in Frame::times, so latency can be measured from the wire.
+  bool kernel_timestamps{true};
+  // Peers tracked for connections_active (see PeerTable).
+  std::size_t peer_capacity{1 << 16};
+  // ShmTransport: client rings created, and bytes per ring (rounded up to a
+  // power of two).
+  std::size_t shm_clients{16};
+  std::size_t shm_ring_bytes{1 << 20};
+  // TcpTransport: connections accepted at once, and read buffer bytes per
+  // connection (at least two full frames).
+  std::size_t tcp_max_connections{256};
+  std::size_t tcp_read_buffer_bytes{1 << 16};
 };
 
 class Transport {
  public:
-  using FrameCallback = std::function<void(const Frame&)>;
+  // One datagram's frames: a single frame, or the run a batch frame unpacks
+  // to (see UdpTransport::parse_frame). The span is only valid for the call.
+  using FrameCallback = std::function<void(std::span<const Frame>)>;
+  using BatchCallback = std::function<void(std::size_t lane)>;
+  using PressureCallback = std::function<bool(std::size_t lane)>;
 
   virtual ~Transport() = default;
 
@@ -32,6 +82,44 @@ class Transport {
   virtual void stop() = 0;
   virtual bool is_running() const = 0;
   virtual TransportStats stats() const = 0;
+  virtual std::string_view backend() const = 0;
+
+  // Whether frames arrive over connections rather than as datagrams, so the
+  // sender a reply goes to cannot have been spoofed.
+  virtual bool stream() const { return false; }
+
+  // Receive lanes. Frames carry the lane they arrived on and, with more than
+  // one lane, the callback runs concurrently on every lane's thread.
+  virtual std::size_t lane_count() const { return 1; }
+
+  // Receive directly into slab slots for `lane`. Frames then carry their slot
+  // and the callback takes ownership of it. Must be called before start().
+  virtual void attach_slab(std::size_t lane, FrameSlab* slab) {
+    (void)lane;
+    (void)slab;
+  }
+
+  // Runs on a lane's thread after the frames of each receive batch have been
+  // passed to the frame callback (see IngressPipeline::flush). Must be called
+  // before start().
+  virtual void set_batch_callback(BatchCallback callback) { (void)callback; }
+
+  // Asked on a lane's thread before each frame is passed on; true means the
+  // lane's consumer is full (see IngressPipeline::congested). Stream
+  // transports then stop reading, so the kernel pushes back on the sender,
+  // while datagram transports keep receiving and let the pipeline drop.
+  // Must be called before start().
+  virtual void set_pressure_callback(PressureCallback callback) { (void)callback; }
+
+  // Sends `message` back to the sender of `frame`, best effort: it never
+  // blocks, and returns false when the transport has no way back (see
+  // Frame::reply_to) or the send would block. Call on the frame's lane
+  // thread, from the frame or batch callback.
+  virtual bool reply(const Frame& frame, std::span<const std::byte> message) {
+    (void)frame;
+    (void)message;
+    return false;
+  }
 };
 
 // Wire protocol for frames over UDP/QUIC
@@ -54,30 +142,123 @@ struct WireHeader {
 
 static_assert(sizeof(WireHeader) == 36, "WireHeader must be 36 bytes");
 
+// Auth prefix of a frame payload: an ed25519 signature, or a session MAC
+// when the frame carries kFrameFlagSessionMac.
+inline constexpr std::size_t kFrameSignatureSize = 64;
+inline constexpr std::size_t kFrameSessionMacSize = 16;
+
+// Batch frame (WireHeader::kind == MessageKind::kBatch) payload:
+//   [auth prefix][count:1] then count x [kind:1][length:1][SBE message:length]
+// filling payload_len exactly. Message i takes nonce + i, so a batch spends
+// `count` nonces; the auth prefix covers the batch's own header (kind kBatch,
+// the first nonce) and the rest of the payload, so one signature check
+// admits every message.
+inline constexpr std::size_t kMaxBatchMessages = 64;
+// Batch datagrams are capped to fit a 1500-byte Ethernet MTU unfragmented
+// (less the IPv4 and UDP headers).
+inline constexpr std::size_t kMaxBatchFrameSize = 1472;
+
+// Largest frame a receive buffer must hold: a full batch datagram.
+inline constexpr std::size_t kMaxWireFrameSize = kMaxBatchFrameSize;
+static_assert(sizeof(WireHeader) + kFrameSignatureSize + sbe::kMaxEncodedSize <= kMaxWireFrameSize,
+              "single-message frames must fit the receive buffers");
+// Slot bytes ahead of the datagram that a receive backend may use for its own
+// metadata (io_uring writes the recvmsg header, source address and kernel
+// timestamp there).
+inline constexpr std::size_t kReceiveHeadroom = 64;
+// Control buffer a receive needs for the SCM_TIMESTAMPNS message.
+inline constexpr std::size_t kTimestampControlSize = CMSG_SPACE(sizeof(timespec));
+
 class UdpTransport : public Transport {
  public:
-  UdpTransport();
+  explicit UdpTransport(TransportOptions options = {});
   ~UdpTransport() override;
 
   bool start(const std::string& endpoint_uri, FrameCallback callback) override;
   void stop() override;
   bool is_running() const override;
   TransportStats stats() const override;
+  std::string_view backend() const override;
+  std::size_t lane_count() const override { return lanes_.size(); }
+  void attach_slab(std::size_t lane, FrameSlab* slab) override;
+  void set_batch_callback(BatchCallback callback) override;
+  // One datagram to the frame's source address, from its lane's socket.
+  bool reply(const Frame& frame, std::span<const std::byte> message) override;
+
+  // Parses a single-message datagram in place; the frame payload aliases
+  // `data`. Batch frames are rejected.
+  static bool parse_frame(const std::byte* data, std::size_t len, Frame& out_frame);
+  // Parses any datagram in place into `out`: one frame, or the contiguous
+  // run of frames a batch carries. Returns the frame count, 0 when the
+  // datagram is malformed or the batch does not fit `out`.
+  static std::size_t parse_frame(const std::byte* data, std::size_t len, std::span<Frame> out);
+  // Unpacks a batch payload (from its auth prefix on) under the batch's
+  // header. Frames alias `payload`; their slot and lane are left unset.
+  static std::size_t unpack_batch(const FrameHeader& header, std::span<const std::byte> payload,
+                                  std::span<Frame> out);
+
+  // Lane the kernel steers `account` to. Mirrors the reuseport BPF program,
+  // which loads bytes 8..11 of the datagram (the low word of the
+  // little-endian account) as a big-endian word and takes it modulo `lanes`.
+  static std::size_t lane_for_account(common::AccountId account, std::size_t lanes) noexcept;
+
+ protected:
+  // Per receive thread; counters are written by that thread only.
+  struct alignas(64) Lane {
+    std::uint16_t index{0};
+    int socket_fd{-1};
+    FrameSlab* slab{nullptr};
+    std::thread thread;
+    std::atomic<std::uint64_t> bytes_received{0};
+    std::atomic<std::uint64_t> frames_received{0};
+    std::atomic<std::uint64_t> batches_received{0};
+    std::atomic<std::uint64_t> frames_malformed{0};
+    std::atomic<std::uint64_t> receive_batches{0};
+    std::atomic<std::uint64_t> datagrams_received{0};
+    // Current receive batch: steady time the syscall returned, and the
+    // offset that rebases kernel (CLOCK_REALTIME) stamps onto the steady clock.
+    common::TimestampNs received_ns{0};
+    common::TimestampNs realtime_offset_ns{0};
+    // This thread's expiry sweep position in the peer table.
+    std::size_t peer_sweep{0};
+    // Frames parsed from the current datagram.
+    std::array<Frame, kMaxBatchMessages> frames{};
+  };
+
+  // Runs on the lane's thread until running_ clears; backends override this
+  // and keep the socket setup, steering and stats of this class.
+  virtual void receive_loop(Lane& lane);
+  // Marks `sender` live as of the lane's current receive batch.
+  void note_peer(Lane& lane, const sockaddr_in& sender) noexcept;
+  // Frame::reply_to for datagrams from `sender`.
+  static std::uint64_t reply_handle(const sockaddr_in& sender) noexcept;
+  // Stamps the lane's receive batch; call as soon as the receive returns.
+  static void note_receive(Lane& lane) noexcept;
+  // Kernel receive time (CLOCK_REALTIME ns) from the SCM_TIMESTAMPNS message
+  // in `message`'s control data, or 0 when there is none.
+  static common::TimestampNs kernel_timestamp(const msghdr& message) noexcept;
+  // Parses and forwards one datagram; returns true when the callback took the
+  // slot. `kernel_ns` is the datagram's kernel_timestamp(), or 0, and
+  // `reply_to` its sender's reply_handle().
+  bool deliver(Lane& lane, std::span<std::byte> buffer, std::size_t received, bool truncated, std::uint32_t slot,
+               common::TimestampNs kernel_ns = 0, std::uint64_t reply_to = 0);
+  // Closes a receive batch on the lane's thread; see set_batch_callback.
+  void end_batch(Lane& lane);
+  // Thread entry: pins the lane to its configured CPU, then runs receive_loop.
+  void run_lane(Lane& lane);
+
+  TransportOptions options_;
+  std::atomic<bool> running_{false};
 
  private:
-  void receive_loop();
-  bool parse_frame(const std::byte* data, std::size_t len, Frame& out_frame, std::vector<std::byte>& payload_storage);
+  void close_sockets();
+  void receive_batched(Lane& lane);
 
   FrameCallback callback_;
-  std::atomic<bool> running_{false};
-  std::thread receive_thread_;
-  int socket_fd_{-1};
-
-  mutable std::atomic<std::uint64_t> bytes_received_{0};
-  mutable std::atomic<std::uint64_t> frames_received_{0};
-  mutable std::atomic<std::uint64_t> frames_malformed_{0};
-  mutable std::mutex peers_mutex_{};
-  mutable std::unordered_map<std::uint64_t, std::chrono::steady_clock::time_point> peer_last_seen_{};
+  BatchCallback batch_callback_;
+  std::vector<std::unique_ptr<Lane>> lanes_;
+
+  PeerTable peers_;
 };
 
 }  // namespace ingest
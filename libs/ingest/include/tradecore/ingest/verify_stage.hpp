@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "tradecore/common/cpu.hpp"
+#include "tradecore/common/types.hpp"
+#include "tradecore/ingest/frame.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+// Signature verification fanned out to a worker pool between the receive
+// threads and the ingress rings.
+//
+// Each receive lane owns a ticket ring. The lane's thread enqueues frames and
+// publishes them; workers (and the lane thread itself while draining) claim
+// runs of up to `batch` contiguous tickets with a CAS on a monotonic claim
+// index, verify the run with one verifier call, and mark each ticket valid or
+// invalid. drain() then walks the lane's tickets strictly in enqueue
+// order, so frames reach the rings in arrival order no matter which worker
+// finished first, and everything downstream of the stage stays single
+// producer per lane. Idle workers sleep on an atomic epoch bumped by enqueue.
+class VerifyStage {
+ public:
+  // Writes the outcome for frames[i] to valid[i].
+  using Verifier = std::function<void(std::span<const Frame> frames, std::span<bool> valid)>;
+
+  static constexpr std::size_t kMaxBatch = 256;
+
+  struct Ticket {
+    common::TimestampNs admitted_ns{0};
+    common::TimestampNs verified_ns{0};
+    // Tickets outstanding in the lane when this one was enqueued.
+    std::size_t queue_depth{0};
+    std::atomic<std::uint8_t> state{0};
+  };
+
+  struct Stats {
+    std::uint64_t verified{0};
+    std::uint64_t failed{0};
+    // Enqueued but not yet drained, across lanes.
+    std::uint64_t in_flight{0};
+  };
+
+  // `capacity` (tickets per lane) is rounded up to a power of two and `batch`
+  // is clamped to [1, kMaxBatch]. The verifier runs concurrently on every
+  // worker.
+  VerifyStage(std::size_t lanes, std::size_t capacity, std::size_t batch, std::size_t workers, Verifier verifier);
+  ~VerifyStage();
+
+  VerifyStage(const VerifyStage&) = delete;
+  VerifyStage& operator=(const VerifyStage&) = delete;
+
+  // Lane-thread side. enqueue() requires !full(lane); the frame's payload
+  // must stay valid until its ticket is drained.
+  [[nodiscard]] bool full(std::size_t lane) const noexcept;
+  [[nodiscard]] bool empty(std::size_t lane) const noexcept;
+  void enqueue(std::size_t lane, const Frame& frame, common::TimestampNs admitted_ns);
+
+  // Verifies unclaimed tickets of `lane` on the calling thread, waits for the
+  // ones workers hold, then calls commit(frame, ticket, valid) for every
+  // enqueued ticket in enqueue order.
+  template <typename Commit>
+  void drain(std::size_t lane, Commit&& commit);
+
+  [[nodiscard]] Stats stats() const noexcept;
+  [[nodiscard]] std::size_t worker_count() const noexcept { return workers_.size(); }
+
+ private:
+  static constexpr std::uint8_t kPending = 0;
+  static constexpr std::uint8_t kValid = 1;
+  static constexpr std::uint8_t kInvalid = 2;
+
+  struct alignas(common::kCacheLineSize) LaneQueue {
+    explicit LaneQueue(std::size_t capacity)
+        : frames(std::make_unique<Frame[]>(capacity)), tickets(std::make_unique<Ticket[]>(capacity)) {}
+
+    // Kept apart from the tickets so a claimed run is one contiguous span.
+    std::unique_ptr<Frame[]> frames;
+    std::unique_ptr<Ticket[]> tickets;
+    // Written by the lane thread.
+    alignas(common::kCacheLineSize) std::atomic<std::uint64_t> published{0};
+    std::atomic<std::uint64_t> retired{0};
+    // Contended by workers.
+    alignas(common::kCacheLineSize) std::atomic<std::uint64_t> claimed{0};
+  };
+
+  bool verify_run(LaneQueue& queue);
+  void run_worker(std::size_t index);
+
+  std::size_t mask_;
+  std::size_t batch_;
+  Verifier verifier_;
+  std::vector<std::unique_ptr<LaneQueue>> lanes_;
+  std::vector<std::thread> workers_;
+  alignas(common::kCacheLineSize) std::atomic<std::uint64_t> epoch_{0};
+  std::atomic<bool> stopping_{false};
+  alignas(common::kCacheLineSize) std::atomic<std::uint64_t> verified_{0};
+  std::atomic<std::uint64_t> failed_{0};
+};
+
+template <typename Commit>
+void VerifyStage::drain(std::size_t lane, Commit&& commit) {
+  auto& queue = *lanes_[lane];
+  while (verify_run(queue)) {
+  }
+  const auto published = queue.published.load(std::memory_order_relaxed);
+  for (auto index = queue.retired.load(std::memory_order_relaxed); index != published; ++index) {
+    const Ticket& ticket = queue.tickets[index & mask_];
+    std::uint8_t state;
+    while ((state = ticket.state.load(std::memory_order_acquire)) == kPending) {
+      common::cpu_relax();
+    }
+    commit(queue.frames[index & mask_], ticket, state == kValid);
+    queue.retired.store(index + 1, std::memory_order_release);
+  }
+}
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -0,0 +1,112 @@
+#include "tradecore/ingest/frame_slab.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+namespace tradecore {
+namespace ingest {
+
+namespace {
+
+std::size_t round_up(std::size_t value, std::size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+FrameSlab::FrameSlab(std::size_t slot_count, std::size_t slot_bytes)
+    : slot_count_(slot_count),
+      slot_bytes_(round_up(slot_bytes, kSlotAlignment)),
+      storage_(static_cast<std::byte*>(::operator new[](slot_count * round_up(slot_bytes, kSlotAlignment),
+                                                        std::align_val_t{kSlotAlignment}))),
+      released_(std::bit_ceil(slot_count + 1)),
+      holders_(slot_count, 1) {
+  if (slot_count == 0 || slot_count >= kNoSlabSlot) {
+    throw std::invalid_argument("FrameSlab slot count out of range");
+  }
+  recycled_.reserve(slot_count);
+  for (std::size_t i = slot_count; i > 0; --i) {
+    recycled_.push_back(static_cast<std::uint32_t>(i - 1));
+  }
+}
+
+std::uint32_t FrameSlab::acquire() noexcept {
+  if (!recycled_.empty()) {
+    const auto slot = recycled_.back();
+    recycled_.pop_back();
+    return slot;
+  }
+  std::uint32_t slot = kNoSlabSlot;
+  if (released_.pop(slot)) {
+    return slot;
+  }
+  return kNoSlabSlot;
+}
+
+void FrameSlab::recycle(std::uint32_t slot) noexcept {
+  recycled_.push_back(slot);
+}
+
+void FrameSlab::release(std::uint32_t slot) noexcept {
+  if (auto& holders = holders_[slot]; holders > 1) {
+    --holders;
+    return;
+  }
+  // The free ring is sized for every slot, so the push cannot fail.
+  (void)released_.push(slot);
+}
+
+OwnedFrame::OwnedFrame(OwnedFrame&& other) noexcept
+    : header(other.header),
+      payload(other.payload),
+      arrival_ns(other.arrival_ns),
+      times(other.times),
+      slab_(other.slab_),
+      slot_(other.slot_) {
+  other.slab_ = nullptr;
+  other.slot_ = kNoSlabSlot;
+  other.payload = {};
+}
+
+OwnedFrame& OwnedFrame::operator=(OwnedFrame&& other) noexcept {
+  if (this != &other) {
+    reset();
+    header = other.header;
+    payload = other.payload;
+    arrival_ns = other.arrival_ns;
+    times = other.times;
+    slab_ = other.slab_;
+    slot_ = other.slot_;
+    other.slab_ = nullptr;
+    other.slot_ = kNoSlabSlot;
+    other.payload = {};
+  }
+  return *this;
+}
+
+OwnedFrame::~OwnedFrame() {
+  reset();
+}
+
+void OwnedFrame::reset() noexcept {
+  if (slab_ && slot_ != kNoSlabSlot) {
+    slab_->release(slot_);
+  }
+  slab_ = nullptr;
+  slot_ = kNoSlabSlot;
+  payload = {};
+}
+
+void OwnedFrame::assign(const FrameHeader& frame_header, FrameSlab& slab, std::uint32_t slot,
+                        std::span<const std::byte> frame_payload) noexcept {
+  reset();
+  header = frame_header;
+  payload = frame_payload;
+  arrival_ns = 0;
+  times = {};
+  slab_ = &slab;
+  slot_ = slot;
+}
+
+}  // namespace ingest
+}  // namespace tradecore
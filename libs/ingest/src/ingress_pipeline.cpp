@@ -1,129 +1,718 @@
 #include "tradecore/ingest/ingress_pipeline.hpp"
 
 #include <algorithm>
+#include <cassert>
 #include <chrono>
+#include <cstring>
 #include <memory>
+#include <utility>
+
+#include "tradecore/ingest/transport.hpp"
 
 namespace tradecore {
 namespace ingest {
 
 namespace {
-constexpr common::TimestampNs kOneSecondNs = 1'000'000'000;
+// Slots beyond the queue depths: the frame the transport is receiving into
+// and frames the consumer still holds.
+constexpr std::size_t kSlabHeadroom = 64;
+// Submits between occupancy samples; each sample reads every ring's indices.
+constexpr std::uint32_t kOccupancySampleInterval = 16;
+
+std::unique_ptr<FrameSlab> make_slab(const IngressPipeline::Config& config) {
+  const auto slots = config.frame_slab_slots > 0
+                         ? config.frame_slab_slots
+                         : config.new_order_queue_depth + config.cancel_queue_depth +
+                               config.replace_queue_depth + 2 * config.priority_queue_depth + kSlabHeadroom;
+  const auto slot_bytes = config.frame_slot_bytes > 0 ? config.frame_slot_bytes : kReceiveHeadroom + kMaxWireFrameSize;
+  return std::make_unique<FrameSlab>(slots, slot_bytes);
+}
+
+RateLimiter::Config rate_limits(const IngressPipeline::Config& config) {
+  RateLimiter::Config limits{
+      .tiers = {RateTier{
+          .new_orders_per_second = config.max_new_orders_per_second,
+          .cancels_per_second = config.max_cancels_per_second,
+          .replaces_per_second = config.max_replaces_per_second,
+          .burst_ms = config.rate_burst_ms,
+      }},
+      .account_tiers = config.account_rate_tiers,
+      .capacity = config.rate_table_capacity,
+      .idle_timeout_ns = config.rate_idle_timeout_ns,
+  };
+  limits.tiers.insert(limits.tiers.end(), config.rate_tiers.begin(), config.rate_tiers.end());
+  return limits;
 }
 
-IngressPipeline::IngressPipeline()
-    : arena_(1 << 16),
-      rate_windows_(&arena_),
-      new_orders_(std::make_unique<common::SpscRing<OwnedFrame>>(1 << 12)),
-      cancels_(std::make_unique<common::SpscRing<OwnedFrame>>(1 << 12)),
-      replaces_(std::make_unique<common::SpscRing<OwnedFrame>>(1 << 12)) {}
+// Admission time on the monotonic clock: rate limiting must not trust the
+// client's wire timestamp, and the lane merge orders by it.
+common::TimestampNs admission_now() noexcept {
+  return static_cast<common::TimestampNs>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+}  // namespace
+
+IngressPipeline::Lane::Lane(const Config& config)
+    : replay_window(config.replay_window_capacity, config.replay_cold_capacity),
+      rate_limiter(rate_limits(config)),
+      slab(make_slab(config)),
+      new_orders(config.new_order_queue_depth),
+      cancels(config.cancel_queue_depth),
+      replaces(config.replace_queue_depth),
+      priority_new_orders(config.priority_queue_depth),
+      priority_replaces(config.priority_queue_depth),
+      batch_frames(kMaxBatchMessages) {}
 
-void IngressPipeline::configure(const Config& config, AuthVerifier verifier) {
+IngressPipeline::IngressPipeline() {
+  lanes_.push_back(std::make_unique<Lane>(config_));
+  refill_credits();
+}
+
+void IngressPipeline::configure(const Config& config, AuthVerifier verifier, BatchAuthVerifier batch_verifier) {
   config_ = config;
+  config_.lanes = std::max<std::size_t>(config.lanes, 1);
+  if (!verifier && batch_verifier) {
+    verifier = [batch_verifier](const FrameHeader& header, std::span<const std::byte> payload) {
+      const Frame frame{.header = header, .payload = payload};
+      bool valid = false;
+      batch_verifier(std::span<const Frame>(&frame, 1), std::span<bool>(&valid, 1));
+      return valid;
+    };
+  }
+  if (verifier && !batch_verifier) {
+    batch_verifier = [verifier](std::span<const Frame> frames, std::span<bool> valid) {
+      for (std::size_t i = 0; i < frames.size(); ++i) {
+        valid[i] = verifier(frames[i].header, frames[i].payload);
+      }
+    };
+  }
   verifier_ = std::move(verifier);
-  new_orders_ = std::make_unique<common::SpscRing<OwnedFrame>>(config.new_order_queue_depth);
-  cancels_ = std::make_unique<common::SpscRing<OwnedFrame>>(config.cancel_queue_depth);
-  replaces_ = std::make_unique<common::SpscRing<OwnedFrame>>(config.replace_queue_depth);
-  rate_windows_.clear();
-  stats_ = {};
+  verify_stage_.reset();
+  lanes_.clear();
+  for (std::size_t i = 0; i < config_.lanes; ++i) {
+    lanes_.push_back(std::make_unique<Lane>(config_));
+  }
+  if (verifier_ && config_.verify_workers > 0) {
+    verify_stage_ = std::make_unique<VerifyStage>(config_.lanes, config_.verify_batch, config_.signature_batch,
+                                                  config_.verify_workers, std::move(batch_verifier));
+  }
+  refill_credits();
 }
 
 bool IngressPipeline::submit(const Frame& frame) {
+  if (frame.lane >= lanes_.size()) {
+    // A slab slot belongs to an existing lane's slab, so only borrowed frames
+    // can name a lane this pipeline does not have; a slot here would leak.
+    assert(frame.slot == kNoSlabSlot);
+    return false;
+  }
+  auto& lane = *lanes_[frame.lane];
+  auto& stats = lane.stats;
+
+  // A whole batch frame from an in-process producer: unpack it here.
+  if (frame.header.kind == MessageKind::kBatch) {
+    const auto count = UdpTransport::unpack_batch(frame.header, frame.payload, lane.batch_frames);
+    if (count == 0) {
+      ++stats.dropped_malformed;
+      drop(lane, frame);
+      return false;
+    }
+    const auto frames = std::span<Frame>(lane.batch_frames).first(count);
+    for (auto& unpacked : frames) {
+      unpacked.slot = frame.slot;
+      unpacked.lane = frame.lane;
+      unpacked.times = frame.times;
+      unpacked.reply_to = frame.reply_to;
+    }
+    return submit(std::span<const Frame>(frames));
+  }
+
+  const auto now = admission_now();
   if (frame.header.kind == MessageKind::kHeartbeat) {
-    ++stats_.dropped_heartbeats;
+    ++stats.dropped_heartbeats;
+    drop(lane, frame);
     return true;
   }
 
-  if (verifier_ && !verifier_(frame.header, frame.payload)) {
-    ++stats_.rejected_auth;
+  if (shed(lane, std::span<const Frame>(&frame, 1))) {
+    reject(lane, frame, RejectReason::kShed);
+    drop(lane, frame);
     return false;
   }
 
-  auto [it, inserted] = rate_windows_.try_emplace(frame.header.account, AccountWindow{});
-  auto& window = it->second;
-  if (rate_limit(window, frame.header.kind, frame.header.received_time_ns)) {
-    ++stats_.rejected_rate_limit;
+  // The window lookup is a couple of cache lines, so duplicates are turned
+  // away before the signature check; the nonce is only recorded once the
+  // frame is authenticated and queued.
+  if (config_.replay_protection && !lane.replay_window.check(frame.header.account, frame.header.nonce)) {
+    reject(lane, frame, RejectReason::kReplay);
+    drop(lane, frame);
     return false;
   }
 
-  OwnedFrame owned{
-      .header = frame.header,
-      .payload = std::vector<std::byte>(frame.payload.begin(), frame.payload.end()),
-  };
+  if (verify_stage_) {
+    if (!stage_for_verify(lane, frame, now)) {
+      reject(lane, frame, RejectReason::kQueueFull);
+      return false;
+    }
+    return true;
+  }
 
-  bool pushed = false;
-  switch (frame.header.kind) {
-    case MessageKind::kNewOrder:
-      pushed = new_orders_->push(std::move(owned));
-      break;
+  if (!verifier_) {
+    return admit(lane, frame, now);
+  }
+  if (!verifier_(frame.header, frame.payload)) {
+    reject(lane, frame, RejectReason::kAuth);
+    drop(lane, frame);
+    return false;
+  }
+  Frame verified = frame;
+  verified.times.verified_ns = admission_now();
+  return admit(lane, verified, now);
+}
+
+bool IngressPipeline::submit(std::span<const Frame> frames) {
+  if (frames.empty()) {
+    return false;
+  }
+  const auto& first = frames.front();
+  if (first.batch.empty()) {
+    return submit(first);
+  }
+  if (first.lane >= lanes_.size()) {
+    assert(first.slot == kNoSlabSlot);
+    return false;
+  }
+  auto& lane = *lanes_[first.lane];
+  const auto count = frames.size();
+  const auto now = admission_now();
+
+  // The batch as one frame: the header its auth prefix signs and the payload
+  // from that prefix on.
+  Frame batch{.header = first.header,
+              .payload = first.batch,
+              .slot = first.slot,
+              .lane = first.lane,
+              .times = first.times,
+              .reply_to = first.reply_to};
+  batch.header.kind = MessageKind::kBatch;
+
+  if (shed(lane, frames)) {
+    reject(lane, batch, RejectReason::kShed, count);
+    drop(lane, batch);
+    return false;
+  }
+
+  if (config_.replay_protection) {
+    for (const auto& frame : frames) {
+      if (!lane.replay_window.check(frame.header.account, frame.header.nonce)) {
+        reject(lane, batch, RejectReason::kReplay, count);
+        drop(lane, batch);
+        return false;
+      }
+    }
+  }
+
+  // The stage verifies the batch as a single ticket; flush() unpacks it again
+  // from the slab copy.
+  if (verify_stage_) {
+    if (!stage_for_verify(lane, batch, now)) {
+      reject(lane, batch, RejectReason::kQueueFull, count);
+      return false;
+    }
+    return true;
+  }
+
+  if (!verifier_) {
+    return admit_batch(lane, frames, now, 0);
+  }
+  if (!verifier_(batch.header, batch.payload)) {
+    reject(lane, batch, RejectReason::kAuth, count);
+    drop(lane, batch);
+    return false;
+  }
+  return admit_batch(lane, frames, now, admission_now());
+}
+
+bool IngressPipeline::stage_for_verify(Lane& lane, const Frame& frame, common::TimestampNs now) {
+  // The payload must outlive submit() until the lane flushes, so borrowed
+  // buffers are copied into the slab up front.
+  Frame owned = frame;
+  if (owned.slot == kNoSlabSlot) {
+    auto& slab = *lane.slab;
+    if (frame.payload.size() > slab.slot_bytes()) {
+      return false;
+    }
+    owned.slot = slab.acquire();
+    if (owned.slot == kNoSlabSlot) {
+      return false;
+    }
+    const auto slot = slab.slot(owned.slot);
+    if (!frame.payload.empty()) {
+      std::memcpy(slot.data(), frame.payload.data(), frame.payload.size());
+    }
+    owned.payload = slot.first(frame.payload.size());
+  }
+  if (verify_stage_->full(frame.lane)) {
+    flush(frame.lane);
+  }
+  verify_stage_->enqueue(frame.lane, owned, now);
+  return true;
+}
+
+void IngressPipeline::flush(std::size_t lane_index) {
+  if (lane_index >= lanes_.size()) {
+    return;
+  }
+  auto& lane = *lanes_[lane_index];
+  sample_occupancy(lane);
+  if (!verify_stage_ || verify_stage_->empty(lane_index)) {
+    return;
+  }
+  verify_stage_->drain(lane_index, [&](const Frame& frame, const VerifyStage::Ticket& ticket, bool valid) {
+    if (verify_observer_) {
+      verify_observer_(std::chrono::nanoseconds(ticket.verified_ns - ticket.admitted_ns), ticket.queue_depth);
+    }
+    if (frame.header.kind == MessageKind::kBatch) {
+      commit_batch(lane, frame, valid, ticket);
+      return;
+    }
+    if (!valid) {
+      reject(lane, frame, RejectReason::kAuth);
+      drop(lane, frame);
+      return;
+    }
+    // Both copies of a duplicate can pass the pre-check while queued
+    // together; only the first to commit keeps its nonce.
+    if (config_.replay_protection && !lane.replay_window.check(frame.header.account, frame.header.nonce)) {
+      reject(lane, frame, RejectReason::kReplay, 1, true);
+      drop(lane, frame);
+      return;
+    }
+    Frame verified = frame;
+    verified.times.verified_ns = ticket.verified_ns;
+    admit(lane, verified, ticket.admitted_ns);
+  });
+}
+
+void IngressPipeline::commit_batch(Lane& lane, const Frame& batch, bool valid, const VerifyStage::Ticket& ticket) {
+  const auto count = UdpTransport::unpack_batch(batch.header, batch.payload, lane.batch_frames);
+  const auto frames = std::span<Frame>(lane.batch_frames).first(count);
+  if (!valid) {
+    reject(lane, batch, RejectReason::kAuth, std::max<std::size_t>(count, 1));
+    drop(lane, batch);
+    return;
+  }
+  if (count == 0) {
+    ++lane.stats.dropped_malformed;
+    drop(lane, batch);
+    return;
+  }
+  if (config_.replay_protection) {
+    for (const auto& frame : frames) {
+      if (!lane.replay_window.check(frame.header.account, frame.header.nonce)) {
+        reject(lane, batch, RejectReason::kReplay, count, true);
+        drop(lane, batch);
+        return;
+      }
+    }
+  }
+  for (auto& frame : frames) {
+    frame.slot = batch.slot;
+    frame.lane = batch.lane;
+    frame.times = batch.times;
+    frame.reply_to = batch.reply_to;
+  }
+  admit_batch(lane, frames, ticket.admitted_ns, ticket.verified_ns);
+}
+
+bool IngressPipeline::admit_batch(Lane& lane, std::span<const Frame> frames, common::TimestampNs now,
+                                  common::TimestampNs verified_ns) {
+  auto& stats = lane.stats;
+  const auto& first = frames.front();
+  const auto count = frames.size();
+  const bool authenticated = verified_ns != 0;
+  Frame batch{.header = first.header,
+              .payload = first.batch,
+              .slot = first.slot,
+              .lane = first.lane,
+              .reply_to = first.reply_to};
+  batch.header.kind = MessageKind::kBatch;
+
+  // Room for every message first, so no push below can fail part way. From
+  // the producer side size() can only overstate what is queued.
+  std::array<std::pair<Ring*, std::size_t>, 5> needed{};
+  for (const auto& frame : frames) {
+    auto* ring = &ring_for(lane, frame.header);
+    auto it = std::find_if(needed.begin(), needed.end(),
+                           [ring](const auto& entry) { return entry.first == ring || entry.first == nullptr; });
+    it->first = ring;
+    ++it->second;
+  }
+  for (const auto& [ring, messages] : needed) {
+    if (ring != nullptr && ring->capacity() - ring->size() < messages) {
+      reject(lane, batch, RejectReason::kQueueFull, count, authenticated);
+      drop(lane, batch);
+      return false;
+    }
+  }
+
+  if (!lane.rate_limiter.admit_batch(first.header.account, frames, now)) {
+    reject(lane, batch, RejectReason::kRateLimit, count, authenticated);
+    drop(lane, batch);
+    return false;
+  }
+
+  // Payload offsets are the same in the batch payload and in its slot, so a
+  // borrowed batch is copied once and every message points into the copy.
+  auto& slab = *lane.slab;
+  auto slot = first.slot;
+  const std::byte* base = nullptr;
+  if (slot != kNoSlabSlot) {
+    base = slab.slot(slot).data();
+  } else {
+    if (first.batch.size() > slab.slot_bytes()) {
+      reject(lane, batch, RejectReason::kQueueFull, count, authenticated);
+      return false;
+    }
+    slot = slab.acquire();
+    if (slot == kNoSlabSlot) {
+      reject(lane, batch, RejectReason::kQueueFull, count, authenticated);
+      return false;
+    }
+    std::memcpy(slab.slot(slot).data(), first.batch.data(), first.batch.size());
+    base = first.batch.data();
+  }
+  slab.share(slot, static_cast<std::uint32_t>(count));
+
+  for (const auto& frame : frames) {
+    SlotRef ref{
+        .header = frame.header,
+        .arrival_ns = now,
+        .times = frame.times,
+        .slot = slot,
+        .payload_offset = static_cast<std::uint32_t>(frame.payload.data() - base),
+        .payload_size = static_cast<std::uint32_t>(frame.payload.size()),
+    };
+    ref.times.verified_ns = verified_ns;
+    (void)ring_for(lane, frame.header).push(ref);
+    if (config_.replay_protection) {
+      lane.replay_window.accept(frame.header.account, frame.header.nonce, now);
+    }
+  }
+  stats.accepted += count;
+  return true;
+}
+
+IngressPipeline::Ring& IngressPipeline::ring_for(Lane& lane, const FrameHeader& header) noexcept {
+  const bool priority = classify(header) == PriorityClass::kPriority;
+  switch (header.kind) {
     case MessageKind::kCancel:
-      pushed = cancels_->push(std::move(owned));
-      break;
+      return lane.cancels;
     case MessageKind::kReplace:
-      pushed = replaces_->push(std::move(owned));
-      break;
+      return priority ? lane.priority_replaces : lane.replaces;
+    case MessageKind::kNewOrder:
     case MessageKind::kHeartbeat:
-      // handled earlier
+    case MessageKind::kBatch:
       break;
   }
+  return priority ? lane.priority_new_orders : lane.new_orders;
+}
+
+bool IngressPipeline::admit(Lane& lane, const Frame& frame, common::TimestampNs now) {
+  auto& stats = lane.stats;
+  const bool authenticated = frame.times.verified_ns != 0;
+  if (!lane.rate_limiter.admit(frame.header.account, frame.header.kind, now)) {
+    reject(lane, frame, RejectReason::kRateLimit, 1, authenticated);
+    drop(lane, frame);
+    return false;
+  }
+
+  auto& slab = *lane.slab;
+  SlotRef ref{.header = frame.header, .times = frame.times, .slot = frame.slot};
+  if (ref.slot != kNoSlabSlot) {
+    const auto slot = slab.slot(ref.slot);
+    if (!frame.payload.empty()) {
+      ref.payload_offset = static_cast<std::uint32_t>(frame.payload.data() - slot.data());
+    }
+    ref.payload_size = static_cast<std::uint32_t>(frame.payload.size());
+  } else {
+    // In-process producers hand over borrowed buffers: one copy into the slab.
+    if (frame.payload.size() > slab.slot_bytes()) {
+      reject(lane, frame, RejectReason::kQueueFull, 1, authenticated);
+      return false;
+    }
+    ref.slot = slab.acquire();
+    if (ref.slot == kNoSlabSlot) {
+      reject(lane, frame, RejectReason::kQueueFull, 1, authenticated);
+      return false;
+    }
+    if (!frame.payload.empty()) {
+      std::memcpy(slab.slot(ref.slot).data(), frame.payload.data(), frame.payload.size());
+    }
+    ref.payload_size = static_cast<std::uint32_t>(frame.payload.size());
+  }
+
+  ref.arrival_ns = now;
 
-  if (!pushed) {
-    ++stats_.rejected_queue_full;
+  // Heartbeats were dropped by submit() and batches unpacked, so every frame
+  // here has a ring.
+  if (!ring_for(lane, frame.header).push(ref)) {
+    slab.recycle(ref.slot);
+    reject(lane, frame, RejectReason::kQueueFull, 1, authenticated);
     return false;
   }
 
-  ++stats_.accepted;
+  if (config_.replay_protection) {
+    lane.replay_window.accept(frame.header.account, frame.header.nonce, now);
+  }
+  ++stats.accepted;
   return true;
 }
 
+IngressPipeline::PriorityClass IngressPipeline::classify(const FrameHeader& header) const noexcept {
+  if (header.kind == MessageKind::kCancel) {
+    return PriorityClass::kCancel;
+  }
+  return header.priority >= config_.priority_threshold ? PriorityClass::kPriority : PriorityClass::kStandard;
+}
+
+bool IngressPipeline::congested(std::size_t lane) const noexcept {
+  constexpr std::array<RingMember, 5> kRings{&Lane::cancels, &Lane::priority_new_orders, &Lane::priority_replaces,
+                                             &Lane::new_orders, &Lane::replaces};
+  const auto& state = *lanes_[lane];
+  for (const auto ring : kRings) {
+    const auto& queue = state.*ring;
+    const auto reserve = std::min(kMaxBatchMessages, queue.capacity() / 2);
+    if (queue.capacity() - queue.size() < reserve) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IngressPipeline::next(OwnedFrame& out) {
+  constexpr std::array kOrder{PriorityClass::kCancel, PriorityClass::kPriority, PriorityClass::kStandard};
+  if (config_.scheduling == Scheduling::kStrict) {
+    for (const auto priority_class : kOrder) {
+      if (pop_class(priority_class, out)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Two passes: if every class that still has credit is empty, refill and
+  // give the uncredited classes their turn, so the scheduler never idles
+  // while work is queued.
+  for (int pass = 0; pass < 2; ++pass) {
+    for (const auto priority_class : kOrder) {
+      auto& credit = credits_[static_cast<std::size_t>(priority_class)];
+      if (credit > 0 && pop_class(priority_class, out)) {
+        --credit;
+        return true;
+      }
+    }
+    refill_credits();
+  }
+  return false;
+}
+
 bool IngressPipeline::next_new_order(OwnedFrame& out) {
-  return new_orders_->pop(out);
+  constexpr std::array<RingMember, 2> kRings{&Lane::priority_new_orders, &Lane::new_orders};
+  return pop(kRings, out);
 }
 
 bool IngressPipeline::next_cancel(OwnedFrame& out) {
-  return cancels_->pop(out);
+  constexpr std::array<RingMember, 1> kRings{&Lane::cancels};
+  return pop(kRings, out);
 }
 
 bool IngressPipeline::next_replace(OwnedFrame& out) {
-  return replaces_->pop(out);
+  constexpr std::array<RingMember, 2> kRings{&Lane::priority_replaces, &Lane::replaces};
+  return pop(kRings, out);
 }
 
-void IngressPipeline::reset_stats() {
-  stats_ = {};
+bool IngressPipeline::pop_class(PriorityClass priority_class, OwnedFrame& out) {
+  switch (priority_class) {
+    case PriorityClass::kCancel:
+      return next_cancel(out);
+    case PriorityClass::kPriority: {
+      constexpr std::array<RingMember, 2> kRings{&Lane::priority_new_orders, &Lane::priority_replaces};
+      return pop(kRings, out);
+    }
+    case PriorityClass::kStandard: {
+      constexpr std::array<RingMember, 2> kRings{&Lane::new_orders, &Lane::replaces};
+      return pop(kRings, out);
+    }
+  }
+  return false;
 }
 
-bool IngressPipeline::rate_limit(AccountWindow& window, MessageKind kind, common::TimestampNs timestamp) {
-  if (timestamp - window.window_start >= kOneSecondNs) {
-    window.window_start = timestamp;
-    window.new_orders = 0;
-    window.cancels = 0;
-    window.replaces = 0;
+void IngressPipeline::refill_credits() noexcept {
+  for (std::size_t i = 0; i < kPriorityClassCount; ++i) {
+    credits_[i] = std::max<std::uint32_t>(config_.class_weights[i], 1);
   }
+}
 
-  switch (kind) {
-    case MessageKind::kNewOrder:
-      if (window.new_orders >= config_.max_new_orders_per_second) {
-        return true;
+bool IngressPipeline::pop(std::span<const RingMember> rings, OwnedFrame& out) {
+  // Deterministic merge: earliest admission first; ties go to the lowest
+  // lane, then to the earlier ring in `rings`.
+  Lane* source = nullptr;
+  RingMember source_ring = nullptr;
+  const SlotRef* earliest = nullptr;
+  for (const auto& lane : lanes_) {
+    for (const auto ring : rings) {
+      const auto* head = ((*lane).*ring).front();
+      if (head && (!earliest || head->arrival_ns < earliest->arrival_ns)) {
+        earliest = head;
+        source = lane.get();
+        source_ring = ring;
       }
-      ++window.new_orders;
+    }
+  }
+  if (!earliest) {
+    return false;
+  }
+
+  SlotRef ref;
+  if (!(source->*source_ring).pop(ref)) {
+    return false;
+  }
+  auto& slab = *source->slab;
+  const auto payload = slab.slot(ref.slot).subspan(ref.payload_offset, ref.payload_size);
+  out.assign(ref.header, slab, ref.slot, payload);
+  out.arrival_ns = ref.arrival_ns;
+  out.times = ref.times;
+  return true;
+}
+
+void IngressPipeline::drop(Lane& lane, const Frame& frame) {
+  if (frame.slot != kNoSlabSlot) {
+    lane.slab->recycle(frame.slot);
+  }
+}
+
+void IngressPipeline::reject(Lane& lane, const Frame& frame, RejectReason reason, std::size_t messages,
+                             bool authenticated) {
+  auto& stats = lane.stats;
+  switch (reason) {
+    case RejectReason::kAuth:
+      stats.rejected_auth += messages;
       break;
-    case MessageKind::kCancel:
-      if (window.cancels >= config_.max_cancels_per_second) {
-        return true;
-      }
-      ++window.cancels;
+    case RejectReason::kReplay:
+      stats.rejected_replay += messages;
       break;
-    case MessageKind::kReplace:
-      if (window.replaces >= config_.max_replaces_per_second) {
-        return true;
-      }
-      ++window.replaces;
+    case RejectReason::kRateLimit:
+      stats.rejected_rate_limit += messages;
       break;
-    case MessageKind::kHeartbeat:
+    case RejectReason::kQueueFull:
+      stats.rejected_queue_full += messages;
       break;
+    case RejectReason::kShed:
+      stats.rejected_shed += messages;
+      break;
+  }
+  if (reject_observer_) {
+    reject_observer_(frame, reason, messages, authenticated);
   }
+}
 
-  return false;
+bool IngressPipeline::shed(Lane& lane, std::span<const Frame> frames) {
+  if (lane.submits_to_sample == 0) {
+    sample_occupancy(lane);
+  }
+  --lane.submits_to_sample;
+  if (!lane.shedding) {
+    return false;
+  }
+  return std::all_of(frames.begin(), frames.end(), [this](const Frame& frame) {
+    return classify(frame.header) == PriorityClass::kStandard;
+  });
+}
+
+void IngressPipeline::sample_occupancy(Lane& lane) noexcept {
+  // By PriorityClass; the cancel class has a single ring.
+  constexpr std::array<std::array<RingMember, 2>, kPriorityClassCount> kClassRings{{
+      {&Lane::cancels, nullptr},
+      {&Lane::priority_new_orders, &Lane::priority_replaces},
+      {&Lane::new_orders, &Lane::replaces},
+  }};
+  std::size_t fill_pct = 0;
+  for (std::size_t c = 0; c < kPriorityClassCount; ++c) {
+    std::size_t depth = 0;
+    for (const auto ring : kClassRings[c]) {
+      if (ring == nullptr) {
+        continue;
+      }
+      const auto& queue = lane.*ring;
+      const auto size = queue.size();
+      depth += size;
+      fill_pct = std::max(fill_pct, size * 100 / queue.capacity());
+    }
+    // Only the lane writes its watermarks, so load-then-store cannot lose a rise.
+    if (depth > lane.high_watermark[c].load(std::memory_order_relaxed)) {
+      lane.high_watermark[c].store(depth, std::memory_order_relaxed);
+    }
+  }
+  lane.fill_pct.store(static_cast<std::uint8_t>(fill_pct), std::memory_order_relaxed);
+  lane.shedding = config_.shed_watermark_pct > 0 && fill_pct >= config_.shed_watermark_pct;
+  lane.submits_to_sample = kOccupancySampleInterval;
+}
+
+IngressPipeline::Stats IngressPipeline::stats() const noexcept {
+  Stats total{};
+  for (const auto& lane : lanes_) {
+    total.accepted += lane->stats.accepted;
+    total.rejected_auth += lane->stats.rejected_auth;
+    total.rejected_replay += lane->stats.rejected_replay;
+    total.rejected_rate_limit += lane->stats.rejected_rate_limit;
+    total.rejected_queue_full += lane->stats.rejected_queue_full;
+    total.rejected_shed += lane->stats.rejected_shed;
+    total.dropped_heartbeats += lane->stats.dropped_heartbeats;
+    total.dropped_malformed += lane->stats.dropped_malformed;
+    total.throttled_accounts += lane->rate_limiter.stats().throttled_accounts;
+  }
+  return total;
+}
+
+IngressPipeline::VerifyStats IngressPipeline::verify_stats() const noexcept {
+  if (!verify_stage_) {
+    return {};
+  }
+  const auto stage = verify_stage_->stats();
+  return {.verified = stage.verified, .failed = stage.failed, .queue_depth = stage.in_flight};
+}
+
+IngressPipeline::QueueStats IngressPipeline::queue_stats() const noexcept {
+  QueueStats total{};
+  for (const auto& lane : lanes_) {
+    const std::array<std::pair<const Ring*, PriorityClass>, 5> rings{{
+        {&lane->cancels, PriorityClass::kCancel},
+        {&lane->priority_new_orders, PriorityClass::kPriority},
+        {&lane->priority_replaces, PriorityClass::kPriority},
+        {&lane->new_orders, PriorityClass::kStandard},
+        {&lane->replaces, PriorityClass::kStandard},
+    }};
+    for (const auto& [ring, priority_class] : rings) {
+      const auto c = static_cast<std::size_t>(priority_class);
+      total.depth[c] += ring->size();
+      total.capacity[c] += ring->capacity();
+    }
+    for (std::size_t c = 0; c < kPriorityClassCount; ++c) {
+      total.high_watermark[c] += lane->high_watermark[c].load(std::memory_order_relaxed);
+    }
+  }
+  return total;
+}
+
+void IngressPipeline::reset_stats() {
+  for (auto& lane : lanes_) {
+    lane->stats = {};
+    for (auto& watermark : lane->high_watermark) {
+      watermark.store(0, std::memory_order_relaxed);
+    }
+  }
 }
 
 }  // namespace ingest
@@ -0,0 +1,459 @@
+#include "tradecore/ingest/io_uring_transport.hpp"
+
+#include <linux/io_uring.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tradecore/common/cpu.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+namespace {
+
+constexpr std::uint16_t kBufferGroup = 0;
+constexpr std::uint64_t kReceiveUserData = 1;
+constexpr std::uint64_t kCancelUserData = 2;
+constexpr std::uint64_t kProvideUserData = 3;
+// PROVIDE_BUFFERS user data carries the lent slot above the tag.
+constexpr unsigned kUserDataSlotShift = 32;
+constexpr std::uint64_t kUserDataTagMask = (std::uint64_t{1} << kUserDataSlotShift) - 1;
+constexpr std::size_t kMaxBufferEntries = 1 << 12;
+constexpr long long kWaitTimeoutNs = 100'000'000;  // 100ms, as SO_RCVTIMEO on the socket path
+// Buffer ids are 16 bits wide, so only slabs this small can be lent whole.
+constexpr std::size_t kMaxBufferId = 1 << 16;
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void* arg,
+                       std::size_t arg_size) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+template <typename T>
+T load_acquire(T* ptr) {
+  return std::atomic_ref<T>(*ptr).load(std::memory_order_acquire);
+}
+
+template <typename T>
+void store_release(T* ptr, T value) {
+  std::atomic_ref<T>(*ptr).store(value, std::memory_order_release);
+}
+
+// Raw io_uring instance driven by one thread: the submission queue is only
+// touched by that thread and completions are reaped in place.
+class Ring {
+ public:
+  Ring() = default;
+  Ring(const Ring&) = delete;
+  Ring& operator=(const Ring&) = delete;
+  ~Ring() { close(); }
+
+  bool open(unsigned sq_entries, unsigned cq_entries) {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP;
+    params.cq_entries = cq_entries;
+    fd_ = sys_io_uring_setup(sq_entries, &params);
+    if (fd_ < 0) {
+      fd_ = -1;
+      return false;
+    }
+    features_ = params.features;
+
+    sq_ring_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (features_ & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_bytes_ = cq_ring_bytes_ = std::max(sq_ring_bytes_, cq_ring_bytes_);
+    }
+
+    sq_ring_ = map(sq_ring_bytes_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_bytes_, IORING_OFF_CQ_RING);
+    sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(map(sqes_bytes_, IORING_OFF_SQES));
+    if (!sq_ring_ || !cq_ring_ || !sqes_) {
+      close();
+      return false;
+    }
+
+    auto* sq = static_cast<std::byte*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_tail_local_ = *sq_tail_;
+
+    auto* cq = static_cast<std::byte*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  void close() {
+    if (sqes_) {
+      munmap(sqes_, sqes_bytes_);
+      sqes_ = nullptr;
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_bytes_);
+    }
+    cq_ring_ = nullptr;
+    if (sq_ring_) {
+      munmap(sq_ring_, sq_ring_bytes_);
+      sq_ring_ = nullptr;
+    }
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  [[nodiscard]] int fd() const noexcept { return fd_; }
+  [[nodiscard]] unsigned features() const noexcept { return features_; }
+
+  // Zeroed SQE, or nullptr when the submission queue is full.
+  io_uring_sqe* next_sqe() {
+    if (sq_tail_local_ - load_acquire(sq_head_) >= sq_entries_) {
+      return nullptr;
+    }
+    const unsigned index = sq_tail_local_ & sq_mask_;
+    auto* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    ++sq_tail_local_;
+    ++pending_;
+    return sqe;
+  }
+
+  // Submits queued SQEs and, when `wait` is set, blocks for one completion
+  // or the wait timeout.
+  int enter(bool wait) {
+    store_release(sq_tail_, sq_tail_local_);
+    const unsigned to_submit = pending_;
+    pending_ = 0;
+    if (to_submit == 0 && !wait) {
+      return 0;
+    }
+
+    __kernel_timespec timeout{.tv_sec = 0, .tv_nsec = kWaitTimeoutNs};
+    io_uring_getevents_arg arg{};
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = reinterpret_cast<std::uint64_t>(&timeout);
+    const unsigned flags = IORING_ENTER_EXT_ARG | (wait ? IORING_ENTER_GETEVENTS : 0u);
+    return sys_io_uring_enter(fd_, to_submit, wait ? 1 : 0, flags, &arg, sizeof(arg));
+  }
+
+  [[nodiscard]] bool has_completions() const { return load_acquire(cq_tail_) != *cq_head_; }
+
+  template <typename Handler>
+  void reap(Handler&& handler) {
+    unsigned head = *cq_head_;
+    const unsigned tail = load_acquire(cq_tail_);
+    for (; head != tail; ++head) {
+      handler(cqes_[head & cq_mask_]);
+    }
+    store_release(cq_head_, head);
+  }
+
+ private:
+  void* map(std::size_t bytes, off_t offset) const {
+    void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+  }
+
+  int fd_{-1};
+  unsigned features_{0};
+  void* sq_ring_{nullptr};
+  void* cq_ring_{nullptr};
+  io_uring_sqe* sqes_{nullptr};
+  std::size_t sq_ring_bytes_{0};
+  std::size_t cq_ring_bytes_{0};
+  std::size_t sqes_bytes_{0};
+
+  unsigned* sq_head_{nullptr};
+  unsigned* sq_tail_{nullptr};
+  unsigned* sq_array_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned sq_entries_{0};
+  unsigned sq_tail_local_{0};
+  unsigned pending_{0};
+
+  unsigned* cq_head_{nullptr};
+  unsigned* cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe* cqes_{nullptr};
+};
+
+}  // namespace
+
+IoUringTransport::IoUringTransport(TransportOptions options) : UdpTransport(options) {}
+
+IoUringTransport::~IoUringTransport() {
+  // Join the lane threads while this object's receive_loop is still in place.
+  stop();
+}
+
+bool IoUringTransport::supported() {
+  static const bool probed = [] {
+    Ring ring;
+    constexpr unsigned kRequired = IORING_FEAT_EXT_ARG | IORING_FEAT_CQE_SKIP;
+    return ring.open(2, 4) && (ring.features() & kRequired) == kRequired;
+  }();
+  return probed;
+}
+
+std::string_view IoUringTransport::backend() const {
+  const auto fallback = fallback_lanes();
+  if (fallback == 0) {
+    return "io_uring";
+  }
+  if (fallback < lane_count()) {
+    return options_.receive_batch_size > 1 ? "io_uring+recvmmsg" : "io_uring+recvfrom";
+  }
+  return UdpTransport::backend();
+}
+
+bool IoUringTransport::start(const std::string& endpoint_uri, FrameCallback callback) {
+  fallback_lanes_.store(0, std::memory_order_relaxed);
+  return UdpTransport::start(endpoint_uri, std::move(callback));
+}
+
+void IoUringTransport::receive_loop(Lane& lane) {
+  if (!receive_uring(lane)) {
+    fallback_lanes_.fetch_add(1, std::memory_order_relaxed);
+    UdpTransport::receive_loop(lane);
+  }
+}
+
+bool IoUringTransport::receive_uring(Lane& lane) {
+  FrameSlab* slab = lane.slab;
+  if (!slab || slab->slot_count() < 2 || slab->slot_count() > kMaxBufferId ||
+      slab->slot_bytes() <= kReceiveHeadroom) {
+    return false;
+  }
+
+  // Keep about one batch worth of slots lent to the kernel; the rest of the
+  // slab stays available to the rings behind us.
+  const auto entries = static_cast<unsigned>(
+      std::min({std::bit_ceil(std::max<std::size_t>(options_.receive_batch_size, 8)), kMaxBufferEntries,
+                std::bit_floor(slab->slot_count() / 2)}));
+
+  // Room to re-lend every buffer plus the receive and its cancellation in one
+  // submission.
+  Ring ring;
+  if (!ring.open(entries * 2, entries * 4)) {
+    return false;
+  }
+
+  // Multishot recvmsg writes
+  //   [io_uring_recvmsg_out][source address][control data][datagram]
+  // into each buffer; everything ahead of the datagram fits in the slot
+  // headroom. The control data carries the kernel timestamp.
+  static_assert(sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in) + kTimestampControlSize <= kReceiveHeadroom,
+                "recvmsg metadata must fit the slot headroom");
+  sockaddr_in sender{};
+  msghdr message{};
+  message.msg_namelen = sizeof(sockaddr_in);
+  message.msg_controllen = options_.kernel_timestamps ? kTimestampControlSize : 0;
+  const std::size_t payload_offset = sizeof(io_uring_recvmsg_out) + message.msg_namelen + message.msg_controllen;
+
+  // Slots are lent with IORING_OP_PROVIDE_BUFFERS (buffer id = slot index).
+  // The SQEs ride along with the next io_uring_enter, so recycling a buffer
+  // costs no syscall of its own, and only failures post a completion.
+  std::vector<std::uint8_t> lent(slab->slot_count(), 0);
+  unsigned lent_count = 0;
+  auto lend = [&](std::uint32_t slot) {
+    auto* sqe = ring.next_sqe();
+    if (!sqe) {
+      ring.enter(false);
+      sqe = ring.next_sqe();
+    }
+    const auto buffer = slab->slot(slot);
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = 1;
+    sqe->addr = reinterpret_cast<std::uint64_t>(buffer.data());
+    sqe->len = static_cast<std::uint32_t>(buffer.size());
+    sqe->off = slot;
+    sqe->buf_group = kBufferGroup;
+    sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+    sqe->user_data = kProvideUserData | (std::uint64_t{slot} << kUserDataSlotShift);
+    lent[slot] = 1;
+    ++lent_count;
+  };
+  auto replenish = [&] {
+    while (lent_count < entries) {
+      const auto slot = slab->acquire();
+      if (slot == kNoSlabSlot) {
+        break;
+      }
+      lend(slot);
+    }
+  };
+
+  bool armed = false;
+  bool received_any = false;
+  bool unsupported = false;
+  auto arm = [&] {
+    auto* sqe = ring.next_sqe();
+    if (!sqe) {
+      return;
+    }
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = lane.socket_fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(&message);
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = kReceiveUserData;
+    armed = true;
+  };
+
+  // Returns the buffer's slot, or kNoSlabSlot if the completion carried none.
+  auto complete = [&](const io_uring_cqe& cqe) -> std::uint32_t {
+    if ((cqe.user_data & kUserDataTagMask) == kProvideUserData) {
+      // Only failures post a completion: the kernel refused the buffer, so
+      // the slot goes back to the slab for replenish() to lend again.
+      if (cqe.res < 0) {
+        const auto slot = static_cast<std::uint32_t>(cqe.user_data >> kUserDataSlotShift);
+        lent[slot] = 0;
+        --lent_count;
+        slab->recycle(slot);
+      }
+      return kNoSlabSlot;
+    }
+    if (cqe.user_data != kReceiveUserData) {
+      return kNoSlabSlot;
+    }
+    if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+      armed = false;
+    }
+    if (cqe.res < 0) {
+      // -ENOBUFS just means every lent slot is in use; the receive is re-armed
+      // once more are lent. -EINVAL before any datagram means the kernel has
+      // no multishot recvmsg (pre-6.0).
+      if (cqe.res == -EINVAL && !received_any) {
+        unsupported = true;
+      }
+      return kNoSlabSlot;
+    }
+    if ((cqe.flags & IORING_CQE_F_BUFFER) == 0) {
+      return kNoSlabSlot;
+    }
+    const std::uint32_t slot = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+    lent[slot] = 0;
+    --lent_count;
+    return slot;
+  };
+
+  replenish();
+  while (running_.load() && !unsupported) {
+    if (!armed && lent_count > 0) {
+      arm();
+    }
+    if (!armed) {
+      // Slab exhausted: datagrams wait in the socket buffer until the
+      // consumer hands slots back.
+      ring.enter(false);
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+      replenish();
+      continue;
+    }
+
+    // Spin mode only flushes submissions; completions are posted by task work
+    // while we poll the CQ ring from user space.
+    ring.enter(!options_.busy_poll && !ring.has_completions());
+    note_receive(lane);
+
+    std::uint64_t datagrams = 0;
+    ring.reap([&](const io_uring_cqe& cqe) {
+      const auto slot = complete(cqe);
+      if (slot == kNoSlabSlot) {
+        return;
+      }
+      received_any = true;
+      ++datagrams;
+
+      const auto buffer = slab->slot(slot);
+      const auto* header = reinterpret_cast<const io_uring_recvmsg_out*>(buffer.data());
+      bool taken = false;
+      if (static_cast<std::size_t>(cqe.res) < payload_offset) {
+        lane.frames_malformed.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        std::memcpy(&sender, buffer.data() + sizeof(io_uring_recvmsg_out),
+                    std::min<std::size_t>(header->namelen, sizeof(sender)));
+        note_peer(lane, sender);
+        msghdr control{};
+        control.msg_control = buffer.data() + sizeof(io_uring_recvmsg_out) + message.msg_namelen;
+        control.msg_controllen = header->controllen;
+        control.msg_flags = header->flags;
+        const bool truncated = (header->flags & MSG_TRUNC) != 0;
+        taken = deliver(lane, buffer.subspan(payload_offset), header->payloadlen, truncated, slot,
+                        kernel_timestamp(control), reply_handle(sender));
+      }
+      if (!taken) {
+        // Rejected or malformed: lend the same slot straight back.
+        lend(slot);
+      }
+    });
+
+    if (datagrams > 0) {
+      lane.receive_batches.fetch_add(1, std::memory_order_relaxed);
+      lane.datagrams_received.fetch_add(datagrams, std::memory_order_relaxed);
+      // Before replenish, so slots of frames rejected at flush are lent again.
+      end_batch(lane);
+    } else if (options_.busy_poll) {
+      common::cpu_relax();
+    }
+    replenish();
+  }
+
+  // Cancel the multishot receive and wait for its final completion so the
+  // kernel is done with every lent slot before they go back to the slab.
+  if (armed) {
+    if (auto* sqe = ring.next_sqe()) {
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->addr = kReceiveUserData;
+      sqe->user_data = kCancelUserData;
+    }
+    for (int attempts = 0; armed && attempts < 10; ++attempts) {
+      ring.enter(!ring.has_completions());
+      ring.reap([&](const io_uring_cqe& cqe) {
+        const auto slot = complete(cqe);
+        if (slot != kNoSlabSlot) {
+          slab->recycle(slot);
+        }
+      });
+    }
+  }
+  ring.close();
+  for (std::uint32_t slot = 0; slot < lent.size(); ++slot) {
+    if (lent[slot]) {
+      slab->recycle(slot);
+    }
+  }
+
+  // Kernels without multishot recvmsg continue on the socket loop.
+  return !unsupported;
+}
+
+}  // namespace ingest
+}  // namespace tradecore
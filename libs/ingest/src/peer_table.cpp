@@ -0,0 +1,96 @@
+#include "tradecore/ingest/peer_table.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace tradecore {
+namespace ingest {
+
+namespace {
+
+std::size_t home_slot(std::uint64_t key, unsigned shift) noexcept {
+  return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ULL) >> shift);
+}
+
+}  // namespace
+
+PeerTable::PeerTable(std::size_t capacity, common::TimestampNs liveness_ns) : liveness_ns_(liveness_ns) {
+  const auto slots = std::bit_ceil(std::max(capacity, kMaxProbe));
+  mask_ = slots - 1;
+  shift_ = 64 - static_cast<unsigned>(std::countr_zero(slots));
+  slots_ = std::make_unique<Slot[]>(slots);
+}
+
+bool PeerTable::expired(const Slot& slot, common::TimestampNs now_ns) const noexcept {
+  return now_ns - slot.last_seen_ns.load(std::memory_order_relaxed) > liveness_ns_;
+}
+
+void PeerTable::touch(std::uint64_t peer, common::TimestampNs now_ns, std::size_t& sweep_cursor) noexcept {
+  const auto key = peer + 2;
+  const auto home = home_slot(key, shift_);
+
+  // The key may sit anywhere in the probe window, so look through all of it
+  // (up to the first empty slot) before claiming a free one.
+  Slot* free_slot = nullptr;
+  std::uint64_t free_key = kEmpty;
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    Slot& slot = slots_[(home + probe) & mask_];
+    const auto current = slot.key.load(std::memory_order_relaxed);
+    if (current == key) {
+      if (now_ns - slot.last_seen_ns.load(std::memory_order_relaxed) >= kRefreshNs) {
+        slot.last_seen_ns.store(now_ns, std::memory_order_relaxed);
+      }
+      sweep(now_ns, sweep_cursor);
+      return;
+    }
+    const bool reusable = current == kEmpty || current == kTombstone || expired(slot, now_ns);
+    if (reusable && free_slot == nullptr) {
+      free_slot = &slot;
+      free_key = current;
+    }
+    if (current == kEmpty) {
+      break;
+    }
+  }
+
+  // The time goes in first so a sweep never sees the new key with the old
+  // occupant's time. Losing the race to another thread is fine unless it
+  // claimed the slot for this same peer, which then counts already.
+  if (free_slot != nullptr) {
+    free_slot->last_seen_ns.store(now_ns, std::memory_order_relaxed);
+    free_slot->key.compare_exchange_strong(free_key, key, std::memory_order_relaxed);
+  }
+  sweep(now_ns, sweep_cursor);
+}
+
+void PeerTable::sweep(common::TimestampNs now_ns, std::size_t& cursor) noexcept {
+  for (std::size_t step = 0; step < kSweepStep; ++step) {
+    Slot& slot = slots_[cursor & mask_];
+    ++cursor;
+    auto current = slot.key.load(std::memory_order_relaxed);
+    if (current != kEmpty && current != kTombstone && expired(slot, now_ns)) {
+      slot.key.compare_exchange_strong(current, kTombstone, std::memory_order_relaxed);
+    }
+  }
+}
+
+std::size_t PeerTable::live(common::TimestampNs now_ns) const noexcept {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i <= mask_; ++i) {
+    const auto key = slots_[i].key.load(std::memory_order_relaxed);
+    if (key != kEmpty && key != kTombstone && !expired(slots_[i], now_ns)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void PeerTable::clear() noexcept {
+  for (std::size_t i = 0; i <= mask_; ++i) {
+    slots_[i].key.store(kEmpty, std::memory_order_relaxed);
+    slots_[i].last_seen_ns.store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -1,9 +1,37 @@
 #include "tradecore/ingest/quic_transport.hpp"
 
+#include "tradecore/ingest/io_uring_transport.hpp"
+#include "tradecore/ingest/shm_transport.hpp"
+#include "tradecore/ingest/tcp_transport.hpp"
+
 namespace tradecore {
 namespace ingest {
 
-QuicTransport::QuicTransport() : transport_(std::make_unique<UdpTransport>()) {}
+namespace {
+
+std::unique_ptr<Transport> make_udp_transport(const TransportOptions& options) {
+  if (options.io_uring && IoUringTransport::supported()) {
+    return std::make_unique<IoUringTransport>(options);
+  }
+  return std::make_unique<UdpTransport>(options);
+}
+
+std::unique_ptr<Transport> make_transport(std::string_view endpoint_uri, TransportOptions options) {
+  if (!ShmTransport::ring_name(endpoint_uri).empty()) {
+    return std::make_unique<ShmTransport>(std::move(options));
+  }
+  if (TcpTransport::handles(endpoint_uri)) {
+    return std::make_unique<TcpTransport>(std::move(options));
+  }
+  return make_udp_transport(options);
+}
+
+}  // namespace
+
+QuicTransport::QuicTransport(TransportOptions options) : transport_(make_udp_transport(options)) {}
+
+QuicTransport::QuicTransport(std::string_view endpoint_uri, TransportOptions options)
+    : transport_(make_transport(endpoint_uri, std::move(options))) {}
 
 QuicTransport::~QuicTransport() {
   stop();
@@ -25,6 +53,40 @@ bool QuicTransport::is_running() const {
   return transport_ && transport_->is_running();
 }
 
+std::string_view QuicTransport::backend() const {
+  return transport_ ? transport_->backend() : std::string_view{};
+}
+
+bool QuicTransport::stream() const {
+  return transport_ && transport_->stream();
+}
+
+std::size_t QuicTransport::lane_count() const {
+  return transport_ ? transport_->lane_count() : 1;
+}
+
+void QuicTransport::attach_slab(std::size_t lane, FrameSlab* slab) {
+  if (transport_) {
+    transport_->attach_slab(lane, slab);
+  }
+}
+
+void QuicTransport::set_batch_callback(Transport::BatchCallback callback) {
+  if (transport_) {
+    transport_->set_batch_callback(std::move(callback));
+  }
+}
+
+void QuicTransport::set_pressure_callback(Transport::PressureCallback callback) {
+  if (transport_) {
+    transport_->set_pressure_callback(std::move(callback));
+  }
+}
+
+bool QuicTransport::reply(const Frame& frame, std::span<const std::byte> message) {
+  return transport_ && transport_->reply(frame, message);
+}
+
 TransportStats QuicTransport::stats() const {
   if (transport_) {
     return transport_->stats();
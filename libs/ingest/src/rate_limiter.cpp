@@ -0,0 +1,192 @@
+#include "tradecore/ingest/rate_limiter.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace tradecore {
+namespace ingest {
+
+namespace {
+
+constexpr common::TimestampNs kOneSecondNs = 1'000'000'000;
+
+std::size_t kind_index(MessageKind kind) noexcept {
+  switch (kind) {
+    case MessageKind::kNewOrder:
+      return 0;
+    case MessageKind::kCancel:
+      return 1;
+    case MessageKind::kReplace:
+      return 2;
+    case MessageKind::kHeartbeat:
+    case MessageKind::kBatch:
+      break;
+  }
+  return 0;
+}
+
+// Fibonacci hashing: the top bits of the product spread sequential account
+// ids across the table.
+std::size_t home_slot(common::AccountId account, unsigned shift) noexcept {
+  return static_cast<std::size_t>((account * 0x9e3779b97f4a7c15ULL) >> shift);
+}
+
+}  // namespace
+
+RateLimiter::RateLimiter(Config config)
+    : account_tiers_(std::move(config.account_tiers)), idle_timeout_ns_(config.idle_timeout_ns) {
+  if (config.tiers.empty() || config.tiers.size() > 256) {
+    throw std::invalid_argument("RateLimiter needs between 1 and 256 tiers");
+  }
+  for (const auto& tier : config.tiers) {
+    const std::uint32_t rates[kKinds] = {tier.new_orders_per_second, tier.cancels_per_second,
+                                         tier.replaces_per_second};
+    TierLimits limits{};
+    for (std::size_t k = 0; k < kKinds; ++k) {
+      if (rates[k] == 0) {
+        throw std::invalid_argument("RateLimiter rates must be greater than zero");
+      }
+      limits.interval_ns[k] = std::max<common::TimestampNs>(kOneSecondNs / rates[k], 1);
+      const auto burst = std::max<std::uint64_t>(static_cast<std::uint64_t>(rates[k]) * tier.burst_ms / 1000, 1);
+      limits.tolerance_ns[k] = static_cast<common::TimestampNs>(burst - 1) * limits.interval_ns[k];
+    }
+    tiers_.push_back(limits);
+  }
+  for (const auto& [account, tier] : account_tiers_) {
+    if (tier >= tiers_.size()) {
+      throw std::invalid_argument("RateLimiter account tier out of range");
+    }
+  }
+  const auto capacity = std::bit_ceil(std::max(config.capacity, kMaxProbe));
+  mask_ = capacity - 1;
+  shift_ = 64 - static_cast<unsigned>(std::countr_zero(capacity));
+  entries_ = std::make_unique<Entry[]>(capacity);
+}
+
+bool RateLimiter::admit(common::AccountId account, MessageKind kind, common::TimestampNs now_ns) noexcept {
+  if (kind == MessageKind::kHeartbeat) {
+    return true;
+  }
+  Entry* entry = find_or_insert(account, now_ns);
+  if (entry == nullptr) {
+    ++stats_.overflows;
+    return true;
+  }
+  entry->last_seen_ns = now_ns;
+
+  // GCRA: admit while the theoretical arrival time is no further ahead of
+  // now than the burst tolerance, then push it out by one interval.
+  const auto k = kind_index(kind);
+  const auto& limits = tiers_[entry->tier];
+  const auto tat = std::max(entry->tat_ns[k], now_ns);
+  if (tat - now_ns > limits.tolerance_ns[k]) {
+    throttle(*entry, 1);
+    return false;
+  }
+  entry->tat_ns[k] = tat + limits.interval_ns[k];
+  return true;
+}
+
+bool RateLimiter::admit_batch(common::AccountId account, std::span<const Frame> frames,
+                              common::TimestampNs now_ns) noexcept {
+  common::TimestampNs counts[kKinds]{};
+  for (const auto& frame : frames) {
+    if (frame.header.kind != MessageKind::kHeartbeat) {
+      ++counts[kind_index(frame.header.kind)];
+    }
+  }
+  Entry* entry = find_or_insert(account, now_ns);
+  if (entry == nullptr) {
+    ++stats_.overflows;
+    return true;
+  }
+  entry->last_seen_ns = now_ns;
+
+  // n messages fit when the last of them would: the bucket's arrival time
+  // after n - 1 intervals is still within the burst tolerance.
+  const auto& limits = tiers_[entry->tier];
+  common::TimestampNs tat[kKinds];
+  for (std::size_t k = 0; k < kKinds; ++k) {
+    tat[k] = std::max(entry->tat_ns[k], now_ns);
+    if (counts[k] > 0 && tat[k] + (counts[k] - 1) * limits.interval_ns[k] - now_ns > limits.tolerance_ns[k]) {
+      throttle(*entry, static_cast<std::uint32_t>(frames.size()));
+      return false;
+    }
+  }
+  for (std::size_t k = 0; k < kKinds; ++k) {
+    if (counts[k] > 0) {
+      entry->tat_ns[k] = tat[k] + counts[k] * limits.interval_ns[k];
+    }
+  }
+  return true;
+}
+
+void RateLimiter::throttle(Entry& entry, std::uint32_t messages) noexcept {
+  if (entry.throttled == 0) {
+    ++stats_.throttled_accounts;
+  }
+  entry.throttled += messages;
+  stats_.throttled += messages;
+}
+
+RateLimiter::Entry* RateLimiter::find_or_insert(common::AccountId account, common::TimestampNs now_ns) noexcept {
+  const auto home = home_slot(account, shift_);
+  Entry* reusable = nullptr;
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    Entry& entry = entries_[(home + probe) & mask_];
+    if (!entry.used) {
+      // End of the chain: the account is not tracked.
+      if (reusable == nullptr) {
+        reusable = &entry;
+      }
+      break;
+    }
+    if (entry.account == account) {
+      return &entry;
+    }
+    if (reusable == nullptr && now_ns - entry.last_seen_ns >= idle_timeout_ns_) {
+      reusable = &entry;
+    }
+  }
+  if (reusable == nullptr) {
+    return nullptr;
+  }
+
+  // Entries are reused in place and never emptied, so probe chains stay
+  // intact without tombstones.
+  if (reusable->used) {
+    ++stats_.evictions;
+    if (reusable->throttled > 0) {
+      --stats_.throttled_accounts;
+    }
+  } else {
+    ++stats_.tracked;
+  }
+  std::uint8_t tier = 0;
+  if (!account_tiers_.empty()) {
+    if (const auto it = account_tiers_.find(account); it != account_tiers_.end()) {
+      tier = it->second;
+    }
+  }
+  *reusable = Entry{.account = account, .last_seen_ns = now_ns, .tier = tier, .used = true};
+  return reusable;
+}
+
+std::vector<std::pair<common::AccountId, std::uint32_t>> RateLimiter::top_throttled(std::size_t limit) const {
+  std::vector<std::pair<common::AccountId, std::uint32_t>> accounts;
+  for (std::size_t i = 0; i <= mask_; ++i) {
+    const auto& entry = entries_[i];
+    if (entry.used && entry.throttled > 0) {
+      accounts.emplace_back(entry.account, entry.throttled);
+    }
+  }
+  const auto count = std::min(limit, accounts.size());
+  std::partial_sort(accounts.begin(), accounts.begin() + static_cast<std::ptrdiff_t>(count), accounts.end(),
+                    [](const auto& a, const auto& b) { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+  accounts.resize(count);
+  return accounts;
+}
+
+}  // namespace ingest
+}  // namespace tradecore
@@ -0,0 +1,175 @@
+#include "tradecore/ingest/replay_window.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace tradecore {
+namespace ingest {
+
+namespace {
+
+std::size_t home_slot(common::AccountId account, unsigned shift) noexcept {
+  return static_cast<std::size_t>((account * 0x9e3779b97f4a7c15ULL) >> shift);
+}
+
+}  // namespace
+
+ReplayWindow::ReplayWindow(std::size_t capacity, std::size_t cold_capacity) {
+  const auto slots = std::bit_ceil(std::max(capacity, kMaxProbe));
+  mask_ = slots - 1;
+  shift_ = 64 - static_cast<unsigned>(std::countr_zero(slots));
+  entries_ = std::make_unique<Entry[]>(slots);
+
+  const auto cold_slots = std::bit_ceil(std::max(cold_capacity > 0 ? cold_capacity : 4 * slots, kMaxProbe));
+  cold_mask_ = cold_slots - 1;
+  cold_shift_ = 64 - static_cast<unsigned>(std::countr_zero(cold_slots));
+  retired_ = std::make_unique<Retired[]>(cold_slots);
+}
+
+bool ReplayWindow::check(common::AccountId account, std::uint64_t nonce) const noexcept {
+  if (const auto* entry = find(account)) {
+    return !seen(*entry, nonce);
+  }
+  if (stats_.retired > 0) {
+    if (const auto* retired = find_retired(account)) {
+      return nonce > retired->top;
+    }
+  }
+  return true;
+}
+
+void ReplayWindow::accept(common::AccountId account, std::uint64_t nonce, common::TimestampNs now_ns) {
+  auto* entry = const_cast<Entry*>(find(account));
+  if (entry == nullptr) {
+    entry = &insert(account, now_ns);
+  }
+  entry->last_seen_ns = now_ns;
+  mark(*entry, nonce);
+}
+
+const ReplayWindow::Entry* ReplayWindow::find(common::AccountId account) const noexcept {
+  const auto home = home_slot(account, shift_);
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    const Entry& entry = entries_[(home + probe) & mask_];
+    if (!entry.used) {
+      return nullptr;
+    }
+    if (entry.account == account) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+ReplayWindow::Entry& ReplayWindow::insert(common::AccountId account, common::TimestampNs now_ns) {
+  const auto home = home_slot(account, shift_);
+  Entry* target = nullptr;
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    Entry& entry = entries_[(home + probe) & mask_];
+    if (!entry.used) {
+      target = &entry;
+      ++stats_.tracked;
+      break;
+    }
+    if (target == nullptr || entry.last_seen_ns < target->last_seen_ns) {
+      target = &entry;
+    }
+  }
+
+  // Entries are overwritten in place and never emptied, so probe chains stay
+  // intact; the evicted account's top nonce moves to the cold table.
+  if (target->used) {
+    retire(target->account, target->top);
+    ++stats_.evictions;
+  }
+  *target = Entry{.account = account, .last_seen_ns = now_ns, .used = true};
+  if (stats_.retired > 0) {
+    if (auto* retired = const_cast<Retired*>(find_retired(account))) {
+      // Without the evicted bitmap, treat everything up to the old top as used.
+      target->top = retired->top;
+      std::fill(std::begin(target->bits), std::end(target->bits), ~std::uint64_t{0});
+      *retired = Retired{};
+      --stats_.retired;
+      ++stats_.restored;
+    }
+  }
+  return *target;
+}
+
+const ReplayWindow::Retired* ReplayWindow::find_retired(common::AccountId account) const noexcept {
+  const auto home = home_slot(account, cold_shift_);
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    const Retired& retired = retired_[(home + probe) & cold_mask_];
+    if (retired.used && retired.account == account) {
+      return &retired;
+    }
+  }
+  return nullptr;
+}
+
+void ReplayWindow::retire(common::AccountId account, std::uint64_t top) noexcept {
+  // An account is parked at most once: it leaves the cold table when it is
+  // restored, before it can be evicted again.
+  const auto home = home_slot(account, cold_shift_);
+  Retired* target = nullptr;
+  for (std::size_t probe = 0; probe < kMaxProbe; ++probe) {
+    Retired& retired = retired_[(home + probe) & cold_mask_];
+    if (!retired.used) {
+      target = &retired;
+      ++stats_.retired;
+      break;
+    }
+    if (target == nullptr || retired.top < target->top) {
+      target = &retired;
+    }
+  }
+  if (target->used) {
+    ++stats_.cold_overflows;
+  }
+  *target = Retired{.account = account, .top = top, .used = true};
+}
+
+bool ReplayWindow::seen(const Entry& entry, std::uint64_t nonce) noexcept {
+  if (nonce > entry.top) {
+    return false;
+  }
+  const auto offset = entry.top - nonce;
+  if (offset >= kWindowBits) {
+    return true;
+  }
+  return (entry.bits[offset / 64] >> (offset % 64)) & 1U;
+}
+
+void ReplayWindow::mark(Entry& entry, std::uint64_t nonce) noexcept {
+  if (nonce <= entry.top) {
+    const auto offset = entry.top - nonce;
+    if (offset < kWindowBits) {
+      entry.bits[offset / 64] |= std::uint64_t{1} << (offset % 64);
+    }
+    return;
+  }
+
+  // Slide the window up: bit i moves to bit i + shift.
+  const auto shift = nonce - entry.top;
+  if (shift >= kWindowBits) {
+    std::fill(std::begin(entry.bits), std::end(entry.bits), 0);
+  } else {
+    const auto word_shift = static_cast<std::size_t>(shift / 64);
+    const auto bit_shift = static_cast<unsigned>(shift % 64);
+    for (std::size_t w = kWords; w-- > 0;) {
+      std::uint64_t value = 0;
+      if (w >= word_shift) {
+        value = entry.bits[w - word_shift] << bit_shift;
+        if (bit_shift != 0 && w > word_shift) {
+          value |= entry.bits[w - word_shift - 1] >> (64 - bit_shift);
+        }
+      }
+      entry.bits[w] = value;
+    }
+  }
+  entry.bits[0] |= 1;
+  entry.top = nonce;
+}
+
+}  // namespace ingest
+}  // namespace tradecore
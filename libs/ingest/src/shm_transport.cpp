@@ -0,0 +1,406 @@
+#include "tradecore/ingest/shm_transport.hpp"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#include "tradecore/common/cpu.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+namespace {
+
+constexpr std::string_view kScheme = "shm://";
+constexpr std::uint32_t kRingMagic = 0x54524453;  // "TRDS"
+constexpr std::uint32_t kRingVersion = 1;
+// Length word of a record that skips the rest of the lap; records never
+// straddle the end of the ring.
+constexpr std::uint32_t kWrapMarker = 0xffffffff;
+constexpr std::size_t kRecordAlign = 8;
+// Empty polls that yield the CPU before the thread starts napping, so a
+// client that sends in bursts is picked up without a timer wakeup.
+constexpr std::uint32_t kIdleYields = 1024;
+constexpr auto kIdleSleep = std::chrono::microseconds(50);
+
+// Mapped at the start of every ring file; the data area follows. Positions
+// are free-running byte counts. Both processes operate on these atomics, so
+// they must be address-free.
+struct RingHeader {
+  std::uint32_t magic{kRingMagic};
+  std::uint32_t version{kRingVersion};
+  std::uint64_t capacity{0};
+  // Pid of the client holding the ring, 0 when free.
+  alignas(common::kCacheLineSize) std::atomic<std::int64_t> owner_pid{0};
+  alignas(common::kCacheLineSize) std::atomic<std::uint64_t> head{0};
+  alignas(common::kCacheLineSize) std::atomic<std::uint64_t> tail{0};
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::int64_t>::is_always_lock_free,
+              "ring positions are shared across processes");
+
+RingHeader& header_of(void* mapping) noexcept {
+  return *static_cast<RingHeader*>(mapping);
+}
+
+std::byte* data_of(void* mapping) noexcept {
+  return static_cast<std::byte*>(mapping) + sizeof(RingHeader);
+}
+
+// A record is [length:4][datagram] padded to kRecordAlign.
+std::uint64_t record_size(std::size_t length) noexcept {
+  return (sizeof(std::uint32_t) + length + kRecordAlign - 1) & ~(kRecordAlign - 1);
+}
+
+std::string ring_path(std::string_view name, std::size_t index) {
+  return "/" + std::string(name) + "." + std::to_string(index);
+}
+
+common::TimestampNs steady_now() noexcept {
+  return static_cast<common::TimestampNs>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+}  // namespace
+
+ShmTransport::ShmTransport(TransportOptions options) : options_(std::move(options)) {
+  // The ring must hold the largest record with room to wrap.
+  options_.shm_ring_bytes = std::bit_ceil(std::max<std::size_t>(options_.shm_ring_bytes, 4 * kMaxWireFrameSize));
+  options_.shm_clients = std::max<std::size_t>(options_.shm_clients, 1);
+  scratch_.resize(kMaxWireFrameSize);
+}
+
+ShmTransport::~ShmTransport() {
+  stop();
+}
+
+std::string_view ShmTransport::ring_name(std::string_view endpoint_uri) noexcept {
+  if (!endpoint_uri.starts_with(kScheme)) {
+    return {};
+  }
+  const auto name = endpoint_uri.substr(kScheme.size());
+  return name.find('/') == std::string_view::npos ? name : std::string_view{};
+}
+
+bool ShmTransport::start(const std::string& endpoint_uri, FrameCallback callback) {
+  if (running_.load()) {
+    return false;
+  }
+  const auto name = ring_name(endpoint_uri);
+  if (name.empty()) {
+    return false;
+  }
+  for (const int cpu : options_.receive_cpus) {
+    if (cpu >= 0 && !common::cpu_available(cpu)) {
+      return false;
+    }
+  }
+
+  // Rings left behind by an earlier run are replaced, so a client still
+  // holding one has to reconnect.
+  const auto capacity = static_cast<std::uint64_t>(options_.shm_ring_bytes);
+  const auto length = sizeof(RingHeader) + static_cast<std::size_t>(capacity);
+  for (std::size_t i = 0; i < options_.shm_clients; ++i) {
+    Ring ring{.path = ring_path(name, i), .length = length, .capacity = capacity};
+    shm_unlink(ring.path.c_str());
+    const int fd = shm_open(ring.path.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+      unmap();
+      return false;
+    }
+    void* mapping = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(length)) == 0) {
+      mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) {
+      shm_unlink(ring.path.c_str());
+      unmap();
+      return false;
+    }
+    ring.mapping = mapping;
+    new (mapping) RingHeader{.capacity = capacity};
+    rings_.push_back(std::move(ring));
+  }
+
+  callback_ = std::move(callback);
+  running_.store(true);
+  thread_ = std::thread(&ShmTransport::receive_loop, this);
+  return true;
+}
+
+void ShmTransport::stop() {
+  running_.store(false);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  unmap();
+  callback_ = nullptr;
+}
+
+void ShmTransport::unmap() {
+  for (auto& ring : rings_) {
+    munmap(ring.mapping, ring.length);
+    shm_unlink(ring.path.c_str());
+  }
+  rings_.clear();
+}
+
+bool ShmTransport::is_running() const {
+  return running_.load();
+}
+
+TransportStats ShmTransport::stats() const {
+  TransportStats stats{
+      .bytes_received = bytes_received_.load(std::memory_order_relaxed),
+      .frames_received = frames_received_.load(std::memory_order_relaxed),
+      .batches_received = batches_received_.load(std::memory_order_relaxed),
+      .frames_malformed = frames_malformed_.load(std::memory_order_relaxed),
+      .receive_batches = receive_batches_.load(std::memory_order_relaxed),
+      .datagrams_received = datagrams_received_.load(std::memory_order_relaxed),
+  };
+  for (const auto& ring : rings_) {
+    if (header_of(ring.mapping).owner_pid.load(std::memory_order_relaxed) != 0) {
+      ++stats.connections_active;
+    }
+  }
+  return stats;
+}
+
+void ShmTransport::attach_slab(std::size_t lane, FrameSlab* slab) {
+  if (!running_.load() && lane == 0) {
+    slab_ = slab;
+  }
+}
+
+void ShmTransport::set_batch_callback(BatchCallback callback) {
+  if (!running_.load()) {
+    batch_callback_ = std::move(callback);
+  }
+}
+
+void ShmTransport::set_pressure_callback(PressureCallback callback) {
+  if (!running_.load()) {
+    pressure_callback_ = std::move(callback);
+  }
+}
+
+void ShmTransport::receive_loop() {
+  if (!options_.receive_cpus.empty()) {
+    common::pin_current_thread(options_.receive_cpus.front());
+  }
+  std::uint32_t idle = 0;
+  bool paused = false;
+  while (running_.load(std::memory_order_relaxed)) {
+    if (pressure_callback_ && pressure_callback_(0)) {
+      if (!paused) {
+        paused = true;
+        backpressure_pauses_.fetch_add(1, std::memory_order_relaxed);
+      }
+      // Flushing may be what frees the rings (frames parked for verification).
+      if (batch_callback_) {
+        batch_callback_(0);
+      }
+      if (options_.busy_poll) {
+        common::cpu_relax();
+      } else {
+        std::this_thread::sleep_for(kIdleSleep);
+      }
+      continue;
+    }
+    paused = false;
+    std::size_t datagrams = 0;
+    for (auto& ring : rings_) {
+      datagrams += drain(ring);
+    }
+    if (datagrams > 0) {
+      idle = 0;
+      receive_batches_.fetch_add(1, std::memory_order_relaxed);
+      datagrams_received_.fetch_add(datagrams, std::memory_order_relaxed);
+      if (batch_callback_) {
+        batch_callback_(0);
+      }
+    } else if (options_.busy_poll) {
+      common::cpu_relax();
+    } else if (++idle < kIdleYields) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(kIdleSleep);
+    }
+  }
+}
+
+std::size_t ShmTransport::drain(Ring& ring) {
+  auto& header = header_of(ring.mapping);
+  const auto head = header.head.load(std::memory_order_acquire);
+  auto tail = ring.tail;
+  if (head == tail) {
+    return 0;
+  }
+
+  // The client can write anything into its mapping, so every record is
+  // bounds-checked against our own capacity; a bad one drains the ring.
+  const auto* data = data_of(ring.mapping);
+  const auto received_ns = steady_now();
+  std::size_t datagrams = 0;
+  bool corrupt = head - tail > ring.capacity;
+  while (!corrupt && tail != head) {
+    const auto offset = tail & (ring.capacity - 1);
+    std::uint32_t length = 0;
+    std::memcpy(&length, data + offset, sizeof(length));
+    const auto record = length == kWrapMarker ? ring.capacity - offset : record_size(length);
+    if (head - tail < record ||
+        (length != kWrapMarker && (length == 0 || length > kMaxWireFrameSize || offset + record > ring.capacity))) {
+      corrupt = true;
+      break;
+    }
+    if (length != kWrapMarker) {
+      // The record stays in the ring until the lane has room for it.
+      if (pressure_callback_ && pressure_callback_(0)) {
+        break;
+      }
+      deliver(std::span<const std::byte>(data + offset + sizeof(length), length), received_ns);
+      ++datagrams;
+    }
+    tail += record;
+  }
+  if (corrupt) {
+    frames_malformed_.fetch_add(1, std::memory_order_relaxed);
+    tail = head;
+  }
+  ring.tail = tail;
+  header.tail.store(tail, std::memory_order_release);
+  return datagrams;
+}
+
+void ShmTransport::deliver(std::span<const std::byte> datagram, common::TimestampNs received_ns) {
+  bytes_received_.fetch_add(datagram.size(), std::memory_order_relaxed);
+
+  // The producer reuses ring bytes as soon as the tail moves, so the frame
+  // gets its own copy: straight into a slab slot when one is attached.
+  const auto slot = slab_ ? slab_->acquire() : kNoSlabSlot;
+  const std::span<std::byte> buffer = slot != kNoSlabSlot ? slab_->slot(slot) : std::span<std::byte>(scratch_);
+  std::size_t count = 0;
+  if (datagram.size() <= buffer.size()) {
+    std::memcpy(buffer.data(), datagram.data(), datagram.size());
+    count = UdpTransport::parse_frame(buffer.data(), datagram.size(), std::span<Frame>(frames_));
+  }
+  if (count == 0 || !callback_) {
+    if (count == 0) {
+      frames_malformed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (slot != kNoSlabSlot) {
+      slab_->recycle(slot);
+    }
+    return;
+  }
+
+  frames_received_.fetch_add(count, std::memory_order_relaxed);
+  if (!frames_.front().batch.empty()) {
+    batches_received_.fetch_add(1, std::memory_order_relaxed);
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    frames_[i].slot = slot;
+    frames_[i].lane = 0;
+    frames_[i].times = {.received_ns = received_ns};
+  }
+  callback_(std::span<const Frame>(frames_.data(), count));
+}
+
+ShmClient::~ShmClient() {
+  close();
+}
+
+bool ShmClient::connect(std::string_view name) {
+  close();
+  const auto self = static_cast<std::int64_t>(getpid());
+  // Rings are numbered from 0 without gaps; the first missing one ends the scan.
+  for (std::size_t i = 0;; ++i) {
+    const auto path = ring_path(name, i);
+    const int fd = shm_open(path.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+      return false;
+    }
+    struct stat st {};
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) > sizeof(RingHeader)) {
+      mapping = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+      continue;
+    }
+    const auto length = static_cast<std::size_t>(st.st_size);
+    auto& header = header_of(mapping);
+    if (header.magic != kRingMagic || header.version != kRingVersion ||
+        header.capacity != length - sizeof(RingHeader)) {
+      munmap(mapping, length);
+      continue;
+    }
+
+    // Free, or held by a process that no longer exists.
+    auto owner = header.owner_pid.load(std::memory_order_acquire);
+    const bool claimable = owner == 0 || (kill(static_cast<pid_t>(owner), 0) != 0 && errno == ESRCH);
+    if (claimable && header.owner_pid.compare_exchange_strong(owner, self, std::memory_order_acq_rel)) {
+      mapping_ = mapping;
+      length_ = length;
+      head_ = header.head.load(std::memory_order_relaxed);
+      cached_tail_ = header.tail.load(std::memory_order_acquire);
+      return true;
+    }
+    munmap(mapping, length);
+  }
+}
+
+void ShmClient::close() {
+  if (mapping_ == nullptr) {
+    return;
+  }
+  header_of(mapping_).owner_pid.store(0, std::memory_order_release);
+  munmap(mapping_, length_);
+  mapping_ = nullptr;
+  length_ = 0;
+}
+
+bool ShmClient::send(std::span<const std::byte> datagram) {
+  if (mapping_ == nullptr || datagram.empty() || datagram.size() > kMaxWireFrameSize) {
+    return false;
+  }
+  auto& header = header_of(mapping_);
+  const auto capacity = header.capacity;
+  const auto offset = head_ & (capacity - 1);
+  const auto record = record_size(datagram.size());
+  const auto skip = capacity - offset < record ? capacity - offset : 0;
+  if (head_ + skip + record - cached_tail_ > capacity) {
+    cached_tail_ = header.tail.load(std::memory_order_acquire);
+    if (head_ + skip + record - cached_tail_ > capacity) {
+      return false;
+    }
+  }
+
+  auto* data = data_of(mapping_);
+  if (skip > 0) {
+    std::memcpy(data + offset, &kWrapMarker, sizeof(kWrapMarker));
+    head_ += skip;
+  }
+  const auto length = static_cast<std::uint32_t>(datagram.size());
+  const auto start = head_ & (capacity - 1);
+  std::memcpy(data + start, &length, sizeof(length));
+  std::memcpy(data + start + sizeof(length), datagram.data(), datagram.size());
+  head_ += record;
+  header.head.store(head_, std::memory_order_release);
+  return true;
+}
+
+}  // namespace ingest
+}  // namespace tradecore
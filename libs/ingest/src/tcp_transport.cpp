@@ -0,0 +1,395 @@
+#include "tradecore/ingest/tcp_transport.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <regex>
+
+#include "tradecore/common/cpu.hpp"
+#include "tradecore/common/time_utils.hpp"
+
+namespace tradecore {
+namespace ingest {
+
+namespace {
+
+constexpr std::string_view kScheme = "tcp://";
+constexpr std::size_t kMaxEvents = 64;
+// epoll_wait timeout outside busy_poll, so stop() is noticed promptly.
+constexpr int kPollTimeoutMs = 100;
+// How long a congested lane waits before asking again.
+constexpr auto kPauseSleep = std::chrono::microseconds(50);
+
+common::TimestampNs steady_now() noexcept {
+  return static_cast<common::TimestampNs>(common::now_steady().count());
+}
+
+std::string peer_name(const sockaddr_in& addr) {
+  char host[INET_ADDRSTRLEN] = {};
+  inet_ntop(AF_INET, &addr.sin_addr, host, sizeof(host));
+  return std::string(host) + ":" + std::to_string(ntohs(addr.sin_port));
+}
+
+}  // namespace
+
+TcpTransport::TcpTransport(TransportOptions options) : options_(std::move(options)) {
+  options_.tcp_max_connections = std::max<std::size_t>(options_.tcp_max_connections, 1);
+  options_.tcp_read_buffer_bytes = std::max(options_.tcp_read_buffer_bytes, 2 * kMaxWireFrameSize);
+}
+
+TcpTransport::~TcpTransport() {
+  stop();
+}
+
+bool TcpTransport::handles(std::string_view endpoint_uri) noexcept {
+  return endpoint_uri.starts_with(kScheme);
+}
+
+bool TcpTransport::start(const std::string& endpoint_uri, FrameCallback callback) {
+  if (running_.load()) {
+    return false;
+  }
+  std::smatch match;
+  if (!std::regex_match(endpoint_uri, match, std::regex(R"(tcp://([^:]+):(\d+))"))) {
+    return false;
+  }
+  for (const int cpu : options_.receive_cpus) {
+    if (cpu >= 0 && !common::cpu_available(cpu)) {
+      return false;
+    }
+  }
+
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<std::uint16_t>(std::stoi(match[2].str())));
+  const auto host = match[1].str();
+  if (host == "0.0.0.0") {
+    addr.sin_addr.s_addr = INADDR_ANY;
+  } else if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+    return false;
+  }
+
+  listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0) {
+    return false;
+  }
+  int reuse = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = listen_fd_;
+  if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd_, SOMAXCONN) != 0 ||
+      epoll_fd_ < 0 || epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event) != 0) {
+    close_all();
+    return false;
+  }
+
+  callback_ = std::move(callback);
+  running_.store(true);
+  thread_ = std::thread(&TcpTransport::receive_loop, this);
+  return true;
+}
+
+void TcpTransport::stop() {
+  running_.store(false);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close_all();
+  callback_ = nullptr;
+}
+
+void TcpTransport::close_all() {
+  {
+    std::lock_guard lock(connections_mutex_);
+    for (const auto& [fd, connection] : connections_) {
+      ::close(fd);
+    }
+    connections_.clear();
+  }
+  stalled_.clear();
+  if (epoll_fd_ >= 0) {
+    ::close(epoll_fd_);
+    epoll_fd_ = -1;
+  }
+  if (listen_fd_ >= 0) {
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+  }
+}
+
+bool TcpTransport::is_running() const {
+  return running_.load();
+}
+
+TransportStats TcpTransport::stats() const {
+  TransportStats stats{
+      .bytes_received = bytes_received_.load(std::memory_order_relaxed),
+      .frames_received = frames_received_.load(std::memory_order_relaxed),
+      .batches_received = batches_received_.load(std::memory_order_relaxed),
+      .frames_malformed = frames_malformed_.load(std::memory_order_relaxed),
+      .receive_batches = receive_batches_.load(std::memory_order_relaxed),
+      .datagrams_received = datagrams_received_.load(std::memory_order_relaxed),
+  };
+  std::lock_guard lock(connections_mutex_);
+  stats.connections_active = connections_.size();
+  return stats;
+}
+
+std::vector<TcpConnectionStats> TcpTransport::connection_stats() const {
+  std::vector<TcpConnectionStats> out;
+  std::lock_guard lock(connections_mutex_);
+  out.reserve(connections_.size());
+  for (const auto& [fd, connection] : connections_) {
+    out.push_back({
+        .peer = connection->peer,
+        .connected_ns = connection->connected_ns,
+        .bytes_received = connection->bytes_received.load(std::memory_order_relaxed),
+        .frames_received = connection->frames_received.load(std::memory_order_relaxed),
+        .frames_malformed = connection->frames_malformed.load(std::memory_order_relaxed),
+        .reads = connection->reads.load(std::memory_order_relaxed),
+    });
+  }
+  return out;
+}
+
+void TcpTransport::set_batch_callback(BatchCallback callback) {
+  if (!running_.load()) {
+    batch_callback_ = std::move(callback);
+  }
+}
+
+void TcpTransport::set_pressure_callback(PressureCallback callback) {
+  if (!running_.load()) {
+    pressure_callback_ = std::move(callback);
+  }
+}
+
+void TcpTransport::receive_loop() {
+  if (!options_.receive_cpus.empty()) {
+    common::pin_current_thread(options_.receive_cpus.front());
+  }
+  std::array<epoll_event, kMaxEvents> events{};
+  bool paused = false;
+  while (running_.load(std::memory_order_relaxed)) {
+    delivered_ = false;
+    if (pressure_callback_ && pressure_callback_(0)) {
+      if (!paused) {
+        paused = true;
+        backpressure_pauses_.fetch_add(1, std::memory_order_relaxed);
+      }
+      // Flushing may be what frees the rings (frames parked for verification).
+      if (batch_callback_) {
+        batch_callback_(0);
+      }
+      if (options_.busy_poll) {
+        common::cpu_relax();
+      } else {
+        std::this_thread::sleep_for(kPauseSleep);
+      }
+      continue;
+    }
+    paused = false;
+
+    // Frames left in read buffers go before anything new is read.
+    if (!stalled_.empty()) {
+      auto stalled = std::move(stalled_);
+      stalled_.clear();
+      for (const int fd : stalled) {
+        const auto it = connections_.find(fd);
+        if (it == connections_.end()) {
+          continue;
+        }
+        auto& connection = *it->second;
+        connection.stalled = false;
+        const auto parsed = parse_frames(connection);
+        if (parsed == Parsed::kBroken) {
+          close_connection(fd);
+        } else if (parsed == Parsed::kCongested) {
+          connection.stalled = true;
+          stalled_.push_back(fd);
+        }
+      }
+    }
+
+    if (stalled_.empty()) {
+      const int ready = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()),
+                                   options_.busy_poll ? 0 : kPollTimeoutMs);
+      for (int i = 0; i < ready; ++i) {
+        const int fd = events[i].data.fd;
+        if (fd == listen_fd_) {
+          accept_connections();
+          continue;
+        }
+        const auto it = connections_.find(fd);
+        if (it != connections_.end() && !it->second->stalled && !read_connection(*it->second)) {
+          close_connection(fd);
+        }
+      }
+    }
+
+    if (delivered_ && batch_callback_) {
+      batch_callback_(0);
+    }
+  }
+}
+
+void TcpTransport::accept_connections() {
+  for (;;) {
+    sockaddr_in addr{};
+    socklen_t addr_len = sizeof(addr);
+    const int fd = accept4(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      // EAGAIN once the backlog is empty; anything else is retried next poll.
+      return;
+    }
+    if (connections_.size() >= options_.tcp_max_connections) {
+      ::close(fd);
+      continue;
+    }
+    auto connection = std::make_unique<Connection>();
+    connection->fd = fd;
+    connection->id = ++next_connection_id_;
+    connection->peer = peer_name(addr);
+    connection->connected_ns = steady_now();
+    connection->buffer.resize(options_.tcp_read_buffer_bytes);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      ::close(fd);
+      continue;
+    }
+    std::lock_guard lock(connections_mutex_);
+    connections_.emplace(fd, std::move(connection));
+  }
+}
+
+bool TcpTransport::read_connection(Connection& connection) {
+  (void)flush_outbox(connection);
+  // At most a partial frame is left; move it to the front.
+  if (connection.begin > 0) {
+    std::memmove(connection.buffer.data(), connection.buffer.data() + connection.begin,
+                 connection.end - connection.begin);
+    connection.end -= connection.begin;
+    connection.begin = 0;
+  }
+  const auto received = ::recv(connection.fd, connection.buffer.data() + connection.end,
+                             connection.buffer.size() - connection.end, 0);
+  if (received == 0) {
+    return false;
+  }
+  if (received < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  connection.received_ns = steady_now();
+  connection.end += static_cast<std::size_t>(received);
+  connection.bytes_received.fetch_add(static_cast<std::uint64_t>(received), std::memory_order_relaxed);
+  connection.reads.fetch_add(1, std::memory_order_relaxed);
+  bytes_received_.fetch_add(static_cast<std::uint64_t>(received), std::memory_order_relaxed);
+  receive_batches_.fetch_add(1, std::memory_order_relaxed);
+
+  switch (parse_frames(connection)) {
+    case Parsed::kDrained:
+      return true;
+    case Parsed::kCongested:
+      connection.stalled = true;
+      stalled_.push_back(connection.fd);
+      return true;
+    case Parsed::kBroken:
+      return false;
+  }
+  return false;
+}
+
+TcpTransport::Parsed TcpTransport::parse_frames(Connection& connection) {
+  const auto reply_to = (static_cast<std::uint64_t>(connection.id) << 32) | static_cast<std::uint32_t>(connection.fd);
+  while (connection.end - connection.begin >= sizeof(WireHeader)) {
+    const auto* data = connection.buffer.data() + connection.begin;
+    WireHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const auto length = sizeof(WireHeader) + header.payload_len;
+    if (header.magic != WireHeader::kMagic || header.version != WireHeader::kVersion || length > kMaxWireFrameSize) {
+      connection.frames_malformed.fetch_add(1, std::memory_order_relaxed);
+      frames_malformed_.fetch_add(1, std::memory_order_relaxed);
+      return Parsed::kBroken;
+    }
+    if (connection.end - connection.begin < length) {
+      break;
+    }
+    if (pressure_callback_ && pressure_callback_(0)) {
+      return Parsed::kCongested;
+    }
+
+    connection.begin += length;
+    datagrams_received_.fetch_add(1, std::memory_order_relaxed);
+    const auto count = UdpTransport::parse_frame(data, length, std::span<Frame>(frames_));
+    if (count == 0) {
+      connection.frames_malformed.fetch_add(1, std::memory_order_relaxed);
+      frames_malformed_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    connection.frames_received.fetch_add(count, std::memory_order_relaxed);
+    frames_received_.fetch_add(count, std::memory_order_relaxed);
+    if (!frames_.front().batch.empty()) {
+      batches_received_.fetch_add(1, std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      frames_[i].slot = kNoSlabSlot;
+      frames_[i].lane = 0;
+      frames_[i].times = {.received_ns = connection.received_ns};
+      frames_[i].reply_to = reply_to;
+    }
+    callback_(std::span<const Frame>(frames_.data(), count));
+    delivered_ = true;
+  }
+  return Parsed::kDrained;
+}
+
+bool TcpTransport::reply(const Frame& frame, std::span<const std::byte> message) {
+  const auto it = connections_.find(static_cast<int>(frame.reply_to & 0xffffffff));
+  if (frame.reply_to == 0 || it == connections_.end() || it->second->id != frame.reply_to >> 32) {
+    return false;
+  }
+  auto& connection = *it->second;
+  if (!flush_outbox(connection)) {
+    return false;
+  }
+  const auto sent = ::send(connection.fd, message.data(), message.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+  if (sent <= 0) {
+    return false;
+  }
+  connection.outbox.assign(message.begin() + sent, message.end());
+  return true;
+}
+
+bool TcpTransport::flush_outbox(Connection& connection) {
+  if (connection.outbox.empty()) {
+    return true;
+  }
+  const auto sent =
+      ::send(connection.fd, connection.outbox.data(), connection.outbox.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+  if (sent > 0) {
+    connection.outbox.erase(connection.outbox.begin(), connection.outbox.begin() + sent);
+  }
+  return connection.outbox.empty();
+}
+
+void TcpTransport::close_connection(int fd) {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  ::close(fd);
+  std::erase(stalled_, fd);
+  std::lock_guard lock(connections_mutex_);
+  connections_.erase(fd);
+}
+
+}  // namespace ingest
+}  // namespace tradecore
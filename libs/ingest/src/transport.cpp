@@ -1,22 +1,32 @@
 #include "tradecore/ingest/transport.hpp"
 
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/filter.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstddef>
 #include <cstring>
+#include <ctime>
+#include <limits>
 #include <regex>
 #include <stdexcept>
+#include <vector>
+
+#include "tradecore/common/cpu.hpp"
 
 namespace tradecore {
 namespace ingest {
 
 namespace {
 
-constexpr auto kPeerLivenessWindow = std::chrono::seconds(5);
+constexpr common::TimestampNs kPeerLivenessNs = 5'000'000'000;
 
 struct EndpointInfo {
   std::string host;
@@ -35,6 +45,49 @@ EndpointInfo parse_endpoint(const std::string& uri) {
   return {"", 0, false};
 }
 
+// Validates the wire header and fills `out` with the frame it describes;
+// batch frames come back whole, with kind kBatch.
+bool parse_wire(const std::byte* data, std::size_t len, Frame& out) {
+  if (len < sizeof(WireHeader)) {
+    return false;
+  }
+
+  WireHeader header;
+  std::memcpy(&header, data, sizeof(WireHeader));
+
+  // Validate magic and version
+  if (header.magic != WireHeader::kMagic) {
+    return false;
+  }
+
+  if (header.version != WireHeader::kVersion) {
+    return false;
+  }
+
+  // Validate payload length
+  std::size_t expected_len = sizeof(WireHeader) + header.payload_len;
+  if (len < expected_len) {
+    return false;
+  }
+
+  // Validate message kind
+  if (header.kind > static_cast<std::uint8_t>(MessageKind::kBatch)) {
+    return false;
+  }
+
+  // Build frame header
+  out.header.account = header.account;
+  out.header.nonce = header.nonce;
+  out.header.received_time_ns = static_cast<common::TimestampNs>(header.timestamp_ns);
+  out.header.priority = header.priority;
+  out.header.kind = static_cast<MessageKind>(header.kind);
+  out.header.flags = header.flags;
+  out.payload = std::span<const std::byte>(data + sizeof(WireHeader), header.payload_len);
+  out.batch = {};
+
+  return true;
+}
+
 std::uint64_t peer_key(const sockaddr_in& sender_addr) {
   return (static_cast<std::uint64_t>(sender_addr.sin_addr.s_addr) << 16) |
          static_cast<std::uint64_t>(ntohs(sender_addr.sin_port));
@@ -42,7 +95,15 @@ std::uint64_t peer_key(const sockaddr_in& sender_addr) {
 
 }  // namespace
 
-UdpTransport::UdpTransport() = default;
+UdpTransport::UdpTransport(TransportOptions options)
+    : options_(options), peers_(options.peer_capacity, kPeerLivenessNs) {
+  options_.receive_batch_size = std::max<std::size_t>(options_.receive_batch_size, 1);
+  options_.receive_threads = std::max<std::size_t>(options_.receive_threads, 1);
+  for (std::size_t i = 0; i < options_.receive_threads; ++i) {
+    lanes_.push_back(std::make_unique<Lane>());
+    lanes_.back()->index = static_cast<std::uint16_t>(i);
+  }
+}
 
 UdpTransport::~UdpTransport() {
   stop();
@@ -58,17 +119,13 @@ bool UdpTransport::start(const std::string& endpoint_uri, FrameCallback callback
     return false;
   }
 
-  callback_ = std::move(callback);
-
-  // Create UDP socket
-  socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
-  if (socket_fd_ < 0) {
-    return false;
+  for (const int cpu : options_.receive_cpus) {
+    if (cpu >= 0 && !common::cpu_available(cpu)) {
+      return false;
+    }
   }
 
-  // Allow address reuse
-  int opt = 1;
-  setsockopt(socket_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  callback_ = std::move(callback);
 
   // Bind to endpoint
   sockaddr_in addr{};
@@ -79,26 +136,75 @@ bool UdpTransport::start(const std::string& endpoint_uri, FrameCallback callback
     addr.sin_addr.s_addr = INADDR_ANY;
   } else {
     if (inet_pton(AF_INET, endpoint.host.c_str(), &addr.sin_addr) != 1) {
-      close(socket_fd_);
-      socket_fd_ = -1;
       return false;
     }
   }
 
-  if (bind(socket_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
-    close(socket_fd_);
-    socket_fd_ = -1;
-    return false;
+  // One socket per lane. With several lanes they form a SO_REUSEPORT group;
+  // the kernel numbers group members in bind order, which is lane order.
+  const bool reuse_port = lanes_.size() > 1;
+  for (auto& lane : lanes_) {
+    lane->socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (lane->socket_fd < 0) {
+      close_sockets();
+      return false;
+    }
+
+    // Allow address reuse
+    int opt = 1;
+    setsockopt(lane->socket_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    if (reuse_port && setsockopt(lane->socket_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+      close_sockets();
+      return false;
+    }
+
+    if (bind(lane->socket_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+      close_sockets();
+      return false;
+    }
+
+    if (options_.kernel_timestamps) {
+      // Best effort: without it frames just carry no kernel stamp.
+      setsockopt(lane->socket_fd, SOL_SOCKET, SO_TIMESTAMPNS, &opt, sizeof(opt));
+    }
+
+    if (options_.busy_poll) {
+      // Spin mode: never sleep in recv; SO_BUSY_POLL lets the kernel poll the
+      // device queue too (raising it past net.core.busy_poll needs
+      // CAP_NET_ADMIN, so a refusal is not fatal).
+      const int flags = fcntl(lane->socket_fd, F_GETFL, 0);
+      fcntl(lane->socket_fd, F_SETFL, flags | O_NONBLOCK);
+      int busy_poll_us = static_cast<int>(options_.busy_poll_us);
+      setsockopt(lane->socket_fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us));
+    } else {
+      // Set receive timeout for clean shutdown
+      timeval tv{};
+      tv.tv_sec = 0;
+      tv.tv_usec = 100000;  // 100ms
+      setsockopt(lane->socket_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
   }
 
-  // Set receive timeout for clean shutdown
-  timeval tv{};
-  tv.tv_sec = 0;
-  tv.tv_usec = 100000;  // 100ms
-  setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  // Steer by account rather than by the kernel's flow hash so each account's
+  // rate-limit state lives on exactly one lane. Without the program the
+  // partitioning would silently break, so refuse to start.
+  if (reuse_port) {
+    std::array<sock_filter, 3> program{{
+        {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<std::uint32_t>(offsetof(WireHeader, account))},
+        {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<std::uint32_t>(lanes_.size())},
+        {BPF_RET | BPF_A, 0, 0, 0},
+    }};
+    sock_fprog fprog{.len = static_cast<unsigned short>(program.size()), .filter = program.data()};
+    if (setsockopt(lanes_.front()->socket_fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &fprog, sizeof(fprog)) < 0) {
+      close_sockets();
+      return false;
+    }
+  }
 
   running_.store(true);
-  receive_thread_ = std::thread(&UdpTransport::receive_loop, this);
+  for (auto& lane : lanes_) {
+    lane->thread = std::thread(&UdpTransport::run_lane, this, std::ref(*lane));
+  }
 
   return true;
 }
@@ -106,148 +212,366 @@ bool UdpTransport::start(const std::string& endpoint_uri, FrameCallback callback
 void UdpTransport::stop() {
   running_.store(false);
 
-  if (receive_thread_.joinable()) {
-    receive_thread_.join();
-  }
-
-  if (socket_fd_ >= 0) {
-    close(socket_fd_);
-    socket_fd_ = -1;
+  for (auto& lane : lanes_) {
+    if (lane->thread.joinable()) {
+      lane->thread.join();
+    }
   }
 
-  {
-    std::scoped_lock lock(peers_mutex_);
-    peer_last_seen_.clear();
-  }
+  close_sockets();
+  peers_.clear();
 
   callback_ = nullptr;
 }
 
+void UdpTransport::close_sockets() {
+  for (auto& lane : lanes_) {
+    if (lane->socket_fd >= 0) {
+      close(lane->socket_fd);
+      lane->socket_fd = -1;
+    }
+  }
+}
+
 bool UdpTransport::is_running() const {
   return running_.load();
 }
 
 TransportStats UdpTransport::stats() const {
-  std::uint64_t connections_active = 0;
-  const auto now = std::chrono::steady_clock::now();
-  {
-    std::scoped_lock lock(peers_mutex_);
-    for (auto it = peer_last_seen_.begin(); it != peer_last_seen_.end();) {
-      if ((now - it->second) > kPeerLivenessWindow) {
-        it = peer_last_seen_.erase(it);
-      } else {
-        ++connections_active;
-        ++it;
-      }
-    }
+  // Lanes stamp peers with CLOCK_MONOTONIC, which is the steady clock here.
+  const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count();
+  TransportStats stats{.connections_active = peers_.live(now)};
+  for (const auto& lane : lanes_) {
+    stats.bytes_received += lane->bytes_received.load(std::memory_order_relaxed);
+    stats.frames_received += lane->frames_received.load(std::memory_order_relaxed);
+    stats.batches_received += lane->batches_received.load(std::memory_order_relaxed);
+    stats.frames_malformed += lane->frames_malformed.load(std::memory_order_relaxed);
+    stats.receive_batches += lane->receive_batches.load(std::memory_order_relaxed);
+    stats.datagrams_received += lane->datagrams_received.load(std::memory_order_relaxed);
   }
+  return stats;
+}
 
-  return {
-      .bytes_received = bytes_received_.load(),
-      .frames_received = frames_received_.load(),
-      .frames_malformed = frames_malformed_.load(),
-      .connections_active = connections_active,
-  };
+std::string_view UdpTransport::backend() const {
+  return options_.receive_batch_size > 1 ? "recvmmsg" : "recvfrom";
+}
+
+void UdpTransport::attach_slab(std::size_t lane, FrameSlab* slab) {
+  if (!running_.load() && lane < lanes_.size()) {
+    lanes_[lane]->slab = slab;
+  }
+}
+
+void UdpTransport::set_batch_callback(BatchCallback callback) {
+  if (!running_.load()) {
+    batch_callback_ = std::move(callback);
+  }
 }
 
-void UdpTransport::receive_loop() {
+std::size_t UdpTransport::lane_for_account(common::AccountId account, std::size_t lanes) noexcept {
+  if (lanes <= 1) {
+    return 0;
+  }
+  const auto low_word = static_cast<std::uint32_t>(account);
+  return static_cast<std::size_t>(__builtin_bswap32(low_word) % static_cast<std::uint32_t>(lanes));
+}
+
+void UdpTransport::run_lane(Lane& lane) {
+  if (lane.index < options_.receive_cpus.size()) {
+    common::pin_current_thread(options_.receive_cpus[lane.index]);
+  }
+  receive_loop(lane);
+}
+
+void UdpTransport::receive_loop(Lane& lane) {
+  if (options_.receive_batch_size > 1) {
+    receive_batched(lane);
+    return;
+  }
+
   constexpr std::size_t kMaxDatagramSize = 65536;
-  std::array<std::byte, kMaxDatagramSize> buffer{};
-  std::vector<std::byte> payload_storage;
-  payload_storage.reserve(4096);
+  std::vector<std::byte> scratch(kMaxDatagramSize);
+  alignas(cmsghdr) std::array<std::byte, kTimestampControlSize> control{};
+  FrameSlab* slab = lane.slab;
 
   while (running_.load()) {
+    // Receive straight into a slab slot when one is attached so the frame is
+    // never copied again on its way to the ingress rings.
+    std::uint32_t slot = slab ? slab->acquire() : kNoSlabSlot;
+    std::span<std::byte> buffer = slot != kNoSlabSlot ? slab->slot(slot) : std::span<std::byte>(scratch);
+
     sockaddr_in sender_addr{};
-    socklen_t sender_len = sizeof(sender_addr);
-
-    ssize_t received = recvfrom(
-        socket_fd_,
-        buffer.data(),
-        buffer.size(),
-        0,
-        reinterpret_cast<sockaddr*>(&sender_addr),
-        &sender_len);
-
-    if (received < 0) {
-      // Timeout or error, check if still running
+    iovec vector{.iov_base = buffer.data(), .iov_len = buffer.size()};
+    msghdr message{};
+    message.msg_name = &sender_addr;
+    message.msg_namelen = sizeof(sender_addr);
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    ssize_t received = recvmsg(lane.socket_fd, &message, MSG_TRUNC);
+
+    if (received <= 0) {
+      // Timeout or error (EAGAIN when spinning), check if still running
+      if (slot != kNoSlabSlot) {
+        slab->recycle(slot);
+      }
+      if (options_.busy_poll) {
+        common::cpu_relax();
+      }
       continue;
     }
 
-    if (received == 0) {
-      continue;
+    note_receive(lane);
+    lane.receive_batches.fetch_add(1, std::memory_order_relaxed);
+    lane.datagrams_received.fetch_add(1, std::memory_order_relaxed);
+    note_peer(lane, sender_addr);
+
+    // MSG_TRUNC reports the full datagram length; oversized frames are malformed.
+    const auto length = static_cast<std::size_t>(received);
+    if (!deliver(lane, buffer, length, length > buffer.size(), slot, kernel_timestamp(message),
+                 reply_handle(sender_addr)) &&
+        slot != kNoSlabSlot) {
+      slab->recycle(slot);
     }
+    end_batch(lane);
+  }
+}
 
-    bytes_received_.fetch_add(static_cast<std::uint64_t>(received));
-    const auto now = std::chrono::steady_clock::now();
-    {
-      std::scoped_lock lock(peers_mutex_);
-      peer_last_seen_[peer_key(sender_addr)] = now;
-      for (auto it = peer_last_seen_.begin(); it != peer_last_seen_.end();) {
-        if ((now - it->second) > kPeerLivenessWindow) {
-          it = peer_last_seen_.erase(it);
-        } else {
-          ++it;
+void UdpTransport::receive_batched(Lane& lane) {
+  constexpr std::size_t kMaxDatagramSize = 65536;
+  const std::size_t batch = options_.receive_batch_size;
+  FrameSlab* slab = lane.slab;
+
+  // Everything recvmmsg touches is allocated once. Slab slots stay parked in
+  // `slots` until a datagram lands in them and the callback takes ownership.
+  std::vector<mmsghdr> messages(batch);
+  std::vector<iovec> vectors(batch);
+  std::vector<sockaddr_in> senders(batch);
+  struct alignas(cmsghdr) Control {
+    std::array<std::byte, kTimestampControlSize> bytes;
+  };
+  std::vector<Control> controls(batch);
+  std::vector<std::uint32_t> slots(batch, kNoSlabSlot);
+  std::vector<std::byte> scratch(slab ? kMaxDatagramSize : batch * kMaxDatagramSize);
+
+  while (running_.load()) {
+    // Without a slab every entry has its own scratch region. With one, only
+    // entries backed by a slot are offered to the kernel; if the slab is dry
+    // a single scratch entry keeps the socket drained (the frame is dropped
+    // downstream rather than left to overflow the kernel buffer).
+    std::size_t offered = 0;
+    if (slab) {
+      for (; offered < batch; ++offered) {
+        if (slots[offered] == kNoSlabSlot) {
+          slots[offered] = slab->acquire();
+          if (slots[offered] == kNoSlabSlot) {
+            break;
+          }
         }
+        const auto buffer = slab->slot(slots[offered]);
+        vectors[offered] = {.iov_base = buffer.data(), .iov_len = buffer.size()};
       }
+      if (offered == 0) {
+        vectors[0] = {.iov_base = scratch.data(), .iov_len = kMaxDatagramSize};
+        offered = 1;
+      }
+    } else {
+      for (; offered < batch; ++offered) {
+        vectors[offered] = {.iov_base = scratch.data() + offered * kMaxDatagramSize, .iov_len = kMaxDatagramSize};
+      }
+    }
+
+    for (std::size_t i = 0; i < offered; ++i) {
+      messages[i] = {};
+      messages[i].msg_hdr.msg_name = &senders[i];
+      messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      messages[i].msg_hdr.msg_iov = &vectors[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+      messages[i].msg_hdr.msg_control = controls[i].bytes.data();
+      messages[i].msg_hdr.msg_controllen = kTimestampControlSize;
     }
 
-    Frame frame;
-    if (parse_frame(buffer.data(), static_cast<std::size_t>(received), frame, payload_storage)) {
-      frames_received_.fetch_add(1);
-      if (callback_) {
-        callback_(frame);
+    // MSG_WAITFORONE blocks (up to SO_RCVTIMEO) for the first datagram only
+    // and then takes whatever else is already queued; in spin mode the socket
+    // is non-blocking and an empty queue returns at once.
+    const int received =
+        recvmmsg(lane.socket_fd, messages.data(), static_cast<unsigned int>(offered), MSG_WAITFORONE, nullptr);
+    if (received <= 0) {
+      if (options_.busy_poll) {
+        common::cpu_relax();
+      }
+      continue;
+    }
+
+    note_receive(lane);
+    lane.receive_batches.fetch_add(1, std::memory_order_relaxed);
+    lane.datagrams_received.fetch_add(static_cast<std::uint64_t>(received), std::memory_order_relaxed);
+    for (int i = 0; i < received; ++i) {
+      note_peer(lane, senders[i]);
+    }
+
+    for (int i = 0; i < received; ++i) {
+      const auto& message = messages[i];
+      const std::span<std::byte> buffer(static_cast<std::byte*>(vectors[i].iov_base), vectors[i].iov_len);
+      const bool truncated = (message.msg_hdr.msg_flags & MSG_TRUNC) != 0;
+      if (deliver(lane, buffer, message.msg_len, truncated, slots[i], kernel_timestamp(message.msg_hdr),
+                  reply_handle(senders[i]))) {
+        slots[i] = kNoSlabSlot;
+      }
+    }
+    end_batch(lane);
+  }
+
+  if (slab) {
+    for (const auto slot : slots) {
+      if (slot != kNoSlabSlot) {
+        slab->recycle(slot);
       }
-    } else {
-      frames_malformed_.fetch_add(1);
     }
   }
 }
 
-bool UdpTransport::parse_frame(const std::byte* data, std::size_t len, Frame& out_frame, std::vector<std::byte>& payload_storage) {
-  if (len < sizeof(WireHeader)) {
+void UdpTransport::note_peer(Lane& lane, const sockaddr_in& sender) noexcept {
+  peers_.touch(peer_key(sender), lane.received_ns, lane.peer_sweep);
+}
+
+std::uint64_t UdpTransport::reply_handle(const sockaddr_in& sender) noexcept {
+  // The peer key is below 2^48, so the handle is never 0.
+  return peer_key(sender) + 1;
+}
+
+bool UdpTransport::reply(const Frame& frame, std::span<const std::byte> message) {
+  if (frame.reply_to == 0 || frame.lane >= lanes_.size()) {
     return false;
   }
+  const auto key = frame.reply_to - 1;
+  sockaddr_in target{};
+  target.sin_family = AF_INET;
+  target.sin_port = htons(static_cast<std::uint16_t>(key & 0xffff));
+  target.sin_addr.s_addr = static_cast<in_addr_t>(key >> 16);
+  return sendto(lanes_[frame.lane]->socket_fd, message.data(), message.size(), MSG_DONTWAIT,
+                reinterpret_cast<const sockaddr*>(&target), sizeof(target)) == static_cast<ssize_t>(message.size());
+}
 
-  const auto* header = reinterpret_cast<const WireHeader*>(data);
+void UdpTransport::note_receive(Lane& lane) noexcept {
+  // Sampling both clocks back to back per batch keeps the rebasing error to
+  // the gap between the two reads (tens of ns) plus any NTP slew since.
+  timespec steady{};
+  timespec realtime{};
+  clock_gettime(CLOCK_MONOTONIC, &steady);
+  clock_gettime(CLOCK_REALTIME, &realtime);
+  const auto to_ns = [](const timespec& ts) {
+    return static_cast<common::TimestampNs>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+  };
+  lane.received_ns = to_ns(steady);
+  lane.realtime_offset_ns = to_ns(steady) - to_ns(realtime);
+}
 
-  // Validate magic and version
-  if (header->magic != WireHeader::kMagic) {
-    return false;
+common::TimestampNs UdpTransport::kernel_timestamp(const msghdr& message) noexcept {
+  if (message.msg_control == nullptr || (message.msg_flags & MSG_CTRUNC) != 0) {
+    return 0;
   }
+  for (auto* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&message), cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS &&
+        cmsg->cmsg_len >= CMSG_LEN(sizeof(timespec))) {
+      timespec stamp{};
+      std::memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+      return static_cast<common::TimestampNs>(stamp.tv_sec) * 1'000'000'000 + stamp.tv_nsec;
+    }
+  }
+  return 0;
+}
 
-  if (header->version != WireHeader::kVersion) {
+bool UdpTransport::deliver(Lane& lane, std::span<std::byte> buffer, std::size_t received, bool truncated,
+                           std::uint32_t slot, common::TimestampNs kernel_ns, std::uint64_t reply_to) {
+  lane.bytes_received.fetch_add(static_cast<std::uint64_t>(received), std::memory_order_relaxed);
+
+  const auto count =
+      truncated || received > buffer.size() ? 0 : parse_frame(buffer.data(), received, std::span<Frame>(lane.frames));
+  if (count == 0) {
+    lane.frames_malformed.fetch_add(1, std::memory_order_relaxed);
     return false;
   }
 
-  // Validate payload length
-  std::size_t expected_len = sizeof(WireHeader) + header->payload_len;
-  if (len < expected_len) {
+  lane.frames_received.fetch_add(count, std::memory_order_relaxed);
+  if (!lane.frames.front().batch.empty()) {
+    lane.batches_received.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (!callback_) {
     return false;
   }
+  const StageTimes times{
+      .kernel_ns = kernel_ns != 0 ? kernel_ns + lane.realtime_offset_ns : 0,
+      .received_ns = lane.received_ns,
+  };
+  for (std::size_t i = 0; i < count; ++i) {
+    lane.frames[i].slot = slot;
+    lane.frames[i].lane = lane.index;
+    lane.frames[i].times = times;
+    lane.frames[i].reply_to = reply_to;
+  }
+  callback_(std::span<const Frame>(lane.frames.data(), count));
+  return slot != kNoSlabSlot;
+}
 
-  // Validate message kind
-  if (header->kind > static_cast<std::uint8_t>(MessageKind::kHeartbeat)) {
-    return false;
+void UdpTransport::end_batch(Lane& lane) {
+  if (batch_callback_) {
+    batch_callback_(lane.index);
   }
+}
 
-  // Build frame header
-  out_frame.header.account = header->account;
-  out_frame.header.nonce = header->nonce;
-  out_frame.header.received_time_ns = header->timestamp_ns;
-  out_frame.header.priority = header->priority;
-  out_frame.header.kind = static_cast<MessageKind>(header->kind);
-
-  // Copy payload
-  if (header->payload_len > 0) {
-    const std::byte* payload_start = data + sizeof(WireHeader);
-    payload_storage.assign(payload_start, payload_start + header->payload_len);
-    out_frame.payload = std::span<const std::byte>(payload_storage);
-  } else {
-    payload_storage.clear();
-    out_frame.payload = std::span<const std::byte>();
+bool UdpTransport::parse_frame(const std::byte* data, std::size_t len, Frame& out_frame) {
+  return parse_wire(data, len, out_frame) && out_frame.header.kind != MessageKind::kBatch;
+}
+
+std::size_t UdpTransport::parse_frame(const std::byte* data, std::size_t len, std::span<Frame> out) {
+  if (out.empty() || !parse_wire(data, len, out.front())) {
+    return 0;
+  }
+  if (out.front().header.kind != MessageKind::kBatch) {
+    return 1;
   }
+  const auto header = out.front().header;
+  return unpack_batch(header, out.front().payload, out);
+}
 
-  return true;
+std::size_t UdpTransport::unpack_batch(const FrameHeader& header, std::span<const std::byte> payload,
+                                       std::span<Frame> out) {
+  const auto auth = (header.flags & kFrameFlagSessionMac) != 0 ? kFrameSessionMacSize : kFrameSignatureSize;
+  if (payload.size() <= auth) {
+    return 0;
+  }
+  const auto count = std::to_integer<std::size_t>(payload[auth]);
+  if (count == 0 || count > kMaxBatchMessages || count > out.size() ||
+      header.nonce > std::numeric_limits<std::uint64_t>::max() - (count - 1)) {
+    return 0;
+  }
+
+  std::size_t offset = auth + 1;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (payload.size() - offset < 2) {
+      return 0;
+    }
+    const auto kind = std::to_integer<std::uint8_t>(payload[offset]);
+    const auto length = std::to_integer<std::size_t>(payload[offset + 1]);
+    offset += 2;
+    // Heartbeats and nested batches have no place in a batch.
+    if (kind > static_cast<std::uint8_t>(MessageKind::kReplace) || payload.size() - offset < length) {
+      return 0;
+    }
+    auto& frame = out[i];
+    frame.header = header;
+    frame.header.kind = static_cast<MessageKind>(kind);
+    frame.header.nonce = header.nonce + i;
+    frame.payload = payload.subspan(offset, length);
+    frame.batch = payload;
+    offset += length;
+  }
+  return offset == payload.size() ? count : 0;
 }
 
 }  // namespace ingest
@@ -0,0 +1,137 @@
+#include "tradecore/ingest/verify_stage.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <stdexcept>
+
+namespace tradecore {
+namespace ingest {
+
+namespace {
+
+common::TimestampNs steady_now() noexcept {
+  return static_cast<common::TimestampNs>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+}  // namespace
+
+VerifyStage::VerifyStage(std::size_t lanes, std::size_t capacity, std::size_t batch, std::size_t workers,
+                         Verifier verifier)
+    : batch_(std::clamp<std::size_t>(batch, 1, kMaxBatch)), verifier_(std::move(verifier)) {
+  if (!verifier_) {
+    throw std::invalid_argument("VerifyStage requires a verifier");
+  }
+  const auto slots = std::bit_ceil(std::max<std::size_t>(capacity, 1));
+  mask_ = slots - 1;
+  for (std::size_t i = 0; i < std::max<std::size_t>(lanes, 1); ++i) {
+    lanes_.push_back(std::make_unique<LaneQueue>(slots));
+  }
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back([this, i] { run_worker(i); });
+  }
+}
+
+VerifyStage::~VerifyStage() {
+  stopping_.store(true, std::memory_order_release);
+  epoch_.fetch_add(1, std::memory_order_release);
+  epoch_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+bool VerifyStage::full(std::size_t lane) const noexcept {
+  const auto& queue = *lanes_[lane];
+  return queue.published.load(std::memory_order_relaxed) - queue.retired.load(std::memory_order_relaxed) > mask_;
+}
+
+bool VerifyStage::empty(std::size_t lane) const noexcept {
+  const auto& queue = *lanes_[lane];
+  return queue.published.load(std::memory_order_relaxed) == queue.retired.load(std::memory_order_relaxed);
+}
+
+void VerifyStage::enqueue(std::size_t lane, const Frame& frame, common::TimestampNs admitted_ns) {
+  auto& queue = *lanes_[lane];
+  const auto index = queue.published.load(std::memory_order_relaxed);
+  Ticket& ticket = queue.tickets[index & mask_];
+  queue.frames[index & mask_] = frame;
+  ticket.admitted_ns = admitted_ns;
+  ticket.verified_ns = 0;
+  ticket.queue_depth = static_cast<std::size_t>(index - queue.retired.load(std::memory_order_relaxed));
+  ticket.state.store(kPending, std::memory_order_relaxed);
+  queue.published.store(index + 1, std::memory_order_release);
+
+  if (!workers_.empty()) {
+    epoch_.fetch_add(1, std::memory_order_release);
+    epoch_.notify_one();
+  }
+}
+
+bool VerifyStage::verify_run(LaneQueue& queue) {
+  // Claim what is published, up to the batch size and never across the end
+  // of the ring, so the run's frames are contiguous.
+  auto index = queue.claimed.load(std::memory_order_relaxed);
+  std::size_t count = 0;
+  do {
+    const auto published = queue.published.load(std::memory_order_acquire);
+    if (index >= published) {
+      return false;
+    }
+    count = std::min({static_cast<std::size_t>(published - index), batch_, mask_ + 1 - (index & mask_)});
+  } while (!queue.claimed.compare_exchange_weak(index, index + count, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed));
+
+  const auto first = index & mask_;
+  std::array<bool, kMaxBatch> valid{};
+  verifier_(std::span<const Frame>(&queue.frames[first], count), std::span<bool>(valid.data(), count));
+  const auto failures = static_cast<std::size_t>(std::count(valid.begin(), valid.begin() + count, false));
+  verified_.fetch_add(count - failures, std::memory_order_relaxed);
+  failed_.fetch_add(failures, std::memory_order_relaxed);
+  // Publishing the state hands the ticket back to the lane thread.
+  const auto now = steady_now();
+  for (std::size_t i = 0; i < count; ++i) {
+    Ticket& ticket = queue.tickets[first + i];
+    ticket.verified_ns = now;
+    ticket.state.store(valid[i] ? kValid : kInvalid, std::memory_order_release);
+  }
+  return true;
+}
+
+void VerifyStage::run_worker(std::size_t index) {
+  while (true) {
+    const auto epoch = epoch_.load(std::memory_order_acquire);
+    if (stopping_.load(std::memory_order_acquire)) {
+      return;
+    }
+    // Start at a different lane per worker so lanes are served evenly.
+    bool worked = false;
+    for (std::size_t i = 0; i < lanes_.size(); ++i) {
+      auto& queue = *lanes_[(index + i) % lanes_.size()];
+      while (verify_run(queue)) {
+        worked = true;
+      }
+    }
+    if (!worked) {
+      epoch_.wait(epoch, std::memory_order_acquire);
+    }
+  }
+}
+
+VerifyStage::Stats VerifyStage::stats() const noexcept {
+  Stats stats{
+      .verified = verified_.load(std::memory_order_relaxed),
+      .failed = failed_.load(std::memory_order_relaxed),
+  };
+  for (const auto& queue : lanes_) {
+    stats.in_flight +=
+        queue->published.load(std::memory_order_relaxed) - queue->retired.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+}  // namespace ingest
+}  // namespace tradecore
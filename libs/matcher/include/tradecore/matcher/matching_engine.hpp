@@ -64,6 +64,30 @@ struct ReplaceResult {
   std::vector<FillEvent> fills{};
 };
 
+// Point-in-time view of a resting order, used to checkpoint and restore books.
+struct RestingOrder {
+  OrderRequest request{};
+  std::int64_t remaining{0};
+  std::int64_t display_remaining{0};
+  std::uint64_t fifo_seq{0};
+};
+
+struct BookLevel {
+  std::int64_t price{0};
+  std::int64_t total_qty{0};
+  std::int64_t visible_qty{0};
+  std::size_t order_count{0};
+};
+
+// Full book of one market. Sides are ordered best price first and FIFO
+// within a level, so restoring in sequence reproduces queue priority.
+struct MarketBook {
+  common::MarketId market{0};
+  std::uint64_t next_sequence{1};
+  std::vector<RestingOrder> bids{};
+  std::vector<RestingOrder> asks{};
+};
+
 class MatchingEngine {
  public:
   struct Config {
@@ -81,6 +105,15 @@ class MatchingEngine {
   [[nodiscard]] CancelResult cancel(const CancelRequest& request);
   [[nodiscard]] ReplaceResult replace(const ReplaceRequest& request);
 
+  // Book inspection and checkpointing.
+  [[nodiscard]] std::vector<common::MarketId> market_ids() const;
+  [[nodiscard]] std::size_t order_count(common::MarketId market_id) const;
+  [[nodiscard]] std::vector<BookLevel> depth(common::MarketId market_id,
+                                             common::Side side,
+                                             std::size_t max_levels) const;
+  [[nodiscard]] MarketBook export_book(common::MarketId market_id) const;
+  void restore_book(const MarketBook& book);
+
  private:
   struct OrderRecord;
   struct PriceLevel;
@@ -195,6 +195,117 @@ ReplaceResult MatchingEngine::replace(const ReplaceRequest& request) {
   return replace_result;
 }
 
+std::vector<common::MarketId> MatchingEngine::market_ids() const {
+  std::vector<common::MarketId> ids;
+  ids.reserve(markets_.size());
+  for (const auto& [market_id, _] : markets_) {
+    ids.push_back(market_id);
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+std::size_t MatchingEngine::order_count(common::MarketId market_id) const {
+  auto it = markets_.find(market_id);
+  if (it == markets_.end()) {
+    return 0;
+  }
+  return it->second.book_orders.size();
+}
+
+std::vector<BookLevel> MatchingEngine::depth(common::MarketId market_id,
+                                             common::Side side,
+                                             std::size_t max_levels) const {
+  std::vector<BookLevel> levels;
+  auto it = markets_.find(market_id);
+  if (it == markets_.end()) {
+    return levels;
+  }
+
+  auto collect = [&](const auto& book) {
+    for (const auto& [price, level] : book) {
+      if (levels.size() >= max_levels) {
+        break;
+      }
+      BookLevel summary{
+          .price = price,
+          .total_qty = level.total_qty,
+          .visible_qty = level.visible_qty,
+      };
+      for (const auto* record = level.head; record; record = record->next) {
+        ++summary.order_count;
+      }
+      levels.push_back(summary);
+    }
+  };
+
+  if (side == common::Side::kBuy) {
+    collect(it->second.bids);
+  } else {
+    collect(it->second.asks);
+  }
+  return levels;
+}
+
+MarketBook MatchingEngine::export_book(common::MarketId market_id) const {
+  MarketBook book{.market = market_id};
+  auto it = markets_.find(market_id);
+  if (it == markets_.end()) {
+    return book;
+  }
+
+  const auto& shard = it->second;
+  book.next_sequence = shard.next_sequence;
+
+  auto collect = [](const auto& side_book, std::vector<RestingOrder>& out) {
+    for (const auto& [price, level] : side_book) {
+      for (const auto* record = level.head; record; record = record->next) {
+        out.push_back(RestingOrder{
+            .request = record->request,
+            .remaining = record->remaining,
+            .display_remaining = record->display_remaining,
+            .fifo_seq = record->fifo_seq,
+        });
+      }
+    }
+  };
+
+  collect(shard.bids, book.bids);
+  collect(shard.asks, book.asks);
+  return book;
+}
+
+void MatchingEngine::restore_book(const MarketBook& book) {
+  clear_market(book.market);
+  auto& shard = markets_.find(book.market)->second;
+  shard.next_sequence = book.next_sequence;
+
+  auto restore = [&](const std::vector<RestingOrder>& orders) {
+    for (const auto& order : orders) {
+      OrderRecord record;
+      record.request = order.request;
+      record.remaining = order.remaining;
+      record.display_remaining = order.display_remaining;
+      record.fifo_seq = order.fifo_seq;
+      if (common::HasFlag(order.request.flags, common::OrderFlags::kHidden)) {
+        record.display_size = 0;
+      } else if (common::HasFlag(order.request.flags, common::OrderFlags::kIceberg)) {
+        record.display_size = order.request.display_quantity;
+      } else {
+        record.display_size = order.request.quantity;
+      }
+
+      auto [it, inserted] = shard.book_orders.emplace(encode_order_id(order.request.id), std::move(record));
+      if (inserted) {
+        rest_order(shard, it->second);
+      }
+    }
+  };
+
+  restore(book.bids);
+  restore(book.asks);
+}
+
 OrderResult MatchingEngine::place_order(MarketShard& shard, OrderRequest order) {
   OrderResult result;
   const auto encoded = encode_order_id(order.id);
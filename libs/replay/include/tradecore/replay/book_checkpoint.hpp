@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "tradecore/matcher/matching_engine.hpp"
+
+namespace tradecore {
+namespace replay {
+
+// Matcher state after applying every WAL record up to and including
+// `sequence`. `wal_offset` is the byte offset of the following record so
+// replay can seek straight to it instead of scanning from genesis.
+struct BookCheckpoint {
+  std::uint64_t sequence{0};
+  std::uint64_t wal_offset{0};
+  std::vector<matcher::MarketBook> books{};
+};
+
+// Append-only store of periodic book checkpoints plus a fixed-width index
+// keyed by WAL sequence, so the checkpoint nearest to any sequence is found
+// with a binary search over the index and a single read of the data file.
+class CheckpointStore {
+ public:
+  explicit CheckpointStore(std::filesystem::path directory);
+
+  void persist(const BookCheckpoint& checkpoint);
+  [[nodiscard]] std::optional<BookCheckpoint> nearest(std::uint64_t sequence) const;
+  [[nodiscard]] std::optional<std::uint64_t> latest_sequence() const;
+  [[nodiscard]] std::size_t checkpoint_count() const;
+  [[nodiscard]] const std::filesystem::path& directory() const noexcept { return directory_; }
+
+ private:
+  struct IndexEntry {
+    std::uint64_t sequence{0};
+    std::uint64_t wal_offset{0};
+    std::uint64_t data_offset{0};
+    std::uint32_t size{0};
+    std::uint32_t checksum{0};
+  };
+
+  std::filesystem::path directory_{};
+  std::filesystem::path data_path_{};
+  std::filesystem::path index_path_{};
+
+  [[nodiscard]] std::vector<IndexEntry> load_index() const;
+};
+
+}  // namespace replay
+}  // namespace tradecore
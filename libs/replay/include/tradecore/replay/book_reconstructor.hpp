@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "tradecore/common/types.hpp"
+#include "tradecore/ingest/frame.hpp"
+#include "tradecore/ingest/journal_record.hpp"
+#include "tradecore/ingest/sbe_messages.hpp"
+#include "tradecore/matcher/matching_engine.hpp"
+
+namespace tradecore {
+namespace replay {
+
+// Matcher request tradecored derives from an admitted new-order frame. Shared
+// with the daemon so live sequencing and reconstruction stay in lockstep.
+// Orders that leave `market` unset (0, or a v1 sender) go to `default_market`.
+[[nodiscard]] matcher::OrderRequest new_order_request(const ingest::FrameHeader& header,
+                                                      const ingest::sbe::NewOrder& order,
+                                                      common::MarketId default_market);
+
+// Rebuilds matcher state at an arbitrary WAL sequence for forensics: restores
+// the nearest book checkpoint at or before the target and replays the
+// journaled ingress frames that follow it. New orders follow the outcome
+// journaled with them (see JournalRecordType); those refused by risk are
+// skipped.
+class BookReconstructor {
+ public:
+  struct Options {
+    std::filesystem::path wal_path{};
+    std::filesystem::path checkpoint_directory{};
+    common::MarketId default_market{1};
+    std::vector<common::MarketId> markets{};
+  };
+
+  struct Result {
+    std::uint64_t sequence{0};             // last WAL sequence applied
+    std::uint64_t checkpoint_sequence{0};  // checkpoint replay resumed from, 0 for genesis
+    std::uint64_t records_replayed{0};
+  };
+
+  // Decides whether a new order journaled without its outcome (kUnchecked,
+  // from a daemon that predates them) reaches the matcher. Risk state is not
+  // checkpointed; without a hook every such order is admitted.
+  using AdmissionHook = std::function<bool(const matcher::OrderRequest&)>;
+
+  explicit BookReconstructor(Options options);
+
+  void set_admission_hook(AdmissionHook hook);
+
+  Result reconstruct(std::uint64_t target_sequence, matcher::MatchingEngine& engine) const;
+
+  // Rebuilds the engine as of the last record in the WAL. A daemon resuming
+  // an existing WAL calls this before sequencing again, so the checkpoints it
+  // writes afterwards carry the orders resting from before the restart.
+  Result restore(matcher::MatchingEngine& engine) const;
+
+  // Replays the WAL past the latest checkpoint and persists a new checkpoint
+  // every `interval` records. Returns the number of checkpoints written.
+  // Throws std::runtime_error on reaching a kUnchecked record, since no book
+  // past it is known to be right; checkpoints before it are kept.
+  std::size_t build_checkpoints(std::uint64_t interval);
+
+ private:
+  Options options_{};
+  AdmissionHook admission_hook_{};
+
+  void apply_record(matcher::MatchingEngine& engine, ingest::JournalRecordType type,
+                    std::span<const std::byte> payload) const;
+};
+
+}  // namespace replay
+}  // namespace tradecore
@@ -0,0 +1,261 @@
+#include "tradecore/replay/book_checkpoint.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace tradecore {
+namespace replay {
+
+namespace {
+constexpr std::uint32_t kMagic = 0x5443424b;  // 'TCBK'
+constexpr std::uint16_t kVersion = 1;
+constexpr std::uint32_t kFnvPrime = 16777619u;
+constexpr std::uint32_t kFnvOffsetBasis = 2166136261u;
+
+std::uint32_t checksum32(std::span<const std::byte> payload) noexcept {
+  std::uint32_t hash = kFnvOffsetBasis;
+  for (const auto& b : payload) {
+    hash ^= static_cast<std::uint8_t>(b);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+template <typename T>
+void append_primitive(std::vector<std::byte>& buffer, T value) {
+  auto raw = std::bit_cast<std::array<std::byte, sizeof(T)>>(value);
+  buffer.insert(buffer.end(), raw.begin(), raw.end());
+}
+
+template <typename T>
+T read_primitive(std::span<const std::byte> data, std::size_t& offset) {
+  if (offset + sizeof(T) > data.size()) {
+    throw std::runtime_error("truncated book checkpoint");
+  }
+  std::array<std::byte, sizeof(T)> storage{};
+  std::memcpy(storage.data(), data.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return std::bit_cast<T>(storage);
+}
+
+void encode_orders(std::vector<std::byte>& buffer, const std::vector<matcher::RestingOrder>& orders) {
+  append_primitive<std::uint32_t>(buffer, static_cast<std::uint32_t>(orders.size()));
+  for (const auto& order : orders) {
+    append_primitive<std::uint64_t>(buffer, order.request.id.value());
+    append_primitive<common::AccountId>(buffer, order.request.account);
+    append_primitive<std::uint8_t>(buffer, static_cast<std::uint8_t>(order.request.side));
+    append_primitive<std::int64_t>(buffer, order.request.quantity);
+    append_primitive<std::int64_t>(buffer, order.request.price);
+    append_primitive<std::int64_t>(buffer, order.request.display_quantity);
+    append_primitive<std::uint8_t>(buffer, static_cast<std::uint8_t>(order.request.tif));
+    append_primitive<std::uint16_t>(buffer, order.request.flags);
+    append_primitive<std::int64_t>(buffer, order.remaining);
+    append_primitive<std::int64_t>(buffer, order.display_remaining);
+    append_primitive<std::uint64_t>(buffer, order.fifo_seq);
+  }
+}
+
+void decode_orders(std::span<const std::byte> data, std::size_t& offset, std::vector<matcher::RestingOrder>& orders) {
+  const auto count = read_primitive<std::uint32_t>(data, offset);
+  orders.clear();
+  orders.reserve(count);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    matcher::RestingOrder order;
+    order.request.id = common::OrderId::from_value(read_primitive<std::uint64_t>(data, offset));
+    order.request.account = read_primitive<common::AccountId>(data, offset);
+    order.request.side = static_cast<common::Side>(read_primitive<std::uint8_t>(data, offset));
+    order.request.quantity = read_primitive<std::int64_t>(data, offset);
+    order.request.price = read_primitive<std::int64_t>(data, offset);
+    order.request.display_quantity = read_primitive<std::int64_t>(data, offset);
+    order.request.tif = static_cast<common::TimeInForce>(read_primitive<std::uint8_t>(data, offset));
+    order.request.flags = read_primitive<std::uint16_t>(data, offset);
+    order.remaining = read_primitive<std::int64_t>(data, offset);
+    order.display_remaining = read_primitive<std::int64_t>(data, offset);
+    order.fifo_seq = read_primitive<std::uint64_t>(data, offset);
+    orders.push_back(order);
+  }
+}
+
+// Appends `size` bytes and syncs them before returning, so whatever is
+// written next can rely on them having reached the disk.
+void append_synced(const std::filesystem::path& path, const void* data, std::size_t size, const char* what) {
+  const int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::system_error(errno, std::system_category(), std::string(what) + ": " + path.string());
+  }
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  while (size > 0) {
+    const auto written = ::write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::system_category(), what);
+    }
+    bytes += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  if (::fsync(fd) != 0) {
+    const int error = errno;
+    ::close(fd);
+    throw std::system_error(error, std::system_category(), what);
+  }
+  ::close(fd);
+}
+
+std::vector<std::byte> encode_checkpoint(const BookCheckpoint& checkpoint) {
+  std::vector<std::byte> buffer;
+  append_primitive<std::uint32_t>(buffer, kMagic);
+  append_primitive<std::uint16_t>(buffer, kVersion);
+  append_primitive<std::uint64_t>(buffer, checkpoint.sequence);
+  append_primitive<std::uint64_t>(buffer, checkpoint.wal_offset);
+  append_primitive<std::uint32_t>(buffer, static_cast<std::uint32_t>(checkpoint.books.size()));
+  for (const auto& book : checkpoint.books) {
+    append_primitive<common::MarketId>(buffer, book.market);
+    append_primitive<std::uint64_t>(buffer, book.next_sequence);
+    encode_orders(buffer, book.bids);
+    encode_orders(buffer, book.asks);
+  }
+  return buffer;
+}
+
+BookCheckpoint decode_checkpoint(std::span<const std::byte> data) {
+  std::size_t offset = 0;
+  if (read_primitive<std::uint32_t>(data, offset) != kMagic) {
+    throw std::runtime_error("invalid book checkpoint magic");
+  }
+  if (read_primitive<std::uint16_t>(data, offset) != kVersion) {
+    throw std::runtime_error("unsupported book checkpoint version");
+  }
+
+  BookCheckpoint checkpoint;
+  checkpoint.sequence = read_primitive<std::uint64_t>(data, offset);
+  checkpoint.wal_offset = read_primitive<std::uint64_t>(data, offset);
+  const auto book_count = read_primitive<std::uint32_t>(data, offset);
+  checkpoint.books.resize(book_count);
+  for (auto& book : checkpoint.books) {
+    book.market = read_primitive<common::MarketId>(data, offset);
+    book.next_sequence = read_primitive<std::uint64_t>(data, offset);
+    decode_orders(data, offset, book.bids);
+    decode_orders(data, offset, book.asks);
+  }
+  return checkpoint;
+}
+
+}  // namespace
+
+CheckpointStore::CheckpointStore(std::filesystem::path directory)
+    : directory_(std::move(directory)) {
+  if (!std::filesystem::exists(directory_)) {
+    std::filesystem::create_directories(directory_);
+  }
+  data_path_ = directory_ / "book_checkpoints.tc";
+  index_path_ = directory_ / "book_checkpoints.idx";
+}
+
+void CheckpointStore::persist(const BookCheckpoint& checkpoint) {
+  if (const auto latest = latest_sequence(); latest && checkpoint.sequence <= *latest) {
+    throw std::runtime_error("book checkpoint sequence must increase");
+  }
+
+  const auto encoded = encode_checkpoint(checkpoint);
+  const auto data_offset = std::filesystem::exists(data_path_)
+                               ? static_cast<std::uint64_t>(std::filesystem::file_size(data_path_))
+                               : std::uint64_t{0};
+
+  // Data is synced before its index entry is appended so a crash leaves at
+  // most an unreferenced tail in the data file, never an entry pointing at
+  // bytes that did not survive.
+  append_synced(data_path_, encoded.data(), encoded.size(), "failed to write book checkpoint");
+
+  const IndexEntry entry{
+      .sequence = checkpoint.sequence,
+      .wal_offset = checkpoint.wal_offset,
+      .data_offset = data_offset,
+      .size = static_cast<std::uint32_t>(encoded.size()),
+      .checksum = checksum32(encoded),
+  };
+  append_synced(index_path_, &entry, sizeof(entry), "failed to write book checkpoint index");
+}
+
+std::optional<BookCheckpoint> CheckpointStore::nearest(std::uint64_t sequence) const {
+  const auto entries = load_index();
+  auto it = std::upper_bound(entries.begin(), entries.end(), sequence,
+                             [](std::uint64_t seq, const IndexEntry& entry) { return seq < entry.sequence; });
+  if (it == entries.begin()) {
+    return std::nullopt;
+  }
+  const auto& entry = *std::prev(it);
+
+  std::ifstream data(data_path_, std::ios::binary);
+  if (!data) {
+    throw std::runtime_error("failed to open book checkpoint file for read: " + data_path_.string());
+  }
+  std::vector<std::byte> encoded(entry.size);
+  data.seekg(static_cast<std::streamoff>(entry.data_offset));
+  data.read(reinterpret_cast<char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+  if (!data) {
+    throw std::runtime_error("truncated book checkpoint");
+  }
+  if (checksum32(encoded) != entry.checksum) {
+    throw std::runtime_error("book checkpoint checksum mismatch");
+  }
+  return decode_checkpoint(encoded);
+}
+
+std::optional<std::uint64_t> CheckpointStore::latest_sequence() const {
+  const auto entries = load_index();
+  if (entries.empty()) {
+    return std::nullopt;
+  }
+  return entries.back().sequence;
+}
+
+std::size_t CheckpointStore::checkpoint_count() const {
+  return load_index().size();
+}
+
+std::vector<CheckpointStore::IndexEntry> CheckpointStore::load_index() const {
+  std::vector<IndexEntry> entries;
+  if (!std::filesystem::exists(index_path_)) {
+    return entries;
+  }
+
+  const auto index_bytes = static_cast<std::size_t>(std::filesystem::file_size(index_path_));
+  const auto data_bytes = std::filesystem::exists(data_path_)
+                              ? static_cast<std::uint64_t>(std::filesystem::file_size(data_path_))
+                              : std::uint64_t{0};
+
+  // A trailing partial entry is an interrupted append and is ignored.
+  entries.resize(index_bytes / sizeof(IndexEntry));
+  std::ifstream index(index_path_, std::ios::binary);
+  if (!index) {
+    throw std::runtime_error("failed to open book checkpoint index for read: " + index_path_.string());
+  }
+  index.read(reinterpret_cast<char*>(entries.data()),
+             static_cast<std::streamsize>(entries.size() * sizeof(IndexEntry)));
+  if (!index) {
+    throw std::runtime_error("failed to read book checkpoint index");
+  }
+
+  while (!entries.empty() && entries.back().data_offset + entries.back().size > data_bytes) {
+    entries.pop_back();
+  }
+  return entries;
+}
+
+}  // namespace replay
+}  // namespace tradecore
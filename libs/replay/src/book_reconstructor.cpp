@@ -0,0 +1,198 @@
+#include "tradecore/replay/book_reconstructor.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "tradecore/ingest/journal_record.hpp"
+#include "tradecore/replay/book_checkpoint.hpp"
+#include "tradecore/wal/wal_writer.hpp"
+
+namespace tradecore {
+namespace replay {
+
+matcher::OrderRequest new_order_request(const ingest::FrameHeader& header,
+                                        const ingest::sbe::NewOrder& order,
+                                        common::MarketId default_market) {
+  return matcher::OrderRequest{
+      .id = common::OrderId{
+          .market = order.market != 0 ? order.market : default_market,
+          .session = static_cast<common::SessionId>(header.account & 0xffff),
+          .local = static_cast<common::SequenceId>(header.nonce & 0xffffffff),
+      },
+      .account = header.account,
+      .side = order.side,
+      .quantity = order.quantity,
+      .price = order.price,
+      .display_quantity = order.display_quantity,
+      .tif = order.time_in_force,
+      .flags = order.flags,
+  };
+}
+
+BookReconstructor::BookReconstructor(Options options)
+    : options_(std::move(options)) {}
+
+void BookReconstructor::set_admission_hook(AdmissionHook hook) {
+  admission_hook_ = std::move(hook);
+}
+
+BookReconstructor::Result BookReconstructor::reconstruct(std::uint64_t target_sequence,
+                                                         matcher::MatchingEngine& engine) const {
+  Result result;
+
+  for (const auto market : options_.markets) {
+    engine.clear_market(market);
+  }
+
+  std::uint64_t resume_offset = 0;
+  const CheckpointStore checkpoints(options_.checkpoint_directory);
+  if (auto checkpoint = checkpoints.nearest(target_sequence)) {
+    for (const auto& book : checkpoint->books) {
+      engine.restore_book(book);
+    }
+    result.sequence = checkpoint->sequence;
+    result.checkpoint_sequence = checkpoint->sequence;
+    resume_offset = checkpoint->wal_offset;
+  }
+
+  if (!std::filesystem::exists(options_.wal_path)) {
+    return result;
+  }
+
+  wal::Reader reader(options_.wal_path);
+  reader.seek_offset(resume_offset);
+  wal::Record record;
+  while (reader.next(record)) {
+    if (record.header.sequence > target_sequence) {
+      break;
+    }
+    if (record.header.sequence <= result.sequence) {
+      continue;
+    }
+    apply_record(engine, static_cast<ingest::JournalRecordType>(record.header.type), record.payload);
+    result.sequence = record.header.sequence;
+    ++result.records_replayed;
+  }
+  return result;
+}
+
+BookReconstructor::Result BookReconstructor::restore(matcher::MatchingEngine& engine) const {
+  return reconstruct(std::numeric_limits<std::uint64_t>::max(), engine);
+}
+
+std::size_t BookReconstructor::build_checkpoints(std::uint64_t interval) {
+  if (interval == 0) {
+    throw std::invalid_argument("checkpoint interval must be positive");
+  }
+  if (!std::filesystem::exists(options_.wal_path)) {
+    return 0;
+  }
+
+  CheckpointStore checkpoints(options_.checkpoint_directory);
+  matcher::MatchingEngine engine;
+  for (const auto market : options_.markets) {
+    engine.add_market(market);
+  }
+
+  std::uint64_t last_sequence = 0;
+  std::uint64_t resume_offset = 0;
+  if (const auto latest = checkpoints.latest_sequence()) {
+    const auto checkpoint = checkpoints.nearest(*latest);
+    for (const auto& book : checkpoint->books) {
+      engine.restore_book(book);
+    }
+    last_sequence = checkpoint->sequence;
+    resume_offset = checkpoint->wal_offset;
+  }
+
+  wal::Reader reader(options_.wal_path);
+  reader.seek_offset(resume_offset);
+  wal::Record record;
+  std::uint64_t checkpoint_sequence = last_sequence;
+  std::size_t written = 0;
+  while (reader.next(record)) {
+    if (record.header.sequence <= last_sequence) {
+      continue;
+    }
+    const auto type = static_cast<ingest::JournalRecordType>(record.header.type);
+    if (type == ingest::JournalRecordType::kUnchecked) {
+      throw std::runtime_error("WAL record " + std::to_string(record.header.sequence) +
+                               " predates journaled risk outcomes; cannot checkpoint past it");
+    }
+    apply_record(engine, type, record.payload);
+    last_sequence = record.header.sequence;
+
+    if (last_sequence - checkpoint_sequence >= interval) {
+      BookCheckpoint checkpoint{
+          .sequence = last_sequence,
+          .wal_offset = reader.offset(),
+      };
+      for (const auto market : engine.market_ids()) {
+        checkpoint.books.push_back(engine.export_book(market));
+      }
+      checkpoints.persist(checkpoint);
+      checkpoint_sequence = last_sequence;
+      ++written;
+    }
+  }
+  return written;
+}
+
+void BookReconstructor::apply_record(matcher::MatchingEngine& engine, ingest::JournalRecordType type,
+                                     std::span<const std::byte> payload) const {
+  ingest::Frame frame;
+  if (type == ingest::JournalRecordType::kRejected || !ingest::decode_journal_record(payload, frame)) {
+    return;
+  }
+
+  // Malformed messages were rejected by the live sequencer as well, so they
+  // are skipped rather than aborting the reconstruction.
+  try {
+    switch (frame.header.kind) {
+      case ingest::MessageKind::kNewOrder: {
+        const auto order = ingest::sbe::decode_new_order(frame.payload);
+        if (!order) {
+          break;
+        }
+        const auto request = new_order_request(frame.header, *order, options_.default_market);
+        if (type == ingest::JournalRecordType::kUnchecked && admission_hook_ && !admission_hook_(request)) {
+          break;
+        }
+        (void)engine.submit(request);
+        break;
+      }
+      case ingest::MessageKind::kCancel: {
+        const auto cancel = ingest::sbe::decode_cancel(frame.payload);
+        if (!cancel) {
+          break;
+        }
+        (void)engine.cancel({.id = common::OrderId::from_value(cancel->order_id)});
+        break;
+      }
+      case ingest::MessageKind::kReplace: {
+        const auto replace = ingest::sbe::decode_replace(frame.payload);
+        if (!replace) {
+          break;
+        }
+        (void)engine.replace({
+            .id = common::OrderId::from_value(replace->order_id),
+            .new_quantity = replace->new_quantity,
+            .new_price = replace->new_price,
+            .new_display_quantity = replace->new_display_quantity,
+            .new_tif = replace->new_time_in_force,
+            .new_flags = replace->new_flags,
+        });
+        break;
+      }
+      case ingest::MessageKind::kHeartbeat:
+      case ingest::MessageKind::kBatch:
+        break;
+    }
+  } catch (const std::runtime_error&) {
+  }
+}
+
+}  // namespace replay
+}  // namespace tradecore
@@ -13,7 +13,9 @@ namespace wal {
 struct RecordHeader {
   std::uint32_t magic{0x5443574c};      // 'TCWL'
   std::uint16_t version{1};
-  std::uint16_t reserved{0};
+  // What the payload holds, for the writer's client to interpret; carried
+  // through append() as given, 0 when untyped.
+  std::uint16_t type{0};
   std::uint64_t sequence{0};
   std::uint32_t payload_size{0};
   std::uint32_t checksum{0};
@@ -43,12 +45,15 @@ class Writer {
   void flush();
   void sync();
   [[nodiscard]] std::uint64_t next_sequence() const noexcept { return next_sequence_; }
+  // Byte offset in the file at which the next appended record will start.
+  [[nodiscard]] std::uint64_t next_offset() const noexcept { return next_offset_; }
 
  private:
   std::FILE* file_{nullptr};
   std::vector<std::byte> buffer_{};
   std::size_t flush_threshold_;
   std::uint64_t next_sequence_{1};
+  std::uint64_t next_offset_{0};
 
   void ensure_open(const std::filesystem::path& path);
 };
@@ -64,6 +69,10 @@ class Reader {
 
   bool next(Record& out_record);
   void seek_sequence(std::uint64_t sequence);
+  // Positions the reader at a record boundary previously reported by
+  // Writer::next_offset() or Reader::offset().
+  void seek_offset(std::uint64_t offset);
+  [[nodiscard]] std::uint64_t offset() const;
 
  private:
   std::FILE* file_{nullptr};
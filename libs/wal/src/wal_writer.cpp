@@ -84,6 +84,11 @@ void Writer::ensure_open(const std::filesystem::path& path) {
   while (reader.next(record)) {
     next_sequence_ = record.header.sequence + 1;
   }
+  const auto end_offset = std::ftell(file_);
+  if (end_offset < 0) {
+    throw std::runtime_error("failed to query WAL size: " + path.string());
+  }
+  next_offset_ = static_cast<std::uint64_t>(end_offset);
 }
 
 void Writer::append(const RecordView& record_view) {
@@ -102,6 +107,7 @@ void Writer::append(const RecordView& record_view) {
   buffer_.insert(buffer_.end(), header_bytes.begin(), header_bytes.end());
   const auto payload_bytes = record_view.payload;
   buffer_.insert(buffer_.end(), payload_bytes.begin(), payload_bytes.end());
+  next_offset_ += sizeof(RecordHeader) + payload_bytes.size();
 
   if (buffer_.size() >= flush_threshold_) {
     flush();
@@ -192,5 +198,25 @@ void Reader::seek_sequence(std::uint64_t sequence) {
   }
 }
 
+void Reader::seek_offset(std::uint64_t offset) {
+  if (!file_) {
+    return;
+  }
+  if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0) {
+    throw std::runtime_error("failed to seek in WAL");
+  }
+}
+
+std::uint64_t Reader::offset() const {
+  if (!file_) {
+    return 0;
+  }
+  const auto position = std::ftell(file_);
+  if (position < 0) {
+    throw std::runtime_error("failed to query WAL position");
+  }
+  return static_cast<std::uint64_t>(position);
+}
+
 }  // namespace wal
 }  // namespace tradecore
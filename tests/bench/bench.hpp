@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+
+#include "tradecore/common/cpu.hpp"
+
+namespace tradecore::bench {
+
+// Benchmarks declared by the bench_*.cpp files; main() runs the ones named on
+// the command line, or all of them.
+void bench_spsc_ring();
+void bench_mpsc_ring();
+void bench_rate_limiter();
+void bench_signature_verify();
+void bench_key_store();
+void bench_sbe();
+void bench_batch_frames();
+void bench_shm_transport();
+
+// Producer and consumer CPUs for two-thread benchmarks; -1 leaves a thread
+// unpinned when the affinity mask does not offer two distinct CPUs.
+struct CpuPair {
+  int producer{-1};
+  int consumer{-1};
+};
+CpuPair pick_cpu_pair();
+
+// Spins on a failed poll, then yields so oversubscribed hosts still progress.
+class Backoff {
+ public:
+  void pause() noexcept {
+    if (++spins_ < kSpinLimit) {
+      common::cpu_relax();
+      return;
+    }
+    spins_ = 0;
+    std::this_thread::yield();
+  }
+  void reset() noexcept { spins_ = 0; }
+
+ private:
+  static constexpr std::uint32_t kSpinLimit = 256;
+  std::uint32_t spins_{0};
+};
+
+// Prints one result row: name, operations per second and ns per operation.
+void report(std::string_view name, std::uint64_t operations, std::chrono::nanoseconds elapsed);
+
+}  // namespace tradecore::bench
@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "tradecore/auth/authenticator.hpp"
+#include "tradecore/ingest/ingress_pipeline.hpp"
+#include "tradecore/ingest/sbe_messages.hpp"
+#include "tradecore/ingest/transport.hpp"
+
+namespace tradecore::bench {
+
+namespace {
+
+constexpr common::AccountId kAccount = 1;
+// As many replaces as fit one MTU-sized batch datagram.
+constexpr std::size_t kMessages = 36;
+constexpr std::size_t kRounds = 40;
+
+// Datagram with an ed25519 signature over the frame header and the rest of
+// the payload, as the daemon's verifier expects.
+std::vector<std::byte> signed_datagram(const auth::SecretKey& secret, ingest::MessageKind kind, std::uint64_t nonce,
+                                       std::span<const std::byte> body) {
+  const ingest::FrameHeader header{.account = kAccount, .nonce = nonce, .kind = kind};
+  std::vector<std::byte> message(sizeof(header));
+  std::memcpy(message.data(), &header, sizeof(header));
+  message.insert(message.end(), body.begin(), body.end());
+  auth::Signature signature;
+  auth::Authenticator::sign(secret, message, signature);
+
+  const ingest::WireHeader wire{
+      .magic = ingest::WireHeader::kMagic,
+      .version = ingest::WireHeader::kVersion,
+      .flags = 0,
+      .account = kAccount,
+      .nonce = nonce,
+      .timestamp_ns = 0,
+      .priority = 0,
+      .kind = static_cast<std::uint8_t>(kind),
+      .payload_len = static_cast<std::uint16_t>(signature.size() + body.size()),
+  };
+  std::vector<std::byte> datagram(sizeof(wire));
+  std::memcpy(datagram.data(), &wire, sizeof(wire));
+  const auto* signature_bytes = reinterpret_cast<const std::byte*>(signature.data());
+  datagram.insert(datagram.end(), signature_bytes, signature_bytes + signature.size());
+  datagram.insert(datagram.end(), body.begin(), body.end());
+  return datagram;
+}
+
+// Parses and admits every datagram, then drains the rings, `kRounds` times.
+void run(std::string_view name, ingest::IngressPipeline& pipeline, const std::vector<std::vector<std::byte>>& datagrams) {
+  std::vector<ingest::Frame> frames(ingest::kMaxBatchMessages);
+  ingest::OwnedFrame out;
+  std::uint64_t admitted = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t round = 0; round < kRounds; ++round) {
+    for (const auto& datagram : datagrams) {
+      const auto count = ingest::UdpTransport::parse_frame(datagram.data(), datagram.size(), frames);
+      pipeline.submit(std::span<const ingest::Frame>(frames.data(), count));
+    }
+    while (pipeline.next(out)) {
+      ++admitted;
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  report(name, kRounds * kMessages, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+  if (admitted != kRounds * kMessages) {
+    std::printf("  unexpected rejections: %llu\n", static_cast<unsigned long long>(kRounds * kMessages - admitted));
+  }
+}
+
+}  // namespace
+
+void bench_batch_frames() {
+  auth::Authenticator authenticator;
+  auth::PublicKey public_key;
+  auth::SecretKey secret;
+  auth::Authenticator::generate_keypair(public_key, secret);
+  authenticator.register_account(kAccount, public_key);
+  const auth::FrameAuthenticator frame_auth(authenticator);
+
+  // A market maker requoting: kMessages replaces, as separate datagrams and
+  // as one batch. Every round resubmits the same nonces, so replay
+  // protection is off.
+  ingest::IngressPipeline pipeline;
+  ingest::IngressPipeline::Config cfg;
+  cfg.replay_protection = false;
+  cfg.max_replaces_per_second = 1'000'000'000;
+  pipeline.configure(cfg, [&frame_auth](const ingest::FrameHeader& header, std::span<const std::byte> payload) {
+    return frame_auth.verify_frame(&header, sizeof(header), payload, header.account);
+  });
+
+  std::vector<std::vector<std::byte>> singles;
+  std::vector<std::byte> batch_body{static_cast<std::byte>(kMessages)};
+  for (std::size_t i = 0; i < kMessages; ++i) {
+    const auto replace = ingest::sbe::encode(ingest::sbe::Replace{
+        .order_id = i + 1,
+        .new_quantity = 1,
+        .new_price = static_cast<std::int64_t>(100 + i),
+    });
+    singles.push_back(signed_datagram(secret, ingest::MessageKind::kReplace, i + 1, replace));
+    batch_body.push_back(static_cast<std::byte>(ingest::MessageKind::kReplace));
+    batch_body.push_back(static_cast<std::byte>(replace.size()));
+    batch_body.insert(batch_body.end(), replace.begin(), replace.end());
+  }
+  const std::vector<std::vector<std::byte>> batch{signed_datagram(secret, ingest::MessageKind::kBatch, 1, batch_body)};
+  std::printf("  %zu replaces: %zu bytes as single frames, %zu bytes as one batch\n", kMessages,
+              singles.size() * singles.front().size(), batch.front().size());
+
+  run("single frames, per message", pipeline, singles);
+  run("batch of " + std::to_string(kMessages) + ", per message", pipeline, batch);
+}
+
+}  // namespace tradecore::bench
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "tradecore/auth/authenticator.hpp"
+#include "tradecore/auth/key_store.hpp"
+
+namespace tradecore::bench {
+
+namespace {
+
+constexpr std::uint64_t kAccounts = 2'000'000;
+constexpr std::uint64_t kLookups = 10'000'000;
+
+}  // namespace
+
+void bench_key_store() {
+  namespace fs = std::filesystem;
+  const auto path = fs::temp_directory_path() / "tradecore_bench_accounts.keys";
+  fs::remove(path.string() + ".log");
+  {
+    std::vector<auth::KeyTable::Entry> entries;
+    entries.reserve(kAccounts);
+    for (std::uint64_t account = 1; account <= kAccounts; ++account) {
+      auth::PublicKey key{};
+      std::memcpy(key.data(), &account, sizeof(account));
+      entries.emplace_back(account * 7, key);
+    }
+    auth::KeyStore::write(path, entries);
+  }
+
+  // Startup: map, validate and publish the whole store.
+  auth::Authenticator authenticator;
+  const auto start = std::chrono::steady_clock::now();
+  auth::KeyStore store(path);
+  authenticator.load(store);
+  const auto loaded = std::chrono::steady_clock::now() - start;
+  std::printf("  load %llu accounts: %.2f ms\n", static_cast<unsigned long long>(authenticator.account_count()),
+              std::chrono::duration<double, std::milli>(loaded).count());
+
+  // Registration on top of the mapped base copies only the overlay.
+  {
+    constexpr std::uint64_t kRegistrations = 1'000;
+    const auto register_start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < kRegistrations; ++i) {
+      authenticator.register_account((kAccounts + 1 + i) * 7, auth::PublicKey{});
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - register_start;
+    report("register_account over mapped base", kRegistrations,
+           std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+  }
+
+  for (const bool present : {true, false}) {
+    std::uint64_t found = 0;
+    const auto lookup_start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < kLookups; ++i) {
+      const auto account = ((i * 0x9e3779b1ULL) % kAccounts + 1) * 7 + (present ? 0 : 1);
+      found += authenticator.has_account(account);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - lookup_start;
+    report(present ? "lookup, registered" : "lookup, unknown", kLookups,
+           std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    std::printf("  found=%llu\n", static_cast<unsigned long long>(found));
+  }
+
+  fs::remove(path);
+}
+
+}  // namespace tradecore::bench
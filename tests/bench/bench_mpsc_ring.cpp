@@ -0,0 +1,119 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.hpp"
+#include "tradecore/common/mpsc_ring.hpp"
+
+namespace tradecore::bench {
+
+namespace {
+
+constexpr std::uint64_t kMessages = 8'000'000;
+constexpr std::size_t kCapacity = 4096;
+constexpr std::size_t kBatch = 32;
+
+// Bounded deque behind a mutex: the lock-based fan-in the ring replaces.
+class MutexDeque {
+ public:
+  bool push(std::uint64_t value) {
+    std::lock_guard lock(mutex_);
+    if (items_.size() == kCapacity) {
+      return false;
+    }
+    items_.push_back(value);
+    return true;
+  }
+
+  std::size_t pop_batch(std::span<std::uint64_t> out) {
+    std::lock_guard lock(mutex_);
+    std::size_t count = 0;
+    while (count < out.size() && !items_.empty()) {
+      out[count++] = items_.front();
+      items_.pop_front();
+    }
+    return count;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::deque<std::uint64_t> items_;
+};
+
+// `producers` threads share kMessages pushes; the calling thread drains in
+// batches of kBatch.
+template <typename Queue>
+void run_fan_in(const std::string& name, Queue& queue, std::size_t producers) {
+  const std::uint64_t per_producer = kMessages / producers;
+  const std::uint64_t total = per_producer * producers;
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      Backoff backoff;
+      while (!go.load(std::memory_order_acquire)) {
+        backoff.pause();
+      }
+      for (std::uint64_t i = 0; i < per_producer;) {
+        if (queue.push(p * per_producer + i)) {
+          backoff.reset();
+          ++i;
+        } else {
+          backoff.pause();
+        }
+      }
+    });
+  }
+
+  std::array<std::uint64_t, kBatch> out{};
+  std::uint64_t received = 0;
+  std::uint64_t checksum = 0;
+  Backoff backoff;
+  const auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  while (received < total) {
+    const auto count = queue.pop_batch(out);
+    if (count == 0) {
+      backoff.pause();
+      continue;
+    }
+    backoff.reset();
+    for (std::size_t i = 0; i < count; ++i) {
+      checksum += out[i];
+    }
+    received += count;
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  report(name, total, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+  if (checksum != total * (total - 1) / 2) {
+    std::printf("  checksum mismatch\n");
+  }
+}
+
+}  // namespace
+
+void bench_mpsc_ring() {
+  for (const std::size_t producers : {1, 2, 4}) {
+    {
+      MutexDeque queue;
+      run_fan_in("mutex deque, " + std::to_string(producers) + " producers", queue, producers);
+    }
+    {
+      common::MpscRing<std::uint64_t> ring(kCapacity);
+      run_fan_in("mpsc ring, " + std::to_string(producers) + " producers", ring, producers);
+    }
+  }
+}
+
+}  // namespace tradecore::bench
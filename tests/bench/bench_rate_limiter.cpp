@@ -0,0 +1,36 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "bench.hpp"
+#include "tradecore/ingest/rate_limiter.hpp"
+
+namespace tradecore::bench {
+
+namespace {
+
+constexpr std::uint64_t kChecks = 20'000'000;
+
+}  // namespace
+
+void bench_rate_limiter() {
+  for (const std::uint64_t accounts : {16, 4'096, 49'152}) {
+    ingest::RateLimiter limiter({.capacity = 1 << 16});
+    // Spread arrivals 10ns apart so most checks are admitted and the bucket
+    // update is on the measured path.
+    std::uint64_t admitted = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < kChecks; ++i) {
+      const auto account = (i * 0x9e3779b1ULL) % accounts + 1;
+      admitted += limiter.admit(account, ingest::MessageKind::kNewOrder, static_cast<common::TimestampNs>(i * 10));
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    report("admit, " + std::to_string(accounts) + " accounts", kChecks,
+           std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    std::printf("  admitted=%llu overflows=%llu\n", static_cast<unsigned long long>(admitted),
+                static_cast<unsigned long long>(limiter.stats().overflows));
+  }
+}
+
+}  // namespace tradecore::bench
@@ -0,0 +1,88 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "tradecore/ingest/sbe_messages.hpp"
+
+namespace tradecore::bench {
+
+namespace {
+
+constexpr std::size_t kMessages = 1'024;
+constexpr std::size_t kRounds = 20'000;
+
+// Keeps a result live without a memory round trip per operation.
+template <typename T>
+void keep(T& value) {
+  asm volatile("" : "+r"(value));
+}
+
+template <typename Fn>
+void run(const char* name, Fn&& fn) {
+  std::uint64_t sink = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t round = 0; round < kRounds; ++round) {
+    for (std::size_t i = 0; i < kMessages; ++i) {
+      sink += fn(i);
+      keep(sink);
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  report(name, kRounds * kMessages, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+  if (sink == 0) {
+    std::printf("  (sink empty)\n");
+  }
+}
+
+}  // namespace
+
+void bench_sbe() {
+  using namespace ingest::sbe;
+
+  std::vector<NewOrder> orders(kMessages);
+  std::vector<Replace> replaces(kMessages);
+  for (std::size_t i = 0; i < kMessages; ++i) {
+    orders[i] = {.side = i % 2 ? common::Side::kSell : common::Side::kBuy,
+                 .quantity = static_cast<std::int64_t>(i + 1),
+                 .price = static_cast<std::int64_t>(1'000 + i),
+                 .flags = static_cast<std::uint16_t>(i & 3)};
+    replaces[i] = {.order_id = i, .new_quantity = static_cast<std::int64_t>(i), .new_price = 7, .new_flags = 0};
+  }
+
+  // Wire buffers packed back to back, so most messages sit unaligned.
+  std::vector<std::byte> wire(kMessages * kNewOrderEncodedSize);
+  std::vector<std::byte> replace_wire(kMessages * kReplaceEncodedSize);
+  for (std::size_t i = 0; i < kMessages; ++i) {
+    encode(orders[i], std::span(wire).subspan(i * kNewOrderEncodedSize, kNewOrderEncodedSize));
+    encode(replaces[i], std::span(replace_wire).subspan(i * kReplaceEncodedSize, kReplaceEncodedSize));
+  }
+  auto order_at = [&](std::size_t i) {
+    return std::span<const std::byte>(wire).subspan(i * kNewOrderEncodedSize, kNewOrderEncodedSize);
+  };
+
+  run("new_order encode, span", [&](std::size_t i) {
+    return encode(orders[i], std::span(wire).subspan(i * kNewOrderEncodedSize, kNewOrderEncodedSize));
+  });
+  run("new_order encode, vector", [&](std::size_t i) { return encode(orders[i]).size(); });
+  run("new_order decode, flyweight price", [&](std::size_t i) {
+    return static_cast<std::uint64_t>(NewOrderDecoder::wrap(order_at(i))->price());
+  });
+  run("new_order decode, whole message", [&](std::size_t i) {
+    const auto order = decode_new_order(order_at(i));
+    return static_cast<std::uint64_t>(order->quantity + order->price + order->flags);
+  });
+  run("replace encode, span", [&](std::size_t i) {
+    return encode(replaces[i], std::span(replace_wire).subspan(i * kReplaceEncodedSize, kReplaceEncodedSize));
+  });
+  run("replace decode, whole message", [&](std::size_t i) {
+    const auto replace =
+        decode_replace(std::span<const std::byte>(replace_wire).subspan(i * kReplaceEncodedSize, kReplaceEncodedSize));
+    return replace->order_id + static_cast<std::uint64_t>(replace->new_quantity);
+  });
+}
+
+}  // namespace tradecore::bench
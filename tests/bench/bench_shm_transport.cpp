@@ -0,0 +1,134 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "tradecore/ingest/sbe_messages.hpp"
+#include "tradecore/ingest/shm_transport.hpp"
+#include "tradecore/ingest/transport.hpp"
+
+namespace tradecore::bench {
+
+namespace {
+
+constexpr std::uint64_t kPings = 10'000;
+constexpr std::uint64_t kStream = 200'000;
+constexpr std::uint16_t kUdpPort = 39300;
+
+std::vector<std::byte> order_datagram() {
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 100});
+  const ingest::WireHeader wire{
+      .magic = ingest::WireHeader::kMagic,
+      .version = ingest::WireHeader::kVersion,
+      .flags = 0,
+      .account = 1,
+      .nonce = 1,
+      .timestamp_ns = 0,
+      .priority = 0,
+      .kind = static_cast<std::uint8_t>(ingest::MessageKind::kNewOrder),
+      .payload_len = static_cast<std::uint16_t>(ingest::kFrameSignatureSize + order.size()),
+  };
+  std::vector<std::byte> datagram(sizeof(wire) + ingest::kFrameSignatureSize);
+  std::memcpy(datagram.data(), &wire, sizeof(wire));
+  datagram.insert(datagram.end(), order.begin(), order.end());
+  return datagram;
+}
+
+// One frame in flight at a time: `send` hands a datagram to the transport
+// and the time until its frame reaches the callback is the one-way latency.
+void ping(std::string_view name, const std::atomic<std::uint64_t>& delivered,
+          const std::function<bool()>& send) {
+  Backoff backoff;
+  const auto start = std::chrono::steady_clock::now();
+  for (std::uint64_t i = 0; i < kPings; ++i) {
+    while (!send()) {
+      backoff.pause();
+    }
+    backoff.reset();
+    while (delivered.load(std::memory_order_acquire) <= i) {
+      backoff.pause();
+    }
+    backoff.reset();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  report(name, kPings, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+}
+
+}  // namespace
+
+void bench_shm_transport() {
+  const auto cpus = pick_cpu_pair();
+  const auto datagram = order_datagram();
+  std::atomic<std::uint64_t> delivered{0};
+  auto count = [&delivered](std::span<const ingest::Frame> frames) {
+    delivered.fetch_add(frames.size(), std::memory_order_release);
+  };
+  common::pin_current_thread(cpus.producer);
+
+  // Both transports spin on the consumer CPU while the calling thread sends;
+  // with a single CPU they idle between polls instead.
+  const ingest::TransportOptions options{
+      .receive_batch_size = 1,
+      .busy_poll = cpus.consumer >= 0,
+      .receive_cpus = {cpus.consumer},
+  };
+
+  {
+    const std::string name = "tradecore-bench-" + std::to_string(getpid());
+    ingest::ShmTransport transport(options);
+    ingest::ShmClient client;
+    if (!transport.start("shm://" + name, count) || !client.connect(name)) {
+      std::printf("  shm transport unavailable\n");
+      return;
+    }
+    ping("shm one-way, send to callback", delivered, [&] { return client.send(datagram); });
+
+    delivered.store(0);
+    Backoff backoff;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < kStream; ++i) {
+      while (!client.send(datagram)) {
+        backoff.pause();
+      }
+      backoff.reset();
+    }
+    while (delivered.load(std::memory_order_acquire) < kStream) {
+      backoff.pause();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    report("shm stream, per frame", kStream, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    transport.stop();
+  }
+
+  {
+    delivered.store(0);
+    ingest::UdpTransport transport(options);
+    if (!transport.start("udp://127.0.0.1:" + std::to_string(kUdpPort), count)) {
+      std::printf("  udp transport unavailable\n");
+      return;
+    }
+    const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(kUdpPort);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    ping("udp loopback one-way, send to callback", delivered, [&] {
+      return sendto(sender, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&target),
+                    sizeof(target)) > 0;
+    });
+    close(sender);
+    transport.stop();
+  }
+}
+
+}  // namespace tradecore::bench
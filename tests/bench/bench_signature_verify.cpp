@@ -0,0 +1,153 @@
+#include <sodium.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "tradecore/auth/authenticator.hpp"
+#include "tradecore/auth/session.hpp"
+#include "tradecore/ingest/frame.hpp"
+
+namespace tradecore::bench {
+
+namespace {
+
+constexpr std::size_t kFrames = 256;
+constexpr std::size_t kAccounts = 64;
+constexpr std::size_t kRounds = 8;
+constexpr std::size_t kMacRounds = 4'000;
+constexpr std::size_t kBodySize = 48;
+
+struct SignedFrame {
+  ingest::FrameHeader header{};
+  std::vector<std::byte> payload;  // [signature:64][body]
+};
+
+std::span<const std::byte> body_of(const SignedFrame& frame) {
+  return std::span<const std::byte>(frame.payload).subspan(auth::kSignatureSize);
+}
+
+std::vector<SignedFrame> make_frames(auth::Authenticator& authenticator, std::vector<auth::SecretKey>& secrets) {
+  secrets.resize(kAccounts);
+  for (std::size_t a = 0; a < kAccounts; ++a) {
+    auth::PublicKey public_key;
+    auth::Authenticator::generate_keypair(public_key, secrets[a]);
+    authenticator.register_account(a + 1, public_key);
+  }
+
+  std::vector<SignedFrame> frames(kFrames);
+  std::vector<std::byte> message;
+  for (std::size_t i = 0; i < kFrames; ++i) {
+    auto& frame = frames[i];
+    frame.header = {.account = i % kAccounts + 1, .nonce = i + 1, .kind = ingest::MessageKind::kNewOrder};
+    frame.payload.assign(auth::kSignatureSize + kBodySize, std::byte{static_cast<unsigned char>(i)});
+
+    const auto* header_bytes = reinterpret_cast<const std::byte*>(&frame.header);
+    message.assign(header_bytes, header_bytes + sizeof(frame.header));
+    message.insert(message.end(), frame.payload.begin() + auth::kSignatureSize, frame.payload.end());
+    auth::Signature signature;
+    auth::Authenticator::sign(secrets[i % kAccounts], message, signature);
+    std::memcpy(frame.payload.data(), signature.data(), signature.size());
+  }
+  return frames;
+}
+
+}  // namespace
+
+void bench_signature_verify() {
+  auth::Authenticator authenticator;
+  const auth::FrameAuthenticator frame_auth(authenticator);
+  std::vector<auth::SecretKey> secrets;
+  const auto frames = make_frames(authenticator, secrets);
+
+  {
+    std::uint64_t valid = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < kRounds; ++round) {
+      for (const auto& frame : frames) {
+        valid += frame_auth.verify_frame(&frame.header, sizeof(frame.header), frame.payload, frame.header.account);
+      }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    report("verify_frame", kRounds * kFrames, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    if (valid != kRounds * kFrames) {
+      std::printf("  unexpected failures: %llu\n", static_cast<unsigned long long>(kRounds * kFrames - valid));
+    }
+  }
+
+  std::vector<auth::FrameAuthenticator::FrameInput> inputs;
+  for (const auto& frame : frames) {
+    inputs.push_back({
+        .header_data = &frame.header,
+        .header_size = sizeof(frame.header),
+        .payload = frame.payload,
+        .account = frame.header.account,
+    });
+  }
+  std::array<bool, kFrames> results{};
+  for (const std::size_t batch : {1, 16, 64, 256}) {
+    std::uint64_t failed_batches = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < kRounds; ++round) {
+      for (std::size_t first = 0; first < kFrames; first += batch) {
+        const auto count = std::min(batch, kFrames - first);
+        failed_batches += frame_auth.verify_frames(std::span(inputs).subspan(first, count),
+                                                   std::span<bool>(results.data(), count))
+                              ? 0
+                              : 1;
+      }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    report("verify_frames, batch " + std::to_string(batch), kRounds * kFrames,
+           std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    if (failed_batches != 0) {
+      std::printf("  unexpected failed batches: %llu\n", static_cast<unsigned long long>(failed_batches));
+    }
+  }
+
+  // Session fast path: the same frames MACed under per-account session keys
+  // and checked through a SessionTable.
+  auth::SessionTable sessions(authenticator, {.capacity = kAccounts});
+  std::vector<auth::SessionKey> keys(kAccounts);
+  for (std::size_t a = 0; a < kAccounts; ++a) {
+    auth::KxPublicKey client_public;
+    auth::KxSecretKey client_secret;
+    crypto_kx_keypair(client_public.data(), client_secret.data());
+    // Hello nonces start at 1: they must exceed the account's last one.
+    const auth::SessionHello hello{.account = a + 1, .nonce = 1, .client_key = client_public};
+    auth::Signature signature;
+    auth::Authenticator::sign(secrets[a], auth::session_hello_message(hello), signature);
+    const auto accept = sessions.open(hello, signature, 0);
+    keys[a] = auth::SessionTable::client_session_key(hello, client_secret, accept->server_key);
+  }
+  std::vector<auth::SessionMac> macs;
+  for (const auto& frame : frames) {
+    macs.push_back(auth::SessionTable::mac(keys[frame.header.account - 1],
+                                           std::as_bytes(std::span(&frame.header, 1)), body_of(frame)));
+  }
+  {
+    std::uint64_t valid = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < kMacRounds; ++round) {
+      for (std::size_t i = 0; i < kFrames; ++i) {
+        const auto& frame = frames[i];
+        // Nonces above the hello nonce; the table does not track replays.
+        valid += sessions.verify(frame.header.account, frame.header.nonce + 1,
+                                 std::as_bytes(std::span(&frame.header, 1)), body_of(frame), macs[i], 1);
+      }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    report("session mac", kMacRounds * kFrames, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+    if (valid != kMacRounds * kFrames) {
+      std::printf("  unexpected failures: %llu\n", static_cast<unsigned long long>(kMacRounds * kFrames - valid));
+    }
+  }
+}
+
+}  // namespace tradecore::bench
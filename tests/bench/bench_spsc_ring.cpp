@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <thread>
+
+#include "bench.hpp"
+#include "legacy_spsc_ring.hpp"
+#include "tradecore/common/spsc_ring.hpp"
+
+namespace tradecore::bench {
+
+namespace {
+
+constexpr std::uint64_t kMessages = 20'000'000;
+constexpr std::size_t kCapacity = 4096;
+constexpr std::size_t kBatch = 32;
+
+// Streams kMessages sequence numbers from a producer thread to the calling
+// thread; `produce(next)` and `consume(checksum)` return how many messages
+// they moved. The checksum keeps the consumer loop from being elided.
+template <typename Produce, typename Consume>
+void run_pair(std::string_view name, Produce produce, Consume consume) {
+  const auto cpus = pick_cpu_pair();
+  const auto start = std::chrono::steady_clock::now();
+  std::thread producer([&] {
+    common::pin_current_thread(cpus.producer);
+    Backoff backoff;
+    std::uint64_t next = 0;
+    while (next < kMessages) {
+      const auto moved = produce(next);
+      if (moved == 0) {
+        backoff.pause();
+      } else {
+        backoff.reset();
+        next += moved;
+      }
+    }
+  });
+  common::pin_current_thread(cpus.consumer);
+  Backoff backoff;
+  std::uint64_t received = 0;
+  std::uint64_t checksum = 0;
+  while (received < kMessages) {
+    const auto moved = consume(checksum);
+    if (moved == 0) {
+      backoff.pause();
+    } else {
+      backoff.reset();
+      received += moved;
+    }
+  }
+  producer.join();
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  report(name, kMessages, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+  if (checksum != kMessages * (kMessages - 1) / 2) {
+    std::printf("  checksum mismatch\n");
+  }
+}
+
+}  // namespace
+
+void bench_spsc_ring() {
+  {
+    LegacySpscRing<std::uint64_t> ring(kCapacity);
+    run_pair(
+        "legacy push/pop", [&](std::uint64_t next) -> std::size_t { return ring.push(next) ? 1 : 0; },
+        [&](std::uint64_t& checksum) -> std::size_t {
+          std::uint64_t value = 0;
+          if (!ring.pop(value)) {
+            return 0;
+          }
+          checksum += value;
+          return 1;
+        });
+  }
+  {
+    common::SpscRing<std::uint64_t> ring(kCapacity);
+    run_pair(
+        "cached push/pop", [&](std::uint64_t next) -> std::size_t { return ring.push(next) ? 1 : 0; },
+        [&](std::uint64_t& checksum) -> std::size_t {
+          std::uint64_t value = 0;
+          if (!ring.pop(value)) {
+            return 0;
+          }
+          checksum += value;
+          return 1;
+        });
+  }
+  {
+    common::SpscRing<std::uint64_t> ring(kCapacity);
+    std::array<std::uint64_t, kBatch> in{};
+    std::array<std::uint64_t, kBatch> out{};
+    run_pair(
+        "cached push_batch/pop_batch (32)",
+        [&](std::uint64_t next) -> std::size_t {
+          const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(kBatch, kMessages - next));
+          for (std::size_t i = 0; i < count; ++i) {
+            in[i] = next + i;
+          }
+          return ring.push_batch(std::span<const std::uint64_t>(in.data(), count));
+        },
+        [&](std::uint64_t& checksum) -> std::size_t {
+          const auto count = ring.pop_batch(out);
+          for (std::size_t i = 0; i < count; ++i) {
+            checksum += out[i];
+          }
+          return count;
+        });
+  }
+  {
+    common::SpscRing<std::uint64_t> ring(kCapacity);
+    run_pair(
+        "cached push/peek+consume", [&](std::uint64_t next) -> std::size_t { return ring.push(next) ? 1 : 0; },
+        [&](std::uint64_t& checksum) -> std::size_t {
+          const auto run = ring.peek();
+          for (const auto value : run) {
+            checksum += value;
+          }
+          ring.consume(run.size());
+          return run.size();
+        });
+  }
+}
+
+}  // namespace tradecore::bench
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace tradecore::bench {
+
+// The pre-2026-10 common::SpscRing, kept verbatim as the comparison baseline:
+// adjacent head/tail atomics, both reloaded on every operation, and
+// std::optional slots.
+template <typename T>
+class LegacySpscRing {
+ public:
+  explicit LegacySpscRing(std::size_t capacity_power_of_two)
+      : buffer_(capacity_power_of_two), mask_(capacity_power_of_two - 1) {
+    if (capacity_power_of_two == 0 || (capacity_power_of_two & mask_) != 0) {
+      throw std::invalid_argument("SpscRing capacity must be power of two");
+    }
+  }
+
+  bool push(T value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t next_head = (head + 1) & mask_;
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    if (next_head == tail) {
+      return false;  // full
+    }
+    buffer_[head] = std::move(value);
+    head_.store(next_head, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T& out) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    if (tail == head) {
+      return false;  // empty
+    }
+    out = std::move(*buffer_[tail]);
+    buffer_[tail].reset();
+    tail_.store((tail + 1) & mask_, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::vector<std::optional<T>> buffer_;
+  const std::size_t mask_;
+  std::atomic<std::size_t> head_{0};
+  std::atomic<std::size_t> tail_{0};
+};
+
+}  // namespace tradecore::bench
@@ -0,0 +1,78 @@
+// Benchmark runner - `tradecore_bench [name...]` runs the named benchmarks, or
+// every benchmark when none are given.
+
+#include <cstdio>
+#include <string_view>
+
+#include "bench.hpp"
+
+namespace {
+
+struct Benchmark {
+  std::string_view name;
+  void (*run)();
+};
+
+constexpr Benchmark kBenchmarks[] = {
+    {"spsc_ring", tradecore::bench::bench_spsc_ring},
+    {"mpsc_ring", tradecore::bench::bench_mpsc_ring},
+    {"rate_limiter", tradecore::bench::bench_rate_limiter},
+    {"signature_verify", tradecore::bench::bench_signature_verify},
+    {"key_store", tradecore::bench::bench_key_store},
+    {"sbe", tradecore::bench::bench_sbe},
+    {"batch_frames", tradecore::bench::bench_batch_frames},
+    {"shm_transport", tradecore::bench::bench_shm_transport},
+};
+
+}  // namespace
+
+namespace tradecore::bench {
+
+CpuPair pick_cpu_pair() {
+  CpuPair pair;
+  for (int cpu = 0; cpu < 1024; ++cpu) {
+    if (!common::cpu_available(cpu)) {
+      continue;
+    }
+    if (pair.producer < 0) {
+      pair.producer = cpu;
+    } else {
+      pair.consumer = cpu;
+      return pair;
+    }
+  }
+  return {};
+}
+
+void report(std::string_view name, std::uint64_t operations, std::chrono::nanoseconds elapsed) {
+  const double seconds = static_cast<double>(elapsed.count()) / 1e9;
+  const double rate = seconds > 0 ? static_cast<double>(operations) / seconds : 0.0;
+  const double ns_per_op = operations > 0 ? static_cast<double>(elapsed.count()) / static_cast<double>(operations) : 0.0;
+  std::printf("%-40.*s %12.2f Mops/s %9.2f ns/op\n", static_cast<int>(name.size()), name.data(), rate / 1e6, ns_per_op);
+}
+
+}  // namespace tradecore::bench
+
+int main(int argc, char** argv) {
+  int ran = 0;
+  for (const auto& benchmark : kBenchmarks) {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc; ++i) {
+      selected = selected || benchmark.name == argv[i];
+    }
+    if (selected) {
+      std::printf("== %.*s\n", static_cast<int>(benchmark.name.size()), benchmark.name.data());
+      benchmark.run();
+      ++ran;
+    }
+  }
+  if (ran == 0) {
+    std::fprintf(stderr, "no benchmark matched; available:");
+    for (const auto& benchmark : kBenchmarks) {
+      std::fprintf(stderr, " %.*s", static_cast<int>(benchmark.name.size()), benchmark.name.data());
+    }
+    std::fprintf(stderr, "\n");
+    return 1;
+  }
+  return 0;
+}
@@ -1,6 +1,8 @@
 // Unit test runner - calls test functions from per-component test files
 
 #include "test_api.hpp"
+#include "test_auth.hpp"
+#include "test_common.hpp"
 #include "test_funding.hpp"
 #include "test_ingest.hpp"
 #include "test_ledger.hpp"
@@ -12,9 +14,22 @@
 int main() {
   using namespace tradecore::tests;
 
+  // Common tests
+  test_spsc_ring();
+  test_spsc_ring_batches();
+  test_spsc_ring_threads();
+  test_mpsc_ring();
+  test_mpsc_ring_threads();
+
   // API tests
   test_api_router();
 
+  // Auth tests
+  test_verify_batch();
+  test_key_table_snapshots();
+  test_session_mac();
+  test_key_store();
+
   // Ledger tests
   test_ledger_credit_debit();
 
@@ -30,7 +45,25 @@ int main() {
   test_cancel_message();
   test_heartbeat_dropped();
   test_rate_limiting();
+  test_token_bucket_rate_limiter();
+  test_nonce_replay_window();
+  test_parallel_verify();
   test_sbe_decode_bounds();
+  test_sbe_schema_evolution();
+  test_peer_table();
+  test_frame_slab_zero_copy();
+  test_udp_batched_receive();
+  test_batch_frames();
+  test_ingress_lane_merge();
+  test_priority_scheduling();
+  test_udp_reuseport_lanes();
+  test_io_uring_receive();
+  test_busy_poll_receive();
+  test_shm_transport();
+  test_tcp_transport();
+  test_ingress_shedding();
+  test_reject_feedback();
+  test_kernel_receive_timestamps();
 
   // Funding tests
   test_funding_engine();
@@ -45,6 +78,8 @@ int main() {
   test_persistence_replay();
   test_persistence_replay_determinism();
   test_snapshot_compaction_and_integrity();
+  test_book_reconstruction();
+  test_book_restore_after_restart();
 
   return 0;
 }
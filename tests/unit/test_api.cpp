@@ -1,7 +1,9 @@
 #include "test_api.hpp"
 
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <string>
 
 #include "tradecore/api/api_router.hpp"
@@ -57,6 +59,22 @@ void test_api_router() {
   assert(metadata.size() == 2);
   assert(metadata[0].wal_offset == 8);
   assert(metadata[1].wal_offset == 9);
+
+  const api::TradeMetadata trade{.wal_offset = 12,
+                                 .order_id = {.market = 3, .session = 1, .local = 5},
+                                 .account = 44,
+                                 .market = 3,
+                                 .price = -250,
+                                 .quantity = 6,
+                                 .timestamp_ns = 1'700'000'000'000'000'000};
+  std::array<std::byte, api::sbe::kTradeReportEncodedSize> report{};
+  assert(api::encode_trade_report(trade, std::span<std::byte>(report).first(report.size() - 1)) == 0);
+  assert(api::encode_trade_report(trade, report) == report.size());
+  const auto decoded = api::sbe::decode_trade_report(report);
+  assert(decoded);
+  assert(decoded->wal_offset == 12 && decoded->order_id == trade.order_id.value() && decoded->account == 44);
+  assert(decoded->market == 3 && decoded->price == -250 && decoded->quantity == 6);
+  assert(decoded->timestamp_ns == trade.timestamp_ns);
 }
 
 }  // namespace tradecore::tests
@@ -0,0 +1,362 @@
+#include "test_auth.hpp"
+
+#include <sodium.h>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "tradecore/auth/authenticator.hpp"
+#include "tradecore/auth/key_store.hpp"
+#include "tradecore/auth/session.hpp"
+#include "tradecore/ingest/frame.hpp"
+
+namespace tradecore::tests {
+
+namespace {
+
+struct SignedFrame {
+  ingest::FrameHeader header{};
+  std::vector<std::byte> payload;
+};
+
+SignedFrame sign_frame(const auth::SecretKey& secret, common::AccountId account, std::uint64_t nonce) {
+  SignedFrame frame{.header = {.account = account, .nonce = nonce, .kind = ingest::MessageKind::kCancel}};
+  frame.payload.assign(auth::kSignatureSize + 16, std::byte{0x5a});
+  const auto* header_bytes = reinterpret_cast<const std::byte*>(&frame.header);
+  std::vector<std::byte> message(header_bytes, header_bytes + sizeof(frame.header));
+  message.insert(message.end(), frame.payload.begin() + auth::kSignatureSize, frame.payload.end());
+  auth::Signature signature;
+  assert(auth::Authenticator::sign(secret, message, signature));
+  std::memcpy(frame.payload.data(), signature.data(), signature.size());
+  return frame;
+}
+
+auth::FrameAuthenticator::FrameInput input(const SignedFrame& frame) {
+  return {
+      .header_data = &frame.header,
+      .header_size = sizeof(frame.header),
+      .payload = frame.payload,
+      .account = frame.header.account,
+  };
+}
+
+}  // namespace
+
+void test_verify_batch() {
+  auth::Authenticator authenticator;
+  std::array<auth::SecretKey, 2> secrets{};
+  for (common::AccountId account = 1; account <= secrets.size(); ++account) {
+    auth::PublicKey public_key;
+    auth::Authenticator::generate_keypair(public_key, secrets[account - 1]);
+    authenticator.register_account(account, public_key);
+  }
+  const auth::FrameAuthenticator frame_auth(authenticator);
+
+  std::vector<SignedFrame> frames;
+  frames.push_back(sign_frame(secrets[0], 1, 1));
+  frames.push_back(sign_frame(secrets[1], 2, 1));
+  frames.push_back(sign_frame(secrets[0], 1, 2));
+  frames[2].payload.back() ^= std::byte{1};         // tampered body
+  frames.push_back(sign_frame(secrets[1], 1, 3));   // signed with the wrong key
+  frames.push_back(sign_frame(secrets[0], 9, 1));   // unregistered account
+  frames.push_back(sign_frame(secrets[1], 2, 2));
+  frames[5].payload.resize(auth::kSignatureSize - 1);  // no room for a signature
+  frames.push_back(sign_frame(secrets[1], 2, 3));
+
+  std::vector<auth::FrameAuthenticator::FrameInput> inputs;
+  for (const auto& frame : frames) {
+    inputs.push_back(input(frame));
+  }
+  std::array<bool, 7> results{};
+  assert(!frame_auth.verify_frames(inputs, results));
+  const std::array<bool, 7> expected{true, true, false, false, false, false, true};
+  assert(results == expected);
+
+  // Batch outcomes agree with the single-frame path.
+  for (std::size_t i = 0; i < frames.size(); ++i) {
+    assert(frame_auth.verify_frame(&frames[i].header, sizeof(frames[i].header), frames[i].payload,
+                                   frames[i].header.account) == expected[i]);
+  }
+
+  const std::array valid_inputs{inputs[0], inputs[1], inputs[6]};
+  std::array<bool, 3> valid_results{};
+  assert(frame_auth.verify_frames(valid_inputs, valid_results));
+  assert(frame_auth.verify_frames({}, {}));
+
+  // Seeded keys are reproducible and sign like generated ones.
+  auth::KeySeed seed{};
+  seed[0] = 7;
+  auth::PublicKey derived_public;
+  auth::PublicKey again_public;
+  auth::SecretKey derived_secret;
+  auth::SecretKey again_secret;
+  auth::Authenticator::derive_keypair(seed, derived_public, derived_secret);
+  auth::Authenticator::derive_keypair(seed, again_public, again_secret);
+  assert(derived_public == again_public && derived_secret == again_secret);
+  authenticator.register_account(3, derived_public);
+  const auto seeded = sign_frame(derived_secret, 3, 1);
+  assert(frame_auth.verify_frame(&seeded.header, sizeof(seeded.header), seeded.payload, 3));
+}
+
+void test_key_table_snapshots() {
+  auth::Authenticator authenticator;
+  auth::PublicKey key_a;
+  auth::SecretKey secret_a;
+  auth::Authenticator::generate_keypair(key_a, secret_a);
+  authenticator.register_account(1, key_a);
+  assert(authenticator.has_account(1) && !authenticator.has_account(2));
+  assert(authenticator.get_public_key(1) == key_a);
+  assert(!authenticator.get_public_key(2));
+
+  // Bulk registration rebuilds once; later duplicates win.
+  std::vector<auth::KeyTable::Entry> entries;
+  for (common::AccountId account = 100; account < 1100; ++account) {
+    auth::PublicKey key{};
+    key[0] = static_cast<std::uint8_t>(account);
+    entries.emplace_back(account, key);
+  }
+  entries.emplace_back(100, key_a);
+  authenticator.register_accounts(entries);
+  assert(authenticator.account_count() == 1001);
+  assert(authenticator.get_public_key(100) == key_a);
+  assert((*authenticator.get_public_key(777))[0] == static_cast<std::uint8_t>(777));
+  authenticator.unregister_account(777);
+  assert(!authenticator.has_account(777) && authenticator.account_count() == 1000);
+
+  // A pre-laid-out [signature][message] buffer verifies in place.
+  const auth::FrameAuthenticator frame_auth(authenticator);
+  std::vector<std::byte> signed_frame(auth::kSignatureSize + 24, std::byte{7});
+  auth::Signature signature;
+  assert(auth::Authenticator::sign(secret_a, std::span(signed_frame).subspan(auth::kSignatureSize), signature));
+  std::memcpy(signed_frame.data(), signature.data(), signature.size());
+  assert(frame_auth.verify_signed(signed_frame, 1));
+  assert(!frame_auth.verify_signed(signed_frame, 2));
+  assert(!frame_auth.verify_signed(std::span(signed_frame).first(10), 1));
+
+  // Readers keep verifying against consistent snapshots while a writer
+  // republishes the table underneath them.
+  std::atomic<bool> done{false};
+  std::atomic<std::uint64_t> failures{0};
+  std::thread reader([&] {
+    while (!done.load()) {
+      if (!frame_auth.verify_signed(signed_frame, 1)) {
+        failures.fetch_add(1);
+      }
+    }
+  });
+  for (common::AccountId account = 2000; account < 2200; ++account) {
+    authenticator.register_account(account, key_a);
+    if (account % 2 == 0) {
+      authenticator.unregister_account(account - 1);
+    }
+  }
+  done.store(true);
+  reader.join();
+  assert(failures.load() == 0);
+  assert(authenticator.has_account(2199) && authenticator.has_account(2198) && !authenticator.has_account(2197));
+}
+
+void test_session_mac() {
+  auth::Authenticator authenticator;
+  auth::PublicKey account_key;
+  auth::SecretKey account_secret;
+  auth::Authenticator::generate_keypair(account_key, account_secret);
+  authenticator.register_account(5, account_key);
+  auth::SessionTable sessions(authenticator, {.capacity = 16, .lifetime_ns = 1'000});
+
+  const auto handshake = [&](std::uint64_t nonce, const auth::SecretKey& signer, common::TimestampNs now,
+                             auth::SessionKey& key) {
+    auth::KxPublicKey client_public;
+    auth::KxSecretKey client_secret;
+    crypto_kx_keypair(client_public.data(), client_secret.data());
+    const auth::SessionHello hello{.account = 5, .nonce = nonce, .client_key = client_public};
+    auth::Signature signature;
+    assert(auth::Authenticator::sign(signer, session_hello_message(hello), signature));
+    const auto accept = sessions.open(hello, signature, now);
+    if (accept) {
+      key = auth::SessionTable::client_session_key(hello, client_secret, accept->server_key);
+    }
+    return accept.has_value();
+  };
+
+  auth::SessionKey key{};
+  assert(handshake(10, account_secret, 100, key));
+  assert(sessions.active(5, 100) && !sessions.active(6, 100));
+
+  const std::array<std::byte, 8> header{std::byte{1}, std::byte{2}};
+  const std::array<std::byte, 12> body{std::byte{3}};
+  const auto mac = auth::SessionTable::mac(key, header, body);
+  assert(sessions.verify(5, 11, header, body, mac, 200));
+  auto tampered = body;
+  tampered[0] = std::byte{4};
+  assert(!sessions.verify(5, 11, header, tampered, mac, 200));
+  assert(!sessions.verify(6, 11, header, body, mac, 200));
+  // Frames must follow the hello in the account's nonce stream.
+  assert(!sessions.verify(5, 10, header, body, mac, 200));
+  // Expired after lifetime_ns.
+  assert(!sessions.verify(5, 11, header, body, mac, 1'100));
+
+  // Replayed or forged hellos are rejected and leave the session alone.
+  auth::SessionKey other{};
+  assert(!handshake(10, account_secret, 300, other));
+  auth::PublicKey stranger_key;
+  auth::SecretKey stranger_secret;
+  auth::Authenticator::generate_keypair(stranger_key, stranger_secret);
+  assert(!handshake(20, stranger_secret, 300, other));
+  assert(sessions.stats().rejected_hellos == 2);
+  assert(sessions.verify(5, 11, header, body, mac, 300));
+
+  // A new handshake rotates the key; close() ends the session.
+  assert(handshake(30, account_secret, 400, other));
+  assert(other != key && sessions.stats().opened == 2);
+  assert(!sessions.verify(5, 31, header, body, mac, 500));
+  assert(sessions.verify(5, 31, header, body, auth::SessionTable::mac(other, header, body), 500));
+  sessions.close(5);
+  assert(!sessions.active(5, 500));
+  assert(!sessions.verify(5, 31, header, body, auth::SessionTable::mac(other, header, body), 500));
+}
+
+void test_key_store() {
+  namespace fs = std::filesystem;
+  const auto tmp_root = fs::temp_directory_path() / "tradecore_tests_key_store";
+  fs::remove_all(tmp_root);
+  const auto path = tmp_root / "accounts.keys";
+  const auto log_path = fs::path(path.string() + ".log");
+
+  auto key_for = [](common::AccountId account) {
+    auth::PublicKey key{};
+    std::memcpy(key.data(), &account, sizeof(account));
+    key[31] = 0xab;
+    return key;
+  };
+
+  // A missing store opens empty.
+  {
+    auth::KeyStore store(path);
+    assert(store.table()->size() == 0);
+  }
+
+  // Unsorted input with a duplicate: the base is sorted and the later key wins.
+  std::vector<auth::KeyTable::Entry> entries;
+  for (common::AccountId account = 1000; account > 0; --account) {
+    entries.emplace_back(account * 3, key_for(account * 3));
+  }
+  entries.emplace_back(300, key_for(1));
+  auth::KeyStore::write(path, entries);
+
+  {
+    auth::KeyStore store(path);
+    assert(store.stats().base_records == 1000);
+    assert(store.stats().log_records == 0);
+    const auto table = store.table();
+    assert(table->size() == 1000);
+    assert(*table->find(3) == key_for(3));
+    assert(*table->find(3000) == key_for(3000));
+    assert(*table->find(300) == key_for(1));
+    assert(table->find(4) == nullptr);
+
+    // Updates go to the log; tables taken earlier are unaffected.
+    const std::vector<auth::KeyTable::Entry> added = {{4, key_for(4)}, {3, key_for(33)}};
+    store.put(added);
+    store.remove(6);
+    store.remove(5);  // never registered
+    assert(store.stats().log_records == 4);
+    const auto updated = store.table();
+    assert(updated->size() == 1000);
+    assert(*updated->find(4) == key_for(4));
+    assert(*updated->find(3) == key_for(33));
+    assert(updated->find(6) == nullptr);
+    assert(*table->find(3) == key_for(3));
+    assert(table->find(6) != nullptr);
+  }
+
+  // Reopening replays the log; a torn record at its tail is dropped.
+  {
+    std::ofstream log(log_path, std::ios::binary | std::ios::app);
+    log.write("TCKL\x01\x00", 6);
+  }
+  {
+    auth::KeyStore store(path);
+    assert(store.stats().log_records == 4);
+    assert(fs::file_size(log_path) == 4 * 56);
+    assert(*store.table()->find(3) == key_for(33));
+
+    auth::Authenticator authenticator;
+    authenticator.register_account(1, key_for(1));
+    authenticator.load(store);
+    assert(authenticator.account_count() == 1000);
+    assert(!authenticator.has_account(1));
+    assert(authenticator.has_account(4));
+
+    // Registration on top of a loaded store copies only the overlay.
+    authenticator.register_account(7, key_for(7));
+    authenticator.unregister_account(9);
+    authenticator.unregister_account(4);
+    assert(authenticator.account_count() == 999);
+    assert(authenticator.has_account(7) && !authenticator.has_account(9) && !authenticator.has_account(4));
+    assert(*authenticator.get_public_key(3) == key_for(33));
+
+    std::size_t visited = 0;
+    store.table()->for_each([&](common::AccountId account, const auth::PublicKey& key) {
+      assert(key == (account == 3 ? key_for(33) : account == 300 ? key_for(1) : key_for(account)));
+      ++visited;
+    });
+    assert(visited == 1000);
+
+    // Compaction folds the log into a new base; the loaded table still reads
+    // the old mapping.
+    store.compact();
+    assert(store.stats().base_records == 1000);
+    assert(store.stats().log_records == 0);
+    assert(fs::file_size(log_path) == 0);
+    assert(authenticator.has_account(12));
+  }
+  {
+    auth::KeyStore store(path);
+    const auto table = store.table();
+    assert(table->size() == 1000);
+    assert(*table->find(3) == key_for(33));
+    assert(*table->find(4) == key_for(4));
+    assert(table->find(6) == nullptr);
+  }
+
+  // Skewed ids still resolve: the interpolated guess falls back to galloping.
+  {
+    std::vector<auth::KeyRecord> records;
+    for (unsigned bit = 0; bit < 64; ++bit) {
+      records.push_back({.account = (1ULL << bit) + bit, .key = key_for(bit)});
+    }
+    const auth::KeyTable table(nullptr, records, {});
+    assert(table.size() == 64);
+    for (unsigned bit = 0; bit < 64; ++bit) {
+      assert(*table.find((1ULL << bit) + bit) == key_for(bit));
+      assert(table.find((1ULL << bit) + bit + 1) == nullptr || bit == 0);
+    }
+    assert(table.find(0) == nullptr);
+  }
+
+  // A flipped byte in the base fails the checksum.
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(32 + 40 * 10 + 12);
+    file.put('\x5a');
+  }
+  bool rejected = false;
+  try {
+    auth::KeyStore store(path);
+  } catch (const std::runtime_error&) {
+    rejected = true;
+  }
+  assert(rejected);
+
+  fs::remove_all(tmp_root);
+}
+
+}  // namespace tradecore::tests
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace tradecore::tests {
+void test_verify_batch();
+void test_key_table_snapshots();
+void test_session_mac();
+void test_key_store();
+}  // namespace tradecore::tests
@@ -0,0 +1,232 @@
+#include "test_common.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "tradecore/common/mpsc_ring.hpp"
+#include "tradecore/common/spsc_ring.hpp"
+
+namespace tradecore::tests {
+
+void test_spsc_ring() {
+  {
+    bool threw = false;
+    try {
+      common::SpscRing<int> ring(6);
+    } catch (const std::invalid_argument&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+
+  // Every slot is usable, and indices keep working across many wraps.
+  common::SpscRing<int> ring(4);
+  assert(ring.capacity() == 4);
+  assert(ring.empty());
+  assert(ring.front() == nullptr);
+  int next_in = 0;
+  int next_out = 0;
+  for (int round = 0; round < 10; ++round) {
+    while (ring.push(next_in)) {
+      ++next_in;
+    }
+    assert(ring.size() == 4);
+    assert(*ring.front() == next_out);
+    int value = -1;
+    assert(ring.pop(value) && value == next_out++);
+    assert(ring.pop(value) && value == next_out++);
+    assert(ring.size() == 2);
+  }
+  int value = -1;
+  while (ring.pop(value)) {
+    assert(value == next_out++);
+  }
+  assert(next_out == next_in);
+  assert(ring.empty());
+
+  // Emplaced elements are destroyed exactly once, whether popped or left in
+  // the ring when it goes away.
+  auto tracker = std::make_shared<int>(0);
+  {
+    common::SpscRing<std::shared_ptr<int>> owners(8);
+    for (int i = 0; i < 5; ++i) {
+      assert(owners.emplace(tracker));
+    }
+    assert(tracker.use_count() == 6);
+    std::shared_ptr<int> out;
+    assert(owners.pop(out));
+    out.reset();
+    assert(tracker.use_count() == 5);
+  }
+  assert(tracker.use_count() == 1);
+}
+
+void test_spsc_ring_batches() {
+  common::SpscRing<std::uint32_t> ring(8);
+  const std::array<std::uint32_t, 6> first{0, 1, 2, 3, 4, 5};
+  assert(ring.push_batch(first) == 6);
+  // Only the prefix that fits is pushed.
+  const std::array<std::uint32_t, 4> second{6, 7, 8, 9};
+  assert(ring.push_batch(second) == 2);
+  assert(ring.size() == 8);
+
+  std::array<std::uint32_t, 5> out{};
+  assert(ring.pop_batch(out) == 5);
+  for (std::uint32_t i = 0; i < 5; ++i) {
+    assert(out[i] == i);
+  }
+
+  // The readable run wraps at the end of the storage: 5..7 now, 8..10 after.
+  const std::array<std::uint32_t, 3> third{8, 9, 10};
+  assert(ring.push_batch(third) == 3);
+  auto run = ring.peek();
+  assert(run.size() == 3);
+  assert(run[0] == 5 && run[2] == 7);
+  ring.consume(run.size());
+  run = ring.peek();
+  assert(run.size() == 3);
+  assert(run[0] == 8 && run[2] == 10);
+  ring.consume(1);
+  assert(*ring.front() == 9);
+
+  std::array<std::uint32_t, 8> rest{};
+  assert(ring.pop_batch(rest) == 2);
+  assert(rest[0] == 9 && rest[1] == 10);
+  assert(ring.pop_batch(rest) == 0);
+  assert(ring.peek().empty());
+}
+
+void test_spsc_ring_threads() {
+  constexpr std::uint64_t kCount = 200'000;
+  common::SpscRing<std::uint64_t> ring(64);
+
+  std::thread producer([&] {
+    std::array<std::uint64_t, 16> batch{};
+    std::uint64_t next = 0;
+    while (next < kCount) {
+      // Alternate single pushes and batches to cover both publish paths.
+      if (next % 3 == 0) {
+        if (ring.push(next)) {
+          ++next;
+        } else {
+          std::this_thread::yield();
+        }
+        continue;
+      }
+      std::size_t fill = 0;
+      for (; fill < batch.size() && next + fill < kCount; ++fill) {
+        batch[fill] = next + fill;
+      }
+      const auto pushed = ring.push_batch(std::span<const std::uint64_t>(batch.data(), fill));
+      if (pushed == 0) {
+        std::this_thread::yield();
+      }
+      next += pushed;
+    }
+  });
+
+  std::array<std::uint64_t, 8> out{};
+  std::uint64_t expected = 0;
+  while (expected < kCount) {
+    const auto count = ring.pop_batch(out);
+    if (count == 0) {
+      std::this_thread::yield();
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      assert(out[i] == expected);
+      ++expected;
+    }
+  }
+  producer.join();
+  assert(ring.empty());
+}
+
+void test_mpsc_ring() {
+  {
+    bool threw = false;
+    try {
+      common::MpscRing<int> ring(12);
+    } catch (const std::invalid_argument&) {
+      threw = true;
+    }
+    assert(threw);
+  }
+
+  common::MpscRing<int> ring(4);
+  assert(ring.empty());
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 4; ++i) {
+      assert(ring.push(round * 10 + i));
+    }
+    assert(!ring.push(-1));
+    std::array<int, 3> out{};
+    assert(ring.pop_batch(out) == 3);
+    assert(out[0] == round * 10 && out[2] == round * 10 + 2);
+    int value = -1;
+    assert(ring.pop(value) && value == round * 10 + 3);
+    assert(!ring.pop(value));
+    assert(ring.empty());
+  }
+
+  auto tracker = std::make_shared<int>(0);
+  {
+    common::MpscRing<std::shared_ptr<int>> owners(4);
+    assert(owners.emplace(tracker));
+    assert(owners.emplace(tracker));
+    std::shared_ptr<int> out;
+    assert(owners.pop(out));
+    out.reset();
+    assert(tracker.use_count() == 2);
+  }
+  assert(tracker.use_count() == 1);
+}
+
+void test_mpsc_ring_threads() {
+  constexpr std::uint64_t kProducers = 3;
+  constexpr std::uint64_t kPerProducer = 50'000;
+  common::MpscRing<std::uint64_t> ring(32);
+
+  // Each value carries its producer in the top bits; per-producer order must
+  // survive the fan-in.
+  std::vector<std::thread> producers;
+  for (std::uint64_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&ring, p] {
+      for (std::uint64_t i = 0; i < kPerProducer;) {
+        if (ring.push((p << 32) | i)) {
+          ++i;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::array<std::uint64_t, kProducers> next{};
+  std::array<std::uint64_t, 16> out{};
+  std::uint64_t received = 0;
+  while (received < kProducers * kPerProducer) {
+    const auto count = ring.pop_batch(out);
+    if (count == 0) {
+      std::this_thread::yield();
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto producer = out[i] >> 32;
+      assert(producer < kProducers);
+      assert((out[i] & 0xffffffffu) == next[producer]);
+      ++next[producer];
+    }
+    received += count;
+  }
+  for (auto& thread : producers) {
+    thread.join();
+  }
+  assert(ring.empty());
+}
+
+}  // namespace tradecore::tests
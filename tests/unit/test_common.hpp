@@ -0,0 +1,9 @@
+#pragma once
+
+namespace tradecore::tests {
+void test_spsc_ring();
+void test_spsc_ring_batches();
+void test_spsc_ring_threads();
+void test_mpsc_ring();
+void test_mpsc_ring_threads();
+}  // namespace tradecore::tests
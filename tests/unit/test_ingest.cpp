@@ -1,13 +1,80 @@
 #include "test_ingest.hpp"
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <cassert>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <string>
 #include <stdexcept>
 #include <span>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "tradecore/common/cpu.hpp"
+#include "tradecore/ingest/feedback.hpp"
 #include "tradecore/ingest/ingress_pipeline.hpp"
+#include "tradecore/ingest/io_uring_transport.hpp"
+#include "tradecore/ingest/peer_table.hpp"
+#include "tradecore/ingest/quic_transport.hpp"
+#include "tradecore/ingest/rate_limiter.hpp"
+#include "tradecore/ingest/replay_window.hpp"
 #include "tradecore/ingest/sbe_messages.hpp"
+#include "tradecore/ingest/shm_transport.hpp"
+#include "tradecore/ingest/tcp_transport.hpp"
+#include "tradecore/ingest/transport.hpp"
 
 namespace tradecore::tests {
 
+namespace {
+
+std::vector<std::byte> make_datagram(common::AccountId account, std::uint64_t nonce, std::span<const std::byte> payload) {
+  ingest::WireHeader wire{
+      .magic = ingest::WireHeader::kMagic,
+      .version = ingest::WireHeader::kVersion,
+      .flags = 0,
+      .account = account,
+      .nonce = nonce,
+      .timestamp_ns = 0,
+      .priority = 0,
+      .kind = static_cast<std::uint8_t>(ingest::MessageKind::kNewOrder),
+      .payload_len = static_cast<std::uint16_t>(payload.size()),
+  };
+  std::vector<std::byte> datagram(sizeof(wire) + payload.size());
+  std::memcpy(datagram.data(), &wire, sizeof(wire));
+  std::memcpy(datagram.data() + sizeof(wire), payload.data(), payload.size());
+  return datagram;
+}
+
+using BatchMessage = std::pair<ingest::MessageKind, std::vector<std::byte>>;
+
+// Batch datagram with a zeroed signature; the tests' verifiers ignore it.
+std::vector<std::byte> make_batch_datagram(common::AccountId account, std::uint64_t nonce,
+                                           std::span<const BatchMessage> messages) {
+  std::vector<std::byte> payload(ingest::kFrameSignatureSize);
+  payload.push_back(static_cast<std::byte>(messages.size()));
+  for (const auto& [kind, bytes] : messages) {
+    payload.push_back(static_cast<std::byte>(kind));
+    payload.push_back(static_cast<std::byte>(bytes.size()));
+    payload.insert(payload.end(), bytes.begin(), bytes.end());
+  }
+  auto datagram = make_datagram(account, nonce, payload);
+  datagram[offsetof(ingest::WireHeader, kind)] = static_cast<std::byte>(ingest::MessageKind::kBatch);
+  return datagram;
+}
+
+}  // namespace
+
 void test_ingress_pipeline() {
   ingest::IngressPipeline pipeline;
   ingest::IngressPipeline::Config cfg;
@@ -34,7 +101,7 @@ void test_ingress_pipeline() {
   ingest::OwnedFrame dequeued;
   assert(pipeline.next_new_order(dequeued));
   const auto decoded_new = ingest::sbe::decode_new_order(dequeued.payload);
-  assert(decoded_new.quantity == sbe_new.quantity);
+  assert(decoded_new->quantity == sbe_new.quantity);
 }
 
 void test_cancel_message() {
@@ -57,7 +124,7 @@ void test_cancel_message() {
   ingest::OwnedFrame dequeued_cancel;
   assert(pipeline.next_cancel(dequeued_cancel));
   const auto decoded_cancel = ingest::sbe::decode_cancel(dequeued_cancel.payload);
-  assert(decoded_cancel.order_id == 42);
+  assert(decoded_cancel->order_id == 42);
 }
 
 void test_heartbeat_dropped() {
@@ -126,38 +193,1545 @@ void test_rate_limiting() {
   assert(pipeline.stats().rejected_rate_limit == 1);
 }
 
-void test_sbe_decode_bounds() {
+void test_token_bucket_rate_limiter() {
+  constexpr common::TimestampNs kSecond = 1'000'000'000;
+  ingest::RateLimiter limiter({
+      .tiers = {ingest::RateTier{.new_orders_per_second = 2, .cancels_per_second = 4, .replaces_per_second = 4},
+                ingest::RateTier{.new_orders_per_second = 1'000, .burst_ms = 10}},
+      .account_tiers = {{42, 1}},
+      .capacity = 16,
+      .idle_timeout_ns = kSecond,
+  });
+
+  // A full bucket holds one second of tokens; refill is continuous, so there
+  // is no window boundary to burst across.
+  assert(limiter.admit(9, ingest::MessageKind::kNewOrder, 0));
+  assert(limiter.admit(9, ingest::MessageKind::kNewOrder, 0));
+  assert(!limiter.admit(9, ingest::MessageKind::kNewOrder, 0));
+  assert(limiter.admit(9, ingest::MessageKind::kCancel, 0));
+  assert(limiter.admit(9, ingest::MessageKind::kNewOrder, kSecond / 2));
+  assert(!limiter.admit(9, ingest::MessageKind::kNewOrder, kSecond / 2));
+  assert(limiter.admit(9, ingest::MessageKind::kNewOrder, kSecond));
+  assert(!limiter.admit(9, ingest::MessageKind::kNewOrder, kSecond));
+  assert(limiter.admit(9, ingest::MessageKind::kHeartbeat, kSecond));
+
+  // Tier 1: 1000/s with a 10ms burst.
+  for (int i = 0; i < 10; ++i) {
+    assert(limiter.admit(42, ingest::MessageKind::kNewOrder, kSecond));
+  }
+  assert(!limiter.admit(42, ingest::MessageKind::kNewOrder, kSecond));
+  assert(limiter.admit(42, ingest::MessageKind::kNewOrder, kSecond + 1'000'000));
+
+  assert(limiter.stats().throttled == 4);
+  assert(limiter.stats().throttled_accounts == 2);
+  const auto top = limiter.top_throttled(1);
+  assert(top.size() == 1 && top[0].first == 9 && top[0].second == 3);
+
+  // Fill the 16-entry table: an extra account is admitted untracked until an
+  // idle entry can be reused.
+  for (common::AccountId account = 100; limiter.stats().tracked < 16; ++account) {
+    assert(limiter.admit(account, ingest::MessageKind::kCancel, kSecond));
+  }
+  assert(limiter.admit(500, ingest::MessageKind::kCancel, kSecond));
+  assert(limiter.stats().overflows == 1);
+  assert(limiter.admit(500, ingest::MessageKind::kCancel, 3 * kSecond));
+  assert(limiter.stats().evictions == 1);
+  assert(limiter.stats().tracked == 16);
+}
+
+void test_nonce_replay_window() {
   {
-    std::vector<std::byte> truncated(ingest::sbe::kNewOrderEncodedSize - 1);
-    bool threw = false;
-    try {
-      (void)ingest::sbe::decode_new_order(truncated);
-    } catch (const std::runtime_error&) {
-      threw = true;
+    ingest::ReplayWindow window(64);
+    assert(window.check(1, 10));
+    window.accept(1, 10, 0);
+    assert(!window.check(1, 10));
+    assert(window.check(1, 9));
+    window.accept(1, 9, 0);
+    assert(!window.check(1, 9));
+    assert(window.check(2, 10));
+
+    // Sliding across word boundaries keeps earlier marks at the right offset.
+    window.accept(1, 80, 0);
+    assert(!window.check(1, 10) && !window.check(1, 9) && window.check(1, 11));
+    // Nonces that fall out of the 512-bit window are rejected as too old.
+    window.accept(1, 10 + 600, 0);
+    assert(!window.check(1, 80));
+    assert(window.check(1, 610 - 511));
+    assert(!window.check(1, 610 - 512));
+  }
+
+  // Evicted accounts keep their high-water mark in the cold map.
+  {
+    ingest::ReplayWindow window(8);
+    for (common::AccountId account = 1; account <= 9; ++account) {
+      window.accept(account, 100, static_cast<common::TimestampNs>(account));
+    }
+    assert(window.stats().evictions == 1);
+    assert(!window.check(1, 100) && !window.check(1, 50));
+    assert(window.check(1, 101));
+    window.accept(1, 101, 20);
+    assert(window.stats().restored == 1);
+    assert(!window.check(1, 100) && !window.check(1, 101));
+    // Restoring account 1 parked account 2, the least recently seen.
+    assert(window.stats().retired == 1);
+  }
+
+  // The cold table is fixed too: once it is full, the parked entry with the
+  // lowest top makes room and is counted.
+  {
+    ingest::ReplayWindow window(8, 8);
+    for (common::AccountId account = 1; account <= 17; ++account) {
+      window.accept(account, 100 + account, static_cast<common::TimestampNs>(account));
     }
-    assert(threw);
+    assert(window.stats().evictions == 9);
+    assert(window.stats().retired == 8 && window.stats().cold_overflows == 1);
+    assert(window.check(1, 50));
+    assert(!window.check(2, 102) && window.check(2, 103));
+  }
+
+  // The pipeline rejects duplicates before the verifier runs, and only
+  // authenticated frames consume a nonce.
+  {
+    int verifications = 0;
+    bool authentic = false;
+    ingest::IngressPipeline pipeline;
+    pipeline.configure({}, [&](const ingest::FrameHeader&, std::span<const std::byte>) {
+      ++verifications;
+      return authentic;
+    });
+    const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 5});
+    const ingest::Frame frame{
+        .header = {.account = 4, .nonce = 77, .kind = ingest::MessageKind::kNewOrder},
+        .payload = std::span<const std::byte>(order.data(), order.size()),
+    };
+    assert(!pipeline.submit(frame));
+    assert(pipeline.stats().rejected_auth == 1);
+    authentic = true;
+    assert(pipeline.submit(frame));
+    assert(!pipeline.submit(frame));
+    assert(pipeline.stats().rejected_replay == 1);
+    assert(verifications == 2);
+  }
+}
+
+void test_parallel_verify() {
+  // Workers finish out of order (later nonces verify faster), yet frames
+  // reach the rings in submit order and forged ones never do.
+  std::atomic<int> verifications{0};
+  ingest::IngressPipeline pipeline;
+  pipeline.configure({.verify_workers = 3, .verify_batch = 8},
+                     [&](const ingest::FrameHeader& header, std::span<const std::byte>) {
+                       ++verifications;
+                       std::this_thread::sleep_for(std::chrono::microseconds(200 - 8 * (header.nonce % 20)));
+                       return header.nonce % 5 != 0;
+                     });
+  std::size_t observed = 0;
+  pipeline.set_verify_observer([&](std::chrono::nanoseconds latency, std::size_t queue_depth) {
+    assert(latency.count() >= 0 && queue_depth < 8);
+    ++observed;
+  });
+
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 5});
+  const auto submit = [&](std::uint64_t nonce) {
+    return pipeline.submit({
+        .header = {.account = 7, .nonce = nonce, .kind = ingest::MessageKind::kNewOrder},
+        .payload = std::span<const std::byte>(order.data(), order.size()),
+    });
+  };
+  for (std::uint64_t nonce = 1; nonce <= 20; ++nonce) {
+    assert(submit(nonce));
+    if (nonce == 3) {
+      // Duplicate queued alongside the original: only one may commit.
+      assert(submit(nonce));
+    }
+  }
+  pipeline.flush(0);
+
+  const auto stats = pipeline.stats();
+  assert(stats.accepted == 16);
+  assert(stats.rejected_auth == 4);
+  assert(stats.rejected_replay == 1);
+  assert(verifications.load() == 21 && observed == 21);
+  const auto verify = pipeline.verify_stats();
+  assert(verify.verified == 17 && verify.failed == 4 && verify.queue_depth == 0);
+
+  ingest::OwnedFrame frame;
+  std::uint64_t expected = 1;
+  while (pipeline.next_new_order(frame)) {
+    if (expected % 5 == 0) {
+      ++expected;
+    }
+    assert(frame.header.nonce == expected);
+    assert(ingest::sbe::decode_new_order(frame.payload)->price == 5);
+    ++expected;
+  }
+  assert(expected == 20);
+
+  // A batch verifier alone is enough; workers hand it contiguous runs of at
+  // most signature_batch frames.
+  {
+    std::mutex mutex;
+    std::vector<std::size_t> runs;
+    ingest::IngressPipeline batched;
+    batched.configure({.verify_workers = 2, .verify_batch = 16, .signature_batch = 4}, {},
+                      [&](std::span<const ingest::Frame> frames, std::span<bool> valid) {
+                        assert(valid.size() == frames.size());
+                        for (std::size_t i = 1; i < frames.size(); ++i) {
+                          assert(frames[i].header.nonce == frames[i - 1].header.nonce + 1);
+                        }
+                        std::fill(valid.begin(), valid.end(), true);
+                        std::scoped_lock lock(mutex);
+                        runs.push_back(frames.size());
+                      });
+    for (std::uint64_t nonce = 1; nonce <= 40; ++nonce) {
+      assert(batched.submit({
+          .header = {.account = 3, .nonce = nonce, .kind = ingest::MessageKind::kCancel},
+          .payload = std::span<const std::byte>(order.data(), order.size()),
+      }));
+    }
+    batched.flush(0);
+    assert(batched.stats().accepted == 40);
+    std::size_t total = 0;
+    for (const auto run : runs) {
+      assert(run >= 1 && run <= 4);
+      total += run;
+    }
+    assert(total == 40);
+  }
+}
+
+void test_sbe_decode_bounds() {
+  // Decoders need the oldest block a sender may still emit; encoders always
+  // write the current one.
+  {
+    std::vector<std::byte> truncated(ingest::sbe::NewOrderDecoder::kMinBlockLength - 1);
+    assert(!ingest::sbe::decode_new_order(truncated));
+    assert(!ingest::sbe::NewOrderDecoder::wrap(truncated));
+    std::vector<std::byte> short_block(ingest::sbe::kNewOrderEncodedSize - 1);
+    assert(ingest::sbe::decode_new_order(short_block));
+    assert(!ingest::sbe::NewOrderEncoder::wrap(short_block));
+    assert(ingest::sbe::encode(ingest::sbe::NewOrder{.quantity = 1}, short_block) == 0);
   }
 
   {
     std::vector<std::byte> truncated(ingest::sbe::kCancelEncodedSize - 1);
-    bool threw = false;
-    try {
-      (void)ingest::sbe::decode_cancel(truncated);
-    } catch (const std::runtime_error&) {
-      threw = true;
+    assert(!ingest::sbe::decode_cancel(truncated));
+    assert(ingest::sbe::encode(ingest::sbe::Cancel{.order_id = 1}, truncated) == 0);
+  }
+
+  {
+    std::vector<std::byte> truncated(ingest::sbe::ReplaceDecoder::kMinBlockLength - 1);
+    assert(!ingest::sbe::decode_replace(truncated));
+    assert(ingest::sbe::encode(ingest::sbe::Replace{.order_id = 1}, truncated) == 0);
+  }
+
+  // Flyweights read and write in place at unaligned offsets, at the fixed
+  // field offsets of the wire layout.
+  {
+    std::array<std::byte, 1 + ingest::sbe::kMaxEncodedSize> buffer{};
+    const auto body = std::span<std::byte>(buffer).subspan(1);
+    auto encoder = ingest::sbe::NewOrderEncoder::wrap(body);
+    assert(encoder);
+    encoder->side(common::Side::kSell).quantity(-3).price(0x0102030405060708).flags(0xbeef);
+    assert(body[0] == std::byte{static_cast<std::uint8_t>(common::Side::kSell)});
+    assert(body[1] == std::byte{0xfd});
+    assert(body[ingest::sbe::NewOrderDecoder::kPriceOffset] == std::byte{0x08});
+    assert(body[ingest::sbe::NewOrderDecoder::kFlagsOffset] == std::byte{0xef});
+
+    const auto decoder = ingest::sbe::NewOrderDecoder::wrap(body);
+    assert(decoder);
+    assert(decoder->side() == common::Side::kSell);
+    assert(decoder->quantity() == -3);
+    assert(decoder->price() == 0x0102030405060708);
+    assert(decoder->flags() == 0xbeef);
+
+    const ingest::sbe::Replace replace{.order_id = 77, .new_quantity = 5, .new_price = 9, .new_flags = 1};
+    const auto written = body.first(ingest::sbe::kReplaceEncodedSize);
+    assert(ingest::sbe::encode(replace, body) == ingest::sbe::kReplaceEncodedSize);
+    const auto decoded = ingest::sbe::decode_replace(written);
+    assert(decoded && decoded->order_id == 77 && decoded->new_quantity == 5 && decoded->new_price == 9 &&
+           decoded->new_flags == 1);
+    assert(ingest::sbe::encode(replace) == std::vector<std::byte>(written.begin(), written.end()));
+  }
+}
+
+void test_sbe_schema_evolution() {
+  const auto same_order = [](const ingest::sbe::NewOrder& lhs, const ingest::sbe::NewOrder& rhs) {
+    return lhs.side == rhs.side && lhs.quantity == rhs.quantity && lhs.price == rhs.price && lhs.flags == rhs.flags &&
+           lhs.market == rhs.market && lhs.time_in_force == rhs.time_in_force &&
+           lhs.display_quantity == rhs.display_quantity && lhs.client_order_id == rhs.client_order_id;
+  };
+  const ingest::sbe::NewOrder order{.side = common::Side::kBuy,
+                                    .quantity = 4,
+                                    .price = 1'000,
+                                    .flags = 2,
+                                    .market = 7,
+                                    .time_in_force = common::TimeInForce::kIoc,
+                                    .display_quantity = 1,
+                                    .client_order_id = 0xabcdef};
+  const auto current = ingest::sbe::encode(order);
+  assert(current.size() == ingest::sbe::kNewOrderEncodedSize);
+  {
+    const auto decoder = ingest::sbe::NewOrderDecoder::wrap(current);
+    assert(decoder && decoder->acting_version() == ingest::sbe::kSchemaVersion);
+    assert(same_order(decoder->get(), order));
+  }
+
+  // A v1 sender's block stops after flags; later fields read as their
+  // schema defaults.
+  {
+    const auto v1 = std::span<const std::byte>(current).first(ingest::sbe::NewOrderDecoder::kMinBlockLength);
+    const auto decoder = ingest::sbe::NewOrderDecoder::wrap(v1);
+    assert(decoder && decoder->acting_version() == 1);
+    const auto decoded = decoder->get();
+    assert(decoded.side == order.side && decoded.quantity == 4 && decoded.price == 1'000 && decoded.flags == 2);
+    assert(decoded.market == 0);
+    assert(decoded.time_in_force == common::TimeInForce::kGtc);
+    assert(decoded.display_quantity == 0 && decoded.client_order_id == 0);
+  }
+
+  // A newer sender's longer block decodes; the unknown tail is ignored.
+  {
+    auto newer = current;
+    newer.resize(newer.size() + 8, std::byte{0xff});
+    const auto decoded = ingest::sbe::decode_new_order(newer);
+    assert(decoded && same_order(*decoded, order));
+  }
+
+  {
+    const ingest::sbe::Replace replace{.order_id = 9,
+                                       .new_quantity = 3,
+                                       .new_price = 11,
+                                       .new_flags = 0,
+                                       .new_display_quantity = 1,
+                                       .new_time_in_force = common::TimeInForce::kFok};
+    const auto bytes = ingest::sbe::encode(replace);
+    const auto v1 = ingest::sbe::decode_replace(std::span<const std::byte>(bytes).first(ingest::sbe::ReplaceDecoder::kMinBlockLength));
+    assert(v1 && v1->order_id == 9 && v1->new_price == 11);
+    assert(v1->new_display_quantity == 0 && v1->new_time_in_force == common::TimeInForce::kGtc);
+    const auto current = ingest::sbe::decode_replace(bytes);
+    assert(current && current->new_display_quantity == 1 &&
+           current->new_time_in_force == common::TimeInForce::kFok);
+  }
+}
+
+void test_peer_table() {
+  constexpr common::TimestampNs kLiveness = 5'000'000'000;
+  constexpr common::TimestampNs kSecond = 1'000'000'000;
+  std::size_t cursor = 0;
+
+  // Repeat datagrams count once; peers drop out once the window passes.
+  {
+    ingest::PeerTable peers(256, kLiveness);
+    for (std::uint64_t peer = 1; peer <= 100; ++peer) {
+      peers.touch(peer, kSecond, cursor);
+      peers.touch(peer, kSecond + 10, cursor);
+    }
+    assert(peers.live(kSecond) == 100);
+    for (std::uint64_t peer = 1; peer <= 40; ++peer) {
+      peers.touch(peer, 4 * kSecond, cursor);
+    }
+    assert(peers.live(7 * kSecond) == 40);
+    assert(peers.live(10 * kSecond) == 0);
+
+    // Expired slots are reused: a whole new generation of peers fits.
+    for (std::uint64_t peer = 1'000; peer < 1'100; ++peer) {
+      peers.touch(peer, 20 * kSecond, cursor);
+    }
+    assert(peers.live(20 * kSecond) == 100);
+    peers.clear();
+    assert(peers.live(20 * kSecond) == 0);
+  }
+
+  // A full table leaves newcomers untracked rather than growing.
+  {
+    ingest::PeerTable peers(16, kLiveness);
+    for (std::uint64_t peer = 1; peer <= 64; ++peer) {
+      peers.touch(peer, kSecond, cursor);
     }
-    assert(threw);
+    assert(peers.capacity() == 16);
+    assert(peers.live(kSecond) <= 16);
   }
 
+  // Receive threads touch overlapping peers concurrently.
   {
-    std::vector<std::byte> truncated(ingest::sbe::kReplaceEncodedSize - 1);
-    bool threw = false;
-    try {
-      (void)ingest::sbe::decode_replace(truncated);
-    } catch (const std::runtime_error&) {
-      threw = true;
+    ingest::PeerTable peers(1 << 12, kLiveness);
+    std::vector<std::thread> threads;
+    for (std::uint64_t t = 0; t < 4; ++t) {
+      threads.emplace_back([&peers, t] {
+        std::size_t thread_cursor = 0;
+        for (int round = 0; round < 3; ++round) {
+          for (std::uint64_t peer = t * 250; peer < t * 250 + 500; ++peer) {
+            peers.touch(peer, kSecond + round, thread_cursor);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
     }
-    assert(threw);
+    assert(peers.live(kSecond) == 1'250);
+  }
+}
+
+void test_frame_slab_zero_copy() {
+  ingest::IngressPipeline pipeline;
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 4;
+  cfg.cancel_queue_depth = 4;
+  cfg.replace_queue_depth = 4;
+  cfg.frame_slab_slots = 2;
+  pipeline.configure(cfg);
+  auto& slab = pipeline.frame_slab();
+  assert(slab.slot_bytes() >= ingest::kMaxWireFrameSize);
+
+  // A transport receives the datagram straight into a slot and parses it in place.
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 3, .price = 7});
+  ingest::WireHeader wire{
+      .magic = ingest::WireHeader::kMagic,
+      .version = ingest::WireHeader::kVersion,
+      .flags = 0,
+      .account = 9,
+      .nonce = 1,
+      .timestamp_ns = 0,
+      .priority = 0,
+      .kind = static_cast<std::uint8_t>(ingest::MessageKind::kNewOrder),
+      .payload_len = static_cast<std::uint16_t>(order.size()),
+  };
+  const auto slot = slab.acquire();
+  assert(slot != ingest::kNoSlabSlot);
+  auto buffer = slab.slot(slot);
+  std::memcpy(buffer.data(), &wire, sizeof(wire));
+  std::memcpy(buffer.data() + sizeof(wire), order.data(), order.size());
+
+  ingest::Frame frame;
+  assert(ingest::UdpTransport::parse_frame(buffer.data(), sizeof(wire) + order.size(), frame));
+  frame.slot = slot;
+  assert(pipeline.submit(frame));
+
+  {
+    ingest::OwnedFrame dequeued;
+    assert(pipeline.next_new_order(dequeued));
+    assert(dequeued.payload.data() == buffer.data() + sizeof(wire));
+    assert(ingest::sbe::decode_new_order(dequeued.payload)->price == 7);
+
+    // Borrowed payloads are copied into the remaining slot; the slab is then
+    // exhausted until the consumer hands a frame back.
+    ingest::Frame borrowed{
+        .header = {.account = 9, .nonce = 2, .kind = ingest::MessageKind::kNewOrder},
+        .payload = std::span<const std::byte>(order.data(), order.size()),
+    };
+    assert(pipeline.submit(borrowed));
+    // A frame turned away for capacity does not burn its nonce, so the
+    // client can retry it unchanged below.
+    borrowed.header.nonce = 3;
+    assert(!pipeline.submit(borrowed));
+    assert(pipeline.stats().rejected_queue_full == 1);
+  }
+
+  ingest::Frame retry{
+      .header = {.account = 9, .nonce = 3, .kind = ingest::MessageKind::kNewOrder},
+      .payload = std::span<const std::byte>(order.data(), order.size()),
+  };
+  assert(pipeline.submit(retry));
+  ingest::OwnedFrame first;
+  ingest::OwnedFrame second;
+  assert(pipeline.next_new_order(first));
+  assert(pipeline.next_new_order(second));
+  assert(first.header.nonce == 2);
+  assert(second.header.nonce == 3);
+  assert(!pipeline.next_new_order(first));
+}
+
+void test_udp_batched_receive() {
+  constexpr std::uint16_t kPort = 39217;
+  ingest::IngressPipeline pipeline;
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 16;
+  cfg.max_new_orders_per_second = 100;
+  pipeline.configure(cfg);
+
+  ingest::UdpTransport transport({.receive_batch_size = 8});
+  transport.attach_slab(0, &pipeline.frame_slab());
+  assert(transport.start("udp://127.0.0.1:" + std::to_string(kPort),
+                         [&](std::span<const ingest::Frame> frames) { pipeline.submit(frames); }));
+
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 11});
+  const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+  assert(sender >= 0);
+  sockaddr_in target{};
+  target.sin_family = AF_INET;
+  target.sin_port = htons(kPort);
+  inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+
+  constexpr std::uint64_t kFrames = 5;
+  for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+    const auto datagram = make_datagram(4, nonce, order);
+    sendto(sender, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+  }
+  const std::byte garbage[4]{};
+  sendto(sender, garbage, sizeof(garbage), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+  close(sender);
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (transport.stats().datagrams_received < kFrames + 1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  transport.stop();
+
+  const auto stats = transport.stats();
+  assert(stats.frames_received == kFrames);
+  assert(stats.frames_malformed == 1);
+  assert(stats.datagrams_received == kFrames + 1);
+  assert(stats.receive_batches >= 1 && stats.receive_batches <= stats.datagrams_received);
+  assert(stats.average_batch_fill() >= 1.0);
+
+  ingest::OwnedFrame frame;
+  for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+    assert(pipeline.next_new_order(frame));
+    assert(frame.header.nonce == nonce);
+    assert(ingest::sbe::decode_new_order(frame.payload)->price == 11);
+  }
+  assert(!pipeline.next_new_order(frame));
+}
+
+void test_batch_frames() {
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 2, .price = 40});
+  const auto cancel = ingest::sbe::encode(ingest::sbe::Cancel{.order_id = 17});
+  const auto replace = ingest::sbe::encode(ingest::sbe::Replace{.order_id = 17, .new_quantity = 1, .new_price = 41});
+  const std::vector<BatchMessage> messages{
+      {ingest::MessageKind::kNewOrder, order},
+      {ingest::MessageKind::kCancel, cancel},
+      {ingest::MessageKind::kReplace, replace},
+  };
+
+  // parse_frame unpacks the batch in place into a run of frames with
+  // consecutive nonces.
+  auto datagram = make_batch_datagram(6, 100, messages);
+  std::array<ingest::Frame, ingest::kMaxBatchMessages> run{};
+  assert(ingest::UdpTransport::parse_frame(datagram.data(), datagram.size(), std::span<ingest::Frame>(run)) == 3);
+  for (std::size_t i = 0; i < 3; ++i) {
+    assert(run[i].header.account == 6);
+    assert(run[i].header.nonce == 100 + i);
+    assert(run[i].header.kind == messages[i].first);
+    assert(std::equal(run[i].payload.begin(), run[i].payload.end(), messages[i].second.begin(),
+                      messages[i].second.end()));
+    assert(run[i].batch.data() == datagram.data() + sizeof(ingest::WireHeader));
+    assert(run[i].batch.size() == datagram.size() - sizeof(ingest::WireHeader));
+  }
+  ingest::Frame single;
+  assert(!ingest::UdpTransport::parse_frame(datagram.data(), datagram.size(), single));
+  assert(ingest::UdpTransport::parse_frame(datagram.data(), datagram.size(), std::span<ingest::Frame>(run).first(2)) ==
+         0);
+
+  // The entries must fill the payload exactly and hold only order-entry kinds.
+  {
+    auto padded = datagram;
+    padded.push_back(std::byte{0});
+    auto& payload_len = padded[offsetof(ingest::WireHeader, payload_len)];
+    payload_len = static_cast<std::byte>(std::to_integer<int>(payload_len) + 1);
+    assert(ingest::UdpTransport::parse_frame(padded.data(), padded.size(), std::span<ingest::Frame>(run)) == 0);
+    const std::vector<BatchMessage> heartbeat{{ingest::MessageKind::kHeartbeat, {}}};
+    const auto nested = make_batch_datagram(6, 1, heartbeat);
+    assert(ingest::UdpTransport::parse_frame(nested.data(), nested.size(), std::span<ingest::Frame>(run)) == 0);
+
+    // Handed to the pipeline whole, a batch that does not unpack is counted
+    // as malformed rather than as an auth failure.
+    ingest::IngressPipeline pipeline;
+    pipeline.configure({});
+    const auto body = std::span<const std::byte>(nested).subspan(sizeof(ingest::WireHeader));
+    assert(!pipeline.submit(ingest::Frame{.header = {.account = 6, .nonce = 1, .kind = ingest::MessageKind::kBatch},
+                                          .payload = body}));
+    assert(pipeline.stats().dropped_malformed == 1 && pipeline.stats().rejected_auth == 0);
+  }
+
+  // One verifier call admits the whole run; the messages share the slab
+  // slot the batch was copied into.
+  {
+    ingest::IngressPipeline pipeline;
+    ingest::IngressPipeline::Config cfg;
+    cfg.frame_slab_slots = 1;
+    std::size_t verifier_calls = 0;
+    pipeline.configure(cfg, [&](const ingest::FrameHeader& header, std::span<const std::byte> payload) {
+      ++verifier_calls;
+      return header.kind == ingest::MessageKind::kBatch && header.nonce == 100 && payload.size() > 64;
+    });
+    assert(ingest::UdpTransport::parse_frame(datagram.data(), datagram.size(), std::span<ingest::Frame>(run)) == 3);
+    assert(pipeline.submit(std::span<const ingest::Frame>(run.data(), 3)));
+    assert(verifier_calls == 1);
+    assert(pipeline.stats().accepted == 3);
+    assert(pipeline.frame_slab().acquire() == ingest::kNoSlabSlot);
+
+    ingest::OwnedFrame cancel_frame;
+    ingest::OwnedFrame order_frame;
+    ingest::OwnedFrame replace_frame;
+    assert(pipeline.next_cancel(cancel_frame) && cancel_frame.header.nonce == 101);
+    assert(pipeline.next_new_order(order_frame) && order_frame.header.nonce == 100);
+    assert(pipeline.next_replace(replace_frame) && replace_frame.header.nonce == 102);
+    assert(ingest::sbe::decode_new_order(order_frame.payload)->price == 40);
+    assert(ingest::sbe::decode_cancel(cancel_frame.payload)->order_id == 17);
+    assert(ingest::sbe::decode_replace(replace_frame.payload)->new_price == 41);
+
+    // The slot comes back only once every message has been released.
+    cancel_frame.reset();
+    order_frame.reset();
+    assert(pipeline.frame_slab().acquire() == ingest::kNoSlabSlot);
+    replace_frame.reset();
+    const auto slot = pipeline.frame_slab().acquire();
+    assert(slot != ingest::kNoSlabSlot);
+    pipeline.frame_slab().recycle(slot);
+
+    // A nonce anywhere in the run already used rejects the whole batch.
+    auto replayed = make_batch_datagram(6, 98, messages);
+    assert(ingest::UdpTransport::parse_frame(replayed.data(), replayed.size(), std::span<ingest::Frame>(run)) == 3);
+    assert(!pipeline.submit(std::span<const ingest::Frame>(run.data(), 3)));
+    assert(pipeline.stats().rejected_replay == 3);
+    assert(verifier_calls == 1);
+    assert(!pipeline.next_new_order(order_frame));
+  }
+
+  // Rate limits and queue room are checked for every message before any is
+  // queued.
+  {
+    ingest::IngressPipeline pipeline;
+    ingest::IngressPipeline::Config cfg;
+    cfg.cancel_queue_depth = 2;
+    cfg.max_new_orders_per_second = 2;
+    cfg.rate_burst_ms = 1'000;
+    pipeline.configure(cfg);
+
+    const std::vector<BatchMessage> cancels(3, {ingest::MessageKind::kCancel, cancel});
+    const auto too_many_cancels = make_batch_datagram(8, 1, cancels);
+    assert(ingest::UdpTransport::parse_frame(too_many_cancels.data(), too_many_cancels.size(),
+                                             std::span<ingest::Frame>(run)) == 3);
+    assert(!pipeline.submit(std::span<const ingest::Frame>(run.data(), 3)));
+    assert(pipeline.stats().rejected_queue_full == 3);
+
+    const std::vector<BatchMessage> orders(3, {ingest::MessageKind::kNewOrder, order});
+    const auto too_many_orders = make_batch_datagram(8, 1, orders);
+    assert(ingest::UdpTransport::parse_frame(too_many_orders.data(), too_many_orders.size(),
+                                             std::span<ingest::Frame>(run)) == 3);
+    assert(!pipeline.submit(std::span<const ingest::Frame>(run.data(), 3)));
+    assert(pipeline.stats().rejected_rate_limit == 3);
+    // Nothing was spent: two orders still fit the burst.
+    const std::vector<BatchMessage> two_orders(2, {ingest::MessageKind::kNewOrder, order});
+    const auto within_burst = make_batch_datagram(8, 1, two_orders);
+    assert(ingest::UdpTransport::parse_frame(within_burst.data(), within_burst.size(),
+                                             std::span<ingest::Frame>(run)) == 2);
+    assert(pipeline.submit(std::span<const ingest::Frame>(run.data(), 2)));
+    assert(pipeline.stats().accepted == 2);
+  }
+
+  // Through the verify stage a batch is one ticket, unpacked again on flush.
+  {
+    ingest::IngressPipeline pipeline;
+    ingest::IngressPipeline::Config cfg;
+    cfg.verify_workers = 1;
+    std::atomic<std::size_t> verifier_calls{0};
+    pipeline.configure(cfg, [&](const ingest::FrameHeader& header, std::span<const std::byte>) {
+      verifier_calls.fetch_add(1);
+      return header.account != 13;
+    });
+    const auto batch = make_batch_datagram(6, 1, messages);
+    assert(ingest::UdpTransport::parse_frame(batch.data(), batch.size(), std::span<ingest::Frame>(run)) == 3);
+    assert(pipeline.submit(std::span<const ingest::Frame>(run.data(), 3)));
+    const auto forged = make_batch_datagram(13, 1, messages);
+    assert(ingest::UdpTransport::parse_frame(forged.data(), forged.size(), std::span<ingest::Frame>(run)) == 3);
+    assert(pipeline.submit(std::span<const ingest::Frame>(run.data(), 3)));
+    pipeline.flush(0);
+    assert(verifier_calls.load() == 2);
+    assert(pipeline.stats().accepted == 3);
+    assert(pipeline.stats().rejected_auth == 3);
+    ingest::OwnedFrame frame;
+    assert(pipeline.next_replace(frame) && ingest::sbe::decode_replace(frame.payload)->new_price == 41);
+  }
+
+  // Over loopback the transport hands the run to the callback in one call.
+  {
+    constexpr std::uint16_t kPort = 39223;
+    ingest::IngressPipeline pipeline;
+    pipeline.configure({});
+    ingest::UdpTransport transport({.receive_batch_size = 4});
+    transport.attach_slab(0, &pipeline.frame_slab());
+    std::atomic<std::size_t> largest_run{0};
+    assert(transport.start("udp://127.0.0.1:" + std::to_string(kPort), [&](std::span<const ingest::Frame> frames) {
+      largest_run.store(std::max(largest_run.load(), frames.size()));
+      pipeline.submit(frames);
+    }));
+
+    const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    assert(sender >= 0);
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(kPort);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    const auto batch = make_batch_datagram(6, 1, messages);
+    sendto(sender, batch.data(), batch.size(), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+    close(sender);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (transport.stats().datagrams_received < 1 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    transport.stop();
+    assert(transport.stats().frames_received == 3);
+    assert(transport.stats().batches_received == 1);
+    assert(largest_run.load() == 3);
+    assert(pipeline.stats().accepted == 3);
+  }
+}
+
+void test_ingress_lane_merge() {
+  ingest::IngressPipeline pipeline;
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 8;
+  cfg.cancel_queue_depth = 8;
+  cfg.replace_queue_depth = 8;
+  cfg.max_new_orders_per_second = 1;
+  cfg.lanes = 2;
+  pipeline.configure(cfg);
+  assert(pipeline.lane_count() == 2);
+  assert(&pipeline.frame_slab(0) != &pipeline.frame_slab(1));
+
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 5});
+  auto submit = [&](common::AccountId account, std::uint64_t nonce, std::uint16_t lane) {
+    const ingest::Frame frame{
+        .header = {.account = account, .nonce = nonce, .kind = ingest::MessageKind::kNewOrder},
+        .payload = std::span<const std::byte>(order.data(), order.size()),
+        .lane = lane,
+    };
+    const bool accepted = pipeline.submit(frame);
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    return accepted;
+  };
+
+  // Lanes keep independent rate-limit windows.
+  assert(submit(1, 1, 0));
+  assert(submit(1, 2, 1));
+  assert(!submit(1, 3, 0));
+  assert(submit(2, 4, 1));
+  assert(submit(3, 5, 0));
+  assert(pipeline.stats().accepted == 4);
+  assert(pipeline.stats().rejected_rate_limit == 1);
+  assert(!pipeline.submit(ingest::Frame{.header = {.account = 5}, .lane = 2}));
+
+  // The merge interleaves lanes in admission order.
+  std::vector<std::uint64_t> merged;
+  common::TimestampNs last_arrival = 0;
+  ingest::OwnedFrame frame;
+  while (pipeline.next_new_order(frame)) {
+    assert(frame.arrival_ns >= last_arrival);
+    last_arrival = frame.arrival_ns;
+    merged.push_back(frame.header.nonce);
+  }
+  assert((merged == std::vector<std::uint64_t>{1, 2, 4, 5}));
+}
+
+void test_priority_scheduling() {
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 5});
+  auto make = [&](std::uint64_t nonce, ingest::MessageKind kind, std::uint8_t priority) {
+    return ingest::Frame{
+        .header = {.account = 7, .nonce = nonce, .priority = priority, .kind = kind},
+        .payload = std::span<const std::byte>(order.data(), order.size()),
+    };
+  };
+  auto drain = [](ingest::IngressPipeline& pipeline) {
+    std::vector<std::uint64_t> nonces;
+    ingest::OwnedFrame frame;
+    while (pipeline.next(frame)) {
+      nonces.push_back(frame.header.nonce);
+    }
+    return nonces;
+  };
+
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 4;
+  cfg.cancel_queue_depth = 4;
+  cfg.replace_queue_depth = 4;
+  cfg.priority_queue_depth = 4;
+  cfg.priority_threshold = 2;
+  cfg.max_new_orders_per_second = 100;
+  cfg.max_cancels_per_second = 100;
+
+  // Strict: every cancel, then the priority tier, then standard orders, each
+  // class in admission order.
+  {
+    cfg.scheduling = ingest::IngressPipeline::Scheduling::kStrict;
+    ingest::IngressPipeline pipeline;
+    pipeline.configure(cfg);
+    assert(pipeline.classify(make(0, ingest::MessageKind::kCancel, 0).header) ==
+           ingest::IngressPipeline::PriorityClass::kCancel);
+    assert(pipeline.classify(make(0, ingest::MessageKind::kNewOrder, 1).header) ==
+           ingest::IngressPipeline::PriorityClass::kStandard);
+    assert(pipeline.classify(make(0, ingest::MessageKind::kReplace, 2).header) ==
+           ingest::IngressPipeline::PriorityClass::kPriority);
+
+    assert(pipeline.submit(make(1, ingest::MessageKind::kNewOrder, 0)));
+    assert(pipeline.submit(make(2, ingest::MessageKind::kNewOrder, 3)));
+    assert(pipeline.submit(make(3, ingest::MessageKind::kReplace, 0)));
+    assert(pipeline.submit(make(4, ingest::MessageKind::kCancel, 0)));
+    assert(pipeline.submit(make(5, ingest::MessageKind::kReplace, 2)));
+    assert(pipeline.submit(make(6, ingest::MessageKind::kCancel, 5)));
+    assert((drain(pipeline) == std::vector<std::uint64_t>{4, 6, 2, 5, 1, 3}));
+  }
+
+  // Weighted: up to class_weights[c] frames per class per round.
+  {
+    cfg.scheduling = ingest::IngressPipeline::Scheduling::kWeighted;
+    cfg.class_weights = {2, 1, 1};
+    ingest::IngressPipeline pipeline;
+    pipeline.configure(cfg);
+    for (std::uint64_t nonce = 1; nonce <= 4; ++nonce) {
+      assert(pipeline.submit(make(nonce, ingest::MessageKind::kCancel, 0)));
+    }
+    assert(pipeline.submit(make(11, ingest::MessageKind::kNewOrder, 2)));
+    assert(pipeline.submit(make(12, ingest::MessageKind::kNewOrder, 2)));
+    assert(pipeline.submit(make(21, ingest::MessageKind::kNewOrder, 0)));
+    assert(pipeline.submit(make(22, ingest::MessageKind::kNewOrder, 0)));
+    assert((drain(pipeline) == std::vector<std::uint64_t>{1, 2, 11, 21, 3, 4, 12, 22}));
+  }
+
+  // A standard backlog fills only its own queue: priority orders and cancels
+  // are still admitted, and the per-kind view still sees both tiers.
+  {
+    ingest::IngressPipeline pipeline;
+    pipeline.configure(cfg);
+    for (std::uint64_t nonce = 1; nonce <= 4; ++nonce) {
+      assert(pipeline.submit(make(nonce, ingest::MessageKind::kNewOrder, 0)));
+    }
+    assert(!pipeline.submit(make(5, ingest::MessageKind::kNewOrder, 0)));
+    assert(pipeline.submit(make(6, ingest::MessageKind::kNewOrder, 2)));
+    assert(pipeline.submit(make(7, ingest::MessageKind::kCancel, 0)));
+    assert(pipeline.stats().rejected_queue_full == 1);
+
+    ingest::OwnedFrame frame;
+    assert(pipeline.next(frame) && frame.header.nonce == 7);
+    assert(pipeline.next(frame) && frame.header.nonce == 6);
+    std::size_t standard = 0;
+    while (pipeline.next_new_order(frame)) {
+      assert(frame.header.priority == 0);
+      ++standard;
+    }
+    assert(standard == 4);
+  }
+}
+
+void test_udp_reuseport_lanes() {
+  constexpr std::uint16_t kPort = 39218;
+  constexpr std::size_t kLanes = 2;
+  ingest::IngressPipeline pipeline;
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 32;
+  cfg.max_new_orders_per_second = 100;
+  cfg.lanes = kLanes;
+  pipeline.configure(cfg);
+
+  ingest::UdpTransport transport({.receive_batch_size = 4, .receive_threads = kLanes});
+  assert(transport.lane_count() == kLanes);
+  for (std::size_t lane = 0; lane < kLanes; ++lane) {
+    transport.attach_slab(lane, &pipeline.frame_slab(lane));
+  }
+
+  std::mutex lanes_mutex;
+  std::unordered_map<common::AccountId, std::uint16_t> seen_lane;
+  const bool started = transport.start("udp://127.0.0.1:" + std::to_string(kPort), [&](std::span<const ingest::Frame> frames) {
+    {
+      std::scoped_lock lock(lanes_mutex);
+      seen_lane[frames.front().header.account] = frames.front().lane;
+    }
+    pipeline.submit(frames);
+  });
+  assert(started);
+
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 3});
+  const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+  assert(sender >= 0);
+  sockaddr_in target{};
+  target.sin_family = AF_INET;
+  target.sin_port = htons(kPort);
+  inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+
+  constexpr common::AccountId kAccounts = 8;
+  for (common::AccountId account = 1; account <= kAccounts; ++account) {
+    // Vary the byte the steering program reduces.
+    const auto datagram = make_datagram(account << 24, 1, order);
+    sendto(sender, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+  }
+  close(sender);
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (transport.stats().frames_received < kAccounts && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  transport.stop();
+  assert(transport.stats().frames_received == kAccounts);
+
+  // Every account landed on the lane the steering function predicts.
+  std::size_t per_lane[kLanes]{};
+  for (const auto& [account, lane] : seen_lane) {
+    assert(lane == ingest::UdpTransport::lane_for_account(account, kLanes));
+    ++per_lane[lane];
+  }
+  assert(per_lane[0] > 0 && per_lane[1] > 0);
+
+  ingest::OwnedFrame frame;
+  std::size_t merged = 0;
+  while (pipeline.next_new_order(frame)) {
+    ++merged;
+  }
+  assert(merged == kAccounts);
+}
+
+void test_io_uring_receive() {
+  if (!ingest::IoUringTransport::supported()) {
+    return;
+  }
+
+  constexpr std::uint16_t kPort = 39219;
+  ingest::IngressPipeline pipeline;
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 16;
+  cfg.max_new_orders_per_second = 100;
+  pipeline.configure(cfg);
+  auto& slab = pipeline.frame_slab();
+
+  ingest::IoUringTransport transport({.receive_batch_size = 8});
+  transport.attach_slab(0, &slab);
+  assert(transport.start("udp://127.0.0.1:" + std::to_string(kPort),
+                         [&](std::span<const ingest::Frame> frames) { pipeline.submit(frames); }));
+
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 2, .price = 13});
+  const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+  assert(sender >= 0);
+  sockaddr_in target{};
+  target.sin_family = AF_INET;
+  target.sin_port = htons(kPort);
+  inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+
+  constexpr std::uint64_t kFrames = 5;
+  for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+    const auto datagram = make_datagram(6, nonce, order);
+    sendto(sender, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+  }
+  const std::byte garbage[4]{};
+  sendto(sender, garbage, sizeof(garbage), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+  close(sender);
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (transport.stats().datagrams_received < kFrames + 1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  transport.stop();
+
+  const auto stats = transport.stats();
+  assert(stats.frames_received == kFrames);
+  assert(stats.frames_malformed == 1);
+  assert(stats.average_batch_fill() >= 1.0);
+  // Kernels without multishot recvmsg run the lane on the socket loop instead.
+  assert(transport.backend() == (transport.fallback_lanes() == 0 ? "io_uring" : "recvmmsg"));
+
+  // Frames were received in place: the payload sits behind the receive
+  // headroom of its slab slot.
+  ingest::OwnedFrame frame;
+  for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+    assert(pipeline.next_new_order(frame));
+    assert(frame.header.nonce == nonce);
+    assert(ingest::sbe::decode_new_order(frame.payload)->price == 13);
+    const auto* base = slab.slot(0).data();
+    const auto offset = static_cast<std::size_t>(frame.payload.data() - base) % slab.slot_bytes();
+    assert(offset > sizeof(ingest::WireHeader) && offset <= ingest::kReceiveHeadroom + sizeof(ingest::WireHeader));
+  }
+  assert(!pipeline.next_new_order(frame));
+  frame.reset();
+
+  // Every slot lent to the kernel came back on stop.
+  std::vector<std::uint32_t> slots;
+  for (auto slot = slab.acquire(); slot != ingest::kNoSlabSlot; slot = slab.acquire()) {
+    slots.push_back(slot);
+  }
+  assert(slots.size() == slab.slot_count());
+}
+
+void test_busy_poll_receive() {
+  const ingest::TransportOptions options{
+      .receive_batch_size = 4,
+      .busy_poll = true,
+      .receive_cpus = {0},
+  };
+
+  auto exercise = [&](ingest::UdpTransport& transport, std::uint16_t port) {
+    ingest::IngressPipeline pipeline;
+    ingest::IngressPipeline::Config cfg;
+    cfg.new_order_queue_depth = 16;
+    cfg.max_new_orders_per_second = 100;
+    pipeline.configure(cfg);
+    transport.attach_slab(0, &pipeline.frame_slab());
+    assert(transport.start("udp://127.0.0.1:" + std::to_string(port),
+                           [&](std::span<const ingest::Frame> frames) { pipeline.submit(frames); }));
+
+    const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 17});
+    const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    assert(sender >= 0);
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    constexpr std::uint64_t kFrames = 3;
+    for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+      const auto datagram = make_datagram(8, nonce, order);
+      sendto(sender, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+    }
+    close(sender);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (transport.stats().frames_received < kFrames && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    transport.stop();
+    assert(transport.stats().frames_received == kFrames);
+
+    ingest::OwnedFrame frame;
+    for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+      assert(pipeline.next_new_order(frame));
+      assert(frame.header.nonce == nonce);
+    }
+  };
+
+  assert(common::cpu_available(0));
+  assert(common::pin_current_thread(-1));
+
+  ingest::UdpTransport socket_transport(options);
+  exercise(socket_transport, 39220);
+
+  if (ingest::IoUringTransport::supported()) {
+    ingest::IoUringTransport uring_transport(options);
+    exercise(uring_transport, 39221);
+  }
+
+  // A CPU outside the affinity mask is refused up front.
+  ingest::UdpTransport unpinnable({.receive_cpus = {CPU_SETSIZE - 1}});
+  if (!common::cpu_available(CPU_SETSIZE - 1)) {
+    assert(!unpinnable.start("udp://127.0.0.1:39222", [](std::span<const ingest::Frame>) {}));
+  }
+}
+
+
+void test_shm_transport() {
+  const std::string name = "tradecore-test-" + std::to_string(getpid());
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 3, .price = 29});
+
+  assert(ingest::ShmTransport::ring_name("shm://" + name) == name);
+  assert(ingest::ShmTransport::ring_name("udp://127.0.0.1:9000").empty());
+  assert(ingest::ShmTransport::ring_name("shm://a/b").empty());
+  assert(ingest::QuicTransport("shm://" + name, {}).backend() == "shm");
+
+  ingest::IngressPipeline pipeline;
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 1 << 10;
+  cfg.replace_queue_depth = 16;
+  cfg.max_new_orders_per_second = 1'000'000;
+  pipeline.configure(cfg);
+  // The smallest ring (four full batch datagrams) so the writes below wrap.
+  ingest::ShmTransport transport({.shm_clients = 2, .shm_ring_bytes = 1});
+  transport.attach_slab(0, &pipeline.frame_slab());
+  std::atomic<std::uint64_t> flushes{0};
+  transport.set_batch_callback([&](std::size_t lane) {
+    assert(lane == 0);
+    flushes.fetch_add(1);
+  });
+  std::mutex mutex;
+  std::vector<std::uint64_t> nonces;
+  assert(transport.start("shm://" + name, [&](std::span<const ingest::Frame> frames) {
+    for (const auto& frame : frames) {
+      assert(frame.times.received_ns > 0 && frame.times.kernel_ns == 0);
+      std::scoped_lock lock(mutex);
+      nonces.push_back(frame.header.nonce);
+    }
+    pipeline.submit(frames);
+  }));
+  assert(!transport.start("shm://" + name, [](std::span<const ingest::Frame>) {}));
+
+  // One ring per client; a third client finds none free.
+  ingest::ShmClient client;
+  ingest::ShmClient other;
+  ingest::ShmClient extra;
+  assert(!client.connect("tradecore-missing-" + std::to_string(getpid())));
+  assert(client.connect(name) && other.connect(name));
+  assert(!extra.connect(name));
+  assert(transport.stats().connections_active == 2);
+  other.close();
+  assert(transport.stats().connections_active == 1);
+  assert(extra.connect(name));
+
+  // Far more than the ring holds: the sender retries while the transport
+  // drains, and every frame arrives once and in order.
+  constexpr std::uint64_t kFrames = 500;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+    const auto datagram = make_datagram(3, nonce, order);
+    while (!client.send(datagram)) {
+      assert(std::chrono::steady_clock::now() < deadline);
+      std::this_thread::yield();
+    }
+  }
+  const std::vector<BatchMessage> messages{
+      {ingest::MessageKind::kReplace, ingest::sbe::encode(ingest::sbe::Replace{.order_id = 1, .new_quantity = 2})},
+      {ingest::MessageKind::kReplace, ingest::sbe::encode(ingest::sbe::Replace{.order_id = 2, .new_quantity = 2})},
+  };
+  const auto batch = make_batch_datagram(3, kFrames + 1, messages);
+  while (!extra.send(batch)) {
+    std::this_thread::yield();
+  }
+  const std::byte garbage[8]{};
+  while (!extra.send(garbage)) {
+    std::this_thread::yield();
+  }
+  const std::vector<std::byte> oversized(ingest::kMaxWireFrameSize + 1);
+  assert(!extra.send(oversized));
+
+  while (transport.stats().frames_malformed < 1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  transport.stop();
+  const auto stats = transport.stats();
+  assert(stats.frames_received == kFrames + 2);
+  assert(stats.batches_received == 1);
+  assert(stats.frames_malformed == 1);
+  assert(stats.datagrams_received == kFrames + 2);
+  assert(flushes.load() > 0);
+  // Each ring is read in order; the two rings may interleave.
+  assert(nonces.size() == kFrames + 2);
+  std::erase_if(nonces, [](std::uint64_t nonce) { return nonce > kFrames; });
+  for (std::uint64_t i = 0; i < kFrames; ++i) {
+    assert(nonces[i] == i + 1);
+  }
+  assert(pipeline.stats().accepted == kFrames + 2);
+
+  // The rings went with the transport.
+  ingest::ShmClient late;
+  assert(!late.connect(name));
+
+  // With the pipeline congested the transport stops draining: the client's
+  // ring fills and it holds back, rather than frames being dropped.
+  ingest::IngressPipeline shallow;
+  cfg.new_order_queue_depth = 16;
+  cfg.shed_watermark_pct = 0;
+  shallow.configure(cfg);
+  ingest::ShmTransport paced({.shm_clients = 1, .shm_ring_bytes = 1});
+  paced.attach_slab(0, &shallow.frame_slab());
+  paced.set_pressure_callback([&](std::size_t lane) { return shallow.congested(lane); });
+  assert(paced.start("shm://" + name, [&](std::span<const ingest::Frame> frames) { shallow.submit(frames); }));
+  ingest::ShmClient held;
+  assert(held.connect(name));
+  std::uint64_t sent = 0;
+  const auto fill_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  for (;;) {
+    assert(std::chrono::steady_clock::now() < fill_deadline);
+    if (held.send(make_datagram(3, sent + 1, order))) {
+      ++sent;
+    } else if (paced.backpressure_pauses() > 0) {
+      break;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  assert(shallow.congested(0));
+  assert(shallow.stats().rejected_queue_full == 0);
+
+  std::uint64_t drained = 0;
+  ingest::OwnedFrame out;
+  const auto drain_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (drained < sent) {
+    assert(std::chrono::steady_clock::now() < drain_deadline);
+    while (shallow.next(out)) {
+      assert(out.header.nonce == ++drained);
+    }
+  }
+  paced.stop();
+  assert(shallow.stats().accepted == sent && shallow.stats().rejected_queue_full == 0);
+}
+
+void test_tcp_transport() {
+  constexpr std::uint16_t kPort = 39228;
+  const std::string endpoint = "tcp://127.0.0.1:" + std::to_string(kPort);
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 2, .price = 31});
+
+  assert(ingest::TcpTransport::handles(endpoint));
+  assert(!ingest::TcpTransport::handles("udp://127.0.0.1:9000"));
+  assert(ingest::QuicTransport(endpoint, {}).backend() == "tcp");
+
+  // Shallow rings that nothing drains until the stream is parked.
+  ingest::IngressPipeline pipeline;
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 8;
+  cfg.replace_queue_depth = 8;
+  cfg.max_new_orders_per_second = 1'000'000;
+  pipeline.configure(cfg);
+  assert(!pipeline.congested(0));
+
+  ingest::TcpTransport transport({.tcp_max_connections = 1, .tcp_read_buffer_bytes = 1});
+  std::atomic<std::uint64_t> flushes{0};
+  transport.set_batch_callback([&](std::size_t lane) {
+    assert(lane == 0);
+    flushes.fetch_add(1);
+  });
+  transport.set_pressure_callback([&](std::size_t lane) { return pipeline.congested(lane); });
+  assert(transport.start(endpoint, [&](std::span<const ingest::Frame> frames) {
+    for (const auto& frame : frames) {
+      assert(frame.slot == ingest::kNoSlabSlot && frame.times.received_ns > 0);
+    }
+    pipeline.submit(frames);
+  }));
+  assert(!transport.start(endpoint, [](std::span<const ingest::Frame>) {}));
+
+  auto connect_client = [&] {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    assert(fd >= 0);
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(kPort);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    assert(connect(fd, reinterpret_cast<sockaddr*>(&target), sizeof(target)) == 0);
+    return fd;
+  };
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  auto wait_for = [&](auto&& done) {
+    while (!done()) {
+      assert(std::chrono::steady_clock::now() < deadline);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  };
+
+  // One stream of single frames, a batch and a frame of unknown kind, written
+  // in one go so reads split frames anywhere.
+  constexpr std::uint64_t kFrames = 100;
+  std::vector<std::byte> stream;
+  for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+    const auto datagram = make_datagram(5, nonce, order);
+    stream.insert(stream.end(), datagram.begin(), datagram.end());
+  }
+  const std::vector<BatchMessage> messages{
+      {ingest::MessageKind::kReplace, ingest::sbe::encode(ingest::sbe::Replace{.order_id = 1, .new_quantity = 2})},
+      {ingest::MessageKind::kReplace, ingest::sbe::encode(ingest::sbe::Replace{.order_id = 2, .new_quantity = 2})},
+  };
+  const auto batch = make_batch_datagram(5, kFrames + 1, messages);
+  stream.insert(stream.end(), batch.begin(), batch.end());
+  auto unknown = make_datagram(5, kFrames + 3, order);
+  unknown[offsetof(ingest::WireHeader, kind)] = std::byte{200};
+  stream.insert(stream.end(), unknown.begin(), unknown.end());
+
+  const int client = connect_client();
+  wait_for([&] { return transport.stats().connections_active == 1; });
+  // Over the connection limit: accepted and closed at once.
+  const int extra = connect_client();
+  char byte;
+  assert(recv(extra, &byte, 1, 0) == 0);
+  close(extra);
+  assert(send(client, stream.data(), stream.size(), 0) == static_cast<ssize_t>(stream.size()));
+
+  // The rings fill and reading stops, rather than frames being dropped.
+  wait_for([&] { return transport.backpressure_pauses() > 0; });
+  assert(pipeline.congested(0));
+  assert(pipeline.stats().rejected_queue_full == 0);
+  assert(transport.stats().frames_received < kFrames);
+
+  std::vector<std::uint64_t> nonces;
+  ingest::OwnedFrame out;
+  wait_for([&] {
+    while (pipeline.next(out)) {
+      nonces.push_back(out.header.nonce);
+    }
+    return nonces.size() == kFrames + 2 && transport.stats().frames_malformed == 1;
+  });
+  for (std::uint64_t i = 0; i < kFrames + 2; ++i) {
+    assert(nonces[i] == i + 1);
+  }
+  const auto stats = transport.stats();
+  assert(stats.frames_received == kFrames + 2);
+  assert(stats.batches_received == 1);
+  assert(stats.datagrams_received == kFrames + 2);
+  assert(stats.bytes_received == stream.size());
+  assert(stats.receive_batches > 1);
+  assert(pipeline.stats().accepted == kFrames + 2 && pipeline.stats().rejected_queue_full == 0);
+  assert(flushes.load() > 0);
+  const auto connections = transport.connection_stats();
+  assert(connections.size() == 1);
+  assert(connections.front().peer.starts_with("127.0.0.1:"));
+  assert(connections.front().frames_received == kFrames + 2 && connections.front().frames_malformed == 1);
+  assert(connections.front().bytes_received == stream.size());
+
+  // A bad header loses the framing: the connection is dropped.
+  const std::byte garbage[sizeof(ingest::WireHeader)]{};
+  assert(send(client, garbage, sizeof(garbage), 0) == static_cast<ssize_t>(sizeof(garbage)));
+  wait_for([&] { return transport.stats().connections_active == 0; });
+  assert(recv(client, &byte, 1, 0) == 0);
+  close(client);
+  assert(transport.stats().frames_malformed == 2);
+  transport.stop();
+}
+
+void test_ingress_shedding() {
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 5});
+  auto make = [&](std::uint64_t nonce, ingest::MessageKind kind, std::uint8_t priority) {
+    return ingest::Frame{
+        .header = {.account = 9, .nonce = nonce, .priority = priority, .kind = kind},
+        .payload = std::span<const std::byte>(order.data(), order.size()),
+    };
+  };
+
+  ingest::IngressPipeline::Config cfg;
+  cfg.new_order_queue_depth = 16;
+  cfg.cancel_queue_depth = 16;
+  cfg.replace_queue_depth = 16;
+  cfg.priority_queue_depth = 16;
+  cfg.max_new_orders_per_second = 1'000;
+  cfg.max_cancels_per_second = 1'000;
+  cfg.max_replaces_per_second = 1'000;
+  cfg.shed_watermark_pct = 50;
+  ingest::IngressPipeline pipeline;
+  pipeline.configure(cfg);
+  struct Rejected {
+    std::uint64_t nonce;
+    ingest::MessageKind kind;
+    ingest::RejectReason reason;
+    std::size_t messages;
+  };
+  std::vector<Rejected> rejected;
+  pipeline.set_reject_observer(
+      [&](const ingest::Frame& frame, ingest::RejectReason reason, std::size_t messages, bool authenticated) {
+        // Shedding happens before the signature check.
+        assert(!authenticated);
+        rejected.push_back({frame.header.nonce, frame.header.kind, reason, messages});
+      });
+
+  // Half the standard new-order queue; flush() samples the occupancy.
+  for (std::uint64_t nonce = 1; nonce <= 8; ++nonce) {
+    assert(pipeline.submit(make(nonce, ingest::MessageKind::kNewOrder, 0)));
+  }
+  pipeline.flush(0);
+  assert(pipeline.queue_fill_pct(0) == 50);
+
+  // Standard orders are shed; cancels and the priority tier still get in.
+  assert(!pipeline.submit(make(9, ingest::MessageKind::kNewOrder, 0)));
+  assert(!pipeline.submit(make(10, ingest::MessageKind::kReplace, 0)));
+  assert(pipeline.submit(make(11, ingest::MessageKind::kCancel, 0)));
+  assert(pipeline.submit(make(12, ingest::MessageKind::kNewOrder, 3)));
+  assert(rejected.size() == 2);
+  assert(rejected[0].nonce == 9 && rejected[0].reason == ingest::RejectReason::kShed && rejected[0].messages == 1);
+  assert(rejected[1].nonce == 10 && rejected[1].kind == ingest::MessageKind::kReplace);
+
+  // A batch is shed whole when every message is standard tier.
+  const auto replace = ingest::sbe::encode(ingest::sbe::Replace{.order_id = 1, .new_quantity = 2});
+  const auto cancel = ingest::sbe::encode(ingest::sbe::Cancel{.order_id = 1});
+  const std::vector<BatchMessage> standard{{ingest::MessageKind::kReplace, replace},
+                                           {ingest::MessageKind::kReplace, replace}};
+  const std::vector<BatchMessage> mixed{{ingest::MessageKind::kCancel, cancel},
+                                        {ingest::MessageKind::kReplace, replace}};
+  std::vector<ingest::Frame> frames(ingest::kMaxBatchMessages);
+  auto submit_batch = [&](std::uint64_t nonce, std::span<const BatchMessage> messages) {
+    const auto datagram = make_batch_datagram(9, nonce, messages);
+    const auto count = ingest::UdpTransport::parse_frame(datagram.data(), datagram.size(), std::span(frames));
+    assert(count == messages.size());
+    return pipeline.submit(std::span<const ingest::Frame>(frames.data(), count));
+  };
+  assert(!submit_batch(20, standard));
+  assert(rejected.back().nonce == 20 && rejected.back().kind == ingest::MessageKind::kBatch &&
+         rejected.back().reason == ingest::RejectReason::kShed && rejected.back().messages == 2);
+  assert(submit_batch(30, mixed));
+  assert(pipeline.stats().rejected_shed == 4);
+
+  using Class = ingest::IngressPipeline::PriorityClass;
+  const auto standard_class = static_cast<std::size_t>(Class::kStandard);
+  const auto cancel_class = static_cast<std::size_t>(Class::kCancel);
+  auto queues = pipeline.queue_stats();
+  assert(queues.depth[standard_class] == 9 && queues.capacity[standard_class] == 32);
+  assert(queues.depth[cancel_class] == 2);
+  assert(queues.high_watermark[standard_class] == 8);
+
+  // Once drained, the next sample stops the shedding. Shed frames never
+  // reached the replay window, so they can be resent as they were.
+  ingest::OwnedFrame out;
+  while (pipeline.next(out)) {
+  }
+  pipeline.flush(0);
+  assert(pipeline.queue_fill_pct(0) == 0);
+  assert(pipeline.submit(make(9, ingest::MessageKind::kNewOrder, 0)));
+  assert(!pipeline.submit(make(9, ingest::MessageKind::kNewOrder, 0)));
+  assert(rejected.back().nonce == 9 && rejected.back().reason == ingest::RejectReason::kReplay);
+  assert(pipeline.queue_stats().high_watermark[standard_class] == 8);  // as sampled
+  pipeline.reset_stats();
+  assert(pipeline.queue_stats().high_watermark[standard_class] == 0);
+
+  // A zero watermark never sheds.
+  cfg.shed_watermark_pct = 0;
+  pipeline.configure(cfg);
+  for (std::uint64_t nonce = 1; nonce <= 16; ++nonce) {
+    assert(pipeline.submit(make(nonce, ingest::MessageKind::kNewOrder, 0)));
+  }
+  assert(pipeline.stats().rejected_shed == 0);
+}
+
+void test_reject_feedback() {
+  constexpr std::uint16_t kPort = 39229;
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 4, .price = 37});
+  const auto datagram = make_datagram(6, 1, order);
+
+  std::array<std::byte, ingest::kRejectAckSize> ack{};
+  assert(ingest::encode_reject_ack({.account = 6, .nonce = 3, .kind = ingest::MessageKind::kBatch}, 4,
+                                   ingest::RejectReason::kRateLimit, 80, ack) == ack.size());
+  const auto decoded = ingest::decode_reject_ack(ack);
+  assert(decoded && decoded->account == 6 && decoded->nonce == 3 && decoded->count == 4);
+  assert(decoded->kind == ingest::MessageKind::kBatch && decoded->reason == ingest::RejectReason::kRateLimit);
+  assert(decoded->queue_fill_pct == 80);
+  assert(!ingest::decode_reject_ack(datagram));
+  assert(!ingest::decode_reject_ack(std::span<const std::byte>(ack).first(ack.size() - 1)));
+
+  // Only authenticated senders are acked over UDP, where the source address
+  // could be forged; stream transports also ack refusals decided before the
+  // signature check. Auth failures are never acked.
+  assert(!ingest::should_ack_reject(ingest::RejectReason::kAuth, false, true));
+  assert(!ingest::should_ack_reject(ingest::RejectReason::kReplay, false, false));
+  assert(ingest::should_ack_reject(ingest::RejectReason::kReplay, false, true));
+  assert(ingest::should_ack_reject(ingest::RejectReason::kRateLimit, true, false));
+
+  // A frame, its replay, a forged frame and a second order over the rate
+  // limit, acked back to the sender over whichever transport they came in on.
+  constexpr std::uint64_t kForgedNonce = 99;
+  auto exercise = [&](ingest::Transport& transport, const std::string& endpoint, int type) {
+    ingest::IngressPipeline pipeline;
+    ingest::IngressPipeline::Config cfg;
+    cfg.new_order_queue_depth = 16;
+    cfg.max_new_orders_per_second = 1;
+    pipeline.configure(cfg, [](const ingest::FrameHeader& header, std::span<const std::byte>) {
+      return header.nonce != kForgedNonce;
+    });
+    pipeline.set_reject_observer([&, stream = transport.stream()](const ingest::Frame& frame,
+                                                                  ingest::RejectReason reason, std::size_t messages,
+                                                                  bool authenticated) {
+      if (!ingest::should_ack_reject(reason, authenticated, stream)) {
+        return;
+      }
+      std::array<std::byte, ingest::kRejectAckSize> reply{};
+      ingest::encode_reject_ack(frame.header, messages, reason, pipeline.queue_fill_pct(frame.lane), reply);
+      assert(transport.reply(frame, reply));
+    });
+    assert(transport.start(endpoint, [&](std::span<const ingest::Frame> frames) {
+      assert(frames.front().reply_to != 0);
+      pipeline.submit(frames);
+    }));
+
+    const int client = socket(AF_INET, type, 0);
+    assert(client >= 0);
+    timeval timeout{.tv_sec = 5, .tv_usec = 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(kPort);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    assert(connect(client, reinterpret_cast<sockaddr*>(&target), sizeof(target)) == 0);
+    for (const auto& frame : {datagram, datagram, make_datagram(6, kForgedNonce, order), make_datagram(6, 2, order)}) {
+      assert(send(client, frame.data(), frame.size(), 0) == static_cast<ssize_t>(frame.size()));
+    }
+
+    auto next_ack = [&] {
+      std::array<std::byte, ingest::kRejectAckSize> received{};
+      assert(recv(client, received.data(), received.size(), MSG_WAITALL) == static_cast<ssize_t>(received.size()));
+      const auto ack = ingest::decode_reject_ack(received);
+      assert(ack && ack->account == 6 && ack->count == 1 && ack->kind == ingest::MessageKind::kNewOrder);
+      return *ack;
+    };
+    if (transport.stream()) {
+      const auto replay = next_ack();
+      assert(replay.nonce == 1 && replay.reason == ingest::RejectReason::kReplay);
+    }
+    const auto throttled = next_ack();
+    assert(throttled.nonce == 2 && throttled.reason == ingest::RejectReason::kRateLimit);
+    close(client);
+    transport.stop();
+    const auto stats = pipeline.stats();
+    assert(stats.accepted == 1 && stats.rejected_replay == 1 && stats.rejected_auth == 1);
+    assert(stats.rejected_rate_limit == 1);
+  };
+  ingest::UdpTransport udp;
+  exercise(udp, "udp://127.0.0.1:" + std::to_string(kPort), SOCK_DGRAM);
+  ingest::TcpTransport tcp;
+  exercise(tcp, "tcp://127.0.0.1:" + std::to_string(kPort), SOCK_STREAM);
+
+  // Shared-memory rings only run one way.
+  ingest::ShmTransport shm;
+  assert(!shm.reply(ingest::Frame{.reply_to = 1}, ack));
+}
+
+void test_kernel_receive_timestamps() {
+  const auto order = ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 1, .price = 23});
+
+  // Every backend stamps the kernel receive and the return of the receive
+  // call; the pipeline adds the end of the signature check.
+  auto exercise = [&](ingest::UdpTransport& transport, std::uint16_t port, bool kernel_stamped) {
+    ingest::IngressPipeline pipeline;
+    ingest::IngressPipeline::Config cfg;
+    cfg.new_order_queue_depth = 16;
+    cfg.max_new_orders_per_second = 100;
+    pipeline.configure(cfg, [](const ingest::FrameHeader&, std::span<const std::byte>) { return true; });
+    transport.attach_slab(0, &pipeline.frame_slab());
+    assert(transport.start("udp://127.0.0.1:" + std::to_string(port),
+                           [&](std::span<const ingest::Frame> frames) { pipeline.submit(frames); }));
+
+    const int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    assert(sender >= 0);
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &target.sin_addr);
+    constexpr std::uint64_t kFrames = 3;
+    for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+      const auto datagram = make_datagram(4, nonce, order);
+      sendto(sender, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&target), sizeof(target));
+    }
+    close(sender);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (transport.stats().frames_received < kFrames && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    transport.stop();
+    assert(transport.stats().frames_received == kFrames);
+
+    ingest::OwnedFrame frame;
+    for (std::uint64_t nonce = 1; nonce <= kFrames; ++nonce) {
+      assert(pipeline.next_new_order(frame));
+      const auto& times = frame.times;
+      assert(times.received_ns > 0);
+      if (kernel_stamped) {
+        assert(times.kernel_ns > 0 && times.kernel_ns <= times.received_ns);
+      } else {
+        assert(times.kernel_ns == 0);
+      }
+      assert(times.received_ns <= frame.arrival_ns);
+      assert(frame.arrival_ns <= times.verified_ns);
+    }
+  };
+
+  ingest::UdpTransport single({.receive_batch_size = 1});
+  exercise(single, 39224, true);
+  ingest::UdpTransport batched({.receive_batch_size = 4});
+  exercise(batched, 39225, true);
+  if (ingest::IoUringTransport::supported()) {
+    ingest::IoUringTransport uring({.receive_batch_size = 4});
+    exercise(uring, 39226, true);
+  }
+  ingest::UdpTransport unstamped({.receive_batch_size = 4, .kernel_timestamps = false});
+  exercise(unstamped, 39227, false);
+
+  // In-process producers have no receive stamps; only verification is timed.
+  {
+    ingest::IngressPipeline pipeline;
+    pipeline.configure({}, [](const ingest::FrameHeader&, std::span<const std::byte>) { return true; });
+    assert(pipeline.submit(ingest::Frame{.header = {.account = 4, .nonce = 1}, .payload = order}));
+    ingest::OwnedFrame frame;
+    assert(pipeline.next_new_order(frame));
+    assert(frame.times.kernel_ns == 0 && frame.times.received_ns == 0);
+    assert(frame.times.verified_ns >= frame.arrival_ns);
   }
 }
 
@@ -5,5 +5,23 @@ void test_ingress_pipeline();
 void test_cancel_message();
 void test_heartbeat_dropped();
 void test_rate_limiting();
+void test_token_bucket_rate_limiter();
+void test_nonce_replay_window();
+void test_parallel_verify();
 void test_sbe_decode_bounds();
+void test_sbe_schema_evolution();
+void test_peer_table();
+void test_frame_slab_zero_copy();
+void test_udp_batched_receive();
+void test_batch_frames();
+void test_ingress_lane_merge();
+void test_priority_scheduling();
+void test_udp_reuseport_lanes();
+void test_io_uring_receive();
+void test_busy_poll_receive();
+void test_shm_transport();
+void test_tcp_transport();
+void test_ingress_shedding();
+void test_reject_feedback();
+void test_kernel_receive_timestamps();
 }  // namespace tradecore::tests
@@ -8,6 +8,10 @@
 #include <span>
 #include <stdexcept>
 
+#include "tradecore/ingest/journal_record.hpp"
+#include "tradecore/ingest/sbe_messages.hpp"
+#include "tradecore/replay/book_checkpoint.hpp"
+#include "tradecore/replay/book_reconstructor.hpp"
 #include "tradecore/replay/replay_driver.hpp"
 #include "tradecore/snapshot/snapshot_store.hpp"
 #include "tradecore/wal/wal_writer.hpp"
@@ -63,6 +67,28 @@ std::int64_t replay_balance_from_fixture(const fs::path& tmp_root, const fs::pat
   driver.execute();
   return replay_balance;
 }
+
+void append_journaled(wal::Writer& writer, ingest::MessageKind kind, std::uint64_t nonce,
+                      const std::vector<std::byte>& message,
+                      ingest::JournalRecordType type = ingest::JournalRecordType::kSequenced) {
+  const ingest::FrameHeader header{.account = 7, .nonce = nonce, .kind = kind};
+  std::vector<std::byte> payload;
+  ingest::encode_journal_record(header, message, payload);
+  writer.append({.header = {.type = static_cast<std::uint16_t>(type)},
+                 .payload = std::span<const std::byte>(payload.data(), payload.size())});
+}
+
+std::vector<std::int64_t> resting_quantities(const matcher::MatchingEngine& engine) {
+  std::vector<std::int64_t> quantities;
+  const auto book = engine.export_book(1);
+  for (const auto& order : book.bids) {
+    quantities.push_back(order.remaining);
+  }
+  for (const auto& order : book.asks) {
+    quantities.push_back(-order.remaining);
+  }
+  return quantities;
+}
 }  // namespace
 
 void test_persistence_replay() {
@@ -146,4 +172,172 @@ void test_snapshot_compaction_and_integrity() {
   fs::remove_all(tmp_root);
 }
 
+void test_book_reconstruction() {
+  namespace fs = std::filesystem;
+  const auto tmp_root = fs::temp_directory_path() / "tradecore_tests_reconstruction";
+  fs::remove_all(tmp_root);
+  fs::create_directories(tmp_root);
+  const auto wal_path = tmp_root / "events.wal";
+
+  const auto session_order = [](std::uint64_t nonce) {
+    return common::OrderId{.market = 1, .session = 7, .local = static_cast<common::SequenceId>(nonce)}.value();
+  };
+
+  {
+    wal::Writer writer(wal_path, 64);
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 1,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 10, .price = 100}));
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 2,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 5, .price = 101}));
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 3,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 4, .price = 100}));
+    append_journaled(writer, ingest::MessageKind::kCancel, 4,
+                     ingest::sbe::encode(ingest::sbe::Cancel{.order_id = session_order(2)}));
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 5,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 3, .price = 99}));
+    append_journaled(writer, ingest::MessageKind::kReplace, 6,
+                     ingest::sbe::encode(ingest::sbe::Replace{.order_id = session_order(1), .new_quantity = 2, .new_price = 102}));
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 7,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 8, .price = 98}));
+    writer.sync();
+  }
+
+  replay::BookReconstructor reconstructor({
+      .wal_path = wal_path,
+      .checkpoint_directory = tmp_root / "checkpoints",
+      .default_market = 1,
+      .markets = {1},
+  });
+
+  // Reference states rebuilt from genesis, before any checkpoint exists.
+  std::vector<std::vector<std::int64_t>> expected;
+  for (std::uint64_t seq = 0; seq <= 7; ++seq) {
+    matcher::MatchingEngine engine;
+    const auto result = reconstructor.reconstruct(seq, engine);
+    assert(result.sequence == seq);
+    assert(result.checkpoint_sequence == 0);
+    expected.push_back(resting_quantities(engine));
+  }
+  assert((expected[3] == std::vector<std::int64_t>{-6, -5}));
+  assert((expected[7] == std::vector<std::int64_t>{3, 8, -2}));
+
+  assert(reconstructor.build_checkpoints(2) == 3);
+  replay::CheckpointStore store(tmp_root / "checkpoints");
+  assert(store.checkpoint_count() == 3);
+  assert(store.latest_sequence() == 6);
+  assert(!store.nearest(1).has_value());
+  assert(store.nearest(5)->sequence == 4);
+
+  for (std::uint64_t seq = 0; seq <= 7; ++seq) {
+    matcher::MatchingEngine engine;
+    const auto result = reconstructor.reconstruct(seq, engine);
+    assert(result.sequence == seq);
+    assert(result.checkpoint_sequence == (seq < 2 ? 0 : seq - seq % 2));
+    assert(result.records_replayed == (seq < 2 ? seq : seq % 2));
+    assert(resting_quantities(engine) == expected[seq]);
+  }
+
+  // Resuming the index only appends checkpoints past the latest one.
+  assert(reconstructor.build_checkpoints(2) == 0);
+
+  // A new order risk refused is journaled but never reaches the book. The
+  // index stops at a record from before outcomes were journaled.
+  const auto outcomes_path = tmp_root / "outcomes.wal";
+  {
+    wal::Writer writer(outcomes_path, 64);
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 1,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 10, .price = 100}));
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 2,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 4, .price = 100}),
+                     ingest::JournalRecordType::kRejected);
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 3,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 3, .price = 99}),
+                     ingest::JournalRecordType::kUnchecked);
+    writer.sync();
+  }
+  replay::BookReconstructor outcomes({
+      .wal_path = outcomes_path,
+      .checkpoint_directory = tmp_root / "outcome_checkpoints",
+      .default_market = 1,
+      .markets = {1},
+  });
+  matcher::MatchingEngine engine;
+  assert(outcomes.reconstruct(3, engine).sequence == 3);
+  assert((resting_quantities(engine) == std::vector<std::int64_t>{3, -10}));
+  outcomes.set_admission_hook([](const matcher::OrderRequest&) { return false; });
+  assert(outcomes.reconstruct(3, engine).sequence == 3);
+  assert((resting_quantities(engine) == std::vector<std::int64_t>{-10}));
+
+  bool refused = false;
+  try {
+    (void)outcomes.build_checkpoints(1);
+  } catch (const std::runtime_error&) {
+    refused = true;
+  }
+  assert(refused);
+  assert(replay::CheckpointStore(tmp_root / "outcome_checkpoints").latest_sequence() == 2);
+
+  fs::remove_all(tmp_root);
+}
+
+void test_book_restore_after_restart() {
+  namespace fs = std::filesystem;
+  const auto tmp_root = fs::temp_directory_path() / "tradecore_tests_restart";
+  fs::remove_all(tmp_root);
+  fs::create_directories(tmp_root);
+  const auto wal_path = tmp_root / "events.wal";
+  const auto checkpoint_dir = tmp_root / "checkpoints";
+
+  {
+    wal::Writer writer(wal_path, 64);
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 1,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 10, .price = 100}));
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 2,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kSell, .quantity = 5, .price = 101}));
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 3,
+                     ingest::sbe::encode(ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 3, .price = 99}));
+    writer.sync();
+  }
+
+  replay::BookReconstructor reconstructor({
+      .wal_path = wal_path,
+      .checkpoint_directory = checkpoint_dir,
+      .default_market = 1,
+      .markets = {1},
+  });
+  assert(reconstructor.build_checkpoints(2) == 1);
+
+  // The restarted daemon resumes from checkpoint 2 plus the WAL tail.
+  matcher::MatchingEngine engine;
+  engine.add_market(1);
+  const auto restored = reconstructor.restore(engine);
+  assert(restored.sequence == 3);
+  assert(restored.checkpoint_sequence == 2);
+  assert(restored.records_replayed == 1);
+  assert((resting_quantities(engine) == std::vector<std::int64_t>{3, -10, -5}));
+
+  // It sequences on from there and checkpoints the book it carries, so a
+  // checkpoint written after the restart still holds the earlier orders.
+  {
+    wal::Writer writer(wal_path, 64);
+    assert(writer.next_sequence() == 4);
+    const auto order = ingest::sbe::NewOrder{.side = common::Side::kBuy, .quantity = 4, .price = 100};
+    append_journaled(writer, ingest::MessageKind::kNewOrder, 4, ingest::sbe::encode(order));
+    writer.sync();
+    (void)engine.submit(replay::new_order_request({.account = 7, .nonce = 4}, order, 1));
+
+    replay::BookCheckpoint checkpoint{.sequence = 4, .wal_offset = writer.next_offset()};
+    checkpoint.books.push_back(engine.export_book(1));
+    replay::CheckpointStore(checkpoint_dir).persist(checkpoint);
+  }
+
+  matcher::MatchingEngine rebuilt;
+  const auto result = reconstructor.reconstruct(4, rebuilt);
+  assert(result.checkpoint_sequence == 4);
+  assert(result.records_replayed == 0);
+  assert((resting_quantities(rebuilt) == std::vector<std::int64_t>{3, -6, -5}));
+
+  fs::remove_all(tmp_root);
+}
+
 }  // namespace tradecore::tests
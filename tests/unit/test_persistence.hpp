@@ -4,4 +4,6 @@ namespace tradecore::tests {
 void test_persistence_replay();
 void test_persistence_replay_determinism();
 void test_snapshot_compaction_and_integrity();
+void test_book_reconstruction();
+void test_book_restore_after_restart();
 }  // namespace tradecore::tests
@@ -0,0 +1,576 @@
+// tradecore_sbegen - generates SBE-style flyweight headers from a TOML
+// message schema.
+//
+//   tradecore_sbegen <schema.toml> <output.hpp>
+//
+// The schema format and its evolution rules are described in
+// libs/ingest/schema/order_entry.toml. The generator checks the rules before
+// writing anything, and rewrites the output only when its contents change so
+// an untouched schema does not trigger rebuilds.
+
+#define TOML_EXCEPTIONS 0
+#include <toml.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Primitive {
+  std::string_view name;
+  std::string_view cpp;
+  std::size_t size;
+  bool is_signed;
+};
+
+constexpr Primitive kPrimitives[] = {
+    {"int8", "std::int8_t", 1, true},     {"uint8", "std::uint8_t", 1, false},
+    {"int16", "std::int16_t", 2, true},   {"uint16", "std::uint16_t", 2, false},
+    {"int32", "std::int32_t", 4, true},   {"uint32", "std::uint32_t", 4, false},
+    {"int64", "std::int64_t", 8, true},   {"uint64", "std::uint64_t", 8, false},
+};
+
+struct Field {
+  std::string name;
+  const Primitive* type{nullptr};
+  // C++ type the wire value is cast to (an enum or alias), or empty.
+  std::string cpp;
+  std::int64_t since{1};
+  std::int64_t default_value{0};
+  std::string description;
+  std::size_t offset{0};
+
+  [[nodiscard]] std::string value_type() const { return cpp.empty() ? std::string(type->cpp) : cpp; }
+};
+
+struct Message {
+  std::string name;
+  std::int64_t id{0};
+  std::int64_t since{1};
+  // Followed by other data on the wire, so its block can never grow.
+  bool fixed{false};
+  std::string description;
+  std::vector<Field> fields;
+  std::map<std::int64_t, std::size_t> block_lengths;  // version -> bytes
+
+  [[nodiscard]] std::size_t length_at(std::int64_t version) const {
+    std::size_t length = 0;
+    for (const auto& field : fields) {
+      if (field.since <= version) {
+        length = field.offset + field.type->size;
+      }
+    }
+    return length;
+  }
+};
+
+struct Schema {
+  std::int64_t id{0};
+  std::int64_t version{1};
+  std::vector<std::string> namespaces;
+  std::vector<std::string> includes;
+  std::string description;
+  std::vector<Message> messages;
+};
+
+[[noreturn]] void fail(const std::string& context, const std::string& message) {
+  throw std::runtime_error(context + ": " + message);
+}
+
+bool is_snake_identifier(std::string_view name) {
+  return !name.empty() && std::islower(static_cast<unsigned char>(name.front())) &&
+         std::all_of(name.begin(), name.end(), [](char c) {
+           return std::islower(static_cast<unsigned char>(c)) || std::isdigit(static_cast<unsigned char>(c)) || c == '_';
+         });
+}
+
+bool is_camel_identifier(std::string_view name) {
+  return !name.empty() && std::isupper(static_cast<unsigned char>(name.front())) &&
+         std::all_of(name.begin(), name.end(), [](char c) { return std::isalnum(static_cast<unsigned char>(c)); });
+}
+
+// new_quantity -> NewQuantity
+std::string camel(std::string_view snake) {
+  std::string out;
+  bool upper = true;
+  for (const char c : snake) {
+    if (c == '_') {
+      upper = true;
+      continue;
+    }
+    out.push_back(upper ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : c);
+    upper = false;
+  }
+  return out;
+}
+
+// NewOrder -> new_order
+std::string snake(std::string_view camel_name) {
+  std::string out;
+  for (const char c : camel_name) {
+    if (std::isupper(static_cast<unsigned char>(c))) {
+      if (!out.empty()) {
+        out.push_back('_');
+      }
+      out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    } else {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+
+std::string require_string(const toml::table& table, std::string_view key, const std::string& context) {
+  const auto value = table[key].value<std::string>();
+  if (!value) {
+    fail(context, "missing string '" + std::string(key) + "'");
+  }
+  return *value;
+}
+
+std::int64_t require_int(const toml::table& table, std::string_view key, const std::string& context) {
+  const auto value = table[key].value<std::int64_t>();
+  if (!value) {
+    fail(context, "missing integer '" + std::string(key) + "'");
+  }
+  return *value;
+}
+
+Field parse_field(const toml::table& table, const Message& message, const std::string& context) {
+  Field field;
+  field.name = require_string(table, "name", context);
+  const auto field_context = context + ": field " + field.name;
+  if (!is_snake_identifier(field.name)) {
+    fail(field_context, "field names are snake_case");
+  }
+  const auto type = require_string(table, "type", field_context);
+  const auto* primitive = std::find_if(std::begin(kPrimitives), std::end(kPrimitives),
+                                       [&](const Primitive& p) { return p.name == type; });
+  if (primitive == std::end(kPrimitives)) {
+    fail(field_context, "unknown type '" + type + "'");
+  }
+  field.type = primitive;
+  field.cpp = table["cpp"].value_or(std::string{});
+  field.since = table["since"].value_or(message.since);
+  field.default_value = table["default"].value_or(std::int64_t{0});
+  field.description = table["description"].value_or(std::string{});
+  if (!primitive->is_signed && field.default_value < 0) {
+    fail(field_context, "negative default for an unsigned field");
+  }
+  if (primitive->size < 8) {
+    const auto bits = primitive->size * 8 - (primitive->is_signed ? 1 : 0);
+    const auto limit = std::int64_t{1} << bits;
+    if (field.default_value >= limit || field.default_value < (primitive->is_signed ? -limit : 0)) {
+      fail(field_context, "default does not fit " + type);
+    }
+  }
+  return field;
+}
+
+Message parse_message(const toml::table& table, const Schema& schema, const std::string& context) {
+  Message message;
+  message.name = require_string(table, "name", context);
+  const auto message_context = context + " " + message.name;
+  if (!is_camel_identifier(message.name)) {
+    fail(message_context, "message names are CamelCase");
+  }
+  message.id = require_int(table, "id", message_context);
+  message.since = table["since"].value_or(std::int64_t{1});
+  message.fixed = table["fixed"].value_or(false);
+  message.description = table["description"].value_or(std::string{});
+  if (message.id <= 0 || message.id > std::numeric_limits<std::uint16_t>::max()) {
+    fail(message_context, "id must be in [1, 65535]");
+  }
+  if (message.since < 1 || message.since > schema.version) {
+    fail(message_context, "since must be in [1, schema version]");
+  }
+
+  const auto* fields = table["fields"].as_array();
+  if (fields == nullptr || fields->empty()) {
+    fail(message_context, "needs a non-empty 'fields' array");
+  }
+  std::set<std::string> names;
+  std::int64_t last_since = message.since;
+  std::size_t offset = 0;
+  for (const auto& node : *fields) {
+    const auto* field_table = node.as_table();
+    if (field_table == nullptr) {
+      fail(message_context, "fields are inline tables");
+    }
+    auto field = parse_field(*field_table, message, message_context);
+    const auto field_context = message_context + ": field " + field.name;
+    if (!names.insert(field.name).second) {
+      fail(field_context, "duplicate field name");
+    }
+    if (field.since < message.since || field.since > schema.version) {
+      fail(field_context, "since must be in [message since, schema version]");
+    }
+    if (field.since < last_since) {
+      fail(field_context, "fields are append-only: a field added in v" + std::to_string(field.since) +
+                              " cannot follow one added in v" + std::to_string(last_since));
+    }
+    if (message.fixed && field.since != message.since) {
+      fail(field_context, "message is fixed (followed by other data on the wire), so fields cannot be added to it");
+    }
+    last_since = field.since;
+    field.offset = offset;
+    offset += field.type->size;
+    message.fields.push_back(std::move(field));
+  }
+
+  // The recorded block length of every version pins the layout released
+  // with it: editing, reordering or resizing a released field changes one of
+  // these and fails here instead of silently breaking peers and old WALs.
+  const auto* lengths = table["block_lengths"].as_table();
+  if (lengths == nullptr) {
+    fail(message_context, "needs a 'block_lengths' table");
+  }
+  for (const auto& [key, node] : *lengths) {
+    const auto version_text = std::string(key.str());
+    if (version_text.size() < 2 || version_text.front() != 'v' ||
+        !std::all_of(version_text.begin() + 1, version_text.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+      fail(message_context, "block_lengths keys look like v1, v2, ...");
+    }
+    const auto length = node.value<std::int64_t>();
+    if (!length || *length < 0) {
+      fail(message_context, "block_lengths." + version_text + " must be a non-negative integer");
+    }
+    message.block_lengths[std::stoll(version_text.substr(1))] = static_cast<std::size_t>(*length);
+  }
+  for (std::int64_t version = message.since; version <= schema.version; ++version) {
+    const auto found = message.block_lengths.find(version);
+    const auto actual = message.length_at(version);
+    if (found == message.block_lengths.end()) {
+      fail(message_context, "block_lengths has no entry for v" + std::to_string(version) + " (fields give " +
+                                std::to_string(actual) + " bytes)");
+    }
+    if (found->second != actual) {
+      fail(message_context, "fields give " + std::to_string(actual) + " bytes at v" + std::to_string(version) +
+                                " but block_lengths records " + std::to_string(found->second) +
+                                ". Released fields cannot change; append new fields with since = " +
+                                std::to_string(schema.version + 1) + " and bump the schema version");
+    }
+  }
+  if (message.block_lengths.size() != static_cast<std::size_t>(schema.version - message.since + 1)) {
+    fail(message_context, "block_lengths lists versions outside [since, schema version]");
+  }
+  return message;
+}
+
+Schema parse_schema(const toml::table& root) {
+  Schema schema;
+  const auto* header = root["schema"].as_table();
+  if (header == nullptr) {
+    fail("schema", "missing [schema] table");
+  }
+  schema.id = require_int(*header, "id", "schema");
+  schema.version = require_int(*header, "version", "schema");
+  schema.description = (*header)["description"].value_or(std::string{});
+  if (schema.id <= 0 || schema.id > std::numeric_limits<std::uint16_t>::max()) {
+    fail("schema", "id must be in [1, 65535]");
+  }
+  if (schema.version < 1 || schema.version > std::numeric_limits<std::uint16_t>::max()) {
+    fail("schema", "version must be in [1, 65535]");
+  }
+
+  std::stringstream ns(require_string(*header, "namespace", "schema"));
+  for (std::string part; std::getline(ns, part, ':');) {
+    if (part.empty()) {
+      continue;
+    }
+    if (!is_snake_identifier(part)) {
+      fail("schema", "namespace components are snake_case");
+    }
+    schema.namespaces.push_back(part);
+  }
+  if (schema.namespaces.empty()) {
+    fail("schema", "empty namespace");
+  }
+  if (const auto* includes = (*header)["includes"].as_array()) {
+    for (const auto& node : *includes) {
+      const auto include = node.value<std::string>();
+      if (!include) {
+        fail("schema", "includes are strings");
+      }
+      schema.includes.push_back(*include);
+    }
+  }
+
+  const auto* messages = root["message"].as_array();
+  if (messages == nullptr || messages->empty()) {
+    fail("schema", "no [[message]] entries");
+  }
+  std::set<std::string> names;
+  std::set<std::int64_t> ids;
+  for (const auto& node : *messages) {
+    const auto* table = node.as_table();
+    if (table == nullptr) {
+      fail("schema", "[[message]] entries are tables");
+    }
+    auto message = parse_message(*table, schema, "message");
+    if (!names.insert(message.name).second) {
+      fail("message " + message.name, "duplicate message name");
+    }
+    if (!ids.insert(message.id).second) {
+      fail("message " + message.name, "duplicate message id " + std::to_string(message.id));
+    }
+    schema.messages.push_back(std::move(message));
+  }
+  return schema;
+}
+
+void emit_comment(std::ostream& out, std::string_view indent, std::string_view text) {
+  std::stringstream lines{std::string(text)};
+  for (std::string line; std::getline(lines, line);) {
+    out << indent << "//" << (line.empty() ? "" : " ") << line << "\n";
+  }
+}
+
+std::string default_expression(const Field& field) {
+  if (field.default_value == 0) {
+    return field.value_type() + "{}";
+  }
+  return "static_cast<" + field.value_type() + ">(" + std::to_string(field.default_value) + ")";
+}
+
+std::string load_expression(const Field& field) {
+  const auto load = "detail::load<" + std::string(field.type->cpp) + ">(data_ + k" + camel(field.name) + "Offset)";
+  return field.cpp.empty() ? load : "static_cast<" + field.cpp + ">(" + load + ")";
+}
+
+void emit_message(std::ostream& out, const Schema& schema, const Message& message) {
+  const auto& name = message.name;
+  const auto decoder = name + "Decoder";
+  const auto encoder = name + "Encoder";
+
+  if (!message.description.empty()) {
+    emit_comment(out, "", message.description);
+  }
+  out << "struct " << name << " {\n";
+  for (const auto& field : message.fields) {
+    out << "  " << field.value_type() << " " << field.name << "{"
+        << (field.default_value == 0 ? "" : default_expression(field)) << "};";
+    if (!field.description.empty()) {
+      out << "  // " << field.description;
+    }
+    out << "\n";
+  }
+  out << "};\n\n";
+
+  out << "class " << decoder << " {\n"
+      << " public:\n"
+      << "  static constexpr std::uint16_t kTemplateId = " << message.id << ";\n"
+      << "  static constexpr std::uint16_t kSinceVersion = " << message.since << ";\n"
+      << "  // Shortest block accepted (the layout at kSinceVersion) and the block\n"
+      << "  // written at kSchemaVersion.\n"
+      << "  static constexpr std::size_t kMinBlockLength = " << message.length_at(message.since) << ";\n"
+      << "  static constexpr std::size_t kBlockLength = " << message.length_at(schema.version) << ";\n";
+  for (const auto& field : message.fields) {
+    out << "  static constexpr std::size_t k" << camel(field.name) << "Offset = " << field.offset << ";\n";
+  }
+  out << "\n"
+      << "  [[nodiscard]] static std::optional<" << decoder << "> wrap(std::span<const std::byte> data) noexcept {\n"
+      << "    return data.size() < kMinBlockLength ? std::nullopt : std::optional<" << decoder << ">(" << decoder
+      << "(data));\n"
+      << "  }\n\n";
+
+  // Versions are checked newest first; each one's block length is known.
+  out << "  // Newest schema version whose fields the block holds in full.\n"
+      << "  [[nodiscard]] std::uint16_t acting_version() const noexcept {\n";
+  for (auto version = schema.version; version > message.since; --version) {
+    if (message.length_at(version) != message.length_at(version - 1)) {
+      out << "    if (size_ >= " << message.length_at(version) << ") {\n"
+          << "      return " << version << ";\n"
+          << "    }\n";
+    }
+  }
+  out << "    return " << message.since << ";\n"
+      << "  }\n\n";
+
+  for (const auto& field : message.fields) {
+    if (field.since == message.since) {
+      out << "  [[nodiscard]] " << field.value_type() << " " << field.name << "() const noexcept { return "
+          << load_expression(field) << "; }\n";
+    } else {
+      out << "  // Since v" << field.since << "; " << default_expression(field) << " when an older sender left it out.\n"
+          << "  [[nodiscard]] " << field.value_type() << " " << field.name << "() const noexcept {\n"
+          << "    return size_ < k" << camel(field.name) << "Offset + sizeof(" << field.type->cpp << ") ? "
+          << default_expression(field) << " : " << load_expression(field) << ";\n"
+          << "  }\n";
+    }
+  }
+  out << "\n  [[nodiscard]] " << name << " get() const noexcept {\n"
+      << "    return {\n";
+  for (const auto& field : message.fields) {
+    out << "        ." << field.name << " = " << field.name << "(),\n";
+  }
+  out << "    };\n"
+      << "  }\n\n"
+      << " private:\n"
+      << "  explicit " << decoder << "(std::span<const std::byte> data) noexcept : data_(data.data()), size_(data.size()) {}\n\n"
+      << "  const std::byte* data_;\n"
+      << "  std::size_t size_;\n"
+      << "};\n\n";
+
+  out << "class " << encoder << " {\n"
+      << " public:\n"
+      << "  [[nodiscard]] static std::optional<" << encoder << "> wrap(std::span<std::byte> data) noexcept {\n"
+      << "    return data.size() < " << decoder << "::kBlockLength ? std::nullopt : std::optional<" << encoder << ">("
+      << encoder << "(data.data()));\n"
+      << "  }\n\n";
+  for (const auto& field : message.fields) {
+    const auto value = field.cpp.empty() ? std::string("value")
+                                         : "static_cast<" + std::string(field.type->cpp) + ">(value)";
+    out << "  " << encoder << "& " << field.name << "(" << field.value_type() << " value) noexcept {\n"
+        << "    detail::store(data_ + " << decoder << "::k" << camel(field.name) << "Offset, " << value << ");\n"
+        << "    return *this;\n"
+        << "  }\n";
+  }
+  out << "\n  " << encoder << "& set(const " << name << "& msg) noexcept {\n"
+      << "    return (*this)";
+  for (const auto& field : message.fields) {
+    out << "\n        ." << field.name << "(msg." << field.name << ")";
+  }
+  out << ";\n"
+      << "  }\n\n"
+      << " private:\n"
+      << "  explicit " << encoder << "(std::byte* data) noexcept : data_(data) {}\n\n"
+      << "  std::byte* data_;\n"
+      << "};\n\n";
+
+  out << "inline constexpr std::size_t k" << name << "EncodedSize = " << decoder << "::kBlockLength;\n\n"
+      << "// Whole-message decode; nullopt when `data` is shorter than the v" << message.since << " block.\n"
+      << "[[nodiscard]] inline std::optional<" << name << "> decode_" << snake(name)
+      << "(std::span<const std::byte> data) noexcept {\n"
+      << "  const auto decoder = " << decoder << "::wrap(data);\n"
+      << "  return decoder ? std::optional<" << name << ">(decoder->get()) : std::nullopt;\n"
+      << "}\n\n"
+      << "// Encodes into `out`; returns the bytes written, or 0 when `out` is too short.\n"
+      << "inline std::size_t encode(const " << name << "& msg, std::span<std::byte> out) noexcept {\n"
+      << "  auto encoder = " << encoder << "::wrap(out);\n"
+      << "  return encoder ? (encoder->set(msg), k" << name << "EncodedSize) : 0;\n"
+      << "}\n\n";
+}
+
+std::string generate(const Schema& schema, const std::filesystem::path& schema_path) {
+  std::ostringstream out;
+  out << "// Generated by tradecore_sbegen from " << schema_path.filename().string() << " - do not edit.\n";
+  if (!schema.description.empty()) {
+    out << "//\n";
+    emit_comment(out, "", schema.description);
+  }
+  out << "\n#pragma once\n\n"
+      << "#include <algorithm>\n"
+      << "#include <bit>\n"
+      << "#include <cstddef>\n"
+      << "#include <cstdint>\n"
+      << "#include <cstring>\n"
+      << "#include <optional>\n"
+      << "#include <span>\n"
+      << "#include <vector>\n";
+  if (!schema.includes.empty()) {
+    out << "\n";
+    for (const auto& include : schema.includes) {
+      out << "#include \"" << include << "\"\n";
+    }
+  }
+  out << "\n";
+  for (const auto& part : schema.namespaces) {
+    out << "namespace " << part << " {\n";
+  }
+  out << "\n"
+      << "static_assert(std::endian::native == std::endian::little, \"SBE messages are encoded little-endian in place\");\n\n"
+      << "inline constexpr std::uint16_t kSchemaId = " << schema.id << ";\n"
+      << "inline constexpr std::uint16_t kSchemaVersion = " << schema.version << ";\n\n"
+      << "namespace detail {\n\n"
+      << "template <typename T>\n"
+      << "[[nodiscard]] inline T load(const std::byte* data) noexcept {\n"
+      << "  T value;\n"
+      << "  std::memcpy(&value, data, sizeof(T));\n"
+      << "  return value;\n"
+      << "}\n\n"
+      << "template <typename T>\n"
+      << "inline void store(std::byte* data, T value) noexcept {\n"
+      << "  std::memcpy(data, &value, sizeof(T));\n"
+      << "}\n\n"
+      << "}  // namespace detail\n\n";
+
+  for (const auto& message : schema.messages) {
+    emit_message(out, schema, message);
+  }
+
+  out << "inline constexpr std::size_t kMaxEncodedSize = std::max({";
+  for (std::size_t i = 0; i < schema.messages.size(); ++i) {
+    out << (i == 0 ? "" : ", ") << "k" << schema.messages[i].name << "EncodedSize";
+  }
+  out << "});\n\n"
+      << "// Allocating form for tools and tests; hot paths encode into their own buffer.\n"
+      << "template <typename Message>\n"
+      << "[[nodiscard]] inline std::vector<std::byte> encode(const Message& msg) {\n"
+      << "  std::vector<std::byte> buffer(kMaxEncodedSize);\n"
+      << "  buffer.resize(encode(msg, std::span<std::byte>(buffer)));\n"
+      << "  return buffer;\n"
+      << "}\n\n";
+  for (auto it = schema.namespaces.rbegin(); it != schema.namespaces.rend(); ++it) {
+    out << "}  // namespace " << *it << "\n";
+  }
+  return out.str();
+}
+
+void write_if_changed(const std::filesystem::path& path, const std::string& contents) {
+  {
+    std::ifstream existing(path, std::ios::binary);
+    if (existing) {
+      const std::string current((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+      if (current == contents) {
+        return;
+      }
+    }
+  }
+  if (path.has_parent_path()) {
+    std::filesystem::create_directories(path.parent_path());
+  }
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out << contents;
+  if (!out) {
+    throw std::runtime_error("cannot write " + path.string());
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cerr << "usage: tradecore_sbegen <schema.toml> <output.hpp>\n";
+    return 2;
+  }
+  const std::filesystem::path schema_path = argv[1];
+  const std::filesystem::path output_path = argv[2];
+
+  auto parsed = toml::parse_file(schema_path.string());
+  if (!parsed) {
+    std::cerr << schema_path.string() << ": " << parsed.error() << "\n";
+    return 1;
+  }
+  try {
+    const auto schema = parse_schema(parsed.table());
+    write_if_changed(output_path, generate(schema, schema_path));
+  } catch (const std::exception& e) {
+    std::cerr << schema_path.string() << ": " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}